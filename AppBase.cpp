@@ -1,15 +1,23 @@
 #include "AppBase.h"
 
-// windows
-#include <windowsx.h>
-
 // d3d
 #include <directxcolors.h>
+#include "GPUProfilerD3D11.h"
 
 // std
+#include <algorithm>
 #include <cassert>
+#include <cfloat>
+#include <chrono>
+#include <fstream>
 #include <vector>
 #include <iostream>
+#include <thread>
+
+#ifdef _WIN32
+#include "PlatformWin32.h"
+#include "RenderDeviceD3D11.h"
+#endif // _WIN32
 
 #if IMGUI
 // imgui
@@ -18,24 +26,27 @@
 #include "../imgui/backends/imgui_impl_dx11.h"
 #endif // IMGUI
 
-LRESULT CALLBACK MainWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
-{
-	// forward hwnd on because we can get messages (e.g., WM_CREATE)
-	// before CreateWindow returns, and thus before mWindow is valid
-	return AppBase::GetApp()->MsgProc(hwnd, msg, wParam, lParam);
-}
-
 AppBase* AppBase::mApp = nullptr;
 
+#ifdef _WIN32
 AppBase::AppBase(HINSTANCE instance)
-	: mInstance(instance)
+	: AppBase(std::make_unique<PlatformWin32>(instance), std::make_unique<RenderDeviceD3D11>())
+{}
+#endif // _WIN32
+
+AppBase::AppBase(std::unique_ptr<Platform> platform, std::unique_ptr<RenderDevice> renderDevice)
+	: mPlatform(std::move(platform))
+	, mRenderDevice(std::move(renderDevice))
 	, mViewport()
 {
 	assert(mApp == nullptr);
 	mApp = this;
 }
 
-AppBase::~AppBase() {}
+AppBase::~AppBase()
+{
+	mApp = nullptr;
+}
 
 AppBase *AppBase::GetApp()
 {
@@ -44,7 +55,7 @@ AppBase *AppBase::GetApp()
 
 bool AppBase::Init()
 {
-	if (!InitWindow())
+	if (!mPlatform->Init(*this, mWindowName, mWindowWidth, mWindowHeight))
 	{
 		return false;
 	}
@@ -55,24 +66,31 @@ bool AppBase::Init()
 	}
 
 #if IMGUI
-	InitImGui();
+	mIsImGuiEnabled = !mPlatform->IsHeadless();
 
-	if (!GPUProfilerInit())
+	if (mIsImGuiEnabled)
 	{
-		return false;
+		InitImGui();
 	}
+
+	mCPUScopeOverheadNs = CPUProfiler::MeasureScopeOverheadNs();
 #endif // IMGUI
 
+	mGPUProfiler.Init(std::make_unique<GPUProfilerD3D11>(mDevice, mContext, mUserDefinedAnnotation), GPUProfiler::Settings());
+
+	mCPUFrameChannel = mFrameStatistics.GetChannel("cpu frame ms");
+	mGPUFrameChannel = mFrameStatistics.GetChannel("gpu frame ms");
+
 	OnResize();
 
 	// default vertex shader
 	{
 		std::wstring path = L"../RenderToyD3D11/shaders/Default.hlsl";
 
-		ComPtr<ID3DBlob> pCode = CompileShader(path,
-											   nullptr,
-											   "DefaultVS",
-											   ShaderTarget::VS);
+		ComPtr<ID3DBlob> pCode = mRenderDevice->CompileShader(path,
+															  nullptr,
+															  "DefaultVS",
+															  ShaderTarget::VS);
 
 		ThrowIfFailed(mDevice->CreateVertexShader(pCode->GetBufferPointer(),
 												  pCode->GetBufferSize(),
@@ -111,10 +129,10 @@ bool AppBase::Init()
 			nullptr, nullptr
 		};
 
-		ComPtr<ID3DBlob> pCode = CompileShader(path,
-											   defines,
-											   "DefaultPS",
-											   ShaderTarget::PS);
+		ComPtr<ID3DBlob> pCode = mRenderDevice->CompileShader(path,
+															  defines,
+															  "DefaultPS",
+															  ShaderTarget::PS);
 
 		ThrowIfFailed(mDevice->CreatePixelShader(pCode->GetBufferPointer(),
 												 pCode->GetBufferSize(),
@@ -128,10 +146,10 @@ bool AppBase::Init()
 	{
 		std::wstring path = L"../RenderToyD3D11/shaders/Fullscreen.hlsl";
 
-		ComPtr<ID3DBlob> pCode = CompileShader(path,
-											   nullptr,
-											   "FullscreenVS",
-											   ShaderTarget::VS);
+		ComPtr<ID3DBlob> pCode = mRenderDevice->CompileShader(path,
+															  nullptr,
+															  "FullscreenVS",
+															  ShaderTarget::VS);
 
 		ThrowIfFailed(mDevice->CreateVertexShader(pCode->GetBufferPointer(),
 												  pCode->GetBufferSize(),
@@ -145,10 +163,10 @@ bool AppBase::Init()
 	{
 		std::wstring path = L"../RenderToyD3D11/shaders/GBuffer.hlsl";
 
-		ComPtr<ID3DBlob> pCode = CompileShader(path,
-											   nullptr,
-											   "GBufferPS",
-											   ShaderTarget::PS);
+		ComPtr<ID3DBlob> pCode = mRenderDevice->CompileShader(path,
+															  nullptr,
+															  "GBufferPS",
+															  ShaderTarget::PS);
 
 		ThrowIfFailed(mDevice->CreatePixelShader(pCode->GetBufferPointer(),
 												 pCode->GetBufferSize(),
@@ -168,10 +186,10 @@ bool AppBase::Init()
 			nullptr, nullptr
 		};
 
-		ComPtr<ID3DBlob> pCode = CompileShader(path,
-											   defines,
-											   "GBufferPS",
-											   ShaderTarget::PS);
+		ComPtr<ID3DBlob> pCode = mRenderDevice->CompileShader(path,
+															  defines,
+															  "GBufferPS",
+															  ShaderTarget::PS);
 
 		ThrowIfFailed(mDevice->CreatePixelShader(pCode->GetBufferPointer(),
 												 pCode->GetBufferSize(),
@@ -236,137 +254,13 @@ bool AppBase::Init()
 	return true;
 }
 
-bool AppBase::InitWindow()
-{
-	WNDCLASS wc;
-	wc.style = CS_HREDRAW | CS_VREDRAW;
-	wc.lpfnWndProc = MainWndProc;
-	wc.cbClsExtra = 0;
-	wc.cbWndExtra = 0;
-	wc.hInstance = mInstance;
-	wc.hIcon = LoadIcon(0, IDI_APPLICATION);
-	wc.hCursor = LoadCursor(0, IDC_ARROW);
-	wc.hbrBackground = HBRUSH(GetStockObject(NULL_BRUSH));
-	wc.lpszMenuName = 0;
-	wc.lpszClassName = L"MainWnd";
-
-	if (!RegisterClass(&wc))
-	{
-		MessageBox(0, L"RegisterClass Failed.", 0, 0);
-		return false;
-	}
-
-	RECT rect = {0, 0, LONG(mWindowWidth), LONG(mWindowHeight)};
-	AdjustWindowRect(&rect, WS_OVERLAPPEDWINDOW, false);
-	int width = rect.right - rect.left;
-	int height = rect.bottom - rect.top;
-
-	mWindow = CreateWindow(L"MainWnd",
-						   mWindowName.c_str(),
-						   WS_OVERLAPPEDWINDOW,
-						   CW_USEDEFAULT,
-						   CW_USEDEFAULT,
-						   width,
-						   height,
-						   0,
-						   0,
-						   mInstance,
-						   0);
-	if (!mWindow)
-	{
-		MessageBox(0, L"CreateWindow Failed.", 0, 0);
-		return false;
-	}
-
-	ShowWindow(mWindow, SW_SHOW);
-	UpdateWindow(mWindow);
-
-	return true;
-}
-
 bool AppBase::InitDirect3D()
 {
-	ComPtr<IDXGIFactory1> pFactory; // IDXGIFactory4
-	ThrowIfFailed(CreateDXGIFactory1(__uuidof(IDXGIFactory1),
-									 reinterpret_cast<void**>(pFactory.GetAddressOf())));
-
-#if 0 // TODO: switch GPU at runtime
-	IDXGIAdapter1* pAdapter;
-	std::vector<ComPtr<IDXGIAdapter1>> pAdapters;
-
-	for (UINT i = 0; pFactory->EnumAdapters1(i, &pAdapter) != DXGI_ERROR_NOT_FOUND; ++i)
-	{
-		pAdapters.push_back(pAdapter);
-	}
-
-	for (const auto& pAdapter : pAdapters)
-	{
-		DXGI_ADAPTER_DESC desc;
-		ThrowIfFailed(pAdapter->GetDesc(&desc));
-	}
-#endif
-
-	// device & context
-	{
-		mCurrGPUIndex = 1;
-
-		ComPtr<IDXGIAdapter1> pAdapter;
-		ThrowIfFailed(pFactory->EnumAdapters1(mCurrGPUIndex, &pAdapter));
-
-		// get GPU name
-		{
-			DXGI_ADAPTER_DESC desc;
-			ThrowIfFailed(pAdapter->GetDesc(&desc));
-
-			mCurrGPUName = desc.Description;
-			mIsCurrGPUNvidia = desc.VendorId == 4318;
-		}
-
-		UINT flags = 0;
-#ifdef _DEBUG
-		flags |= D3D11_CREATE_DEVICE_DEBUG;
-#endif // _DEBUG
-
-		D3D_FEATURE_LEVEL featureLevel;
+	mRenderDevice->Init(*mPlatform, mWindowWidth, mWindowHeight);
 
-		ThrowIfFailed(D3D11CreateDevice(pAdapter.Get(),
-										D3D_DRIVER_TYPE_UNKNOWN, // D3D_DRIVER_TYPE_HARDWARE,
-										nullptr,
-										flags,
-										nullptr,
-										0,
-										D3D11_SDK_VERSION,
-										&mDevice,
-										&featureLevel,
-										&mContext));
-
-		assert(featureLevel >= D3D_FEATURE_LEVEL_11_0);
-
-		ThrowIfFailed(mContext->QueryInterface(__uuidof(mUserDefinedAnnotation.Get()),
-											   reinterpret_cast<void**>(mUserDefinedAnnotation.GetAddressOf())));
-	}
-
-	// swap chain
-	{
-		DXGI_SWAP_CHAIN_DESC desc;
-		desc.BufferDesc.Width = mWindowWidth;
-		desc.BufferDesc.Height = mWindowHeight;
-		desc.BufferDesc.RefreshRate.Numerator = 60;
-		desc.BufferDesc.RefreshRate.Denominator = 1;
-		desc.BufferDesc.Format = mSwapChainFormat;
-		desc.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
-		desc.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
-		desc.SampleDesc.Count = 1;
-		desc.SampleDesc.Quality = 0;
-		desc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
-		desc.BufferCount = min(mSwapChainBufferCount, DXGI_MAX_SWAP_CHAIN_BUFFERS);
-		desc.OutputWindow = mWindow;
-		desc.Windowed = true;
-		desc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
-		desc.Flags = mSwapChainFlags;
-
-		ThrowIfFailed(pFactory->CreateSwapChain(mDevice.Get(), &desc, &mSwapChain));
-	}
+	mDevice = mRenderDevice->GetDevice();
+	mContext = mRenderDevice->GetContext();
+	mUserDefinedAnnotation = mRenderDevice->GetAnnotation();
 
 //	// rasterizer states
 //
@@ -467,7 +361,7 @@ void AppBase::InitImGui()
 	//ImGui::StyleColorsLight();
 
 	// setup platform/renderer backends
-	ImGui_ImplWin32_Init(mWindow);
+	ImGui_ImplWin32_Init(mPlatform->GetWindow());
 	ImGui_ImplDX11_Init(mDevice.Get(), mContext.Get());
 }
 
@@ -478,153 +372,176 @@ void AppBase::CleanupImGui()
 	ImGui::DestroyContext();
 }
 
-bool AppBase::GPUProfilerInit()
+void AppBase::ShowPerfWindow()
 {
-	mQueries.resize((1 + std::size_t(TimestampQueryType::Count)) * mSwapChainBufferCount);
-
-	D3D11_QUERY_DESC desc;
+	ImGui::Begin("Performance", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
 
-	desc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
-	desc.MiscFlags = 0;
+	ImGui::Text("GPU: %ls", mRenderDevice->GetName().c_str());
+	ImGui::Text("Resolution: %dx%d", mWindowWidth, mWindowHeight);
+	//ImGui::NewLine();
 
-	for (std::size_t i = 0; i < mSwapChainBufferCount; ++i)
+	// over the last frames rather than the last one, the 1% low is what stutter shows up in
 	{
-		// the first mSwapChainBufferCount queries are disjoint
-		ThrowIfFailed(mDevice->CreateQuery(&desc, &mQueries[i]));
-	}
+		const FrameStatistics::Summary cpu = mFrameStatistics.GetSummary(mCPUFrameChannel);
+		const FrameStatistics::Summary gpu = mFrameStatistics.GetSummary(mGPUFrameChannel);
+
+		ImGui::Text
+		(
+			"FPS: %6.2f avg, %6.2f 1%% low \n"
+			"CPU: %6.2f ms avg, p50 %6.2f, p95 %6.2f, p99 %6.2f, max %6.2f \n"
+			"GPU: %6.2f ms avg, p50 %6.2f, p95 %6.2f, p99 %6.2f, max %6.2f \n"
+			, (cpu.mean > 0.0) ? 1000.0 / cpu.mean : 0.0
+			, (cpu.onePercentHigh > 0.0) ? 1000.0 / cpu.onePercentHigh : 0.0
+			, cpu.mean, cpu.p50, cpu.p95, cpu.p99, cpu.max
+			, gpu.mean, gpu.p50, gpu.p95, gpu.p99, gpu.max
+		);
+
+		std::vector<float> values;
+
+		mFrameStatistics.GetHistory(mCPUFrameChannel, values);
+		ImGui::PlotLines("##cpu frame", values.data(), int(values.size()), 0, "cpu frame ms", 0.0f, FLT_MAX, ImVec2(0, 60));
+
+		const float max = mFrameStatistics.GetHistogram(mCPUFrameChannel, 32, values);
+		const std::string overlay = "0 - " + std::to_string(int(max + 0.5f)) + " ms";
+		ImGui::PlotHistogram("##cpu frame histogram", values.data(), int(values.size()), 0, overlay.c_str(), 0.0f, FLT_MAX, ImVec2(0, 60));
+
+		if (ImGui::Button("Dump CSV"))
+		{
+			mFrameStatistics.WriteCSV("frame_statistics.csv");
+		}
 
-	desc.Query = D3D11_QUERY_TIMESTAMP;
+		ImGui::SameLine();
 
-	for (std::size_t i = mSwapChainBufferCount; i < mQueries.size(); ++i)
-	{
-		// the remaining queries are timestamps
-		ThrowIfFailed(mDevice->CreateQuery(&desc, &mQueries[i]));
+		if (ImGui::Button("Dump JSON"))
+		{
+			mFrameStatistics.WriteJSON("frame_statistics.json");
+		}
 	}
 
-	return true;
-}
-
-void AppBase::GPUProfilerShutdown()
-{
-	mQueries.clear();
-}
-
-void AppBase::GPUProfilerBegin()
-{
-	// begin disjoint
-	mContext->Begin(mQueries[mCurrQueryIndex].Get());
-	
-	GPUProfilerTimestamp(TimestampQueryType::BeginFrame);
-}
-
-void AppBase::GPUProfilerEnd()
-{
-	GPUProfilerTimestamp(TimestampQueryType::EndFrame);
-	
-	// end disjoint
-	mContext->End(mQueries[mCurrQueryIndex].Get());
-
-	mCurrQueryIndex = (mCurrQueryIndex + 1) % mSwapChainBufferCount;
-}
-
-inline std::size_t AppBase::GetTimestampQueryIndex(const TimestampQueryType type) const
-{
-	return mSwapChainBufferCount + std::size_t(type) * mSwapChainBufferCount + mCurrQueryIndex;
-}
-
-inline std::size_t AppBase::GetTimestampGetDataIndex(const TimestampQueryType type) const
-{
-	return mSwapChainBufferCount + std::size_t(type) * mSwapChainBufferCount + mCurrGetDataIndex;
-}
-
-void AppBase::GPUProfilerTimestamp(const TimestampQueryType type)
-{
-	const std::size_t i = GetTimestampQueryIndex(type);
-	mContext->End(mQueries[i].Get());
-}
-
-void AppBase::ShowPerfWindow()
-{
-	ImGui::Begin("Performance", nullptr, ImGuiWindowFlags_AlwaysAutoResize);
-
-	ImGui::Text("GPU: %ls", mCurrGPUName.c_str());
-	ImGui::Text("Resolution: %dx%d", mWindowWidth, mWindowHeight);
-	//ImGui::NewLine();
+	// the gpu scopes of a frame that finished a few frames ago, nested ones indented under their parent
+	for (const GPUProfiler::ScopeResult& result : mGPUProfiler.GetResults())
+	{
+		ImGui::Text("%*s%-*s %6.2f ms", int(2 * result.depth), "", int(24 - 2 * result.depth), mGPUProfiler.GetScopeName(result.scope).c_str(), result.durationMs);
+	}
 
-	const float fps = 1 / mTimer.GetDeltaTime();
-	const float cpuTime = mTimer.GetDeltaTime() * 1000;
-	float gpuTime = 0;
+	// the cpu scopes of the previous frame, on every thread that recorded some
+	ImGui::Text("CPU scopes (%4.1f ns each):", mCPUScopeOverheadNs);
 
-	float gpuTimeDepthGBufferPrepass = 0;
-	float gpuTimeRayTracedShadows = 0;
-	float gpuTimeRayTracedReflections = 0;
-	float gpuTimeMainPass = 0;
-	float gpuTimeImGui = 0;
+	for (const CPUProfiler::Node& node : CPUProfiler::GetFrameTree())
+	{
+		ImGui::Text("%*s%-*s %6.2f ms %6.2f ms self %4ux  thread %u", int(2 * node.depth), "", int(24 - 2 * node.depth), node.name, node.totalMs, node.selfMs, node.callCount, node.thread);
+	}
 
-	if (mCurrGetDataIndex != -1)
+	// trace capture, written next to the executable
 	{
-		while (mContext->GetData(mQueries[mCurrGetDataIndex].Get(), nullptr, 0, 0) == S_FALSE)
+		if (ImGui::Button("Capture trace"))
 		{
-			Sleep(1);
+			mTraceExporter.CaptureFrames("trace.json", 60);
 		}
 
-		D3D11_QUERY_DATA_TIMESTAMP_DISJOINT data;
-		ThrowIfFailed(mContext->GetData(mQueries[mCurrGetDataIndex].Get(), &data, sizeof(data), 0));
+		ImGui::SameLine();
 
-		if (!data.Disjoint)
+		if (ImGui::Checkbox("and frames over 50 ms", &mIsSpikeCaptureEnabled))
 		{
-			UINT64 timestamps[std::size_t(TimestampQueryType::Count)];
-
-			for (std::size_t i = 0; i < std::size_t(TimestampQueryType::Count); ++i)
-			{
-				const std::size_t query = GetTimestampGetDataIndex(TimestampQueryType(i));
-
-				while (!mIsCurrGPUNvidia && (mContext->GetData(mQueries[query].Get(), nullptr, 0, 0) == S_FALSE))
-				{
-					Sleep(1);
-				}
+			mTraceExporter.SetSpikeCapture("spike_", mIsSpikeCaptureEnabled ? 50.0 : 0.0);
+		}
 
-				ThrowIfFailed(mContext->GetData(mQueries[query].Get(), &timestamps[i], sizeof(UINT64), 0));
-			}
+		const TraceExporter::Stats& traces = mTraceExporter.GetStats();
 
-			auto CalcGpuTime = [timestamps, data](const TimestampQueryType begin, const TimestampQueryType end)
-			{
-				return (1000.0f * (timestamps[std::size_t(end)] - timestamps[std::size_t(begin)])) / data.Frequency;
-			};
+		ImGui::Text
+		(
+			"Traces: %zu captured, %zu frames written, %zu dropped \n"
+			, traces.captureCount
+			, traces.writtenFrames
+			, traces.droppedFrames
+		);
+	}
 
-			gpuTime = CalcGpuTime(TimestampQueryType::BeginFrame, TimestampQueryType::EndFrame);
+	// content deduplication
+	{
+		const MaterialManager::DeduplicationStats& materials = mMaterialManager.GetDeduplicationStats();
+		const TextureManager::DeduplicationStats& textures = mTextureManager.GetDeduplicationStats();
+
+		ImGui::Text
+		(
+			"Materials: %zu unique / %zu added, %6.2f KB saved \n"
+			"Textures:  %zu unique / %zu loaded, %6.2f MB saved, %zu SRVs saved \n"
+			, mMaterialManager.GetMaterials().size()
+			, materials.requestCount
+			, materials.savedBytes / 1024.0f
+			, mTextureManager.GetTextureCount()
+			, textures.requestCount
+			, textures.savedBytes / (1024.0f * 1024.0f)
+			, textures.savedSRVs
+		);
+	}
 
-			gpuTimeDepthGBufferPrepass = CalcGpuTime(TimestampQueryType::DepthGbufferPrepassBegin, TimestampQueryType::DepthGbufferPrepassEnd);
-			gpuTimeRayTracedShadows = CalcGpuTime(TimestampQueryType::RayTracedShadowsBegin, TimestampQueryType::RayTracedShadowsEnd);
-			gpuTimeRayTracedReflections = CalcGpuTime(TimestampQueryType::RayTracedReflectionsBegin, TimestampQueryType::RayTracedReflectionsEnd);
-			gpuTimeMainPass = CalcGpuTime(TimestampQueryType::MainPassBegin, TimestampQueryType::MainPassEnd);
-			gpuTimeImGui = CalcGpuTime(TimestampQueryType::ImGuiBegin, TimestampQueryType::ImGuiEnd);
-		}
+	// async texture loads
+	{
+		const TextureManager::AsyncLoadStats& loads = mTextureManager.GetAsyncLoadStats();
+
+		ImGui::Text
+		(
+			"Async textures: %zu ready, %zu pending \n"
+			"Latency: %6.2f ms avg, %6.2f ms max, parse %6.2f ms avg \n"
+			"Throughput: %6.2f MB/s \n"
+			, loads.completedCount
+			, loads.GetPendingCount()
+			, loads.GetAverageLatencyMs()
+			, loads.maxLatencyMs
+			, loads.completedCount ? loads.totalParseMs / loads.completedCount : 0.0
+			, loads.GetThroughputMBs()
+		);
+	}
 
-		mCurrGetDataIndex = (mCurrGetDataIndex + 1) % mSwapChainBufferCount;
+	// compressed textures
+	{
+		const CompressedTexture::Report& decompression = mTextureManager.GetDecompressionStats();
+
+		ImGui::Text
+		(
+			"Decompression: %zu chunks, %6.2f MB, ratio %4.2f, %6.2f MB/s \n"
+			, decompression.chunkCount
+			, decompression.originalBytes / (1024.0f * 1024.0f)
+			, decompression.GetRatio()
+			, decompression.GetThroughputMBs()
+		);
 	}
-	else
+
+	// texture streaming
 	{
-		mCurrGetDataIndex = 0;
+		const TextureStreamer& streamer = mTextureManager.GetStreamer();
+		const TextureStreamer::Stats& stats = streamer.GetStats();
+
+		ImGui::Text
+		(
+			"Streaming: %6.2f / %6.2f MB resident, %zu in, %zu evicted, %zu denied \n"
+			, stats.residentBytes / (1024.0f * 1024.0f)
+			, streamer.GetSettings().budgetBytes / (1024.0f * 1024.0f)
+			, stats.streamInCount
+			, stats.evictionCount
+			, stats.deniedCount
+		);
 	}
 
-	ImGui::Text("FPS: %6.2f", fps);
-	ImGui::Text("CPU: %6.2f ms", cpuTime);
-	ImGui::Text("GPU: %6.2f ms", gpuTime);
-
-	ImGui::Text
-	(
-		//"DepthGBufferPrepass:  %6.2f ms \n"
-		"RayTracedShadows:     %6.2f ms \n"
-		"RayTracedReflections: %6.2f ms \n"
-		//"MainPass:             %6.2f ms \n"
-		//"ImGui:                %6.2f ms \n"
-		//, gpuTimeDepthGBufferPrepass
-		, gpuTimeRayTracedShadows
-		, gpuTimeRayTracedReflections
-		//, gpuTimeMainPass
-		//, gpuTimeImGui
-	);
+	// virtual textures
+	for (std::size_t i = 0; i < mTextureManager.GetVirtualTextureCount(); ++i)
+	{
+		const VirtualTexture& virtualTexture = mTextureManager.GetVirtualTexture(i);
+		const VirtualTexture::Stats& stats = virtualTexture.GetStats();
+
+		ImGui::Text
+		(
+			"Virtual texture %zu: %zu / %u pages resident, %zu requested, %zu missing, %zu uploaded, %zu evicted \n"
+			, i
+			, stats.residentPages
+			, virtualTexture.GetSettings().slotsX * virtualTexture.GetSettings().slotsY
+			, stats.requestedPages
+			, stats.missingPages
+			, stats.uploadCount
+			, stats.evictionCount
+		);
+	}
 
 	//ImGui::NewLine();
 
@@ -638,32 +555,20 @@ void AppBase::ShowPerfWindow()
 
 void AppBase::OnResize()
 {
-	static UINT prevWidth = 0;
-	static UINT prevHeight = 0;
-
-	if ((mWindowWidth == 0) || (mWindowHeight == 0) || ((mWindowWidth == prevWidth) && (mWindowHeight == prevHeight)))
+	if (!mDevice || (mWindowWidth == 0) || (mWindowHeight == 0) || ((mWindowWidth == mResizedWidth) && (mWindowHeight == mResizedHeight)))
 	{
-		// resize only if the new size is valid and different
+		// resize only if there's a device and the new size is valid and different
 		return;
 	}
 
-	prevWidth = mWindowWidth;
-	prevHeight = mWindowHeight;
+	mResizedWidth = mWindowWidth;
+	mResizedHeight = mWindowHeight;
 
 	// back buffer
 	{
 		mBackBufferRTV.Reset();
 
-		ThrowIfFailed(mSwapChain->ResizeBuffers(min(mSwapChainBufferCount, DXGI_MAX_SWAP_CHAIN_BUFFERS),
-												mWindowWidth,
-												mWindowHeight,
-												mSwapChainFormat,
-												mSwapChainFlags));
-
-		ComPtr<ID3D11Resource> pBackBuffer;
-		ThrowIfFailed(mSwapChain->GetBuffer(0,
-											__uuidof(ID3D11Resource),
-											reinterpret_cast<void**>(pBackBuffer.GetAddressOf())));
+		ComPtr<ID3D11Resource> pBackBuffer = mRenderDevice->ResizeBackBuffer(mWindowWidth, mWindowHeight);
 
 		NameResource(pBackBuffer.Get(), "BackBuffer");
 
@@ -862,164 +767,24 @@ void AppBase::OnResize()
 	mCamera.SetLens(0.25f * XM_PI, mWindowAspectRatio, 1.0f, 1000.0f);
 }
 
-#if IMGUI
-extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
-#endif // IMGUI
-
-LRESULT AppBase::MsgProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
+void AppBase::OnPause(const bool isPaused)
 {
-#if IMGUI
-	if (ImGui_ImplWin32_WndProcHandler(mWindow, msg, wParam, lParam))
-	{
-		return true;
-	}
-#endif // IMGUI
-
-	switch (msg)
-	{
-	// WM_ACTIVATE is sent when the window is activated or deactivated
-	// we pause the game when the window is deactivated and unpause it when it becomes active
-	case WM_ACTIVATE:
-	{
-		if (LOWORD(wParam) == WA_INACTIVE)
-		{
-			mIsAppPaused = true;
-			mTimer.Stop();
-		}
-		else
-		{
-			mIsAppPaused = false;
-			mTimer.Start();
-		}
-		return 0;
-	}
-	// WM_SIZE is sent when the user resizes the window
-	case WM_SIZE:
-	{
-		// new client area dimensions
-		mWindowWidth = LOWORD(lParam);
-		mWindowHeight = HIWORD(lParam);
+	mIsAppPaused = isPaused;
 
-		if (mDevice)
-		{
-			switch (wParam)
-			{
-
-			case SIZE_MINIMIZED:
-			{
-				mIsAppPaused = true;
-				mIsWindowMinimized = true;
-				mIsWindowMaximized = false;
-			}
-			case SIZE_MAXIMIZED:
-			{
-				mIsAppPaused = false;
-				mIsWindowMinimized = false;
-				mIsWindowMaximized = true;
-				OnResize();
-			}
-			case SIZE_RESTORED:
-			{
-				// restoring from minimized state?
-				if (mIsWindowMinimized)
-				{
-					mIsAppPaused = false;
-					mIsWindowMinimized = false;
-					OnResize();
-				}
-				// restoring from maximized state?
-				else if (mIsWindowMaximized)
-				{
-					mIsAppPaused = false;
-					mIsWindowMaximized = false;
-					OnResize();
-				}
-				else if (mIsWindowResizing)
-				{
-					// If user is dragging the resize bars, we do not resize
-					// the buffers here because as the user continuously
-					// drags the resize bars, a stream of WM_SIZE messages are
-					// sent to the window, and it would be pointless (and slow)
-					// to resize for each WM_SIZE message received from dragging
-					// the resize bars. So instead, we reset after the user is
-					// done resizing the window and releases the resize bars, which
-					// sends a WM_EXITSIZEMOVE message.
-				}
-				else // API call such as SetWindowPos or mSwapChain->SetFullscreenState.
-				{
-					OnResize();
-				}
-			}
-			}
-		}
-		return 0;
-	}
-	// WM_EXITSIZEMOVE is sent when the user grabs the resize bars
-	case WM_ENTERSIZEMOVE:
+	if (isPaused)
 	{
-		mIsAppPaused = true;
-		mIsWindowResizing = true;
 		mTimer.Stop();
-		return 0;
 	}
-	// WM_EXITSIZEMOVE is sent when the user releases the resize bars
-	case WM_EXITSIZEMOVE:
+	else
 	{
-		mIsAppPaused = false;
-		mIsWindowResizing = false;
 		mTimer.Start();
-		OnResize(); // we reset everything based on the new window dimensions
-		return 0;
-	}
-	// WM_DESTROY is sent when the window is being destroyed
-	case WM_DESTROY:
-	{
-		PostQuitMessage(0);
-		return 0;
-	}
-	// WM_MENUCHAR is sent when a menu is active and the user presses a key that does not correspond to any mnemonic or accelerator key
-	case WM_MENUCHAR:
-	{
-		// don't beep when we alt-enter
-		return MAKELRESULT(0, MNC_CLOSE);
-	}
-	// catch this message so to prevent the window from becoming too small
-	case WM_GETMINMAXINFO:
-	{
-		((MINMAXINFO *)lParam)->ptMinTrackSize.x = 200;
-		((MINMAXINFO *)lParam)->ptMinTrackSize.y = 200;
-		return 0;
-	}
-	case WM_LBUTTONDOWN:
-	case WM_MBUTTONDOWN:
-	case WM_RBUTTONDOWN:
-	{
-		OnMouseDown(wParam, GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam));
-		return 0;
-	}
-	case WM_LBUTTONUP:
-	case WM_MBUTTONUP:
-	case WM_RBUTTONUP:
-	{
-		OnMouseUp(wParam, GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam));
-		return 0;
-	}
-	case WM_MOUSEMOVE:
-	{
-		OnMouseMove(wParam, GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam));
-		return 0;
-	}
-	case WM_KEYUP:
-	{
-		if (wParam == VK_ESCAPE)
-		{
-			PostQuitMessage(0);
-		}
-		return 0;
-	}
 	}
+}
 
-	return DefWindowProc(hwnd, msg, wParam, lParam);
+void AppBase::OnWindowSize(const UINT width, const UINT height)
+{
+	mWindowWidth = width;
+	mWindowHeight = height;
 }
 
 void AppBase::OnMouseDown(WPARAM state, int x, int y)
@@ -1027,12 +792,12 @@ void AppBase::OnMouseDown(WPARAM state, int x, int y)
 	mLastMousePosition.x = x;
 	mLastMousePosition.y = y;
 
-	SetCapture(mWindow);
+	mPlatform->SetMouseCapture(true);
 }
 
 void AppBase::OnMouseUp(WPARAM state, int x, int y)
 {
-	ReleaseCapture();
+	mPlatform->SetMouseCapture(false);
 }
 
 void AppBase::OnMouseMove(WPARAM state, int x, int y)
@@ -1042,7 +807,8 @@ void AppBase::OnMouseMove(WPARAM state, int x, int y)
 		return x < a ? a : (x > b ? b : x);
 	};
 
-	if ((state & MK_LBUTTON) != 0)
+	// a camera path owns the camera while it plays
+	if (((state & MK_LBUTTON) != 0) && !mCameraPlayer.IsPlaying())
 	{
 		float dx = XMConvertToRadians(0.25f * static_cast<float>(x - mLastMousePosition.x));
 		float dy = XMConvertToRadians(0.25f * static_cast<float>(y - mLastMousePosition.y));
@@ -1057,28 +823,28 @@ void AppBase::OnMouseMove(WPARAM state, int x, int y)
 
 void AppBase::OnKeyboardEvent(const Timer& timer)
 {
-	const float dt = timer.GetDeltaTime();
+	const float dt = float(timer.GetDeltaTime());
 
 	float speed = 10;
 
-	if ((GetAsyncKeyState(VK_LSHIFT) & 0x8000))
+	if (mPlatform->IsKeyDown(VK_LSHIFT))
 	{
 		speed *= 2;
 	}
 
-	if ((GetAsyncKeyState('W') & 0x8000))
+	if (mPlatform->IsKeyDown('W'))
 	{
 		mCamera.Walk(+speed * dt);
 	}
-	if ((GetAsyncKeyState('S') & 0x8000))
+	if (mPlatform->IsKeyDown('S'))
 	{
 		mCamera.Walk(-speed * dt);
 	}
-	if ((GetAsyncKeyState('A') & 0x8000))
+	if (mPlatform->IsKeyDown('A'))
 	{
 		mCamera.Strafe(-speed * dt);
 	}
-	if ((GetAsyncKeyState('D') & 0x8000))
+	if (mPlatform->IsKeyDown('D'))
 	{
 		mCamera.Strafe(+speed * dt);
 	}
@@ -1086,33 +852,47 @@ void AppBase::OnKeyboardEvent(const Timer& timer)
 
 int AppBase::Run()
 {
-	MSG msg = {0};
-
 	mTimer.Reset();
 
-	while (msg.message != WM_QUIT)
+	while (mPlatform->PumpEvents())
 	{
-		if (PeekMessage(&msg, 0, 0, 0, PM_REMOVE))
+		const int64_t frameBeginTicks = Timer::GetSystemTicks();
+
+		// a benchmark frame is one step of the path however long it took
+		if (mIsCameraBenchmark)
 		{
-			TranslateMessage(&msg);
-			DispatchMessage(&msg);
+			mCameraBenchmarkTicks += mCameraBenchmarkStepTicks;
 		}
-		else
+
+		mTimer.Tick();
+
+		if (!mIsAppPaused)
 		{
-			mTimer.Tick();
+			mGPUProfiler.BeginFrame();
 
-			if (!mIsAppPaused)
 			{
-#if IMGUI
-				GPUProfilerBegin();
-#endif // IMGUI
+				CPUProfiler::Scope scope("update");
+
+				for (int i = 0; i < mTimer.GetFixedStepCount(); ++i)
+				{
+					FixedUpdate(mTimer);
+				}
+
+				StepCameraPath();
 
 				Update(mTimer);
+			}
+
+			{
+				CPUProfiler::Scope scope("draw");
 				Draw(mTimer);
+			}
 
 #if IMGUI
-				mUserDefinedAnnotation->BeginEvent(L"imgui");
-				GPUProfilerTimestamp(TimestampQueryType::ImGuiBegin);
+			if (mIsImGuiEnabled)
+			{
+				CPUProfiler::Scope cpuScope("imgui");
+				GPUProfiler::Scope scope(mGPUProfiler, "imgui");
 
 				ImGui_ImplDX11_NewFrame();
 				ImGui_ImplWin32_NewFrame();
@@ -1122,30 +902,198 @@ int AppBase::Run()
 
 				ImGui::Render();
 				ImGui_ImplDX11_RenderDrawData(ImGui::GetDrawData());
-
-				GPUProfilerTimestamp(TimestampQueryType::ImGuiEnd);
-				mUserDefinedAnnotation->EndEvent();
+			}
 #endif // IMGUI
 
-				ThrowIfFailed(mSwapChain->Present(0, 0));
+			{
+				CPUProfiler::Scope scope("present");
+				mRenderDevice->Present();
+			}
+
+			mGPUProfiler.EndFrame();
+			CPUProfiler::EndFrame();
+
+			// a benchmark's timer is simulated, its frames are timed on the system clock
+			const double frameMs = mIsCameraBenchmark ? double(Timer::GetSystemTicks() - frameBeginTicks) * 1000.0 / Timer::kTicksPerSecond
+													  : mTimer.GetDeltaTime() * 1000.0;
+
+			mTraceExporter.AddFrame(mGPUProfiler, frameMs);
+			RecordFrameStatistics(frameMs);
+
+			if (mIsCameraBenchmark)
+			{
+				RecordCameraBenchmarkFrame(frameMs);
+
+				if (!mCameraPlayer.IsPlaying())
+				{
+					break;
+				}
+			}
+		}
+		else
+		{
+			std::this_thread::sleep_for(std::chrono::milliseconds(100));
+		}
+	}
 
 #if IMGUI
-				GPUProfilerEnd();
+	if (mIsImGuiEnabled)
+	{
+		CleanupImGui();
+	}
 #endif // IMGUI
+
+	mGPUProfiler.Shutdown();
+
+	return mPlatform->GetExitCode();
+}
+
+void AppBase::RecordFrameStatistics(const double frameMs)
+{
+	mFrameStatistics.Record(mCPUFrameChannel, frameMs);
+
+	// the gpu trails by a few frames, each resolved frame is recorded once
+	if (mGPUProfiler.GetResolvedFrame() != mLastStatisticsGPUFrame)
+	{
+		mLastStatisticsGPUFrame = mGPUProfiler.GetResolvedFrame();
+
+		mFrameStatistics.Record(mGPUFrameChannel, mGPUProfiler.GetFrameMs());
+
+		for (const GPUProfiler::ScopeResult& result : mGPUProfiler.GetResults())
+		{
+			if (result.depth == 0)
+			{
+				mFrameStatistics.Record(mFrameStatistics.GetChannel("gpu " + mGPUProfiler.GetScopeName(result.scope) + " ms"), result.durationMs);
 			}
-			else
+		}
+	}
+
+	mFrameStatistics.Record(mFrameStatistics.GetChannel("cpu scopes"), double(CPUProfiler::GetFrameEvents().size()));
+
+	mFrameStatistics.EndFrame();
+}
+
+void AppBase::StartCameraRecording(const double interval)
+{
+	mCameraRecorder.Start(interval);
+}
+
+const CameraPath& AppBase::StopCameraRecording()
+{
+	mCameraRecorder.Stop();
+
+	return mCameraRecorder.GetPath();
+}
+
+void AppBase::PlayCameraPath(const CameraPath& path, const double stepSeconds, const bool isBenchmark)
+{
+	assert(!path.IsEmpty() && (stepSeconds > 0.0));
+
+	if (!mCameraPlayer.IsPlaying())
+	{
+		mAppFixedTimestep = mTimer.GetFixedTimestep();
+	}
+
+	mCameraPlayer.Start(path, stepSeconds);
+
+	mIsCameraBenchmark = isBenchmark;
+	mCameraBenchmarkFrames.clear();
+
+	if (isBenchmark)
+	{
+		// the frames see the same delta times on every run, lights and animations included
+		mCameraBenchmarkStepTicks = int64_t(stepSeconds * Timer::kTicksPerSecond + 0.5);
+		mCameraBenchmarkTicks = 0;
+		mCameraBenchmarkGPUFrame = mGPUProfiler.GetFrame();
+
+		mTimer = Timer([this]() { return mCameraBenchmarkTicks; });
+		mTimer.SetFixedTimestep(stepSeconds, 1);
+		mTimer.Reset();
+	}
+	else
+	{
+		mTimer.SetFixedTimestep(stepSeconds);
+	}
+}
+
+void AppBase::StepCameraPath()
+{
+	if (!mCameraPlayer.IsPlaying())
+	{
+		return;
+	}
+
+	for (int i = 0; i < mTimer.GetFixedStepCount(); ++i)
+	{
+		mCameraPlayer.Step();
+	}
+
+	if (mCameraPlayer.IsPlaying())
+	{
+		return;
+	}
+
+	// the frame that reached the end shows the last key, Update leaves the camera alone from now on
+	mCameraPlayer.Apply(mCamera, 0.0);
+
+	// a benchmark ends the run instead, its timer stays simulated
+	if (!mIsCameraBenchmark && (mTimer.GetFixedTimestep() != mAppFixedTimestep))
+	{
+		mTimer.SetFixedTimestep(mAppFixedTimestep);
+	}
+}
+
+void AppBase::RecordCameraBenchmarkFrame(const double cpuMs)
+{
+	CameraBenchmarkFrame frame;
+	frame.pathTime = mCameraPlayer.GetTime();
+	frame.cpuMs = cpuMs;
+
+	mCameraBenchmarkFrames.push_back(frame);
+
+	// the gpu trails by a few frames and can return several at once, each time goes to the frame it
+	// belongs to
+	for (const GPUProfiler::ResolvedFrame& resolved : mGPUProfiler.GetResolvedFrames())
+	{
+		if (resolved.frame > mCameraBenchmarkGPUFrame)
+		{
+			const std::size_t i = std::size_t(resolved.frame - mCameraBenchmarkGPUFrame - 1);
+
+			if (i < mCameraBenchmarkFrames.size())
 			{
-				Sleep(100);
+				mCameraBenchmarkFrames[i].gpuMs = resolved.frameMs;
 			}
 		}
 	}
+}
 
-#if IMGUI
-	CleanupImGui();
-	GPUProfilerShutdown();
-#endif // IMGUI
+bool AppBase::WriteCameraBenchmark(const std::string& path) const
+{
+	std::ofstream stream(path);
+
+	if (!stream)
+	{
+		return false;
+	}
 
-	return int(msg.wParam);
+	stream << "frame,\"path time\",\"cpu ms\",\"gpu ms\"\n";
+
+	for (std::size_t i = 0; i < mCameraBenchmarkFrames.size(); ++i)
+	{
+		const CameraBenchmarkFrame& frame = mCameraBenchmarkFrames[i];
+
+		stream << i << ',' << frame.pathTime << ',' << frame.cpuMs << ',';
+
+		// missing values are empty cells
+		if (frame.gpuMs >= 0.0)
+		{
+			stream << frame.gpuMs;
+		}
+
+		stream << '\n';
+	}
+
+	return bool(stream);
 }
 
 void AppBase::UpdateMainPassCB(const Timer& timer)
@@ -1167,16 +1115,33 @@ void AppBase::UpdateMainPassCB(const Timer& timer)
 	buffer.lights[1].strength = { 0.4f, 0.4f, 0.4f };;
 	buffer.lights[2].direction = mLighting.GetLightDirection(2);
 	buffer.lights[2].strength = { 0.2f, 0.2f, 0.2f };
-	
+
+	// the point lights follow the directional ones, as many as fit
+	const std::size_t pointLightCount = std::min<std::size_t>(mLighting.GetPointLightCount(), LIGHT_MAX_COUNT - 3);
+
+	for (std::size_t i = 0; i < pointLightCount; ++i)
+	{
+		buffer.lights[3 + i] = mLighting.GetPointLight(i);
+	}
+
 	mContext->UpdateSubresource(mMainPassCB.Get(), 0, nullptr, &buffer, 0, 0);
 }
 
 void AppBase::Update(const Timer& timer)
 {
-	OnKeyboardEvent(timer);
+	if (mCameraPlayer.IsPlaying())
+	{
+		mCameraPlayer.Apply(mCamera, timer.GetInterpolationAlpha());
+	}
+	else
+	{
+		OnKeyboardEvent(timer);
+	}
 
 	mCamera.UpdateViewMatrix();
 
+	mCameraRecorder.Record(timer.GetTotalTime(), mCamera);
+
 	if (mIsLightUpdateEnabled)
 	{
 		mLighting.UpdateLights(timer);
@@ -1186,4 +1151,22 @@ void AppBase::Update(const Timer& timer)
 
 	mMeshManager.UpdateBuffers();
 	mMaterialManager.UpdateBuffer();
+
+	// textures whose files were parsed during the last frame replace their placeholders
+	{
+		CPUProfiler::Scope scope("async texture loads");
+		mTextureManager.FlushAsyncLoads();
+	}
+
+	// the mip requests of this frame turn into stream ins and evictions
+	{
+		CPUProfiler::Scope scope("texture streaming");
+		mTextureManager.UpdateStreaming();
+	}
+
+	// the virtual texture feedback of this frame turns into tile copies
+	{
+		CPUProfiler::Scope scope("virtual textures");
+		mTextureManager.UpdateVirtualTextures();
+	}
 }
\ No newline at end of file
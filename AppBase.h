@@ -2,7 +2,6 @@
 
 // windows
 #include <wrl.h>
-#include <comdef.h>
 using Microsoft::WRL::ComPtr;
 
 // d3d
@@ -11,61 +10,103 @@ using Microsoft::WRL::ComPtr;
 using namespace DirectX;
 
 // std
+#include <memory>
 #include <string>
 #include <sstream>
+#include <vector>
 
 // 
 #include "Camera.h"
+#include "CameraPath.h"
+#include "CPUProfiler.h"
+#include "FrameStatistics.h"
+#include "GPUProfiler.h"
 #include "Lighting.h"
 #include "MaterialManager.h"
 #include "MeshManager.h"
 #include "ObjectManager.h"
+#include "Platform.h"
+#include "RenderDevice.h"
 #include "TextureManager.h"
+#include "TraceExporter.h"
 #include "Timer.h"
 #include "Utility.h"
 
-// imgui
-#define IMGUI _DEBUG || 1
-
-class AppBase
+class AppBase : public Platform::Listener
 {
 public:
 
+#ifdef _WIN32
+    // win32 window and the d3d11 hardware device
     AppBase(HINSTANCE instance);
+#endif // _WIN32
+
+    // PlatformHeadless and RenderDeviceNull run the same frames without a window or a gpu
+    AppBase(std::unique_ptr<Platform> platform, std::unique_ptr<RenderDevice> renderDevice);
+
     AppBase(const AppBase&) = delete;
     AppBase& operator=(const AppBase&) = delete;
     ~AppBase();
 
     static AppBase* GetApp();
-    LRESULT MsgProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
 
     virtual bool Init();
     int Run();
 
-    virtual void OnResize();
+    void OnResize() override;
     virtual void Update(const Timer& timer);
     virtual void Draw(const Timer& timer) = 0;
 
+    const FrameStatistics& GetFrameStatistics() const { return mFrameStatistics; }
+
+    // keys of mCamera from the next Update on, at most one every interval seconds
+    void StartCameraRecording(const double interval = 0.1);
+    const CameraPath& StopCameraRecording();
+
+    // drives mCamera along the path, one step of stepSeconds per fixed timestep of mTimer, and ignores
+    // the camera input until it ends. as a benchmark every frame takes exactly one step on a simulated
+    // clock, so each run renders the same frames whatever they took, their cpu and gpu times are kept
+    // for WriteCameraBenchmark and Run returns at the end of the path
+    void PlayCameraPath(const CameraPath& path, const double stepSeconds, const bool isBenchmark);
+
+    bool IsPlayingCameraPath() const { return mCameraPlayer.IsPlaying(); }
+
+    struct CameraBenchmarkFrame
+    {
+        double pathTime = 0.0;
+        double cpuMs = 0.0;  // Tick to Present
+        double gpuMs = -1.0; // < 0 when the profiler didn't resolve it, the last few frames never are
+    };
+
+    const std::vector<CameraBenchmarkFrame>& GetCameraBenchmarkFrames() const { return mCameraBenchmarkFrames; }
+
+    // a csv row per frame
+    bool WriteCameraBenchmark(const std::string& path) const;
+
 protected:
 
-    virtual void OnMouseDown(WPARAM state, int x, int y);
-    virtual void OnMouseUp(WPARAM state, int x, int y);
-    virtual void OnMouseMove(WPARAM state, int x, int y);
+    void OnPause(const bool isPaused) override;
+    void OnWindowSize(const UINT width, const UINT height) override;
+
+    void OnMouseDown(WPARAM state, int x, int y) override;
+    void OnMouseUp(WPARAM state, int x, int y) override;
+    void OnMouseMove(WPARAM state, int x, int y) override;
     virtual void OnKeyboardEvent(const Timer& timer);
 
+    // called GetFixedStepCount times per frame before Update once mTimer has a fixed timestep,
+    // Update and Draw blend the last two steps with GetInterpolationAlpha
+    virtual void FixedUpdate(const Timer& timer) {}
+
     virtual void UpdateMainPassCB(const Timer& timer);
 
+    std::unique_ptr<Platform> mPlatform;
+    std::unique_ptr<RenderDevice> mRenderDevice;
 
     ComPtr<ID3D11Device> mDevice;
     ComPtr<ID3D11DeviceContext> mContext;
 
     ComPtr<ID3DUserDefinedAnnotation> mUserDefinedAnnotation;
 
-    struct ScopeEvent
-    {
-
-    };
-
     ComPtr<ID3D11RenderTargetView> mBackBufferRTV;
     ComPtr<ID3D11DepthStencilView> mDepthStencilBufferDSV;
     ComPtr<ID3D11DepthStencilView> mDepthStencilBufferReadOnlyDSV;
@@ -144,66 +185,55 @@ protected:
 
     ComPtr<ID3D11SamplerState> mSamplerLinearWrap;
 
-#if IMGUI
-    enum class TimestampQueryType
-    {
-        BeginFrame,
+    // gpu timings of named scopes, GPUProfiler::Scope around the passes of Draw
+    GPUProfiler mGPUProfiler;
 
-        DepthGbufferPrepassBegin,
-        DepthGbufferPrepassEnd,
-
-        RayTracedShadowsBegin,
-        RayTracedShadowsEnd,
+private:
 
-        RayTracedReflectionsBegin,
-        RayTracedReflectionsEnd,
+    bool InitDirect3D();
+#if IMGUI
+    void InitImGui();
+    void CleanupImGui();
 
-        MainPassBegin,
-        MainPassEnd,
+    void ShowPerfWindow();
 
-        ImGuiBegin,
-        ImGuiEnd,
+    double mCPUScopeOverheadNs = 0.0;
+    bool mIsSpikeCaptureEnabled = false;
 
-        EndFrame,
+    // not when headless, the win32 backend needs a window
+    bool mIsImGuiEnabled = false;
+#endif // IMGUI
 
-        Count
-    };
+    // after the profilers, so it's destroyed first and its writer is done with their scope names
+    TraceExporter mTraceExporter;
 
-    void GPUProfilerTimestamp(const TimestampQueryType type);
-#endif // IMGUI
+    // frame times and the gpu passes over the last frames
+    FrameStatistics mFrameStatistics;
+    std::size_t mCPUFrameChannel = 0;
+    std::size_t mGPUFrameChannel = 0;
+    uint64_t mLastStatisticsGPUFrame = 0;
 
-private:
+    void RecordFrameStatistics(const double frameMs);
 
-    bool InitWindow();
-    bool InitDirect3D();
-#if IMGUI
-    void InitImGui();
-    void CleanupImGui();
+    // camera paths
+    CameraPathRecorder mCameraRecorder;
+    CameraPathPlayer mCameraPlayer;
 
-    //std::size_t mTimestampQueryCount = 3;
-    std::vector<ComPtr<ID3D11Query>> mQueries;
-    std::size_t mCurrQueryIndex = 0;
-    std::size_t mCurrGetDataIndex = -1;
+    // the app's own timestep, back once an interactive playback ends
+    double mAppFixedTimestep = 0.0;
 
-    bool GPUProfilerInit();
-    void GPUProfilerShutdown();
-    void GPUProfilerBegin();
-    void GPUProfilerEnd();
-    std::size_t GetTimestampQueryIndex(const TimestampQueryType type) const;
-    std::size_t GetTimestampGetDataIndex(const TimestampQueryType type) const;
+    bool mIsCameraBenchmark = false;
+    int64_t mCameraBenchmarkStepTicks = 0;
+    int64_t mCameraBenchmarkTicks = 0; // the clock of mTimer during a benchmark
+    uint64_t mCameraBenchmarkGPUFrame = 0; // the GPUProfiler frame before the first one of the benchmark
+    std::vector<CameraBenchmarkFrame> mCameraBenchmarkFrames;
 
-    void ShowPerfWindow();
-#endif // IMGUI
+    void StepCameraPath();
+    void RecordCameraBenchmarkFrame(const double cpuMs);
 
     static AppBase* mApp;
 
-    HINSTANCE mInstance = nullptr;
-    HWND mWindow = nullptr;
-
     bool mIsAppPaused = false;
-    bool mIsWindowMinimized = false;
-    bool mIsWindowMaximized = false;
-    bool mIsWindowResizing = false;
 
     Timer mTimer;
 
@@ -214,19 +244,9 @@ private:
     UINT mWindowHeight = 600;
     float mWindowAspectRatio = float(mWindowWidth) / float(mWindowHeight);
 
-    UINT mCurrGPUIndex;
-    std::wstring mCurrGPUName;
-    bool mIsCurrGPUNvidia;
-
-    UINT mSwapChainBufferCount = 2;
-    DXGI_FORMAT mSwapChainFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
-    UINT mSwapChainFlags = 0;
-
-
-    ComPtr<IDXGISwapChain> mSwapChain;
-
-
-
+    // size of the back buffer and the targets, OnResize skips sizes they already have
+    UINT mResizedWidth = 0;
+    UINT mResizedHeight = 0;
 
     // default states
     ComPtr<ID3D11RasterizerState> mRasterizerState;
@@ -0,0 +1,291 @@
+#include "AssetArchive.h"
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+//
+#include "Compression.h"
+
+namespace
+{
+	constexpr uint32_t kMagic = 0x43524141; // "AARC"
+	constexpr uint32_t kVersion = 1;
+	constexpr std::size_t kAlignment = 4096;
+
+	std::size_t AlignUp(const std::size_t value, const std::size_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+}
+
+void AssetArchive::Build(const std::vector<Input>& inputs,
+						 const std::string& destinationPath,
+						 const Settings& settings,
+						 Report* report)
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	struct Item
+	{
+		MappedFile file;
+		std::vector<uint8_t> compressed; // empty when the entry is stored
+		uint32_t crc = 0;
+	};
+
+	std::vector<Item> items(inputs.size());
+
+	// reading, checksumming and compressing don't depend on each other
+	ParallelFor(inputs.size(), [&](const std::size_t i)
+	{
+		Item& item = items[i];
+
+		if (!item.file.Open(inputs[i].path))
+		{
+			return;
+		}
+
+		const std::size_t size = item.file.GetSize();
+
+		item.crc = Crc32(item.file.GetData(), size);
+
+		if (!settings.compress || (size == 0))
+		{
+			return;
+		}
+
+		item.compressed.resize(GetLZCompressBound(size));
+
+		const std::size_t compressedSize = LZCompress(item.file.GetData(), size, item.compressed.data(), item.compressed.size());
+
+		if (compressedSize <= std::size_t(size * (1.0 - settings.minSavings)))
+		{
+			item.compressed.resize(compressedSize);
+		}
+		else
+		{
+			item.compressed.clear();
+			item.compressed.shrink_to_fit();
+		}
+	});
+
+	std::vector<Entry> entries(inputs.size());
+	std::string names;
+
+	for (std::size_t i = 0; i < inputs.size(); ++i)
+	{
+		assert(items[i].file.IsOpen());
+
+		Entry& entry = entries[i];
+		entry.nameHash = HashBytes(inputs[i].name.data(), inputs[i].name.size());
+		entry.size = items[i].file.GetSize();
+		entry.storedSize = items[i].compressed.empty() ? entry.size : items[i].compressed.size();
+		entry.crc = items[i].crc;
+		entry.flags = items[i].compressed.empty() ? 0 : kCompressed;
+		entry.nameOffset = uint32_t(names.size());
+		entry.nameSize = uint32_t(inputs[i].name.size());
+
+		names += inputs[i].name;
+	}
+
+	// the payloads keep the input order, only the table is sorted for the lookups
+	std::size_t offset = AlignUp(sizeof(Header) + entries.size() * sizeof(Entry) + names.size(), kAlignment);
+
+	for (Entry& entry : entries)
+	{
+		entry.offset = offset;
+		offset = AlignUp(offset + entry.storedSize, kAlignment);
+	}
+
+	std::vector<std::size_t> order(entries.size());
+
+	for (std::size_t i = 0; i < order.size(); ++i)
+	{
+		order[i] = i;
+	}
+
+	std::sort(order.begin(), order.end(), [&](const std::size_t a, const std::size_t b)
+	{
+		return entries[a].nameHash < entries[b].nameHash;
+	});
+
+	std::vector<Entry> toc(entries.size());
+
+	for (std::size_t i = 0; i < order.size(); ++i)
+	{
+		toc[i] = entries[order[i]];
+	}
+
+	Header header = {};
+	header.magic = kMagic;
+	header.version = kVersion;
+	header.entryCount = uint32_t(toc.size());
+	header.namesSize = uint32_t(names.size());
+	header.tocCrc = Crc32(names.data(), names.size(), Crc32(toc.data(), toc.size() * sizeof(Entry)));
+
+	std::ofstream stream(destinationPath, std::ios::binary);
+	assert(stream);
+
+	stream.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	stream.write(reinterpret_cast<const char*>(toc.data()), toc.size() * sizeof(Entry));
+	stream.write(names.data(), names.size());
+
+	const std::vector<char> padding(kAlignment, 0);
+	std::size_t written = sizeof(header) + toc.size() * sizeof(Entry) + names.size();
+
+	for (std::size_t i = 0; i < entries.size(); ++i)
+	{
+		stream.write(padding.data(), entries[i].offset - written);
+
+		const Item& item = items[i];
+
+		if (item.compressed.empty())
+		{
+			stream.write(reinterpret_cast<const char*>(item.file.GetData()), item.file.GetSize());
+		}
+		else
+		{
+			stream.write(reinterpret_cast<const char*>(item.compressed.data()), item.compressed.size());
+		}
+
+		written = entries[i].offset + entries[i].storedSize;
+	}
+
+	if (report)
+	{
+		*report = Report();
+		report->entryCount = entries.size();
+		report->archiveBytes = written;
+		report->buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		for (const Entry& entry : entries)
+		{
+			report->compressedCount += (entry.flags & kCompressed) ? 1 : 0;
+			report->originalBytes += entry.size;
+		}
+	}
+}
+
+bool AssetArchive::Open(const std::string& path)
+{
+	Close();
+
+	if (!mFile.Open(path))
+	{
+		return false;
+	}
+
+	const uint8_t* data = mFile.GetData();
+	const std::size_t size = mFile.GetSize();
+
+	Header header = {};
+
+	if (size >= sizeof(Header))
+	{
+		std::memcpy(&header, data, sizeof(Header));
+	}
+
+	const std::size_t tocSize = std::size_t(header.entryCount) * sizeof(Entry);
+
+	bool isValid = (header.magic == kMagic) &&
+				   (header.version == kVersion) &&
+				   (size >= sizeof(Header) + tocSize + header.namesSize);
+
+	// the mapping is page aligned, so the table right after the header is aligned for its fields
+	if (isValid)
+	{
+		mEntries = std::span<const Entry>(reinterpret_cast<const Entry*>(data + sizeof(Header)), header.entryCount);
+		mNames = reinterpret_cast<const char*>(data + sizeof(Header) + tocSize);
+
+		isValid = (Crc32(mNames, header.namesSize, Crc32(mEntries.data(), tocSize)) == header.tocCrc);
+	}
+
+	for (std::size_t i = 0; isValid && (i < mEntries.size()); ++i)
+	{
+		const Entry& entry = mEntries[i];
+
+		// written so a huge offset or size can't wrap the sum past the check; stored entries are read
+		// as they are, so their stored and original sizes are the same
+		isValid = (entry.offset % kAlignment == 0) &&
+				  (entry.offset <= size) &&
+				  (entry.storedSize <= size - entry.offset) &&
+				  ((entry.flags & kCompressed) || (entry.storedSize == entry.size)) &&
+				  (std::size_t(entry.nameOffset) + entry.nameSize <= header.namesSize);
+	}
+
+	if (!isValid)
+	{
+		Close();
+	}
+
+	return isValid;
+}
+
+std::span<const uint8_t> AssetArchive::GetEntry(const std::string& name, std::vector<uint8_t>& storage) const
+{
+	const Entry* pEntry = Find(name);
+
+	return pEntry ? ReadEntry(*pEntry, storage) : std::span<const uint8_t>();
+}
+
+bool AssetArchive::Verify() const
+{
+	std::vector<uint8_t> storage;
+
+	for (const Entry& entry : mEntries)
+	{
+		const std::span<const uint8_t> data = ReadEntry(entry, storage);
+
+		// compressed entries were checked while reading them
+		if ((data.size() != entry.size) || (!(entry.flags & kCompressed) && (Crc32(data.data(), data.size()) != entry.crc)))
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+const AssetArchive::Entry* AssetArchive::Find(const std::string& name) const
+{
+	const uint64_t hash = HashBytes(name.data(), name.size());
+
+	auto i = std::lower_bound(mEntries.begin(), mEntries.end(), hash, [](const Entry& entry, const uint64_t value)
+	{
+		return entry.nameHash < value;
+	});
+
+	// names sharing a hash sit next to each other
+	for (; (i != mEntries.end()) && (i->nameHash == hash); ++i)
+	{
+		if ((i->nameSize == name.size()) && (std::memcmp(mNames + i->nameOffset, name.data(), name.size()) == 0))
+		{
+			return &*i;
+		}
+	}
+
+	return nullptr;
+}
+
+std::span<const uint8_t> AssetArchive::ReadEntry(const Entry& entry, std::vector<uint8_t>& storage) const
+{
+	const uint8_t* data = mFile.GetData() + entry.offset;
+
+	if (!(entry.flags & kCompressed))
+	{
+		return std::span<const uint8_t>(data, entry.size);
+	}
+
+	storage.resize(entry.size);
+
+	if (!LZDecompress(data, entry.storedSize, storage.data(), storage.size()) ||
+		(Crc32(storage.data(), storage.size()) != entry.crc))
+	{
+		return std::span<const uint8_t>();
+	}
+
+	return std::span<const uint8_t>(storage.data(), storage.size());
+}
\ No newline at end of file
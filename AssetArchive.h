@@ -0,0 +1,117 @@
+#pragma once
+
+// std
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+//
+#include "Utility.h"
+
+// single file package of assets: a table of contents sorted by name hash, then the entries, each on a
+// 4 KiB boundary so stored entries go to the loaders straight from the mapping. entries that shrink
+// enough are LZ compressed, every entry carries the CRC32 of its original bytes
+class AssetArchive
+{
+public:
+
+	struct Settings
+	{
+		bool compress = true;
+		double minSavings = 0.125; // entries saving less stay stored, which keeps them mappable
+	};
+
+	// name is what the entry is looked up by, path where its bytes are read from
+	struct Input
+	{
+		std::string name;
+		std::string path;
+	};
+
+	struct Report
+	{
+		std::size_t entryCount = 0;
+		std::size_t compressedCount = 0;
+		std::size_t originalBytes = 0;
+		std::size_t archiveBytes = 0; // alignment padding and table of contents included
+		double buildSeconds = 0.0;
+
+		double GetRatio() const
+		{
+			return archiveBytes ? double(originalBytes) / double(archiveBytes) : 0.0;
+		}
+	};
+
+	static void Build(const std::vector<Input>& inputs,
+					  const std::string& destinationPath,
+					  const Settings& settings,
+					  Report* report = nullptr);
+
+	// checks the header, the CRC of the table of contents and that every entry lies aligned inside the
+	// file, the bytes of the entries are checked as they are read
+	bool Open(const std::string& path);
+
+	void Close()
+	{
+		mFile.Close();
+		mEntries = {};
+		mNames = nullptr;
+	}
+
+	bool IsOpen() const
+	{
+		return mFile.IsOpen();
+	}
+
+	std::size_t GetEntryCount() const
+	{
+		return mEntries.size();
+	}
+
+	bool Contains(const std::string& name) const
+	{
+		return Find(name) != nullptr;
+	}
+
+	// the original bytes of an entry: stored entries point into the mapping, compressed ones are
+	// decompressed into storage and checked against their CRC; empty if missing or corrupt
+	std::span<const uint8_t> GetEntry(const std::string& name, std::vector<uint8_t>& storage) const;
+
+	// check every entry against its CRC, which reads the whole archive
+	bool Verify() const;
+
+private:
+
+	struct Header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint32_t entryCount;
+		uint32_t namesSize;
+		uint32_t tocCrc; // of the entries and the names
+		uint32_t reserved;
+	};
+
+	struct Entry
+	{
+		uint64_t nameHash;
+		uint64_t offset;
+		uint64_t storedSize;
+		uint64_t size;
+		uint32_t crc;
+		uint32_t flags;
+		uint32_t nameOffset;
+		uint32_t nameSize;
+	};
+
+	static constexpr uint32_t kCompressed = 1;
+
+	const Entry* Find(const std::string& name) const;
+
+	std::span<const uint8_t> ReadEntry(const Entry& entry, std::vector<uint8_t>& storage) const;
+
+	MappedFile mFile;
+	std::span<const Entry> mEntries;
+	const char* mNames = nullptr;
+};
\ No newline at end of file
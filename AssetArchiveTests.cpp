@@ -0,0 +1,159 @@
+#include "UnitTest.h"
+
+// std
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "AssetArchive.h"
+#include "Compression.h"
+
+// archives built from small files, read back, and their table of contents tampered with to check that
+// Open turns it away
+
+namespace
+{
+	// the on-disk layout of AssetArchive, a 24 byte header then 48 byte entries
+	constexpr std::size_t kHeaderSize = 24;
+	constexpr std::size_t kTocCrcOffset = 16;
+	constexpr std::size_t kEntrySize = 48;
+	constexpr std::size_t kOffsetOffset = 8;
+	constexpr std::size_t kStoredSizeOffset = 16;
+	constexpr std::size_t kFlagsOffset = 36;
+
+	std::vector<uint8_t> ReadFile(const std::string& path)
+	{
+		std::ifstream stream(path, std::ios::binary);
+		return std::vector<uint8_t>(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	}
+
+	void WriteFile(const std::string& path, const std::vector<uint8_t>& data)
+	{
+		std::ofstream stream(path, std::ios::binary);
+		stream.write(reinterpret_cast<const char*>(data.data()), data.size());
+	}
+
+	// a compressible and an incompressible file in an archive, returned as bytes
+	std::vector<uint8_t> BuildArchive()
+	{
+		std::vector<uint8_t> text;
+		std::vector<uint8_t> noise;
+		uint32_t random = 1;
+
+		for (std::size_t i = 0; i < 10000; ++i)
+		{
+			text.push_back(uint8_t("stored or compressed "[i % 21]));
+
+			random = random * 1664525u + 1013904223u;
+			noise.push_back(uint8_t(random >> 24));
+		}
+
+		WriteFile("archive_text.bin", text);
+		WriteFile("archive_noise.bin", noise);
+
+		AssetArchive::Build({ { "text", "archive_text.bin" }, { "noise", "archive_noise.bin" } }, "archive.bin", {});
+
+		std::remove("archive_text.bin");
+		std::remove("archive_noise.bin");
+
+		std::vector<uint8_t> archive = ReadFile("archive.bin");
+		std::remove("archive.bin");
+
+		return archive;
+	}
+
+	// patch a field of the first entry that has or lacks the compressed flag, fix up the CRC of the table
+	// of contents so only the field is wrong, and try to open the result
+	bool OpenPatched(std::vector<uint8_t> archive, const bool isCompressed, const std::function<void(uint8_t* entry)>& patch)
+	{
+		uint32_t entryCount = 0;
+		uint32_t namesSize = 0;
+		std::memcpy(&entryCount, &archive[8], sizeof(entryCount));
+		std::memcpy(&namesSize, &archive[12], sizeof(namesSize));
+
+		for (uint32_t i = 0; i < entryCount; ++i)
+		{
+			uint8_t* entry = &archive[kHeaderSize + i * kEntrySize];
+
+			uint32_t flags = 0;
+			std::memcpy(&flags, entry + kFlagsOffset, sizeof(flags));
+
+			if (((flags & 1) != 0) == isCompressed)
+			{
+				patch(entry);
+				break;
+			}
+		}
+
+		const std::size_t tocSize = std::size_t(entryCount) * kEntrySize;
+		const uint32_t tocCrc = Crc32(&archive[kHeaderSize + tocSize], namesSize, Crc32(&archive[kHeaderSize], tocSize));
+		std::memcpy(&archive[kTocCrcOffset], &tocCrc, sizeof(tocCrc));
+
+		WriteFile("archive_patched.bin", archive);
+
+		AssetArchive reader;
+		const bool isOpen = reader.Open("archive_patched.bin");
+		reader.Close();
+
+		std::remove("archive_patched.bin");
+
+		return isOpen;
+	}
+
+	void SetField(uint8_t* entry, const std::size_t offset, const uint64_t value)
+	{
+		std::memcpy(entry + offset, &value, sizeof(value));
+	}
+
+	uint64_t GetField(const uint8_t* entry, const std::size_t offset)
+	{
+		uint64_t value = 0;
+		std::memcpy(&value, entry + offset, sizeof(value));
+		return value;
+	}
+}
+
+UNIT_TEST(AssetArchiveRoundTrip)
+{
+	WriteFile("archive.bin", BuildArchive());
+
+	AssetArchive archive;
+	CHECK(archive.Open("archive.bin"));
+	CHECK(archive.GetEntryCount() == 2);
+	CHECK(archive.Verify());
+
+	std::vector<uint8_t> storage;
+	const std::span<const uint8_t> text = archive.GetEntry("text", storage);
+
+	CHECK((text.size() == 10000) && (std::memcmp(text.data(), "stored or compressed ", 21) == 0));
+	CHECK(archive.GetEntry("noise", storage).size() == 10000);
+	CHECK(archive.GetEntry("missing", storage).empty());
+
+	archive.Close();
+	std::remove("archive.bin");
+}
+
+UNIT_TEST(AssetArchiveRejectsBadEntries)
+{
+	const std::vector<uint8_t> archive = BuildArchive();
+
+	// the patching alone keeps it valid
+	CHECK(OpenPatched(archive, false, [](uint8_t*) {}));
+	CHECK(OpenPatched(archive, true, [](uint8_t*) {}));
+
+	// a stored entry whose stored size isn't its size would be handed out short or past its bytes
+	CHECK(!OpenPatched(archive, false, [](uint8_t* entry) { SetField(entry, kStoredSizeOffset, GetField(entry, kStoredSizeOffset) - 1); }));
+
+	// offsets off the 4 KiB grid
+	CHECK(!OpenPatched(archive, false, [](uint8_t* entry) { SetField(entry, kOffsetOffset, GetField(entry, kOffsetOffset) + 16); }));
+	CHECK(!OpenPatched(archive, true, [](uint8_t* entry) { SetField(entry, kOffsetOffset, GetField(entry, kOffsetOffset) + 1); }));
+
+	// an offset and a size whose sum wraps around to something small
+	CHECK(!OpenPatched(archive, true, [](uint8_t* entry) { SetField(entry, kStoredSizeOffset, ~uint64_t(0) - GetField(entry, kOffsetOffset) + 2); }));
+	CHECK(!OpenPatched(archive, true, [](uint8_t* entry) { SetField(entry, kOffsetOffset, ~uint64_t(0) - 4095); }));
+}
\ No newline at end of file
@@ -0,0 +1,1106 @@
+#include "BlockCompressor.h"
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+// d3d
+#include <directxmath.h>
+#include "BlockDecoder.h"
+#include "DDSTextureLoader11.h"
+using namespace DirectX;
+
+//
+#include "Utility.h"
+
+namespace
+{
+	// endpoints of the segment along the principal axis of the texels that covers all of them, in 0-1
+	// space; mask selects the channels that take part and texels with a zero weight are ignored
+	void FitLine(const XMVECTOR texels[16], const float weights[16], const XMVECTOR mask, XMVECTOR& e0, XMVECTOR& e1)
+	{
+		XMVECTOR mean = XMVectorZero();
+		float total = 0.0f;
+
+		for (int i = 0; i < 16; ++i)
+		{
+			mean = XMVectorMultiplyAdd(XMVectorReplicate(weights[i]), texels[i], mean);
+			total += weights[i];
+		}
+
+		if (total == 0.0f)
+		{
+			e0 = XMVectorZero();
+			e1 = XMVectorZero();
+			return;
+		}
+
+		mean = XMVectorScale(mean, 1.0f / total);
+
+		// covariance, one row per channel
+		XMVECTOR rows[4] = { XMVectorZero(), XMVectorZero(), XMVectorZero(), XMVectorZero() };
+
+		for (int i = 0; i < 16; ++i)
+		{
+			const XMVECTOR d = XMVectorMultiply(XMVectorSubtract(texels[i], mean), mask);
+			const XMVECTOR dw = XMVectorScale(d, weights[i]);
+
+			rows[0] = XMVectorMultiplyAdd(dw, XMVectorSplatX(d), rows[0]);
+			rows[1] = XMVectorMultiplyAdd(dw, XMVectorSplatY(d), rows[1]);
+			rows[2] = XMVectorMultiplyAdd(dw, XMVectorSplatZ(d), rows[2]);
+			rows[3] = XMVectorMultiplyAdd(dw, XMVectorSplatW(d), rows[3]);
+		}
+
+		// power iteration from the row of the channel that varies the most
+		const float variances[4] = { XMVectorGetX(rows[0]), XMVectorGetY(rows[1]), XMVectorGetZ(rows[2]), XMVectorGetW(rows[3]) };
+		XMVECTOR axis = rows[std::max_element(variances, variances + 4) - variances];
+
+		for (int iteration = 0; iteration < 8; ++iteration)
+		{
+			const XMVECTOR next = XMVectorMultiplyAdd(rows[0], XMVectorSplatX(axis),
+								  XMVectorMultiplyAdd(rows[1], XMVectorSplatY(axis),
+								  XMVectorMultiplyAdd(rows[2], XMVectorSplatZ(axis),
+								  XMVectorMultiply(rows[3], XMVectorSplatW(axis)))));
+
+			if (XMVectorGetX(XMVector4LengthSq(next)) < 1e-12f)
+			{
+				break;
+			}
+
+			axis = XMVector4Normalize(next);
+		}
+
+		if (XMVectorGetX(XMVector4LengthSq(axis)) < 1e-12f)
+		{
+			// flat block
+			e0 = mean;
+			e1 = mean;
+			return;
+		}
+
+		float low = std::numeric_limits<float>::max();
+		float high = -std::numeric_limits<float>::max();
+
+		for (int i = 0; i < 16; ++i)
+		{
+			if (weights[i] > 0.0f)
+			{
+				const float t = XMVectorGetX(XMVector4Dot(XMVectorMultiply(XMVectorSubtract(texels[i], mean), mask), axis));
+				low = std::min(low, t);
+				high = std::max(high, t);
+			}
+		}
+
+		e0 = XMVectorSaturate(XMVectorMultiplyAdd(axis, XMVectorReplicate(low), mean));
+		e1 = XMVectorSaturate(XMVectorMultiplyAdd(axis, XMVectorReplicate(high), mean));
+	}
+
+	// least squares endpoints for texels that sit at the given fractions between e0 and e1,
+	// left untouched when the fractions don't constrain both endpoints
+	void RefineLine(const XMVECTOR texels[16], const float weights[16], const float fractions[16], XMVECTOR& e0, XMVECTOR& e1)
+	{
+		float aa = 0.0f;
+		float bb = 0.0f;
+		float ab = 0.0f;
+		XMVECTOR ax = XMVectorZero();
+		XMVECTOR bx = XMVectorZero();
+
+		for (int i = 0; i < 16; ++i)
+		{
+			const float a = (1.0f - fractions[i]) * weights[i];
+			const float b = fractions[i] * weights[i];
+
+			aa += a * (1.0f - fractions[i]);
+			bb += b * fractions[i];
+			ab += a * fractions[i];
+			ax = XMVectorMultiplyAdd(XMVectorReplicate(a), texels[i], ax);
+			bx = XMVectorMultiplyAdd(XMVectorReplicate(b), texels[i], bx);
+		}
+
+		const float determinant = aa * bb - ab * ab;
+
+		if (std::abs(determinant) < 1e-6f)
+		{
+			return;
+		}
+
+		const float scale = 1.0f / determinant;
+
+		e0 = XMVectorSaturate(XMVectorScale(XMVectorSubtract(XMVectorScale(ax, bb), XMVectorScale(bx, ab)), scale));
+		e1 = XMVectorSaturate(XMVectorScale(XMVectorSubtract(XMVectorScale(bx, aa), XMVectorScale(ax, ab)), scale));
+	}
+
+	void LoadTexels(const uint8_t rgba[64], XMVECTOR texels[16])
+	{
+		for (int i = 0; i < 16; ++i)
+		{
+			texels[i] = XMVectorScale(XMVectorSet(rgba[4 * i + 0], rgba[4 * i + 1], rgba[4 * i + 2], rgba[4 * i + 3]), 1.0f / 255.0f);
+		}
+	}
+
+	uint32_t Square(const int x)
+	{
+		return uint32_t(x * x);
+	}
+
+	// bc1
+
+	uint16_t To565(const XMVECTOR color)
+	{
+		XMFLOAT4 c;
+		XMStoreFloat4(&c, XMVectorSaturate(color));
+
+		return uint16_t((uint32_t(c.x * 31.0f + 0.5f) << 11) | (uint32_t(c.y * 63.0f + 0.5f) << 5) | uint32_t(c.z * 31.0f + 0.5f));
+	}
+
+	// the palette exactly as BlockDecoder builds it
+	void GetBC1Palette(const uint16_t c0, const uint16_t c1, const bool isFourColor, int palette[4][3])
+	{
+		const uint16_t colors[2] = { c0, c1 };
+
+		for (int e = 0; e < 2; ++e)
+		{
+			const int r = (colors[e] >> 11) & 31;
+			const int g = (colors[e] >> 5) & 63;
+			const int b = colors[e] & 31;
+
+			palette[e][0] = (r << 3) | (r >> 2);
+			palette[e][1] = (g << 2) | (g >> 4);
+			palette[e][2] = (b << 3) | (b >> 2);
+		}
+
+		for (int c = 0; c < 3; ++c)
+		{
+			if (isFourColor)
+			{
+				palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+				palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+			}
+			else
+			{
+				palette[2][c] = (palette[0][c] + palette[1][c] + 1) / 2;
+				palette[3][c] = 0;
+			}
+		}
+	}
+
+	// color half of bc1 and bc3, bc3 decodes it with four colors whatever the endpoint order
+	void EncodeColor(const uint8_t rgba[64], uint8_t* block, const bool allowTransparent)
+	{
+		XMVECTOR texels[16];
+		LoadTexels(rgba, texels);
+
+		float weights[16];
+		bool isTransparent[16];
+		bool hasTransparent = false;
+
+		for (int i = 0; i < 16; ++i)
+		{
+			isTransparent[i] = allowTransparent && (rgba[4 * i + 3] < 128);
+			weights[i] = isTransparent[i] ? 0.0f : 1.0f;
+			hasTransparent |= isTransparent[i];
+		}
+
+		XMVECTOR e0;
+		XMVECTOR e1;
+		FitLine(texels, weights, XMVectorSet(1.0f, 1.0f, 1.0f, 0.0f), e0, e1);
+
+		uint32_t bestError = std::numeric_limits<uint32_t>::max();
+
+		// the range fit, then a least squares refit on the indices it picked
+		for (int pass = 0; pass < 2; ++pass)
+		{
+			uint16_t c0 = To565(e0);
+			uint16_t c1 = To565(e1);
+
+			// the endpoint order selects the mode, three colors are needed for transparent texels
+			if (hasTransparent ? (c0 > c1) : (c0 < c1))
+			{
+				std::swap(c0, c1);
+				std::swap(e0, e1);
+			}
+
+			const bool isFourColor = c0 > c1;
+
+			int palette[4][3];
+			GetBC1Palette(c0, c1, isFourColor, palette);
+
+			uint32_t indices = 0;
+			uint32_t error = 0;
+			float fractions[16];
+
+			for (int i = 0; i < 16; ++i)
+			{
+				uint32_t index = 3;
+				uint32_t texelError = 0;
+
+				if (!isTransparent[i])
+				{
+					texelError = std::numeric_limits<uint32_t>::max();
+
+					for (uint32_t p = 0; p < (isFourColor ? 4u : 3u); ++p)
+					{
+						const uint32_t e = Square(palette[p][0] - rgba[4 * i + 0]) +
+										   Square(palette[p][1] - rgba[4 * i + 1]) +
+										   Square(palette[p][2] - rgba[4 * i + 2]);
+
+						if (e < texelError)
+						{
+							texelError = e;
+							index = p;
+						}
+					}
+				}
+
+				static const float kFractions4[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+				static const float kFractions3[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+
+				fractions[i] = isFourColor ? kFractions4[index] : kFractions3[index];
+				indices |= index << (2 * i);
+				error += texelError;
+			}
+
+			if (error < bestError)
+			{
+				bestError = error;
+
+				block[0] = uint8_t(c0);
+				block[1] = uint8_t(c0 >> 8);
+				block[2] = uint8_t(c1);
+				block[3] = uint8_t(c1 >> 8);
+				block[4] = uint8_t(indices);
+				block[5] = uint8_t(indices >> 8);
+				block[6] = uint8_t(indices >> 16);
+				block[7] = uint8_t(indices >> 24);
+			}
+
+			if ((error == 0) || (c0 == c1))
+			{
+				break;
+			}
+
+			RefineLine(texels, weights, fractions, e0, e1);
+		}
+	}
+
+	// bc4
+
+	void GetBC4Palette(const uint32_t a0, const uint32_t a1, uint32_t palette[8])
+	{
+		palette[0] = a0;
+		palette[1] = a1;
+
+		if (a0 > a1)
+		{
+			for (uint32_t i = 1; i < 7; ++i)
+			{
+				palette[i + 1] = ((7 - i) * a0 + i * a1 + 3) / 7;
+			}
+		}
+		else
+		{
+			for (uint32_t i = 1; i < 5; ++i)
+			{
+				palette[i + 1] = ((5 - i) * a0 + i * a1 + 2) / 5;
+			}
+
+			palette[6] = 0;
+			palette[7] = 255;
+		}
+	}
+
+	// bc7
+
+	uint32_t Expand(const uint32_t value, const uint32_t bits)
+	{
+		return (bits >= 8) ? value : ((value << (8 - bits)) | (value >> (2 * bits - 8)));
+	}
+
+	uint32_t Interpolate(const uint32_t e0, const uint32_t e1, const uint32_t weight)
+	{
+		return ((64 - weight) * e0 + weight * e1 + 32) >> 6;
+	}
+
+	// value with bits bits, plus the p bit when p >= 0, whose expansion is the closest to target (0-255)
+	uint32_t Quantize(const float target, const uint32_t bits, const int p)
+	{
+		const uint32_t totalBits = bits + ((p >= 0) ? 1 : 0);
+		const int maxValue = (1 << bits) - 1;
+
+		const float guess = (p >= 0) ? (target / 255.0f * float((1 << totalBits) - 1) - float(p)) * 0.5f
+									 : target / 255.0f * float(maxValue);
+
+		uint32_t best = 0;
+		float bestError = std::numeric_limits<float>::max();
+
+		for (int q = int(guess + 0.5f) - 1; q <= int(guess + 0.5f) + 1; ++q)
+		{
+			if ((q < 0) || (q > maxValue))
+			{
+				continue;
+			}
+
+			const uint32_t value = (p >= 0) ? ((uint32_t(q) << 1) | uint32_t(p)) : uint32_t(q);
+			const float error = std::abs(float(Expand(value, totalBits)) - target);
+
+			if (error < bestError)
+			{
+				bestError = error;
+				best = uint32_t(q);
+			}
+		}
+
+		return best;
+	}
+
+	struct BitWriter
+	{
+		uint8_t* data;
+		uint32_t position = 0;
+
+		void Write(const uint32_t value, const uint32_t count)
+		{
+			for (uint32_t i = 0; i < count; ++i, ++position)
+			{
+				data[position >> 3] |= uint8_t(((value >> i) & 1) << (position & 7));
+			}
+		}
+	};
+
+	// a block in one of the single subset modes, 4, 5 or 6
+	struct BC7Block
+	{
+		uint32_t mode = 6;
+		uint32_t rotation = 0;
+		uint32_t indexSelection = 0;
+		uint32_t endpoints[2][4] = {}; // quantized, without the p bits
+		uint32_t pBits[2] = {};
+		uint32_t indices[16] = {};          // as stored: the 2 bit set of modes 4 and 5, the 4 bit set of mode 6
+		uint32_t secondaryIndices[16] = {}; // the 3 bit set of mode 4, alpha of mode 5
+	};
+
+	struct BC7ModeBits
+	{
+		uint32_t color;
+		uint32_t alpha;
+		uint32_t indices;
+		uint32_t secondaryIndices;
+	};
+
+	BC7ModeBits GetModeBits(const uint32_t mode)
+	{
+		switch (mode)
+		{
+			case 4:
+				return { 5, 6, 2, 3 };
+			case 5:
+				return { 7, 8, 2, 2 };
+			default:
+				return { 7, 7, 4, 0 };
+		}
+	}
+
+	void WriteBC7(const BC7Block& bc7, uint8_t* block)
+	{
+		std::memset(block, 0, 16);
+
+		const BC7ModeBits bits = GetModeBits(bc7.mode);
+
+		BitWriter writer = { block };
+		writer.Write(1u << bc7.mode, bc7.mode + 1);
+
+		if (bc7.mode != 6)
+		{
+			writer.Write(bc7.rotation, 2);
+		}
+
+		if (bc7.mode == 4)
+		{
+			writer.Write(bc7.indexSelection, 1);
+		}
+
+		for (uint32_t c = 0; c < 3; ++c)
+		{
+			writer.Write(bc7.endpoints[0][c], bits.color);
+			writer.Write(bc7.endpoints[1][c], bits.color);
+		}
+
+		writer.Write(bc7.endpoints[0][3], bits.alpha);
+		writer.Write(bc7.endpoints[1][3], bits.alpha);
+
+		if (bc7.mode == 6)
+		{
+			writer.Write(bc7.pBits[0], 1);
+			writer.Write(bc7.pBits[1], 1);
+		}
+
+		// the anchor index drops its top bit
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			writer.Write(bc7.indices[i], bits.indices - ((i == 0) ? 1 : 0));
+		}
+
+		if (bits.secondaryIndices > 0)
+		{
+			for (uint32_t i = 0; i < 16; ++i)
+			{
+				writer.Write(bc7.secondaryIndices[i], bits.secondaryIndices - ((i == 0) ? 1 : 0));
+			}
+		}
+	}
+
+	// pick the closest palette entry over channels [first, last) for every texel, then flip the
+	// endpoints of those channels if the anchor index has its top bit set
+	void SelectIndices(const uint8_t rgba[64],
+					   uint32_t expanded[2][4],
+					   const uint32_t first,
+					   const uint32_t last,
+					   const uint32_t indexBits,
+					   uint32_t indices[16],
+					   bool& isSwapped)
+	{
+		const uint8_t* weights = BlockDecoder::GetBC7Weights(indexBits);
+		const uint32_t count = 1u << indexBits;
+
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			uint32_t bestError = std::numeric_limits<uint32_t>::max();
+
+			for (uint32_t index = 0; index < count; ++index)
+			{
+				uint32_t error = 0;
+
+				for (uint32_t c = first; c < last; ++c)
+				{
+					error += Square(int(Interpolate(expanded[0][c], expanded[1][c], weights[index])) - rgba[4 * i + c]);
+				}
+
+				if (error < bestError)
+				{
+					bestError = error;
+					indices[i] = index;
+				}
+			}
+		}
+
+		isSwapped = (indices[0] >> (indexBits - 1)) != 0;
+
+		if (isSwapped)
+		{
+			for (uint32_t c = first; c < last; ++c)
+			{
+				std::swap(expanded[0][c], expanded[1][c]);
+			}
+
+			for (uint32_t i = 0; i < 16; ++i)
+			{
+				indices[i] = count - 1 - indices[i];
+			}
+		}
+	}
+
+	// quantize e0 and e1 (0-1, rotation already applied to rgba) for a single subset mode and pick the
+	// indices; fractions receives where each texel sits between the stored color endpoints, for a refit,
+	// and isColorSwapped tells whether those are e1 and e0 because of the anchor index
+	void BuildBC7(const uint8_t rgba[64],
+				  const uint32_t mode,
+				  const uint32_t rotation,
+				  const uint32_t indexSelection,
+				  const XMVECTOR e0,
+				  const XMVECTOR e1,
+				  BC7Block& bc7,
+				  float fractions[16],
+				  bool& isColorSwapped)
+	{
+		const BC7ModeBits bits = GetModeBits(mode);
+
+		bc7.mode = mode;
+		bc7.rotation = rotation;
+		bc7.indexSelection = indexSelection;
+
+		XMFLOAT4 targets[2];
+		XMStoreFloat4(&targets[0], XMVectorScale(e0, 255.0f));
+		XMStoreFloat4(&targets[1], XMVectorScale(e1, 255.0f));
+
+		uint32_t expanded[2][4];
+
+		for (uint32_t e = 0; e < 2; ++e)
+		{
+			const float target[4] = { targets[e].x, targets[e].y, targets[e].z, targets[e].w };
+
+			if (mode == 6)
+			{
+				// both p bits are tried, the one that lands closer wins
+				float bestError = std::numeric_limits<float>::max();
+
+				for (int p = 0; p < 2; ++p)
+				{
+					uint32_t values[4];
+					float error = 0.0f;
+
+					for (uint32_t c = 0; c < 4; ++c)
+					{
+						values[c] = Quantize(target[c], bits.color, p);
+						error += std::abs(float(Expand((values[c] << 1) | uint32_t(p), bits.color + 1)) - target[c]);
+					}
+
+					if (error < bestError)
+					{
+						bestError = error;
+						bc7.pBits[e] = uint32_t(p);
+
+						for (uint32_t c = 0; c < 4; ++c)
+						{
+							bc7.endpoints[e][c] = values[c];
+							expanded[e][c] = Expand((values[c] << 1) | uint32_t(p), bits.color + 1);
+						}
+					}
+				}
+			}
+			else
+			{
+				for (uint32_t c = 0; c < 4; ++c)
+				{
+					const uint32_t channelBits = (c < 3) ? bits.color : bits.alpha;
+
+					bc7.endpoints[e][c] = Quantize(target[c], channelBits, -1);
+					expanded[e][c] = Expand(bc7.endpoints[e][c], channelBits);
+				}
+			}
+		}
+
+		const uint8_t* colorWeights = nullptr;
+
+		if (mode == 6)
+		{
+			SelectIndices(rgba, expanded, 0, 4, bits.indices, bc7.indices, isColorSwapped);
+
+			if (isColorSwapped)
+			{
+				std::swap(bc7.endpoints[0], bc7.endpoints[1]);
+				std::swap(bc7.pBits[0], bc7.pBits[1]);
+			}
+
+			colorWeights = BlockDecoder::GetBC7Weights(bits.indices);
+
+			for (uint32_t i = 0; i < 16; ++i)
+			{
+				fractions[i] = colorWeights[bc7.indices[i]] / 64.0f;
+			}
+
+			return;
+		}
+
+		// color and alpha get index sets of their own, mode 4 can give either one the 3 bit set
+		const uint32_t colorIndexBits = indexSelection ? bits.secondaryIndices : bits.indices;
+		const uint32_t alphaIndexBits = indexSelection ? bits.indices : bits.secondaryIndices;
+
+		uint32_t* colorIndices = indexSelection ? bc7.secondaryIndices : bc7.indices;
+		uint32_t* alphaIndices = indexSelection ? bc7.indices : bc7.secondaryIndices;
+
+		bool isAlphaSwapped = false;
+		SelectIndices(rgba, expanded, 0, 3, colorIndexBits, colorIndices, isColorSwapped);
+		SelectIndices(rgba, expanded, 3, 4, alphaIndexBits, alphaIndices, isAlphaSwapped);
+
+		if (isColorSwapped)
+		{
+			for (uint32_t c = 0; c < 3; ++c)
+			{
+				std::swap(bc7.endpoints[0][c], bc7.endpoints[1][c]);
+			}
+		}
+
+		if (isAlphaSwapped)
+		{
+			std::swap(bc7.endpoints[0][3], bc7.endpoints[1][3]);
+		}
+
+		colorWeights = BlockDecoder::GetBC7Weights(colorIndexBits);
+
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			fractions[i] = colorWeights[colorIndices[i]] / 64.0f;
+		}
+	}
+
+	uint32_t GetBlockError(const uint8_t a[64], const uint8_t b[64])
+	{
+		uint32_t error = 0;
+
+		for (int i = 0; i < 64; ++i)
+		{
+			error += Square(int(a[i]) - int(b[i]));
+		}
+
+		return error;
+	}
+}
+
+bool BlockCompressor::IsSupportedFormat(const DXGI_FORMAT format)
+{
+	switch (format)
+	{
+		case DXGI_FORMAT_BC1_UNORM:
+		case DXGI_FORMAT_BC1_UNORM_SRGB:
+		case DXGI_FORMAT_BC3_UNORM:
+		case DXGI_FORMAT_BC3_UNORM_SRGB:
+		case DXGI_FORMAT_BC4_UNORM:
+		case DXGI_FORMAT_BC5_UNORM:
+		case DXGI_FORMAT_BC7_UNORM:
+		case DXGI_FORMAT_BC7_UNORM_SRGB:
+			return true;
+		default:
+			return false;
+	}
+}
+
+void BlockCompressor::EncodeBlock(const DXGI_FORMAT format, const uint8_t rgba[64], uint8_t* block, const Quality quality)
+{
+	switch (format)
+	{
+		case DXGI_FORMAT_BC1_UNORM:
+		case DXGI_FORMAT_BC1_UNORM_SRGB:
+			EncodeBC1(rgba, block, true);
+			break;
+		case DXGI_FORMAT_BC3_UNORM:
+		case DXGI_FORMAT_BC3_UNORM_SRGB:
+			EncodeBC3(rgba, block);
+			break;
+		case DXGI_FORMAT_BC4_UNORM:
+			EncodeBC4(rgba, block);
+			break;
+		case DXGI_FORMAT_BC5_UNORM:
+			EncodeBC5(rgba, block);
+			break;
+		case DXGI_FORMAT_BC7_UNORM:
+		case DXGI_FORMAT_BC7_UNORM_SRGB:
+			EncodeBC7(rgba, block, quality);
+			break;
+		default:
+			assert(false);
+			break;
+	}
+}
+
+void BlockCompressor::EncodeBC1(const uint8_t rgba[64], uint8_t* block, const bool allowTransparent)
+{
+	EncodeColor(rgba, block, allowTransparent);
+}
+
+void BlockCompressor::EncodeBC3(const uint8_t rgba[64], uint8_t* block)
+{
+	EncodeBC4(rgba + 3, block);
+	EncodeColor(rgba, block + 8, false);
+}
+
+void BlockCompressor::EncodeBC4(const uint8_t* channel, uint8_t* block)
+{
+	uint32_t low = 255;
+	uint32_t high = 0;
+
+	// the six value mode has 0 and 255 for free, its endpoints only need to cover the rest
+	uint32_t innerLow = 255;
+	uint32_t innerHigh = 0;
+
+	for (int i = 0; i < 16; ++i)
+	{
+		const uint32_t value = channel[4 * i];
+
+		low = std::min(low, value);
+		high = std::max(high, value);
+
+		if ((value != 0) && (value != 255))
+		{
+			innerLow = std::min(innerLow, value);
+			innerHigh = std::max(innerHigh, value);
+		}
+	}
+
+	if (innerLow > innerHigh)
+	{
+		innerLow = innerHigh = 0;
+	}
+
+	// a0 > a1 interpolates eight values, a0 <= a1 six plus 0 and 255
+	const uint32_t candidates[2][2] = { { high, low }, { innerLow, innerHigh } };
+
+	uint32_t bestError = std::numeric_limits<uint32_t>::max();
+
+	for (const auto& candidate : candidates)
+	{
+		uint32_t palette[8];
+		GetBC4Palette(candidate[0], candidate[1], palette);
+
+		uint64_t indices = 0;
+		uint32_t error = 0;
+
+		for (int i = 0; i < 16; ++i)
+		{
+			uint32_t bestIndex = 0;
+			uint32_t texelError = std::numeric_limits<uint32_t>::max();
+
+			for (uint32_t p = 0; p < 8; ++p)
+			{
+				const uint32_t e = Square(int(palette[p]) - int(channel[4 * i]));
+
+				if (e < texelError)
+				{
+					texelError = e;
+					bestIndex = p;
+				}
+			}
+
+			indices |= uint64_t(bestIndex) << (3 * i);
+			error += texelError;
+		}
+
+		if (error < bestError)
+		{
+			bestError = error;
+
+			block[0] = uint8_t(candidate[0]);
+			block[1] = uint8_t(candidate[1]);
+
+			for (int i = 0; i < 6; ++i)
+			{
+				block[2 + i] = uint8_t(indices >> (8 * i));
+			}
+		}
+	}
+}
+
+void BlockCompressor::EncodeBC5(const uint8_t rgba[64], uint8_t* block)
+{
+	EncodeBC4(rgba + 0, block);
+	EncodeBC4(rgba + 1, block + 8);
+}
+
+void BlockCompressor::EncodeBC7(const uint8_t rgba[64], uint8_t* block, const Quality quality)
+{
+	bool isOpaque = true;
+
+	for (int i = 0; i < 16; ++i)
+	{
+		isOpaque &= (rgba[4 * i + 3] == 255);
+	}
+
+	struct Trial
+	{
+		uint32_t mode;
+		uint32_t rotation;
+		uint32_t indexSelection;
+	};
+
+	std::vector<Trial> trials = { { 6, 0, 0 } };
+
+	if (quality != Quality::Fast)
+	{
+		// rotating alpha with another channel only pays off when alpha isn't constant
+		for (uint32_t rotation = 0; rotation < (isOpaque ? 1u : 4u); ++rotation)
+		{
+			trials.push_back({ 5, rotation, 0 });
+		}
+	}
+
+	if (quality == Quality::Slow)
+	{
+		for (uint32_t rotation = 0; rotation < 4; ++rotation)
+		{
+			trials.push_back({ 4, rotation, 0 });
+			trials.push_back({ 4, rotation, 1 });
+		}
+	}
+
+	const float weights[16] = { 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1, 1 };
+
+	uint32_t bestError = std::numeric_limits<uint32_t>::max();
+
+	for (const Trial& trial : trials)
+	{
+		uint8_t rotated[64];
+		std::memcpy(rotated, rgba, 64);
+
+		if (trial.rotation > 0)
+		{
+			for (int i = 0; i < 16; ++i)
+			{
+				std::swap(rotated[4 * i + trial.rotation - 1], rotated[4 * i + 3]);
+			}
+		}
+
+		XMVECTOR texels[16];
+		LoadTexels(rotated, texels);
+
+		XMVECTOR e0;
+		XMVECTOR e1;
+
+		if (trial.mode == 6)
+		{
+			FitLine(texels, weights, XMVectorSet(1.0f, 1.0f, 1.0f, 1.0f), e0, e1);
+		}
+		else
+		{
+			// alpha is fitted on its own, it has its own endpoints and indices
+			FitLine(texels, weights, XMVectorSet(1.0f, 1.0f, 1.0f, 0.0f), e0, e1);
+
+			float low = 1.0f;
+			float high = 0.0f;
+
+			for (int i = 0; i < 16; ++i)
+			{
+				low = std::min(low, XMVectorGetW(texels[i]));
+				high = std::max(high, XMVectorGetW(texels[i]));
+			}
+
+			e0 = XMVectorSetW(e0, low);
+			e1 = XMVectorSetW(e1, high);
+		}
+
+		for (int pass = 0; pass < ((quality == Quality::Slow) ? 2 : 1); ++pass)
+		{
+			BC7Block bc7;
+			float fractions[16];
+			bool isSwapped = false;
+			BuildBC7(rotated, trial.mode, trial.rotation, trial.indexSelection, e0, e1, bc7, fractions, isSwapped);
+
+			uint8_t candidate[16];
+			WriteBC7(bc7, candidate);
+
+			// judged on what the decoder gives back, rotation included
+			uint8_t decoded[64];
+			BlockDecoder::DecodeBC7(candidate, decoded);
+
+			const uint32_t error = GetBlockError(decoded, rgba);
+
+			if (error < bestError)
+			{
+				bestError = error;
+				std::memcpy(block, candidate, 16);
+			}
+
+			if (error == 0)
+			{
+				return;
+			}
+
+			// refit the color endpoints on the chosen indices, which are relative to the stored order
+			XMVECTOR r0 = isSwapped ? e1 : e0;
+			XMVECTOR r1 = isSwapped ? e0 : e1;
+			RefineLine(texels, weights, fractions, r0, r1);
+
+			if (trial.mode != 6)
+			{
+				// alpha keeps its own range
+				r0 = XMVectorSetW(r0, XMVectorGetW(isSwapped ? e1 : e0));
+				r1 = XMVectorSetW(r1, XMVectorGetW(isSwapped ? e0 : e1));
+			}
+
+			e0 = isSwapped ? r1 : r0;
+			e1 = isSwapped ? r0 : r1;
+		}
+	}
+}
+
+std::vector<uint8_t> BlockCompressor::Compress(const uint8_t* ddsData,
+												const std::size_t ddsDataSize,
+												const Settings& settings,
+												Report* report)
+{
+	DDSTextureInfo info;
+	const uint8_t* bitData = nullptr;
+	std::size_t bitSize = 0;
+
+	ThrowIfFailed(GetDDSTextureInfoFromMemory(ddsData, ddsDataSize, &info, &bitData, &bitSize));
+
+	assert(info.resourceDimension == D3D11_RESOURCE_DIMENSION_TEXTURE2D);
+	assert(info.isCubeMap == 0);
+	assert(IsSupportedFormat(settings.format));
+
+	// d3d11 wants the top level of block compressed textures to be made of whole blocks
+	assert((info.width % 4 == 0) && (info.height % 4 == 0));
+
+	const bool isBGRA = (info.format == DXGI_FORMAT_B8G8R8A8_UNORM) || (info.format == DXGI_FORMAT_B8G8R8A8_UNORM_SRGB);
+	const bool isSRGB = (info.format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB) || (info.format == DXGI_FORMAT_B8G8R8A8_UNORM_SRGB);
+
+	assert(isBGRA || isSRGB || (info.format == DXGI_FORMAT_R8G8B8A8_UNORM));
+
+	DXGI_FORMAT format = settings.format;
+
+	if (isSRGB)
+	{
+		switch (format)
+		{
+			case DXGI_FORMAT_BC1_UNORM: format = DXGI_FORMAT_BC1_UNORM_SRGB; break;
+			case DXGI_FORMAT_BC3_UNORM: format = DXGI_FORMAT_BC3_UNORM_SRGB; break;
+			case DXGI_FORMAT_BC7_UNORM: format = DXGI_FORMAT_BC7_UNORM_SRGB; break;
+			default: break;
+		}
+	}
+
+	const std::size_t blockSize = BlockDecoder::GetBlockSize(format);
+
+	std::vector<D3D11_SUBRESOURCE_DATA> srcData(std::size_t(info.mipCount) * info.arraySize);
+	ThrowIfFailed(GetDDSSubresourceData(info, bitData, bitSize, srcData.data()));
+
+	std::vector<std::vector<uint8_t>> levels(srcData.size());
+	std::vector<D3D11_SUBRESOURCE_DATA> dstData(srcData.size());
+
+	// 4x4 texels of a subresource as rgba, the edges are replicated into partial blocks
+	auto GatherBlock = [&](const std::size_t i, const uint32_t bx, const uint32_t by, uint8_t rgba[64])
+	{
+		const uint32_t width = std::max(1u, info.width >> (i % info.mipCount));
+		const uint32_t height = std::max(1u, info.height >> (i % info.mipCount));
+
+		for (uint32_t y = 0; y < 4; ++y)
+		{
+			const uint32_t sy = std::min(by * 4 + y, height - 1);
+			const uint8_t* row = static_cast<const uint8_t*>(srcData[i].pSysMem) + std::size_t(sy) * srcData[i].SysMemPitch;
+
+			for (uint32_t x = 0; x < 4; ++x)
+			{
+				const uint8_t* texel = row + std::size_t(std::min(bx * 4 + x, width - 1)) * 4;
+				uint8_t* dst = &rgba[4 * (4 * y + x)];
+
+				dst[0] = texel[isBGRA ? 2 : 0];
+				dst[1] = texel[1];
+				dst[2] = texel[isBGRA ? 0 : 2];
+				dst[3] = texel[3];
+			}
+		}
+	};
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for (std::size_t i = 0; i < srcData.size(); ++i)
+	{
+		const uint32_t width = std::max(1u, info.width >> (i % info.mipCount));
+		const uint32_t height = std::max(1u, info.height >> (i % info.mipCount));
+		const uint32_t blocksX = (width + 3) / 4;
+		const uint32_t blocksY = (height + 3) / 4;
+
+		levels[i].resize(std::size_t(blocksX) * blocksY * blockSize);
+
+		ParallelFor(blocksY, [&](const std::size_t by)
+		{
+			for (uint32_t bx = 0; bx < blocksX; ++bx)
+			{
+				uint8_t rgba[64];
+				GatherBlock(i, bx, uint32_t(by), rgba);
+
+				EncodeBlock(format, rgba, &levels[i][(by * blocksX + bx) * blockSize], settings.quality);
+			}
+		});
+
+		dstData[i].pSysMem = levels[i].data();
+		dstData[i].SysMemPitch = UINT(blocksX * blockSize);
+		dstData[i].SysMemSlicePitch = UINT(levels[i].size());
+	}
+
+	const double encodeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	if (report)
+	{
+		*report = Report();
+		report->encodeSeconds = encodeSeconds;
+
+		// channels the format stores, alpha of bc1 is only a test
+		const uint32_t channelCount = ((format == DXGI_FORMAT_BC4_UNORM) ? 1 :
+									   (format == DXGI_FORMAT_BC5_UNORM) ? 2 :
+									   ((format == DXGI_FORMAT_BC1_UNORM) || (format == DXGI_FORMAT_BC1_UNORM_SRGB)) ? 3 : 4);
+
+		double error = 0.0;
+
+		for (std::size_t i = 0; i < srcData.size(); ++i)
+		{
+			const uint32_t width = std::max(1u, info.width >> (i % info.mipCount));
+			const uint32_t height = std::max(1u, info.height >> (i % info.mipCount));
+			const uint32_t blocksX = (width + 3) / 4;
+			const uint32_t blocksY = (height + 3) / 4;
+
+			report->texelCount += std::size_t(width) * height;
+			report->sourceBytes += std::size_t(width) * height * 4;
+			report->compressedBytes += levels[i].size();
+
+			if (!settings.verify)
+			{
+				continue;
+			}
+
+			std::vector<uint64_t> rowErrors(blocksY, 0);
+
+			ParallelFor(blocksY, [&](const std::size_t by)
+			{
+				for (uint32_t bx = 0; bx < blocksX; ++bx)
+				{
+					uint8_t rgba[64];
+					uint8_t decoded[64];
+					GatherBlock(i, bx, uint32_t(by), rgba);
+					BlockDecoder::DecodeBlock(format, &levels[i][(by * blocksX + bx) * blockSize], decoded);
+
+					// replicated edge texels are not part of the image
+					for (uint32_t y = 0; y < std::min(4u, height - uint32_t(by) * 4); ++y)
+					{
+						for (uint32_t x = 0; x < std::min(4u, width - bx * 4); ++x)
+						{
+							const uint8_t* texel = &rgba[4 * (4 * y + x)];
+
+							// bc1 stores texels failing the alpha test as black
+							const bool isCutOut = (channelCount == 3) && (texel[3] < 128);
+
+							for (uint32_t c = 0; c < channelCount; ++c)
+							{
+								rowErrors[by] += Square(int(decoded[4 * (4 * y + x) + c]) - (isCutOut ? 0 : int(texel[c])));
+							}
+						}
+					}
+				}
+			});
+
+			for (const uint64_t rowError : rowErrors)
+			{
+				error += double(rowError);
+			}
+		}
+
+		if (settings.verify && (error > 0.0))
+		{
+			const double mse = error / (double(report->texelCount) * channelCount);
+			report->psnr = 10.0 * std::log10(255.0 * 255.0 / mse);
+		}
+	}
+
+	DDSTextureInfo dstInfo = info;
+	dstInfo.format = format;
+
+	std::size_t size = 0;
+	ThrowIfFailed(SaveDDSTextureToMemory(dstInfo, dstData.data(), nullptr, 0, &size));
+
+	std::vector<uint8_t> result(size);
+	ThrowIfFailed(SaveDDSTextureToMemory(dstInfo, dstData.data(), result.data(), result.size(), &size));
+
+	return result;
+}
+
+void BlockCompressor::Compress(const std::string& sourcePath,
+							   const std::string& destinationPath,
+							   const Settings& settings,
+							   Report* report)
+{
+	std::vector<uint8_t> result;
+
+	{
+		MappedFile source(sourcePath);
+		assert(source.IsOpen());
+
+		result = Compress(source.GetData(), source.GetSize(), settings, report);
+	}
+
+	std::ofstream stream(destinationPath, std::ios::binary);
+	assert(stream);
+
+	stream.write(reinterpret_cast<const char*>(result.data()), result.size());
+}
\ No newline at end of file
@@ -0,0 +1,74 @@
+#pragma once
+
+// std
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+// d3d
+#include <d3d11.h>
+
+// import time block compression of rgba8 DDS files; bc1, bc3, bc4 and bc5 fit their endpoints along the
+// principal axis of the block, bc7 searches its single subset modes, how many depends on the quality.
+// blocks are spread across threads by rows and every result can be checked against BlockDecoder
+class BlockCompressor
+{
+public:
+
+	enum class Quality
+	{
+		Fast,   // bc7 mode 6 only
+		Normal, // adds mode 5, rotating alpha with the other channels for blocks that aren't opaque
+		Slow,   // adds mode 4 and a least squares refinement of the endpoints
+	};
+
+	struct Settings
+	{
+		DXGI_FORMAT format = DXGI_FORMAT_BC7_UNORM; // the srgb variant is picked when the source is srgb
+		Quality quality = Quality::Normal;
+		bool verify = true;
+	};
+
+	struct Report
+	{
+		std::size_t texelCount = 0;
+		std::size_t sourceBytes = 0;
+		std::size_t compressedBytes = 0;
+		double encodeSeconds = 0.0;
+
+		// decoded against the source over the channels the format keeps, infinite for an exact match
+		double psnr = std::numeric_limits<double>::infinity();
+
+		double GetMegapixelsPerSecond() const
+		{
+			return (encodeSeconds > 0.0) ? (texelCount / 1000000.0) / encodeSeconds : 0.0;
+		}
+	};
+
+	static bool IsSupportedFormat(const DXGI_FORMAT format);
+
+	// rgba8 texels of a 4x4 block, row major
+	static void EncodeBlock(const DXGI_FORMAT format, const uint8_t rgba[64], uint8_t* block, const Quality quality);
+
+	// texels with alpha below 128 become transparent when allowTransparent is set
+	static void EncodeBC1(const uint8_t rgba[64], uint8_t* block, const bool allowTransparent);
+	static void EncodeBC3(const uint8_t rgba[64], uint8_t* block);
+
+	// a single channel, read every 4 bytes starting at channel
+	static void EncodeBC4(const uint8_t* channel, uint8_t* block);
+
+	static void EncodeBC5(const uint8_t rgba[64], uint8_t* block);
+	static void EncodeBC7(const uint8_t rgba[64], uint8_t* block, const Quality quality);
+
+	// every mip and item of a 2D rgba8 DDS (array)
+	static std::vector<uint8_t> Compress(const uint8_t* ddsData,
+										 const std::size_t ddsDataSize,
+										 const Settings& settings,
+										 Report* report = nullptr);
+
+	static void Compress(const std::string& sourcePath,
+						 const std::string& destinationPath,
+						 const Settings& settings,
+						 Report* report = nullptr);
+};
\ No newline at end of file
@@ -0,0 +1,238 @@
+#include "UnitTest.h"
+
+// std
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+// d3d
+#include "DDSTextureLoader11.h"
+using namespace DirectX;
+
+#include "BlockCompressor.h"
+#include "BlockDecoder.h"
+#include "Utility.h"
+
+// round trips of synthetic images through the encoder, measured with BlockDecoder, which
+// BlockDecoderTests holds to reference texels, so the psnr doesn't only check the encoder against itself
+
+namespace
+{
+	const uint32_t kImageSize = 64;
+
+	enum class Image
+	{
+		Gradient, // smooth ramps, opaque
+		Noise,    // every channel random, opaque
+		Alpha,    // a color ramp under a radial alpha ramp with a cut out hole
+	};
+
+	std::vector<uint8_t> CreateImage(const Image image)
+	{
+		std::vector<uint8_t> rgba(kImageSize * kImageSize * 4);
+		uint32_t random = 0x2545f491;
+
+		for (uint32_t y = 0; y < kImageSize; ++y)
+		{
+			for (uint32_t x = 0; x < kImageSize; ++x)
+			{
+				uint8_t* texel = &rgba[(y * kImageSize + x) * 4];
+
+				if (image == Image::Noise)
+				{
+					for (int c = 0; c < 4; ++c)
+					{
+						random = random * 1664525u + 1013904223u;
+						texel[c] = uint8_t(random >> 24);
+					}
+
+					texel[3] = 255;
+					continue;
+				}
+
+				texel[0] = uint8_t(x * 255 / (kImageSize - 1));
+				texel[1] = uint8_t(y * 255 / (kImageSize - 1));
+				texel[2] = uint8_t((x + y) * 255 / (2 * (kImageSize - 1)));
+				texel[3] = 255;
+
+				if (image == Image::Alpha)
+				{
+					const float dx = float(x) - kImageSize / 2.0f;
+					const float dy = float(y) - kImageSize / 2.0f;
+					const float distance = std::sqrt(dx * dx + dy * dy) / (kImageSize / 2.0f);
+					texel[3] = (distance < 0.25f) ? 0 : uint8_t(std::fmin(distance, 1.0f) * 255.0f);
+				}
+			}
+		}
+
+		return rgba;
+	}
+
+	// encodes and decodes every block of the image, the psnr over the first channelCount channels. bc1
+	// keeps one bit of alpha, so it is measured against the source with alpha cut at 128 and the
+	// transparent texels black
+	double RoundTrip(const DXGI_FORMAT format, const BlockCompressor::Quality quality, const Image image, const int channelCount)
+	{
+		const std::vector<uint8_t> rgba = CreateImage(image);
+		std::vector<uint8_t> expected = rgba;
+
+		if (format == DXGI_FORMAT_BC1_UNORM)
+		{
+			for (std::size_t i = 0; i < expected.size(); i += 4)
+			{
+				if (expected[i + 3] < 128)
+					expected[i] = expected[i + 1] = expected[i + 2] = expected[i + 3] = 0;
+				else
+					expected[i + 3] = 255;
+			}
+		}
+		double error = 0.0;
+
+		for (uint32_t by = 0; by < kImageSize; by += 4)
+		{
+			for (uint32_t bx = 0; bx < kImageSize; bx += 4)
+			{
+				uint8_t source[64];
+				uint8_t reference[64];
+
+				for (uint32_t row = 0; row < 4; ++row)
+				{
+					std::memcpy(&source[row * 16], &rgba[((by + row) * kImageSize + bx) * 4], 16);
+					std::memcpy(&reference[row * 16], &expected[((by + row) * kImageSize + bx) * 4], 16);
+				}
+
+				uint8_t block[16];
+				BlockCompressor::EncodeBlock(format, source, block, quality);
+
+				uint8_t decoded[64];
+				BlockDecoder::DecodeBlock(format, block, decoded);
+
+				for (int i = 0; i < 16; ++i)
+				{
+					for (int c = 0; c < channelCount; ++c)
+					{
+						const double difference = double(decoded[4 * i + c]) - double(reference[4 * i + c]);
+						error += difference * difference;
+					}
+				}
+			}
+		}
+
+		if (error == 0.0)
+			return std::numeric_limits<double>::infinity();
+
+		const double mse = error / (double(kImageSize) * kImageSize * channelCount);
+		return 10.0 * std::log10(255.0 * 255.0 / mse);
+	}
+
+	struct Minimum
+	{
+		DXGI_FORMAT format;
+		int channelCount;
+		BlockCompressor::Quality quality;
+		double psnr[3]; // gradient, noise, alpha
+	};
+
+	// about a decibel under what the encoder reaches today. only bc7 looks at the quality, the others
+	// must not get worse with it
+	const Minimum kMinimums[] =
+	{
+		{ DXGI_FORMAT_BC1_UNORM, 4, BlockCompressor::Quality::Fast,   { 39.0, 14.0, 39.5 } },
+		{ DXGI_FORMAT_BC1_UNORM, 4, BlockCompressor::Quality::Normal, { 39.0, 14.0, 39.5 } },
+		{ DXGI_FORMAT_BC1_UNORM, 4, BlockCompressor::Quality::Slow,   { 39.0, 14.0, 39.5 } },
+		{ DXGI_FORMAT_BC3_UNORM, 4, BlockCompressor::Quality::Fast,   { 39.0, 14.0, 38.5 } },
+		{ DXGI_FORMAT_BC3_UNORM, 4, BlockCompressor::Quality::Normal, { 39.0, 14.0, 38.5 } },
+		{ DXGI_FORMAT_BC3_UNORM, 4, BlockCompressor::Quality::Slow,   { 39.0, 14.0, 38.5 } },
+		{ DXGI_FORMAT_BC4_UNORM, 1, BlockCompressor::Quality::Fast,   { 50.5, 28.0, 50.5 } },
+		{ DXGI_FORMAT_BC4_UNORM, 1, BlockCompressor::Quality::Normal, { 50.5, 28.0, 50.5 } },
+		{ DXGI_FORMAT_BC4_UNORM, 1, BlockCompressor::Quality::Slow,   { 50.5, 28.0, 50.5 } },
+		{ DXGI_FORMAT_BC5_UNORM, 2, BlockCompressor::Quality::Fast,   { 50.5, 28.0, 50.5 } },
+		{ DXGI_FORMAT_BC5_UNORM, 2, BlockCompressor::Quality::Normal, { 50.5, 28.0, 50.5 } },
+		{ DXGI_FORMAT_BC5_UNORM, 2, BlockCompressor::Quality::Slow,   { 50.5, 28.0, 50.5 } },
+		{ DXGI_FORMAT_BC7_UNORM, 4, BlockCompressor::Quality::Fast,   { 40.0, 14.5, 39.0 } },
+		{ DXGI_FORMAT_BC7_UNORM, 4, BlockCompressor::Quality::Normal, { 40.0, 14.5, 40.5 } },
+		{ DXGI_FORMAT_BC7_UNORM, 4, BlockCompressor::Quality::Slow,   { 44.0, 18.0, 41.5 } },
+	};
+
+	void CheckMinimums(const DXGI_FORMAT format)
+	{
+		double previous[3] = {};
+
+		for (const Minimum& minimum : kMinimums)
+		{
+			if (minimum.format != format)
+				continue;
+
+			for (int image = 0; image < 3; ++image)
+			{
+				const double psnr = RoundTrip(format, minimum.quality, Image(image), minimum.channelCount);
+				CHECK(psnr >= minimum.psnr[image]);
+				CHECK(psnr >= previous[image]);
+				previous[image] = psnr;
+			}
+		}
+	}
+}
+
+UNIT_TEST(BlockCompressorBC1)
+{
+	CheckMinimums(DXGI_FORMAT_BC1_UNORM);
+}
+
+UNIT_TEST(BlockCompressorBC3)
+{
+	CheckMinimums(DXGI_FORMAT_BC3_UNORM);
+}
+
+UNIT_TEST(BlockCompressorBC4)
+{
+	CheckMinimums(DXGI_FORMAT_BC4_UNORM);
+}
+
+UNIT_TEST(BlockCompressorBC5)
+{
+	CheckMinimums(DXGI_FORMAT_BC5_UNORM);
+}
+
+UNIT_TEST(BlockCompressorBC7)
+{
+	CheckMinimums(DXGI_FORMAT_BC7_UNORM);
+}
+
+UNIT_TEST(BlockCompressorReportedPSNR)
+{
+	const std::vector<uint8_t> rgba = CreateImage(Image::Alpha);
+
+	DDSTextureInfo info;
+	info.width = kImageSize;
+	info.height = kImageSize;
+	info.depth = 1;
+	info.mipCount = 1;
+	info.arraySize = 1;
+	info.format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	info.resourceDimension = D3D11_RESOURCE_DIMENSION_TEXTURE2D;
+	info.isCubeMap = 0;
+
+	D3D11_SUBRESOURCE_DATA subresource = {};
+	subresource.pSysMem = rgba.data();
+	subresource.SysMemPitch = kImageSize * 4;
+	subresource.SysMemSlicePitch = UINT(rgba.size());
+
+	std::size_t ddsSize = 0;
+	ThrowIfFailed(SaveDDSTextureToMemory(info, &subresource, nullptr, 0, &ddsSize));
+
+	std::vector<uint8_t> dds(ddsSize);
+	ThrowIfFailed(SaveDDSTextureToMemory(info, &subresource, dds.data(), dds.size(), &ddsSize));
+
+	BlockCompressor::Settings settings;
+	settings.format = DXGI_FORMAT_BC7_UNORM;
+	settings.quality = BlockCompressor::Quality::Normal;
+
+	BlockCompressor::Report report;
+	BlockCompressor::Compress(dds.data(), dds.size(), settings, &report);
+
+	CHECK(report.texelCount == kImageSize * kImageSize);
+	CHECK_NEAR(report.psnr, RoundTrip(settings.format, settings.quality, Image::Alpha, 4), 0.01);
+}
\ No newline at end of file
@@ -0,0 +1,933 @@
+#include "BlockDecoder.h"
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+
+// d3d
+#include <directxpackedvector.h>
+#include "DDSTextureLoader11.h"
+using namespace DirectX;
+using namespace DirectX::PackedVector;
+
+//
+#include "Utility.h"
+
+namespace
+{
+	// bc7 partitions from the format specification, one bit per texel for two subsets
+	// and two bits per texel for three, texel 0 in the lowest bits
+	constexpr uint16_t kPartitions2[64] =
+	{
+		0xcccc, 0x8888, 0xeeee, 0xecc8, 0xc880, 0xfeec, 0xfec8, 0xec80,
+		0xc800, 0xffec, 0xfe80, 0xe800, 0xffe8, 0xff00, 0xfff0, 0xf000,
+		0xf710, 0x008e, 0x7100, 0x08ce, 0x008c, 0x7310, 0x3100, 0x8cce,
+		0x088c, 0x3110, 0x6666, 0x366c, 0x17e8, 0x0ff0, 0x718e, 0x399c,
+		0xaaaa, 0xf0f0, 0x5a5a, 0x33cc, 0x3c3c, 0x55aa, 0x9696, 0xa55a,
+		0x73ce, 0x13c8, 0x324c, 0x3bdc, 0x6996, 0xc33c, 0x9966, 0x0660,
+		0x0272, 0x04e4, 0x4e40, 0x2720, 0xc936, 0x936c, 0x39c6, 0x639c,
+		0x9336, 0x9cc6, 0x817e, 0xe718, 0xccf0, 0x0fcc, 0x7744, 0xee22,
+	};
+
+	constexpr uint32_t kPartitions3[64] =
+	{
+		0xaa685050, 0x6a5a5040, 0x5a5a4200, 0x5450a0a8, 0xa5a50000, 0xa0a05050, 0x5555a0a0, 0x5a5a5050,
+		0xaa550000, 0xaa555500, 0xaaaa5500, 0x90909090, 0x94949494, 0xa4a4a4a4, 0xa9a59450, 0x2a0a4250,
+		0xa5945040, 0x0a425054, 0xa5a5a500, 0x55a0a0a0, 0xa8a85454, 0x6a6a4040, 0xa4a45000, 0x1a1a0500,
+		0x0050a4a4, 0xaaa59090, 0x14696914, 0x69691400, 0xa08585a0, 0xaa821414, 0x50a4a450, 0x6a5a0200,
+		0xa9a58000, 0x5090a0a8, 0xa8a09050, 0x24242424, 0x00aa5500, 0x24924924, 0x24499224, 0x50a50a50,
+		0x500aa550, 0xaaaa4444, 0x66660000, 0xa5a0a5a0, 0x50a050a0, 0x69286928, 0x44aaaa44, 0x66666600,
+		0xaa444444, 0x54a854a8, 0x95809580, 0x96969600, 0xa85454a8, 0x80959580, 0xaa141414, 0x96960000,
+		0xaaaa1414, 0xa05050a0, 0xa0a5a5a0, 0x96000000, 0x40804080, 0xa9a8a9a8, 0xaaaaaa44, 0x2a4a5254,
+	};
+
+	// texels whose index drops its top bit, besides texel 0 which is the anchor of the first subset
+	constexpr uint8_t kAnchors2[64] =
+	{
+		15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+		15,  2,  8,  2,  2,  8,  8, 15,  2,  8,  2,  2,  8,  8,  2,  2,
+		15, 15,  6,  8,  2,  8, 15, 15,  2,  8,  2,  2,  2, 15, 15,  6,
+		 6,  2,  6,  8, 15, 15,  2,  2, 15, 15, 15, 15, 15,  2,  2, 15,
+	};
+
+	constexpr uint8_t kAnchors3Second[64] =
+	{
+		 3,  3, 15, 15,  8,  3, 15, 15,  8,  8,  6,  6,  6,  5,  3,  3,
+		 3,  3,  8, 15,  3,  3,  6, 10,  5,  8,  8,  6,  8,  5, 15, 15,
+		 8, 15,  3,  5,  6, 10,  8, 15, 15,  3, 15,  5, 15, 15, 15, 15,
+		 3, 15,  5,  5,  5,  8,  5, 10,  5, 10,  8, 13, 15, 12,  3,  3,
+	};
+
+	constexpr uint8_t kAnchors3Third[64] =
+	{
+		15,  8,  8,  3, 15, 15,  3,  8, 15, 15, 15, 15, 15, 15, 15,  8,
+		15,  8, 15,  3, 15,  8, 15,  8,  3, 15,  6, 10, 15, 15, 10,  8,
+		15,  3, 15, 10, 10,  8,  9, 10,  6, 15,  8, 15,  3,  6,  6,  8,
+		15,  3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,  3, 15, 15,  8,
+	};
+
+	constexpr uint8_t kWeights2[4] = { 0, 21, 43, 64 };
+	constexpr uint8_t kWeights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+	constexpr uint8_t kWeights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+	enum class PBits
+	{
+		None,
+		PerEndpoint,
+		PerSubset,
+	};
+
+	struct BC7Mode
+	{
+		uint32_t subsetCount;
+		uint32_t partitionBits;
+		uint32_t rotationBits;
+		uint32_t indexSelectionBits;
+		uint32_t colorBits;
+		uint32_t alphaBits;
+		PBits pBits;
+		uint32_t indexBits;
+		uint32_t secondaryIndexBits;
+	};
+
+	constexpr BC7Mode kBC7Modes[8] =
+	{
+		{ 3, 4, 0, 0, 4, 0, PBits::PerEndpoint, 3, 0 },
+		{ 2, 6, 0, 0, 6, 0, PBits::PerSubset,   3, 0 },
+		{ 3, 6, 0, 0, 5, 0, PBits::None,        2, 0 },
+		{ 2, 6, 0, 0, 7, 0, PBits::PerEndpoint, 2, 0 },
+		{ 1, 0, 2, 1, 5, 6, PBits::None,        2, 3 },
+		{ 1, 0, 2, 0, 7, 8, PBits::None,        2, 2 },
+		{ 1, 0, 0, 0, 7, 7, PBits::PerEndpoint, 4, 0 },
+		{ 2, 6, 0, 0, 5, 5, PBits::PerEndpoint, 2, 0 },
+	};
+
+	// bc6h header fields, named after the endpoint they belong to: w and x are the endpoints
+	// of the first region, y and z those of the second
+	enum BC6HField : uint8_t
+	{
+		RW, GW, BW,
+		RX, GX, BX,
+		RY, GY, BY,
+		RZ, GZ, BZ,
+	};
+
+	// count bits of a field starting at bit first, stored lowest first
+	struct BC6HRun
+	{
+		uint8_t field;
+		uint8_t first;
+		uint8_t count;
+	};
+
+	struct BC6HMode
+	{
+		uint32_t regionCount;
+		bool isTransformed;   // the other endpoints are stored as deltas from w
+		uint32_t endpointBits;
+		uint32_t deltaBits[3];
+		BC6HRun runs[24];     // the header after the mode bits, unused runs are empty
+	};
+
+	// modes 1 to 14 of the specification, the header layouts scatter the high bits of the fields
+	constexpr BC6HMode kBC6HModes[14] =
+	{
+		{ 2, true, 10, { 5, 5, 5 },
+			{ { GY, 4, 1 }, { BY, 4, 1 }, { BZ, 4, 1 }, { RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 5 }, { GZ, 4, 1 },
+			  { GY, 0, 4 }, { GX, 0, 5 }, { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 5 }, { BZ, 1, 1 }, { BY, 0, 4 }, { RY, 0, 5 },
+			  { BZ, 2, 1 }, { RZ, 0, 5 }, { BZ, 3, 1 } } },
+		{ 2, true, 7, { 6, 6, 6 },
+			{ { GY, 5, 1 }, { GZ, 4, 1 }, { GZ, 5, 1 }, { RW, 0, 7 }, { BZ, 0, 1 }, { BZ, 1, 1 }, { BY, 4, 1 }, { GW, 0, 7 },
+			  { BY, 5, 1 }, { BZ, 2, 1 }, { GY, 4, 1 }, { BW, 0, 7 }, { BZ, 3, 1 }, { BZ, 5, 1 }, { BZ, 4, 1 }, { RX, 0, 6 },
+			  { GY, 0, 4 }, { GX, 0, 6 }, { GZ, 0, 4 }, { BX, 0, 6 }, { BY, 0, 4 }, { RY, 0, 6 }, { RZ, 0, 6 } } },
+		{ 2, true, 11, { 5, 4, 4 },
+			{ { RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 5 }, { RW, 10, 1 }, { GY, 0, 4 }, { GX, 0, 4 }, { GW, 10, 1 },
+			  { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 4 }, { BW, 10, 1 }, { BZ, 1, 1 }, { BY, 0, 4 }, { RY, 0, 5 }, { BZ, 2, 1 },
+			  { RZ, 0, 5 }, { BZ, 3, 1 } } },
+		{ 2, true, 11, { 4, 5, 4 },
+			{ { RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 4 }, { RW, 10, 1 }, { GZ, 4, 1 }, { GY, 0, 4 }, { GX, 0, 5 },
+			  { GW, 10, 1 }, { GZ, 0, 4 }, { BX, 0, 4 }, { BW, 10, 1 }, { BZ, 1, 1 }, { BY, 0, 4 }, { RY, 0, 4 }, { BZ, 0, 1 },
+			  { BZ, 2, 1 }, { RZ, 0, 4 }, { GY, 4, 1 }, { BZ, 3, 1 } } },
+		{ 2, true, 11, { 4, 4, 5 },
+			{ { RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 4 }, { RW, 10, 1 }, { BY, 4, 1 }, { GY, 0, 4 }, { GX, 0, 4 },
+			  { GW, 10, 1 }, { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 5 }, { BW, 10, 1 }, { BY, 0, 4 }, { RY, 0, 4 }, { BZ, 1, 1 },
+			  { BZ, 2, 1 }, { RZ, 0, 4 }, { BZ, 4, 1 }, { BZ, 3, 1 } } },
+		{ 2, true, 9, { 5, 5, 5 },
+			{ { RW, 0, 9 }, { BY, 4, 1 }, { GW, 0, 9 }, { GY, 4, 1 }, { BW, 0, 9 }, { BZ, 4, 1 }, { RX, 0, 5 }, { GZ, 4, 1 },
+			  { GY, 0, 4 }, { GX, 0, 5 }, { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 5 }, { BZ, 1, 1 }, { BY, 0, 4 }, { RY, 0, 5 },
+			  { BZ, 2, 1 }, { RZ, 0, 5 }, { BZ, 3, 1 } } },
+		{ 2, true, 8, { 6, 5, 5 },
+			{ { RW, 0, 8 }, { GZ, 4, 1 }, { BY, 4, 1 }, { GW, 0, 8 }, { BZ, 2, 1 }, { GY, 4, 1 }, { BW, 0, 8 }, { BZ, 3, 1 },
+			  { BZ, 4, 1 }, { RX, 0, 6 }, { GY, 0, 4 }, { GX, 0, 5 }, { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 5 }, { BZ, 1, 1 },
+			  { BY, 0, 4 }, { RY, 0, 6 }, { RZ, 0, 6 } } },
+		{ 2, true, 8, { 5, 6, 5 },
+			{ { RW, 0, 8 }, { BZ, 0, 1 }, { BY, 4, 1 }, { GW, 0, 8 }, { GY, 5, 1 }, { GY, 4, 1 }, { BW, 0, 8 }, { GZ, 5, 1 },
+			  { BZ, 4, 1 }, { RX, 0, 5 }, { GZ, 4, 1 }, { GY, 0, 4 }, { GX, 0, 6 }, { GZ, 0, 4 }, { BX, 0, 5 }, { BZ, 1, 1 },
+			  { BY, 0, 4 }, { RY, 0, 5 }, { BZ, 2, 1 }, { RZ, 0, 5 }, { BZ, 3, 1 } } },
+		{ 2, true, 8, { 5, 5, 6 },
+			{ { RW, 0, 8 }, { BZ, 1, 1 }, { BY, 4, 1 }, { GW, 0, 8 }, { BY, 5, 1 }, { GY, 4, 1 }, { BW, 0, 8 }, { BZ, 5, 1 },
+			  { BZ, 4, 1 }, { RX, 0, 5 }, { GZ, 4, 1 }, { GY, 0, 4 }, { GX, 0, 5 }, { BZ, 0, 1 }, { GZ, 0, 4 }, { BX, 0, 6 },
+			  { BY, 0, 4 }, { RY, 0, 5 }, { BZ, 2, 1 }, { RZ, 0, 5 }, { BZ, 3, 1 } } },
+		{ 2, false, 6, { 6, 6, 6 },
+			{ { RW, 0, 6 }, { GZ, 4, 1 }, { BZ, 0, 1 }, { BZ, 1, 1 }, { BY, 4, 1 }, { GW, 0, 6 }, { GY, 5, 1 }, { BY, 5, 1 },
+			  { BZ, 2, 1 }, { GY, 4, 1 }, { BW, 0, 6 }, { GZ, 5, 1 }, { BZ, 3, 1 }, { BZ, 5, 1 }, { BZ, 4, 1 }, { RX, 0, 6 },
+			  { GY, 0, 4 }, { GX, 0, 6 }, { GZ, 0, 4 }, { BX, 0, 6 }, { BY, 0, 4 }, { RY, 0, 6 }, { RZ, 0, 6 } } },
+		{ 1, false, 10, { 10, 10, 10 },
+			{ { RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 10 }, { GX, 0, 10 }, { BX, 0, 10 } } },
+		{ 1, true, 11, { 9, 9, 9 },
+			{ { RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 9 }, { RW, 10, 1 }, { GX, 0, 9 }, { GW, 10, 1 }, { BX, 0, 9 },
+			  { BW, 10, 1 } } },
+		{ 1, true, 12, { 8, 8, 8 },
+			{ { RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 8 }, { RW, 11, 1 }, { RW, 10, 1 }, { GX, 0, 8 }, { GW, 11, 1 },
+			  { GW, 10, 1 }, { BX, 0, 8 }, { BW, 11, 1 }, { BW, 10, 1 } } },
+		{ 1, true, 16, { 4, 4, 4 },
+			{ { RW, 0, 10 }, { GW, 0, 10 }, { BW, 0, 10 }, { RX, 0, 4 }, { RW, 15, 1 }, { RW, 14, 1 }, { RW, 13, 1 }, { RW, 12, 1 },
+			  { RW, 11, 1 }, { RW, 10, 1 }, { GX, 0, 4 }, { GW, 15, 1 }, { GW, 14, 1 }, { GW, 13, 1 }, { GW, 12, 1 }, { GW, 11, 1 },
+			  { GW, 10, 1 }, { BX, 0, 4 }, { BW, 15, 1 }, { BW, 14, 1 }, { BW, 13, 1 }, { BW, 12, 1 }, { BW, 11, 1 }, { BW, 10, 1 } } },
+	};
+
+	// bc7 fields are packed from the lowest bit of the first byte
+	struct BitReader
+	{
+		const uint8_t* data;
+		uint32_t position = 0;
+
+		uint32_t Read(const uint32_t count)
+		{
+			uint32_t value = 0;
+
+			for (uint32_t i = 0; i < count; ++i, ++position)
+			{
+				value |= uint32_t((data[position >> 3] >> (position & 7)) & 1) << i;
+			}
+
+			return value;
+		}
+	};
+
+	uint32_t GetSubset(const uint32_t subsetCount, const uint32_t partition, const uint32_t texel)
+	{
+		switch (subsetCount)
+		{
+			case 2:
+				return (kPartitions2[partition] >> texel) & 1;
+			case 3:
+				return (kPartitions3[partition] >> (2 * texel)) & 3;
+			default:
+				return 0;
+		}
+	}
+
+	bool IsAnchor(const uint32_t subsetCount, const uint32_t partition, const uint32_t texel)
+	{
+		switch (subsetCount)
+		{
+			case 2:
+				return (texel == 0) || (texel == kAnchors2[partition]);
+			case 3:
+				return (texel == 0) || (texel == kAnchors3Second[partition]) || (texel == kAnchors3Third[partition]);
+			default:
+				return texel == 0;
+		}
+	}
+
+	uint8_t Interpolate(const uint32_t e0, const uint32_t e1, const uint32_t weight)
+	{
+		return uint8_t(((64 - weight) * e0 + weight * e1 + 32) >> 6);
+	}
+
+	// the top bits are replicated into the low ones
+	uint32_t Expand(const uint32_t value, const uint32_t bits)
+	{
+		return (bits >= 8) ? value : ((value << (8 - bits)) | (value >> (2 * bits - 8)));
+	}
+
+	uint32_t Expand565(const uint16_t color, uint32_t rgb[3])
+	{
+		rgb[0] = Expand((color >> 11) & 31, 5);
+		rgb[1] = Expand((color >> 5) & 63, 6);
+		rgb[2] = Expand(color & 31, 5);
+
+		return color;
+	}
+
+	int32_t SignExtend(const int32_t value, const uint32_t bits)
+	{
+		const int32_t shift = 32 - int32_t(bits);
+		return int32_t(uint32_t(value) << shift) >> shift;
+	}
+
+	// bc6h endpoints are widened to 16 bits before the interpolation
+	int32_t Unquantize(const int32_t value, const uint32_t bits, const bool isSigned)
+	{
+		if (!isSigned)
+		{
+			if ((bits >= 15) || (value == 0))
+			{
+				return value;
+			}
+
+			return (value == (1 << bits) - 1) ? 0xffff : ((value << 16) + 0x8000) >> bits;
+		}
+
+		if (bits >= 16)
+		{
+			return value;
+		}
+
+		const int32_t magnitude = std::abs(value);
+		int32_t result = 0;
+
+		if (magnitude >= (1 << (bits - 1)) - 1)
+		{
+			result = 0x7fff;
+		}
+		else if (magnitude > 0)
+		{
+			result = ((magnitude << 15) + 0x4000) >> (bits - 1);
+		}
+
+		return (value < 0) ? -result : result;
+	}
+
+	// scales the interpolated value to the half float range and returns its bits
+	uint16_t FinishUnquantize(const int32_t value, const bool isSigned)
+	{
+		if (!isSigned)
+		{
+			return uint16_t((value * 31) >> 6);
+		}
+
+		return (value < 0) ? uint16_t(0x8000 | ((-value * 31) >> 5)) : uint16_t((value * 31) >> 5);
+	}
+
+	// decode every block of a subresource with decode(block, texels) and copy the texels inside
+	// width x height to rows pitch bytes apart, one thread per block row at a time
+	template<typename Texel, typename F>
+	void DecodeBlocks(const DXGI_FORMAT format,
+					  const D3D11_SUBRESOURCE_DATA& subresource,
+					  const uint32_t width,
+					  const uint32_t height,
+					  uint8_t* output,
+					  const std::size_t pitch,
+					  F&& decode)
+	{
+		const std::size_t blockSize = BlockDecoder::GetBlockSize(format);
+		const uint32_t blocksX = (width + 3) / 4;
+		const uint32_t blocksY = (height + 3) / 4;
+
+		ParallelFor(blocksY, [&](const std::size_t by)
+		{
+			const uint8_t* blocks = static_cast<const uint8_t*>(subresource.pSysMem) + by * subresource.SysMemPitch;
+			const uint32_t rowCount = std::min(4u, height - uint32_t(by) * 4);
+
+			for (uint32_t bx = 0; bx < blocksX; ++bx)
+			{
+				Texel texels[16];
+				decode(blocks + bx * blockSize, texels);
+
+				const std::size_t rowSize = std::min(4u, width - bx * 4) * sizeof(Texel);
+
+				for (uint32_t y = 0; y < rowCount; ++y)
+				{
+					uint8_t* row = output + (by * 4 + y) * pitch + std::size_t(bx) * 4 * sizeof(Texel);
+					std::memcpy(row, &texels[4 * y], rowSize);
+				}
+			}
+		});
+	}
+}
+
+bool BlockDecoder::IsSupportedFormat(const DXGI_FORMAT format)
+{
+	switch (format)
+	{
+		case DXGI_FORMAT_BC4_SNORM:
+		case DXGI_FORMAT_BC5_SNORM:
+		case DXGI_FORMAT_BC6H_UF16:
+		case DXGI_FORMAT_BC6H_SF16:
+			return true;
+		default:
+			return IsUNormFormat(format);
+	}
+}
+
+bool BlockDecoder::IsUNormFormat(const DXGI_FORMAT format)
+{
+	switch (format)
+	{
+		case DXGI_FORMAT_BC1_UNORM:
+		case DXGI_FORMAT_BC1_UNORM_SRGB:
+		case DXGI_FORMAT_BC2_UNORM:
+		case DXGI_FORMAT_BC2_UNORM_SRGB:
+		case DXGI_FORMAT_BC3_UNORM:
+		case DXGI_FORMAT_BC3_UNORM_SRGB:
+		case DXGI_FORMAT_BC4_UNORM:
+		case DXGI_FORMAT_BC5_UNORM:
+		case DXGI_FORMAT_BC7_UNORM:
+		case DXGI_FORMAT_BC7_UNORM_SRGB:
+			return true;
+		default:
+			return false;
+	}
+}
+
+std::size_t BlockDecoder::GetBlockSize(const DXGI_FORMAT format)
+{
+	switch (format)
+	{
+		case DXGI_FORMAT_BC1_UNORM:
+		case DXGI_FORMAT_BC1_UNORM_SRGB:
+		case DXGI_FORMAT_BC4_UNORM:
+		case DXGI_FORMAT_BC4_SNORM:
+			return 8;
+		default:
+			return 16;
+	}
+}
+
+void BlockDecoder::DecodeBlock(const DXGI_FORMAT format, const uint8_t* block, uint8_t rgba[64])
+{
+	switch (format)
+	{
+		case DXGI_FORMAT_BC1_UNORM:
+		case DXGI_FORMAT_BC1_UNORM_SRGB:
+			DecodeBC1(block, rgba);
+			break;
+		case DXGI_FORMAT_BC2_UNORM:
+		case DXGI_FORMAT_BC2_UNORM_SRGB:
+			DecodeBC2(block, rgba);
+			break;
+		case DXGI_FORMAT_BC3_UNORM:
+		case DXGI_FORMAT_BC3_UNORM_SRGB:
+			DecodeBC3(block, rgba);
+			break;
+		case DXGI_FORMAT_BC4_UNORM:
+			// single channel formats read back as red, opaque
+			std::memset(rgba, 0, 64);
+			DecodeBC4(block, rgba);
+			for (int i = 0; i < 16; ++i)
+			{
+				rgba[4 * i + 3] = 255;
+			}
+			break;
+		case DXGI_FORMAT_BC5_UNORM:
+			DecodeBC5(block, rgba);
+			break;
+		case DXGI_FORMAT_BC7_UNORM:
+		case DXGI_FORMAT_BC7_UNORM_SRGB:
+			DecodeBC7(block, rgba);
+			break;
+		default:
+			assert(false);
+			break;
+	}
+}
+
+void BlockDecoder::DecodeBlock(const DXGI_FORMAT format, const uint8_t* block, XMFLOAT4 texels[16])
+{
+	switch (format)
+	{
+		case DXGI_FORMAT_BC4_SNORM:
+			for (int i = 0; i < 16; ++i)
+			{
+				texels[i] = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
+			}
+			DecodeBC4S(block, &texels[0].x);
+			break;
+		case DXGI_FORMAT_BC5_SNORM:
+			DecodeBC5S(block, texels);
+			break;
+		case DXGI_FORMAT_BC6H_UF16:
+		case DXGI_FORMAT_BC6H_SF16:
+			DecodeBC6H(block, texels, format == DXGI_FORMAT_BC6H_SF16);
+			break;
+		default:
+		{
+			uint8_t rgba[64];
+			DecodeBlock(format, block, rgba);
+
+			for (int i = 0; i < 16; ++i)
+			{
+				XMStoreFloat4(&texels[i], XMLoadUByteN4(reinterpret_cast<const XMUBYTEN4*>(&rgba[4 * i])));
+			}
+			break;
+		}
+	}
+}
+
+void BlockDecoder::DecodeSubresource(const DXGI_FORMAT format,
+									 const D3D11_SUBRESOURCE_DATA& subresource,
+									 const uint32_t width,
+									 const uint32_t height,
+									 uint8_t* rgba,
+									 const std::size_t pitch)
+{
+	assert(IsUNormFormat(format));
+
+	DecodeBlocks<uint32_t>(format, subresource, width, height, rgba, pitch, [format](const uint8_t* block, uint32_t texels[16])
+	{
+		DecodeBlock(format, block, reinterpret_cast<uint8_t*>(texels));
+	});
+}
+
+void BlockDecoder::DecodeSubresource(const DXGI_FORMAT format,
+									 const D3D11_SUBRESOURCE_DATA& subresource,
+									 const uint32_t width,
+									 const uint32_t height,
+									 XMFLOAT4* texels,
+									 const std::size_t pitch)
+{
+	assert(IsSupportedFormat(format));
+
+	DecodeBlocks<XMFLOAT4>(format, subresource, width, height, reinterpret_cast<uint8_t*>(texels), pitch, [format](const uint8_t* block, XMFLOAT4 blockTexels[16])
+	{
+		DecodeBlock(format, block, blockTexels);
+	});
+}
+
+std::vector<std::vector<XMFLOAT4>> BlockDecoder::Decode(const uint8_t* ddsData, const std::size_t ddsDataSize, Report* report)
+{
+	DDSTextureInfo info;
+	const uint8_t* bitData = nullptr;
+	std::size_t bitSize = 0;
+
+	ThrowIfFailed(GetDDSTextureInfoFromMemory(ddsData, ddsDataSize, &info, &bitData, &bitSize));
+
+	assert(info.resourceDimension == D3D11_RESOURCE_DIMENSION_TEXTURE2D);
+	assert(IsSupportedFormat(info.format));
+
+	std::vector<D3D11_SUBRESOURCE_DATA> subresources(std::size_t(info.mipCount) * info.arraySize);
+	ThrowIfFailed(GetDDSSubresourceData(info, bitData, bitSize, subresources.data()));
+
+	// allocated up front so the timing only covers the decoding
+	std::vector<std::vector<XMFLOAT4>> levels(subresources.size());
+
+	for (std::size_t i = 0; i < levels.size(); ++i)
+	{
+		const uint32_t width = std::max(1u, info.width >> (i % info.mipCount));
+		const uint32_t height = std::max(1u, info.height >> (i % info.mipCount));
+
+		levels[i].resize(std::size_t(width) * height);
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for (std::size_t i = 0; i < levels.size(); ++i)
+	{
+		const uint32_t width = std::max(1u, info.width >> (i % info.mipCount));
+		const uint32_t height = std::max(1u, info.height >> (i % info.mipCount));
+
+		DecodeSubresource(info.format, subresources[i], width, height, levels[i].data(), width * sizeof(XMFLOAT4));
+	}
+
+	if (report)
+	{
+		*report = Report();
+		report->format = info.format;
+		report->decodeSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		for (std::size_t i = 0; i < levels.size(); ++i)
+		{
+			report->texelCount += levels[i].size();
+			report->compressedBytes += subresources[i].SysMemSlicePitch;
+		}
+	}
+
+	return levels;
+}
+
+void BlockDecoder::DecodeBC1(const uint8_t* block, uint8_t rgba[64], const bool allowThreeColor)
+{
+	const uint16_t c0 = uint16_t(block[0] | (block[1] << 8));
+	const uint16_t c1 = uint16_t(block[2] | (block[3] << 8));
+	const uint32_t indices = block[4] | (block[5] << 8) | (block[6] << 16) | (uint32_t(block[7]) << 24);
+
+	uint32_t palette[4][4];
+	Expand565(c0, palette[0]);
+	Expand565(c1, palette[1]);
+	palette[0][3] = 255;
+	palette[1][3] = 255;
+
+	for (int c = 0; c < 3; ++c)
+	{
+		if ((c0 > c1) || !allowThreeColor)
+		{
+			palette[2][c] = (2 * palette[0][c] + palette[1][c] + 1) / 3;
+			palette[3][c] = (palette[0][c] + 2 * palette[1][c] + 1) / 3;
+		}
+		else
+		{
+			// three colors and transparent black
+			palette[2][c] = (palette[0][c] + palette[1][c] + 1) / 2;
+			palette[3][c] = 0;
+		}
+	}
+
+	palette[2][3] = 255;
+	palette[3][3] = ((c0 > c1) || !allowThreeColor) ? 255 : 0;
+
+	for (int i = 0; i < 16; ++i)
+	{
+		const uint32_t* color = palette[(indices >> (2 * i)) & 3];
+
+		rgba[4 * i + 0] = uint8_t(color[0]);
+		rgba[4 * i + 1] = uint8_t(color[1]);
+		rgba[4 * i + 2] = uint8_t(color[2]);
+		rgba[4 * i + 3] = uint8_t(color[3]);
+	}
+}
+
+void BlockDecoder::DecodeBC2(const uint8_t* block, uint8_t rgba[64])
+{
+	DecodeBC1(block + 8, rgba, false);
+
+	// explicit 4 bit alpha, texel 0 in the low bits of the first byte
+	for (int i = 0; i < 16; ++i)
+	{
+		rgba[4 * i + 3] = uint8_t(((block[i / 2] >> (4 * (i & 1))) & 15) * 17);
+	}
+}
+
+void BlockDecoder::DecodeBC3(const uint8_t* block, uint8_t rgba[64])
+{
+	DecodeBC1(block + 8, rgba, false);
+	DecodeBC4(block, rgba + 3);
+}
+
+void BlockDecoder::DecodeBC4(const uint8_t* block, uint8_t* channel)
+{
+	const uint32_t a0 = block[0];
+	const uint32_t a1 = block[1];
+
+	uint32_t palette[8] = { a0, a1 };
+
+	if (a0 > a1)
+	{
+		for (uint32_t i = 1; i < 7; ++i)
+		{
+			palette[i + 1] = ((7 - i) * a0 + i * a1 + 3) / 7;
+		}
+	}
+	else
+	{
+		for (uint32_t i = 1; i < 5; ++i)
+		{
+			palette[i + 1] = ((5 - i) * a0 + i * a1 + 2) / 5;
+		}
+
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+
+	uint64_t indices = 0;
+
+	for (int i = 0; i < 6; ++i)
+	{
+		indices |= uint64_t(block[2 + i]) << (8 * i);
+	}
+
+	for (int i = 0; i < 16; ++i)
+	{
+		channel[4 * i] = uint8_t(palette[(indices >> (3 * i)) & 7]);
+	}
+}
+
+void BlockDecoder::DecodeBC4S(const uint8_t* block, float* channel)
+{
+	// -128 and -127 both map to -1
+	const int32_t a0 = std::max(int32_t(int8_t(block[0])), -127);
+	const int32_t a1 = std::max(int32_t(int8_t(block[1])), -127);
+
+	float palette[8] = { a0 / 127.0f, a1 / 127.0f };
+
+	if (a0 > a1)
+	{
+		for (int32_t i = 1; i < 7; ++i)
+		{
+			palette[i + 1] = ((7 - i) * a0 + i * a1) / (7.0f * 127.0f);
+		}
+	}
+	else
+	{
+		for (int32_t i = 1; i < 5; ++i)
+		{
+			palette[i + 1] = ((5 - i) * a0 + i * a1) / (5.0f * 127.0f);
+		}
+
+		palette[6] = -1.0f;
+		palette[7] = 1.0f;
+	}
+
+	uint64_t indices = 0;
+
+	for (int i = 0; i < 6; ++i)
+	{
+		indices |= uint64_t(block[2 + i]) << (8 * i);
+	}
+
+	for (int i = 0; i < 16; ++i)
+	{
+		channel[4 * i] = palette[(indices >> (3 * i)) & 7];
+	}
+}
+
+void BlockDecoder::DecodeBC5(const uint8_t* block, uint8_t rgba[64])
+{
+	DecodeBC4(block, rgba + 0);
+	DecodeBC4(block + 8, rgba + 1);
+
+	for (int i = 0; i < 16; ++i)
+	{
+		rgba[4 * i + 2] = 0;
+		rgba[4 * i + 3] = 255;
+	}
+}
+
+void BlockDecoder::DecodeBC5S(const uint8_t* block, XMFLOAT4 texels[16])
+{
+	for (int i = 0; i < 16; ++i)
+	{
+		texels[i] = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+
+	DecodeBC4S(block, &texels[0].x);
+	DecodeBC4S(block + 8, &texels[0].y);
+}
+
+void BlockDecoder::DecodeBC6H(const uint8_t* block, XMFLOAT4 texels[16], const bool isSigned)
+{
+	BitReader reader = { block };
+
+	// two mode bits, or five when the low two are 2 or 3
+	uint32_t modeBits = reader.Read(2);
+	uint32_t modeIndex = modeBits;
+
+	if (modeBits >= 2)
+	{
+		modeBits |= reader.Read(3) << 2;
+		modeIndex = ((modeBits & 3) == 2) ? 2 + (modeBits >> 2) : 10 + (modeBits >> 2);
+	}
+
+	// reserved modes decode to black
+	if (modeIndex >= 14)
+	{
+		for (int i = 0; i < 16; ++i)
+		{
+			texels[i] = XMFLOAT4(0.0f, 0.0f, 0.0f, 1.0f);
+		}
+		return;
+	}
+
+	const BC6HMode& mode = kBC6HModes[modeIndex];
+
+	int32_t endpoints[4][3] = {};
+	int32_t* fields = &endpoints[0][0];
+
+	for (const BC6HRun& run : mode.runs)
+	{
+		fields[run.field] |= int32_t(reader.Read(run.count)) << run.first;
+	}
+
+	const uint32_t partition = (mode.regionCount == 2) ? reader.Read(5) : 0;
+	const uint32_t endpointCount = 2 * mode.regionCount;
+
+	for (uint32_t c = 0; c < 3; ++c)
+	{
+		if (isSigned)
+		{
+			endpoints[0][c] = SignExtend(endpoints[0][c], mode.endpointBits);
+		}
+
+		for (uint32_t e = 1; e < endpointCount; ++e)
+		{
+			if (isSigned || mode.isTransformed)
+			{
+				endpoints[e][c] = SignExtend(endpoints[e][c], mode.deltaBits[c]);
+			}
+
+			if (mode.isTransformed)
+			{
+				endpoints[e][c] = (endpoints[0][c] + endpoints[e][c]) & ((1 << mode.endpointBits) - 1);
+
+				if (isSigned)
+				{
+					endpoints[e][c] = SignExtend(endpoints[e][c], mode.endpointBits);
+				}
+			}
+		}
+
+		for (uint32_t e = 0; e < endpointCount; ++e)
+		{
+			endpoints[e][c] = Unquantize(endpoints[e][c], mode.endpointBits, isSigned);
+		}
+	}
+
+	const uint32_t indexBits = (mode.regionCount == 2) ? 3 : 4;
+	const uint8_t* weights = GetBC7Weights(indexBits);
+
+	// rgb halves and an alpha of one, converted to floats together
+	uint16_t halves[16][4];
+
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		const uint32_t weight = weights[reader.Read(indexBits - (IsAnchor(mode.regionCount, partition, i) ? 1 : 0))];
+		const uint32_t region = GetSubset(mode.regionCount, partition, i);
+		const int32_t* e0 = endpoints[2 * region + 0];
+		const int32_t* e1 = endpoints[2 * region + 1];
+
+		for (uint32_t c = 0; c < 3; ++c)
+		{
+			const int32_t value = (int32_t(64 - weight) * e0[c] + int32_t(weight) * e1[c] + 32) >> 6;
+			halves[i][c] = FinishUnquantize(value, isSigned);
+		}
+
+		halves[i][3] = 0x3c00;
+	}
+
+	XMConvertHalfToFloatStream(&texels[0].x, sizeof(float), &halves[0][0], sizeof(uint16_t), 64);
+}
+
+void BlockDecoder::DecodeBC7(const uint8_t* block, uint8_t rgba[64])
+{
+	uint32_t modeIndex = 0;
+
+	while ((modeIndex < 8) && !(block[0] & (1 << modeIndex)))
+	{
+		++modeIndex;
+	}
+
+	// reserved mode, decodes to transparent black
+	if (modeIndex == 8)
+	{
+		std::memset(rgba, 0, 64);
+		return;
+	}
+
+	const BC7Mode& mode = kBC7Modes[modeIndex];
+
+	BitReader reader = { block, modeIndex + 1 };
+
+	const uint32_t partition = reader.Read(mode.partitionBits);
+	const uint32_t rotation = reader.Read(mode.rotationBits);
+	const uint32_t indexSelection = reader.Read(mode.indexSelectionBits);
+
+	const uint32_t endpointCount = 2 * mode.subsetCount;
+	uint32_t endpoints[6][4] = {};
+
+	for (uint32_t c = 0; c < 3; ++c)
+	{
+		for (uint32_t e = 0; e < endpointCount; ++e)
+		{
+			endpoints[e][c] = reader.Read(mode.colorBits);
+		}
+	}
+
+	for (uint32_t e = 0; e < endpointCount; ++e)
+	{
+		endpoints[e][3] = reader.Read(mode.alphaBits);
+	}
+
+	uint32_t colorBits = mode.colorBits;
+	uint32_t alphaBits = mode.alphaBits;
+
+	if (mode.pBits != PBits::None)
+	{
+		for (uint32_t e = 0; e < endpointCount; ++e)
+		{
+			// per subset p bits are shared by both endpoints of the subset
+			if ((mode.pBits == PBits::PerSubset) && (e & 1))
+			{
+				for (uint32_t c = 0; c < 4; ++c)
+				{
+					endpoints[e][c] = (endpoints[e][c] << 1) | (endpoints[e - 1][c] & 1);
+				}
+				continue;
+			}
+
+			const uint32_t p = reader.Read(1);
+
+			for (uint32_t c = 0; c < 4; ++c)
+			{
+				endpoints[e][c] = (endpoints[e][c] << 1) | p;
+			}
+		}
+
+		++colorBits;
+		alphaBits += (alphaBits > 0) ? 1 : 0;
+	}
+
+	for (uint32_t e = 0; e < endpointCount; ++e)
+	{
+		for (uint32_t c = 0; c < 3; ++c)
+		{
+			endpoints[e][c] = Expand(endpoints[e][c], colorBits);
+		}
+
+		endpoints[e][3] = (alphaBits > 0) ? Expand(endpoints[e][3], alphaBits) : 255;
+	}
+
+	uint32_t indices[16];
+	uint32_t secondaryIndices[16] = {};
+
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		indices[i] = reader.Read(mode.indexBits - (IsAnchor(mode.subsetCount, partition, i) ? 1 : 0));
+	}
+
+	if (mode.secondaryIndexBits > 0)
+	{
+		for (uint32_t i = 0; i < 16; ++i)
+		{
+			secondaryIndices[i] = reader.Read(mode.secondaryIndexBits - ((i == 0) ? 1 : 0));
+		}
+	}
+
+	for (uint32_t i = 0; i < 16; ++i)
+	{
+		const uint32_t subset = GetSubset(mode.subsetCount, partition, i);
+		const uint32_t* e0 = endpoints[2 * subset + 0];
+		const uint32_t* e1 = endpoints[2 * subset + 1];
+
+		uint32_t colorWeight = GetBC7Weights(mode.indexBits)[indices[i]];
+		uint32_t alphaWeight = colorWeight;
+
+		if (mode.secondaryIndexBits > 0)
+		{
+			alphaWeight = GetBC7Weights(mode.secondaryIndexBits)[secondaryIndices[i]];
+
+			if (indexSelection)
+			{
+				std::swap(colorWeight, alphaWeight);
+			}
+		}
+
+		uint8_t* texel = &rgba[4 * i];
+
+		texel[0] = Interpolate(e0[0], e1[0], colorWeight);
+		texel[1] = Interpolate(e0[1], e1[1], colorWeight);
+		texel[2] = Interpolate(e0[2], e1[2], colorWeight);
+		texel[3] = Interpolate(e0[3], e1[3], alphaWeight);
+
+		if (rotation > 0)
+		{
+			std::swap(texel[rotation - 1], texel[3]);
+		}
+	}
+}
+
+const uint8_t* BlockDecoder::GetBC7Weights(const uint32_t indexBits)
+{
+	switch (indexBits)
+	{
+		case 2:
+			return kWeights2;
+		case 3:
+			return kWeights3;
+		default:
+			return kWeights4;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,83 @@
+#pragma once
+
+// std
+#include <cstdint>
+#include <vector>
+
+// d3d
+#include <d3d11.h>
+#include <directxmath.h>
+
+// decodes block compressed texels on the cpu, for tools that need to read back compressed textures
+// such as the compressor's own validation; every block is 4x4 texels written row major. the unorm
+// formats decode to rgba8, all of them decode to floats: snorm in -1..1 and bc6h as the stored half
+// floats. srgb texels come back as stored, they are not linearized
+class BlockDecoder
+{
+public:
+
+	struct Report
+	{
+		DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+		std::size_t texelCount = 0;
+		std::size_t compressedBytes = 0;
+		double decodeSeconds = 0.0;
+
+		double GetMegapixelsPerSecond() const
+		{
+			return (decodeSeconds > 0.0) ? (texelCount / 1000000.0) / decodeSeconds : 0.0;
+		}
+	};
+
+	static bool IsSupportedFormat(const DXGI_FORMAT format);
+
+	// formats with an rgba8 result, all but the snorm ones and bc6h
+	static bool IsUNormFormat(const DXGI_FORMAT format);
+
+	// 8 bytes for bc1 and bc4, 16 for the others
+	static std::size_t GetBlockSize(const DXGI_FORMAT format);
+
+	static void DecodeBlock(const DXGI_FORMAT format, const uint8_t* block, uint8_t rgba[64]);
+	static void DecodeBlock(const DXGI_FORMAT format, const uint8_t* block, DirectX::XMFLOAT4 texels[16]);
+
+	// a whole subresource as GetDDSSubresourceData lays it out, the block rows are spread across threads;
+	// the width x height texels are written pitch bytes apart, the parts of edge blocks past them are dropped
+	static void DecodeSubresource(const DXGI_FORMAT format,
+								  const D3D11_SUBRESOURCE_DATA& subresource,
+								  const uint32_t width,
+								  const uint32_t height,
+								  uint8_t* rgba,
+								  const std::size_t pitch);
+
+	static void DecodeSubresource(const DXGI_FORMAT format,
+								  const D3D11_SUBRESOURCE_DATA& subresource,
+								  const uint32_t width,
+								  const uint32_t height,
+								  DirectX::XMFLOAT4* texels,
+								  const std::size_t pitch);
+
+	// every mip and item of a 2D DDS (array) as floats, in the GetDDSSubresourceData order with tight rows;
+	// the report times the decoding alone
+	static std::vector<std::vector<DirectX::XMFLOAT4>> Decode(const uint8_t* ddsData,
+															  const std::size_t ddsDataSize,
+															  Report* report = nullptr);
+
+	// allowThreeColor is false for the color part of bc2 and bc3, which always uses four colors
+	static void DecodeBC1(const uint8_t* block, uint8_t rgba[64], const bool allowThreeColor = true);
+	static void DecodeBC2(const uint8_t* block, uint8_t rgba[64]);
+	static void DecodeBC3(const uint8_t* block, uint8_t rgba[64]);
+
+	// a single channel, written every 4 bytes starting at channel
+	static void DecodeBC4(const uint8_t* block, uint8_t* channel);
+
+	// the signed variant in -1..1, written every 4 floats starting at channel
+	static void DecodeBC4S(const uint8_t* block, float* channel);
+
+	static void DecodeBC5(const uint8_t* block, uint8_t rgba[64]);
+	static void DecodeBC5S(const uint8_t* block, DirectX::XMFLOAT4 texels[16]);
+	static void DecodeBC6H(const uint8_t* block, DirectX::XMFLOAT4 texels[16], const bool isSigned);
+	static void DecodeBC7(const uint8_t* block, uint8_t rgba[64]);
+
+	// bc7 interpolation weights out of 64 for 2, 3 and 4 bit indices, bc6h uses the same
+	static const uint8_t* GetBC7Weights(const uint32_t indexBits);
+};
\ No newline at end of file
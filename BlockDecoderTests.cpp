@@ -0,0 +1,383 @@
+#include "UnitTest.h"
+
+// std
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+
+#include "BlockDecoder.h"
+
+// reference blocks of every BCn format and the texels a reference decoder makes of them. DirectXTex
+// and the D3D reference rasterizer aren't at hand on every machine that runs these, so the texels were
+// generated once with the BCn decoder of Pillow 12.3, which is independent of ours. BC4 is given as
+// (value, 0, 0, 255) and BC5 as (red, green, 0, 255), the way DecodeBlock writes them
+
+namespace
+{
+	struct ReferenceBlock
+	{
+		DXGI_FORMAT format;
+		const char* description;
+		uint8_t block[16];
+		uint8_t rgba[64];
+	};
+
+	const ReferenceBlock kReferenceBlocks[] =
+	{
+		{ DXGI_FORMAT_BC1_UNORM, "four colors, red to blue",
+		  { 0x00, 0xf8, 0x1f, 0x00, 0xe4, 0xe4, 0xe4, 0xe4 },
+		  {
+			  0xff, 0x00, 0x00, 0xff, 0x00, 0x00, 0xff, 0xff, 0xaa, 0x00, 0x55, 0xff, 0x55, 0x00, 0xaa, 0xff,
+			  0xff, 0x00, 0x00, 0xff, 0x00, 0x00, 0xff, 0xff, 0xaa, 0x00, 0x55, 0xff, 0x55, 0x00, 0xaa, 0xff,
+			  0xff, 0x00, 0x00, 0xff, 0x00, 0x00, 0xff, 0xff, 0xaa, 0x00, 0x55, 0xff, 0x55, 0x00, 0xaa, 0xff,
+			  0xff, 0x00, 0x00, 0xff, 0x00, 0x00, 0xff, 0xff, 0xaa, 0x00, 0x55, 0xff, 0x55, 0x00, 0xaa, 0xff } },
+		{ DXGI_FORMAT_BC1_UNORM, "three colors and transparent black, the endpoints swapped",
+		  { 0x1f, 0x00, 0x00, 0xf8, 0xe4, 0xe4, 0xe4, 0xe4 },
+		  {
+			  0x00, 0x00, 0xff, 0xff, 0xff, 0x00, 0x00, 0xff, 0x7f, 0x00, 0x7f, 0xff, 0x00, 0x00, 0x00, 0x00,
+			  0x00, 0x00, 0xff, 0xff, 0xff, 0x00, 0x00, 0xff, 0x7f, 0x00, 0x7f, 0xff, 0x00, 0x00, 0x00, 0x00,
+			  0x00, 0x00, 0xff, 0xff, 0xff, 0x00, 0x00, 0xff, 0x7f, 0x00, 0x7f, 0xff, 0x00, 0x00, 0x00, 0x00,
+			  0x00, 0x00, 0xff, 0xff, 0xff, 0x00, 0x00, 0xff, 0x7f, 0x00, 0x7f, 0xff, 0x00, 0x00, 0x00, 0x00 } },
+		{ DXGI_FORMAT_BC1_UNORM, "equal endpoints are the three color mode",
+		  { 0x10, 0x84, 0x10, 0x84, 0x1b, 0x6c, 0xb1, 0xc6 },
+		  {
+			  0x00, 0x00, 0x00, 0x00, 0x84, 0x82, 0x84, 0xff, 0x84, 0x82, 0x84, 0xff, 0x84, 0x82, 0x84, 0xff,
+			  0x84, 0x82, 0x84, 0xff, 0x00, 0x00, 0x00, 0x00, 0x84, 0x82, 0x84, 0xff, 0x84, 0x82, 0x84, 0xff,
+			  0x84, 0x82, 0x84, 0xff, 0x84, 0x82, 0x84, 0xff, 0x00, 0x00, 0x00, 0x00, 0x84, 0x82, 0x84, 0xff,
+			  0x84, 0x82, 0x84, 0xff, 0x84, 0x82, 0x84, 0xff, 0x84, 0x82, 0x84, 0xff, 0x00, 0x00, 0x00, 0x00 } },
+		{ DXGI_FORMAT_BC1_UNORM, "random",
+		  { 0xa5, 0x3d, 0x6c, 0xf0, 0x95, 0x88, 0x0e, 0xb2 },
+		  {
+			  0xf7, 0x0c, 0x63, 0xff, 0xf7, 0x0c, 0x63, 0xff, 0xf7, 0x0c, 0x63, 0xff, 0x98, 0x61, 0x46, 0xff,
+			  0x39, 0xb6, 0x29, 0xff, 0x98, 0x61, 0x46, 0xff, 0x39, 0xb6, 0x29, 0xff, 0x98, 0x61, 0x46, 0xff,
+			  0x98, 0x61, 0x46, 0xff, 0x00, 0x00, 0x00, 0x00, 0x39, 0xb6, 0x29, 0xff, 0x39, 0xb6, 0x29, 0xff,
+			  0x98, 0x61, 0x46, 0xff, 0x39, 0xb6, 0x29, 0xff, 0x00, 0x00, 0x00, 0x00, 0x98, 0x61, 0x46, 0xff } },
+		{ DXGI_FORMAT_BC1_UNORM, "random",
+		  { 0x46, 0x02, 0x96, 0xe1, 0x8a, 0xa1, 0x27, 0x28 },
+		  {
+			  0x73, 0x3c, 0x73, 0xff, 0x73, 0x3c, 0x73, 0xff, 0x00, 0x49, 0x31, 0xff, 0x73, 0x3c, 0x73, 0xff,
+			  0xe7, 0x30, 0xb5, 0xff, 0x00, 0x49, 0x31, 0xff, 0x73, 0x3c, 0x73, 0xff, 0x73, 0x3c, 0x73, 0xff,
+			  0x00, 0x00, 0x00, 0x00, 0xe7, 0x30, 0xb5, 0xff, 0x73, 0x3c, 0x73, 0xff, 0x00, 0x49, 0x31, 0xff,
+			  0x00, 0x49, 0x31, 0xff, 0x73, 0x3c, 0x73, 0xff, 0x73, 0x3c, 0x73, 0xff, 0x00, 0x49, 0x31, 0xff } },
+		{ DXGI_FORMAT_BC2_UNORM, "random",
+		  { 0xc5, 0x81, 0x75, 0xe7, 0x29, 0x5f, 0xce, 0xad, 0x0a, 0xab, 0x89, 0x5e, 0x32, 0xbc, 0x13, 0xc7 },
+		  {
+			  0x91, 0x87, 0x4f, 0x55, 0xad, 0x61, 0x52, 0xcc, 0x75, 0xad, 0x4c, 0x11, 0xad, 0x61, 0x52, 0x88,
+			  0xad, 0x61, 0x52, 0x55, 0x75, 0xad, 0x4c, 0x77, 0x75, 0xad, 0x4c, 0x77, 0x91, 0x87, 0x4f, 0xee,
+			  0x75, 0xad, 0x4c, 0x99, 0xad, 0x61, 0x52, 0x22, 0x5a, 0xd3, 0x4a, 0xff, 0xad, 0x61, 0x52, 0x55,
+			  0x75, 0xad, 0x4c, 0xee, 0x5a, 0xd3, 0x4a, 0xcc, 0xad, 0x61, 0x52, 0xdd, 0x75, 0xad, 0x4c, 0xaa } },
+		{ DXGI_FORMAT_BC2_UNORM, "random",
+		  { 0x00, 0xb5, 0xa7, 0xfa, 0x88, 0x9b, 0xa6, 0x80, 0x37, 0x45, 0xfd, 0xf0, 0x23, 0x79, 0x6d, 0xc0 },
+		  {
+			  0xba, 0x4a, 0xde, 0x00, 0x42, 0xa6, 0xbd, 0x00, 0x7e, 0x78, 0xcd, 0x55, 0x42, 0xa6, 0xbd, 0xbb,
+			  0xf7, 0x1c, 0xef, 0x77, 0x7e, 0x78, 0xcd, 0xaa, 0xba, 0x4a, 0xde, 0xaa, 0xf7, 0x1c, 0xef, 0xff,
+			  0xf7, 0x1c, 0xef, 0x88, 0xba, 0x4a, 0xde, 0x88, 0x7e, 0x78, 0xcd, 0xbb, 0xf7, 0x1c, 0xef, 0x99,
+			  0x42, 0xa6, 0xbd, 0x66, 0x42, 0xa6, 0xbd, 0xaa, 0x42, 0xa6, 0xbd, 0x00, 0xba, 0x4a, 0xde, 0x88 } },
+		{ DXGI_FORMAT_BC2_UNORM, "four colors whatever the order of the endpoints",
+		  { 0xa5, 0x4d, 0xca, 0x18, 0x25, 0x30, 0xbb, 0x1d, 0x1f, 0x00, 0x00, 0xf8, 0xff, 0xe4, 0x1b, 0xff },
+		  {
+			  0xaa, 0x00, 0x55, 0x55, 0xaa, 0x00, 0x55, 0xaa, 0xaa, 0x00, 0x55, 0xdd, 0xaa, 0x00, 0x55, 0x44,
+			  0x00, 0x00, 0xff, 0xaa, 0xff, 0x00, 0x00, 0xcc, 0x55, 0x00, 0xaa, 0x88, 0xaa, 0x00, 0x55, 0x11,
+			  0xaa, 0x00, 0x55, 0x55, 0x55, 0x00, 0xaa, 0x22, 0xff, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0x33,
+			  0xaa, 0x00, 0x55, 0xbb, 0xaa, 0x00, 0x55, 0xbb, 0xaa, 0x00, 0x55, 0xdd, 0xaa, 0x00, 0x55, 0x11 } },
+		{ DXGI_FORMAT_BC3_UNORM, "eight alpha values",
+		  { 0xc8, 0x1e, 0x9e, 0x7d, 0x15, 0x7b, 0xc6, 0x82, 0x36, 0xa2, 0x0a, 0xcf, 0x54, 0x8a, 0x21, 0x99 },
+		  {
+			  0xa5, 0x45, 0xb5, 0x4e, 0xce, 0xe3, 0x52, 0x97, 0xce, 0xe3, 0x52, 0x4e, 0xce, 0xe3, 0x52, 0x4e,
+			  0xb2, 0x79, 0x94, 0x36, 0xb2, 0x79, 0x94, 0xaf, 0xa5, 0x45, 0xb5, 0x66, 0xb2, 0x79, 0x94, 0xc8,
+			  0xce, 0xe3, 0x52, 0x97, 0xa5, 0x45, 0xb5, 0x36, 0xb2, 0x79, 0x94, 0x1e, 0xa5, 0x45, 0xb5, 0x97,
+			  0xce, 0xe3, 0x52, 0x7f, 0xb2, 0x79, 0x94, 0x66, 0xce, 0xe3, 0x52, 0xc8, 0xb2, 0x79, 0x94, 0x7f } },
+		{ DXGI_FORMAT_BC3_UNORM, "six alpha values, 0 and 255",
+		  { 0x1e, 0xc8, 0xfb, 0x32, 0xa3, 0x52, 0x9a, 0xa8, 0x64, 0x86, 0xc2, 0x81, 0x18, 0xa5, 0x15, 0xa2 },
+		  {
+			  0x84, 0xcf, 0x21, 0x62, 0x84, 0x9c, 0x1b, 0xff, 0x84, 0x38, 0x10, 0x62, 0x84, 0xcf, 0x21, 0xc8,
+			  0x84, 0x38, 0x10, 0x62, 0x84, 0x38, 0x10, 0x00, 0x84, 0x9c, 0x1b, 0x1e, 0x84, 0x9c, 0x1b, 0xa6,
+			  0x84, 0x38, 0x10, 0x40, 0x84, 0x38, 0x10, 0x40, 0x84, 0x38, 0x10, 0xc8, 0x84, 0xcf, 0x21, 0xa6,
+			  0x84, 0x9c, 0x1b, 0xc8, 0x84, 0xcf, 0x21, 0xc8, 0x84, 0x9c, 0x1b, 0x40, 0x84, 0x9c, 0x1b, 0xa6 } },
+		{ DXGI_FORMAT_BC3_UNORM, "four colors whatever the order of the endpoints",
+		  { 0xff, 0x00, 0x88, 0xc6, 0xfa, 0x88, 0xc6, 0xfa, 0x1f, 0x00, 0x00, 0xf8, 0xff, 0xe4, 0x1b, 0xff },
+		  {
+			  0xaa, 0x00, 0x55, 0xff, 0xaa, 0x00, 0x55, 0x00, 0xaa, 0x00, 0x55, 0xda, 0xaa, 0x00, 0x55, 0xb6,
+			  0x00, 0x00, 0xff, 0x91, 0xff, 0x00, 0x00, 0x6d, 0x55, 0x00, 0xaa, 0x48, 0xaa, 0x00, 0x55, 0x24,
+			  0xaa, 0x00, 0x55, 0xff, 0x55, 0x00, 0xaa, 0x00, 0xff, 0x00, 0x00, 0xda, 0x00, 0x00, 0xff, 0xb6,
+			  0xaa, 0x00, 0x55, 0x91, 0xaa, 0x00, 0x55, 0x6d, 0xaa, 0x00, 0x55, 0x48, 0xaa, 0x00, 0x55, 0x24 } },
+		{ DXGI_FORMAT_BC4_UNORM, "eight values, every index",
+		  { 0xc8, 0x0a, 0x88, 0xc6, 0xfa, 0x88, 0xc6, 0xfa },
+		  {
+			  0xc8, 0x00, 0x00, 0xff, 0x0a, 0x00, 0x00, 0xff, 0xac, 0x00, 0x00, 0xff, 0x91, 0x00, 0x00, 0xff,
+			  0x76, 0x00, 0x00, 0xff, 0x5b, 0x00, 0x00, 0xff, 0x40, 0x00, 0x00, 0xff, 0x25, 0x00, 0x00, 0xff,
+			  0xc8, 0x00, 0x00, 0xff, 0x0a, 0x00, 0x00, 0xff, 0xac, 0x00, 0x00, 0xff, 0x91, 0x00, 0x00, 0xff,
+			  0x76, 0x00, 0x00, 0xff, 0x5b, 0x00, 0x00, 0xff, 0x40, 0x00, 0x00, 0xff, 0x25, 0x00, 0x00, 0xff } },
+		{ DXGI_FORMAT_BC4_UNORM, "six values, 0 and 255, every index",
+		  { 0x0a, 0xc8, 0x88, 0xc6, 0xfa, 0x88, 0xc6, 0xfa },
+		  {
+			  0x0a, 0x00, 0x00, 0xff, 0xc8, 0x00, 0x00, 0xff, 0x30, 0x00, 0x00, 0xff, 0x56, 0x00, 0x00, 0xff,
+			  0x7c, 0x00, 0x00, 0xff, 0xa2, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0xff,
+			  0x0a, 0x00, 0x00, 0xff, 0xc8, 0x00, 0x00, 0xff, 0x30, 0x00, 0x00, 0xff, 0x56, 0x00, 0x00, 0xff,
+			  0x7c, 0x00, 0x00, 0xff, 0xa2, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0xff } },
+		{ DXGI_FORMAT_BC4_UNORM, "equal endpoints",
+		  { 0x4d, 0x4d, 0xe4, 0x4c, 0x2e, 0xdb, 0xfd, 0x9b },
+		  {
+			  0x4d, 0x00, 0x00, 0xff, 0x4d, 0x00, 0x00, 0xff, 0x4d, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0xff,
+			  0x4d, 0x00, 0x00, 0xff, 0x4d, 0x00, 0x00, 0xff, 0x4d, 0x00, 0x00, 0xff, 0x4d, 0x00, 0x00, 0xff,
+			  0x4d, 0x00, 0x00, 0xff, 0x4d, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0xff,
+			  0xff, 0x00, 0x00, 0xff, 0xff, 0x00, 0x00, 0xff, 0x00, 0x00, 0x00, 0xff, 0x4d, 0x00, 0x00, 0xff } },
+		{ DXGI_FORMAT_BC5_UNORM, "eight red values, six green values",
+		  { 0xf0, 0x10, 0xe8, 0x69, 0x87, 0x7f, 0xb5, 0x6d, 0x10, 0xf0, 0x22, 0x0b, 0xb6, 0x4d, 0x3d, 0x89 },
+		  {
+			  0xf0, 0x3c, 0x00, 0xff, 0x70, 0x96, 0x00, 0xff, 0x30, 0x96, 0x00, 0xff, 0x90, 0xc3, 0x00, 0xff,
+			  0x50, 0x10, 0x00, 0xff, 0x50, 0x96, 0x00, 0xff, 0x10, 0xc3, 0x00, 0xff, 0x90, 0xc3, 0x00, 0xff,
+			  0x30, 0xc3, 0x00, 0xff, 0x30, 0xf0, 0x00, 0xff, 0x70, 0xc3, 0x00, 0xff, 0xd0, 0x00, 0x00, 0xff,
+			  0xb0, 0x69, 0x00, 0xff, 0xb0, 0x3c, 0x00, 0xff, 0xb0, 0x3c, 0x00, 0xff, 0xb0, 0x96, 0x00, 0xff } },
+		{ DXGI_FORMAT_BC5_UNORM, "equal red endpoints, full green range",
+		  { 0x32, 0x32, 0x9c, 0x80, 0x71, 0x4f, 0x6b, 0xaf, 0xff, 0x00, 0x5b, 0x60, 0x56, 0xeb, 0x09, 0xf3 },
+		  {
+			  0x32, 0xb6, 0x00, 0xff, 0x32, 0xb6, 0x00, 0xff, 0x32, 0x00, 0x00, 0xff, 0x32, 0xff, 0x00, 0xff,
+			  0x32, 0x48, 0x00, 0xff, 0x32, 0x91, 0x00, 0xff, 0x32, 0x6d, 0x00, 0xff, 0x32, 0xda, 0x00, 0xff,
+			  0xff, 0xb6, 0x00, 0xff, 0x32, 0x6d, 0x00, 0xff, 0x32, 0x24, 0x00, 0xff, 0x32, 0x91, 0x00, 0xff,
+			  0x00, 0xff, 0x00, 0xff, 0x00, 0x48, 0x00, 0xff, 0x32, 0x91, 0x00, 0xff, 0x32, 0x24, 0x00, 0xff } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 0",
+		  { 0x67, 0x5b, 0xb9, 0x91, 0x1a, 0x0a, 0xb2, 0x26, 0x3e, 0x22, 0x0f, 0x39, 0xdd, 0xf6, 0x4d, 0x1f },
+		  {
+			  0xc1, 0x5e, 0x54, 0xff, 0xde, 0x08, 0x18, 0xff, 0xd2, 0x1d, 0x18, 0xff, 0xbb, 0x46, 0x18, 0xff,
+			  0xc1, 0x5e, 0x54, 0xff, 0xcf, 0xaf, 0x3d, 0xff, 0xbb, 0x46, 0x18, 0xff, 0xbb, 0x46, 0x18, 0xff,
+			  0xc8, 0x85, 0x49, 0xff, 0xd6, 0xd6, 0x31, 0xff, 0xb6, 0x26, 0x75, 0xff, 0xb6, 0x26, 0x75, 0xff,
+			  0xc4, 0x71, 0x4e, 0xff, 0xce, 0x5a, 0xff, 0xff, 0xb6, 0x26, 0x75, 0xff, 0xa5, 0x00, 0x10, 0xff } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 0",
+		  { 0xed, 0xd6, 0xa9, 0xe5, 0x8a, 0x54, 0xe1, 0x6b, 0xb9, 0x58, 0xeb, 0x5d, 0xac, 0xb1, 0x31, 0x34 },
+		  {
+			  0x7d, 0x6f, 0xe1, 0xff, 0xbd, 0x5a, 0x5a, 0xff, 0x56, 0x31, 0xa8, 0xff, 0x8e, 0x64, 0x88, 0xff,
+			  0x88, 0x6c, 0xcb, 0xff, 0x9e, 0x65, 0x9c, 0xff, 0x56, 0x31, 0xa8, 0xff, 0x3c, 0x18, 0xb7, 0xff,
+			  0xe7, 0x42, 0xb5, 0xff, 0xa5, 0x6f, 0xc0, 0xff, 0xa5, 0x6f, 0xc0, 0xff, 0x8c, 0x80, 0xc3, 0xff,
+			  0xd1, 0x51, 0xb9, 0xff, 0x8c, 0x80, 0xc3, 0xff, 0x60, 0x9e, 0xca, 0xff, 0xe7, 0x42, 0xb5, 0xff } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 0",
+		  { 0xbb, 0x0e, 0x7b, 0x64, 0xae, 0xab, 0x7f, 0x44, 0x70, 0x79, 0x1d, 0xc9, 0xfa, 0x3f, 0x21, 0x92 },
+		  {
+			  0x68, 0x55, 0x32, 0xff, 0x84, 0xd6, 0x21, 0xff, 0x30, 0xdc, 0xb9, 0xff, 0x30, 0xdc, 0xb9, 0xff,
+			  0x68, 0x55, 0x32, 0xff, 0x91, 0xc5, 0x30, 0xff, 0x29, 0xff, 0xce, 0xff, 0x29, 0xff, 0xce, 0xff,
+			  0x7b, 0x7b, 0x29, 0xff, 0xaa, 0xa2, 0x4e, 0xff, 0x2f, 0xe2, 0xbc, 0xff, 0x31, 0xd6, 0xb5, 0xff,
+			  0x5f, 0x42, 0x37, 0xff, 0x9d, 0xb3, 0x3f, 0xff, 0x2f, 0xe2, 0xbc, 0xff, 0x2f, 0xe2, 0xbc, 0xff } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 1",
+		  { 0x4a, 0x10, 0x3a, 0xe0, 0x56, 0xe9, 0x98, 0xd3, 0xfd, 0x14, 0x81, 0xdb, 0x6a, 0x9e, 0x98, 0x55 },
+		  {
+			  0x42, 0x5a, 0x4e, 0xff, 0x42, 0x5a, 0x4e, 0xff, 0xa3, 0x97, 0xdf, 0xff, 0x95, 0x8e, 0xcb, 0xff,
+			  0x95, 0x8e, 0xcb, 0xff, 0x5d, 0x6b, 0x77, 0xff, 0x88, 0x86, 0xb6, 0xff, 0x50, 0x63, 0x62, 0xff,
+			  0x66, 0x61, 0x2b, 0xff, 0x6b, 0x74, 0x8b, 0xff, 0x5d, 0x6b, 0x77, 0xff, 0x7a, 0x7d, 0xa2, 0xff,
+			  0x2a, 0x46, 0x36, 0xff, 0x66, 0x61, 0x2b, 0xff, 0xa5, 0x7e, 0x1f, 0xff, 0x5d, 0x6b, 0x77, 0xff } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 1",
+		  { 0x2e, 0xbd, 0xf3, 0x9b, 0xbc, 0x9d, 0xec, 0x50, 0x66, 0x17, 0xa2, 0x57, 0x38, 0xa1, 0x02, 0xb1 },
+		  {
+			  0xf5, 0xf1, 0x40, 0xff, 0xc0, 0xea, 0x4a, 0xff, 0x38, 0xd9, 0x64, 0xff, 0x6d, 0xe0, 0x5a, 0xff,
+			  0xc0, 0xea, 0x4a, 0xff, 0xf5, 0xf1, 0x40, 0xff, 0x38, 0xd9, 0x64, 0xff, 0x88, 0xe3, 0x55, 0xff,
+			  0xf5, 0xf1, 0x40, 0xff, 0xc0, 0xea, 0x4a, 0xff, 0x6d, 0xe0, 0x5a, 0xff, 0xff, 0x26, 0xdb, 0xff,
+			  0xf5, 0xf1, 0x40, 0xff, 0xf1, 0x42, 0xbf, 0xff, 0xa9, 0xd3, 0x32, 0xff, 0xe3, 0x5f, 0xa4, 0xff } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 1",
+		  { 0xba, 0xab, 0xdd, 0x4b, 0x66, 0xdc, 0xad, 0x9f, 0x0a, 0x65, 0x1b, 0x29, 0xb7, 0xb4, 0xea, 0xb6 },
+		  {
+			  0xbb, 0xa7, 0x8b, 0xff, 0xdf, 0x7e, 0x47, 0xff, 0xc6, 0x86, 0x4c, 0xff, 0xbb, 0xa7, 0x8b, 0xff,
+			  0xb5, 0xa1, 0x84, 0xff, 0x4a, 0xaf, 0x66, 0xff, 0x62, 0xa7, 0x61, 0xff, 0xbb, 0xa7, 0x8b, 0xff,
+			  0xc6, 0x86, 0x4c, 0xff, 0xc2, 0xae, 0x91, 0xff, 0xcf, 0xbb, 0x9e, 0xff, 0xc6, 0x86, 0x4c, 0xff,
+			  0x4a, 0xaf, 0x66, 0xff, 0xd5, 0xc1, 0xa5, 0xff, 0xd5, 0xc1, 0xa5, 0xff, 0xc6, 0x86, 0x4c, 0xff } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 2",
+		  { 0x24, 0x34, 0x79, 0x99, 0xdf, 0x32, 0x6c, 0x67, 0xe2, 0x0a, 0xc8, 0x95, 0x10, 0x80, 0x52, 0x26 },
+		  {
+			  0xd6, 0x29, 0xbd, 0xff, 0x9b, 0x23, 0x84, 0xff, 0xd6, 0x29, 0xbd, 0xff, 0xd6, 0x29, 0xbd, 0xff,
+			  0xd6, 0x29, 0xbd, 0xff, 0xd6, 0x29, 0xbd, 0xff, 0x5c, 0x1e, 0x49, 0xff, 0x5c, 0x1e, 0x49, 0xff,
+			  0x7b, 0xb5, 0x84, 0xff, 0xb3, 0xdc, 0xc7, 0xff, 0xcb, 0x2b, 0x26, 0xff, 0xe7, 0x63, 0x52, 0xff,
+			  0xce, 0xef, 0xe7, 0xff, 0x7b, 0xb5, 0x84, 0xff, 0xd9, 0x48, 0x3c, 0xff, 0xe7, 0x63, 0x52, 0xff } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 2",
+		  { 0x7c, 0xf1, 0xd8, 0x07, 0x03, 0xac, 0x8e, 0xb5, 0xd2, 0x3d, 0x0f, 0x6e, 0xc8, 0x86, 0xbd, 0x43 },
+		  {
+			  0x8d, 0xa0, 0x76, 0xff, 0xc6, 0xc6, 0x73, 0xff, 0x18, 0x52, 0x7b, 0xff, 0x51, 0x78, 0x78, 0xff,
+			  0x85, 0xaa, 0x82, 0xff, 0xde, 0x39, 0xf7, 0xff, 0x41, 0x9f, 0x43, 0xff, 0xa8, 0x62, 0xa6, 0xff,
+			  0x85, 0xaa, 0x82, 0xff, 0x39, 0xb5, 0x00, 0xff, 0x85, 0xaa, 0x82, 0xff, 0x39, 0xb5, 0x00, 0xff,
+			  0x85, 0xaa, 0x82, 0xff, 0xde, 0x39, 0xf7, 0xff, 0x41, 0x9f, 0x43, 0xff, 0xde, 0x39, 0xf7, 0xff } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 2",
+		  { 0x44, 0x3f, 0x0d, 0x8e, 0x1a, 0x57, 0x7e, 0xde, 0xd3, 0xd2, 0x22, 0x5e, 0xe6, 0xab, 0xf3, 0x5b },
+		  {
+			  0xff, 0x73, 0xb5, 0xff, 0xc3, 0x41, 0xaa, 0xff, 0x73, 0xce, 0x10, 0xff, 0x73, 0xce, 0x10, 0xff,
+			  0x50, 0xde, 0x18, 0xff, 0x50, 0xde, 0x18, 0xff, 0xa5, 0xde, 0x7b, 0xff, 0x31, 0x9c, 0xce, 0xff,
+			  0x7f, 0xc8, 0x96, 0xff, 0x57, 0xb2, 0xb3, 0xff, 0xa5, 0x29, 0xa5, 0xff, 0xa5, 0x29, 0xa5, 0xff,
+			  0xe1, 0x5b, 0xb0, 0xff, 0xa5, 0x29, 0xa5, 0xff, 0x50, 0xde, 0x18, 0xff, 0x08, 0xff, 0x29, 0xff } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 3",
+		  { 0x58, 0xdf, 0xa1, 0x69, 0xe8, 0x9a, 0x86, 0x3a, 0x69, 0x2a, 0x03, 0x13, 0x26, 0x46, 0xdf, 0x14 },
+		  {
+			  0xd4, 0xb2, 0x31, 0xff, 0xee, 0xd6, 0x34, 0xff, 0xc2, 0x50, 0x1d, 0xff, 0xd2, 0x50, 0x06, 0xff,
+			  0xa0, 0x68, 0x2a, 0xff, 0xd2, 0x50, 0x06, 0xff, 0xb1, 0x4f, 0x36, 0xff, 0xba, 0x8c, 0x2d, 0xff,
+			  0xa1, 0x4f, 0x4d, 0xff, 0xa1, 0x4f, 0x4d, 0xff, 0xba, 0x8c, 0x2d, 0xff, 0xd4, 0xb2, 0x31, 0xff,
+			  0xb1, 0x4f, 0x36, 0xff, 0xba, 0x8c, 0x2d, 0xff, 0xee, 0xd6, 0x34, 0xff, 0xd2, 0x50, 0x06, 0xff } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 3",
+		  { 0x18, 0x6a, 0x6f, 0x9b, 0x39, 0x39, 0xc3, 0xde, 0x0e, 0x89, 0x63, 0x65, 0xea, 0x8c, 0x75, 0x43 },
+		  {
+			  0xb5, 0xc9, 0x87, 0xff, 0x9e, 0x97, 0x87, 0xff, 0x6e, 0x32, 0x88, 0xff, 0x9e, 0x97, 0x87, 0xff,
+			  0xad, 0xc2, 0xa5, 0xff, 0x70, 0xcd, 0xb6, 0xff, 0x36, 0xd8, 0xc6, 0xff, 0xe7, 0xb7, 0x95, 0xff,
+			  0x85, 0x64, 0x88, 0xff, 0x85, 0x64, 0x88, 0xff, 0x6e, 0x32, 0x88, 0xff, 0x85, 0x64, 0x88, 0xff,
+			  0x70, 0xcd, 0xb6, 0xff, 0x36, 0xd8, 0xc6, 0xff, 0xad, 0xc2, 0xa5, 0xff, 0x36, 0xd8, 0xc6, 0xff } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 3",
+		  { 0x78, 0x9a, 0x4b, 0x63, 0xb3, 0x11, 0x74, 0xf1, 0x1d, 0x8e, 0x23, 0x6b, 0xc5, 0xd8, 0xb8, 0xb9 },
+		  {
+			  0xa2, 0x74, 0x39, 0xff, 0xc7, 0x2f, 0x47, 0xff, 0x75, 0x59, 0x64, 0xff, 0xc9, 0x48, 0x68, 0xff,
+			  0xc7, 0x2f, 0x47, 0xff, 0x4a, 0x40, 0x8e, 0xff, 0xca, 0x63, 0x8b, 0xff, 0xa2, 0x74, 0x39, 0xff,
+			  0xc7, 0x2f, 0x47, 0xff, 0x4a, 0x40, 0x8e, 0xff, 0xc9, 0x48, 0x68, 0xff, 0x4a, 0x40, 0x8e, 0xff,
+			  0xcd, 0x8d, 0x0f, 0xff, 0xcc, 0x7c, 0xac, 0xff, 0xa2, 0x74, 0x39, 0xff, 0xc9, 0x48, 0x68, 0xff } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 4",
+		  { 0xb0, 0xe5, 0x5d, 0xd4, 0xc8, 0xd0, 0xea, 0x1d, 0x1e, 0x1a, 0x23, 0x6a, 0x9c, 0x55, 0x3c, 0x07 },
+		  {
+			  0x0c, 0xac, 0x61, 0x35, 0x44, 0x76, 0x40, 0x58, 0xb6, 0xbd, 0x6b, 0x29, 0xb6, 0x65, 0x36, 0x64,
+			  0x7e, 0x53, 0x2b, 0x6f, 0xb6, 0xbd, 0x6b, 0x29, 0x0c, 0x42, 0x21, 0x7b, 0x0c, 0x76, 0x40, 0x58,
+			  0xb6, 0x65, 0x36, 0x64, 0xb6, 0x9a, 0x56, 0x40, 0x0c, 0xac, 0x61, 0x35, 0x0c, 0x53, 0x2b, 0x6f,
+			  0x44, 0x89, 0x4c, 0x4c, 0xb6, 0x53, 0x2b, 0x6f, 0x0c, 0xac, 0x61, 0x35, 0x7e, 0xbd, 0x6b, 0x29 } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 4",
+		  { 0x90, 0x2a, 0xb5, 0x3c, 0xcf, 0x96, 0x2c, 0xa4, 0x4e, 0x56, 0xc0, 0x27, 0xd9, 0x11, 0xd0, 0x61 },
+		  {
+			  0x52, 0x6b, 0x9c, 0x55, 0x52, 0x6b, 0x9c, 0x55, 0x4a, 0xce, 0x39, 0x55, 0x4f, 0x95, 0x72, 0x6d,
+			  0x50, 0x87, 0x80, 0x3c, 0x50, 0x87, 0x80, 0x6d, 0x4b, 0xc0, 0x47, 0x55, 0x4b, 0xc0, 0x47, 0x55,
+			  0x51, 0x79, 0x8e, 0x24, 0x50, 0x87, 0x80, 0x55, 0x52, 0x6b, 0x9c, 0x3c, 0x52, 0x6b, 0x9c, 0x6d,
+			  0x4c, 0xb2, 0x55, 0x24, 0x4f, 0x95, 0x72, 0x3c, 0x52, 0x6b, 0x9c, 0x3c, 0x4f, 0x95, 0x72, 0x6d } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 4",
+		  { 0xb0, 0xc8, 0xd2, 0x4e, 0x8c, 0xcf, 0xec, 0x5f, 0x9c, 0xeb, 0x6c, 0x1f, 0x98, 0x02, 0xf1, 0xd7 },
+		  {
+			  0xb8, 0xba, 0x26, 0x62, 0xb8, 0xda, 0x2d, 0x95, 0x30, 0xda, 0x2d, 0x95, 0x30, 0xef, 0x31, 0xb5,
+			  0x30, 0xaf, 0x23, 0x52, 0x30, 0xa5, 0x21, 0x42, 0x73, 0xe5, 0x2f, 0xa5, 0xfb, 0xd0, 0x2a, 0x84,
+			  0x73, 0xba, 0x26, 0x62, 0x30, 0xa5, 0x21, 0x42, 0xfb, 0xd0, 0x2a, 0x84, 0x30, 0xa5, 0x21, 0x42,
+			  0xb8, 0xef, 0x31, 0xb5, 0xb8, 0xef, 0x31, 0xb5, 0x30, 0xda, 0x2d, 0x95, 0xb8, 0xe5, 0x2f, 0xa5 } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 5",
+		  { 0x20, 0x36, 0xcf, 0x8c, 0x0f, 0xf4, 0x91, 0xf5, 0x4d, 0xe5, 0xee, 0xb4, 0x39, 0x7d, 0x0d, 0x58 },
+		  {
+			  0x5c, 0x96, 0x7f, 0x64, 0x5c, 0x96, 0x7f, 0x75, 0x4c, 0xc9, 0x7e, 0x7d, 0x4c, 0xc9, 0x7e, 0x64,
+			  0x4c, 0xc9, 0x7e, 0x6c, 0x6c, 0x66, 0x81, 0x7d, 0x3c, 0xf9, 0x7c, 0x7d, 0x5c, 0x96, 0x7f, 0x6c,
+			  0x3c, 0xf9, 0x7c, 0x6c, 0x5c, 0x96, 0x7f, 0x7d, 0x3c, 0xf9, 0x7c, 0x64, 0x5c, 0x96, 0x7f, 0x64,
+			  0x4c, 0xc9, 0x7e, 0x64, 0x4c, 0xc9, 0x7e, 0x75, 0x5c, 0x96, 0x7f, 0x6c, 0x3c, 0xf9, 0x7c, 0x6c } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 5",
+		  { 0x60, 0x5e, 0xa9, 0x44, 0xd9, 0x99, 0x66, 0x94, 0x3f, 0x0e, 0x36, 0x61, 0x01, 0x28, 0x1d, 0x03 },
+		  {
+			  0x19, 0x49, 0x5e, 0xb5, 0x19, 0x95, 0xa7, 0xa5, 0x19, 0x49, 0x5e, 0xb5, 0x19, 0x24, 0x3a, 0xbd,
+			  0x19, 0x95, 0xa7, 0xa5, 0xa2, 0x49, 0x5e, 0xb5, 0xa2, 0x24, 0x3a, 0xbd, 0x19, 0x24, 0x3a, 0xbd,
+			  0x5c, 0x95, 0xa7, 0xa5, 0xe5, 0x70, 0x83, 0xad, 0x5c, 0x49, 0x5e, 0xb5, 0x19, 0x70, 0x83, 0xad,
+			  0xe5, 0x24, 0x3a, 0xbd, 0x19, 0x24, 0x3a, 0xbd, 0x19, 0x95, 0xa7, 0xa5, 0x19, 0x70, 0x83, 0xad } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 5",
+		  { 0xe0, 0x79, 0x9a, 0x6d, 0x17, 0x6e, 0x80, 0x00, 0x9b, 0x6c, 0x6e, 0x20, 0x6f, 0x2f, 0xc6, 0xbc },
+		  {
+			  0xf3, 0x6c, 0x55, 0xc3, 0x68, 0x76, 0xc0, 0x1a, 0xf3, 0x6c, 0x8c, 0xc3, 0xc5, 0x6f, 0x55, 0x8c,
+			  0x96, 0x73, 0xc0, 0x51, 0xc5, 0x6f, 0xc0, 0x8c, 0x68, 0x76, 0x8c, 0x1a, 0xf3, 0x6c, 0x20, 0xc3,
+			  0x68, 0x76, 0x8c, 0x1a, 0xc5, 0x6f, 0x55, 0x8c, 0x68, 0x76, 0x20, 0x1a, 0xf3, 0x6c, 0xc0, 0xc3,
+			  0xf3, 0x6c, 0x20, 0xc3, 0xf3, 0x6c, 0xc0, 0xc3, 0xc5, 0x6f, 0xc0, 0x8c, 0x96, 0x73, 0x8c, 0x51 } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 6",
+		  { 0xc0, 0x56, 0x4d, 0xd0, 0xe7, 0x49, 0x3f, 0x38, 0x83, 0xdd, 0xd6, 0x8f, 0x65, 0x4a, 0xb0, 0xc9 },
+		  {
+			  0x5b, 0x13, 0x7b, 0x41, 0x63, 0x87, 0x90, 0x59, 0x69, 0xd8, 0x9f, 0x6a, 0x69, 0xd8, 0x9f, 0x6a,
+			  0x61, 0x68, 0x8a, 0x53, 0x69, 0xd8, 0x9f, 0x6a, 0x6b, 0xfb, 0xa5, 0x71, 0x63, 0x87, 0x90, 0x59,
+			  0x60, 0x55, 0x87, 0x4f, 0x61, 0x68, 0x8a, 0x53, 0x65, 0xaa, 0x96, 0x60, 0x5f, 0x46, 0x84, 0x4c,
+			  0x5a, 0x04, 0x78, 0x3e, 0x66, 0xb9, 0x99, 0x63, 0x64, 0x97, 0x93, 0x5c, 0x68, 0xc9, 0x9c, 0x67 } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 6",
+		  { 0x40, 0xd7, 0x34, 0x4d, 0x22, 0x6a, 0xd5, 0xd0, 0x6c, 0x92, 0x71, 0x16, 0xd4, 0x96, 0xa5, 0x76 },
+		  {
+			  0x7b, 0x9b, 0x9a, 0xbf, 0x7b, 0x9b, 0x9a, 0xbf, 0x67, 0xbf, 0x8f, 0xce, 0x88, 0x80, 0xa3, 0xb6,
+			  0x62, 0xca, 0x8c, 0xd2, 0x7f, 0x92, 0x9d, 0xbc, 0x7b, 0x9b, 0x9a, 0xbf, 0x62, 0xca, 0x8c, 0xd2,
+			  0x70, 0xae, 0x94, 0xc7, 0x9c, 0x5c, 0xae, 0xa7, 0x7b, 0x9b, 0x9a, 0xbf, 0x88, 0x80, 0xa3, 0xb6,
+			  0x75, 0xa5, 0x97, 0xc4, 0x8e, 0x76, 0xa6, 0xb1, 0x7b, 0x9b, 0x9a, 0xbf, 0x7f, 0x92, 0x9d, 0xbc } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 6",
+		  { 0x40, 0x89, 0xa6, 0xbf, 0xce, 0xce, 0x26, 0xf5, 0xd4, 0x64, 0xf8, 0xab, 0xd7, 0x6e, 0x53, 0x0d },
+		  {
+			  0x27, 0xf6, 0xa8, 0x42, 0x32, 0xdb, 0x71, 0xcf, 0x29, 0xf1, 0x9f, 0x5b, 0x2b, 0xec, 0x94, 0x76,
+			  0x2d, 0xe7, 0x8a, 0x8f, 0x34, 0xd6, 0x66, 0xea, 0x30, 0xe0, 0x7a, 0xb6, 0x2f, 0xe2, 0x7f, 0xaa,
+			  0x2c, 0xea, 0x8f, 0x82, 0x32, 0xdb, 0x71, 0xcf, 0x33, 0xd8, 0x6b, 0xde, 0x2b, 0xec, 0x94, 0x76,
+			  0x28, 0xf3, 0xa3, 0x4f, 0x2a, 0xef, 0x9a, 0x67, 0x32, 0xdb, 0x71, 0xcf, 0x25, 0xfb, 0xb3, 0x27 } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 7",
+		  { 0x80, 0x29, 0x3a, 0x9f, 0xfd, 0x96, 0x71, 0x33, 0x83, 0x43, 0x81, 0x79, 0x4f, 0xd3, 0xbd, 0x3c },
+		  {
+			  0x41, 0xce, 0x59, 0x5f, 0x41, 0xce, 0x59, 0x5f, 0x3c, 0x9a, 0x44, 0x37, 0x98, 0xca, 0xa4, 0xdd,
+			  0x41, 0xce, 0x59, 0x5f, 0x3c, 0x9a, 0x44, 0x37, 0x98, 0xca, 0xa4, 0xdd, 0x65, 0xc7, 0xe7, 0xe7,
+			  0xff, 0xcf, 0x1c, 0xc7, 0x65, 0xc7, 0xe7, 0xe7, 0x38, 0x69, 0x30, 0x10, 0x3c, 0x9a, 0x44, 0x37,
+			  0xff, 0xcf, 0x1c, 0xc7, 0x38, 0x69, 0x30, 0x10, 0x38, 0x69, 0x30, 0x10, 0x45, 0xff, 0x6d, 0x86 } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 7",
+		  { 0x80, 0x7f, 0x90, 0x0f, 0x55, 0xf8, 0x65, 0xad, 0x9a, 0x83, 0x44, 0xfb, 0x29, 0x7f, 0xd3, 0x26 },
+		  {
+			  0x0c, 0xae, 0xae, 0x04, 0x69, 0xdb, 0xdb, 0xbd, 0x39, 0xa1, 0xae, 0x1c, 0x69, 0x93, 0xae, 0x35,
+			  0x96, 0x86, 0xae, 0x4d, 0x41, 0x92, 0xe3, 0xeb, 0x96, 0x86, 0xae, 0x4d, 0x69, 0x93, 0xae, 0x35,
+			  0x39, 0xa1, 0xae, 0x1c, 0x55, 0xb6, 0xdf, 0xd4, 0x55, 0xb6, 0xdf, 0xd4, 0x69, 0xdb, 0xdb, 0xbd,
+			  0x96, 0x86, 0xae, 0x4d, 0x7d, 0xff, 0xd7, 0xa6, 0x69, 0xdb, 0xdb, 0xbd, 0x7d, 0xff, 0xd7, 0xa6 } },
+		{ DXGI_FORMAT_BC7_UNORM, "mode 7",
+		  { 0x80, 0xd8, 0x4d, 0xa9, 0x59, 0xb0, 0x8a, 0xfd, 0xd7, 0x89, 0x91, 0x63, 0xcf, 0xb1, 0xf2, 0x5d },
+		  {
+			  0x98, 0x7a, 0xcd, 0x15, 0x98, 0x7a, 0xcd, 0x15, 0x4d, 0x5d, 0xbe, 0xcf, 0x6d, 0x2c, 0x75, 0x8e,
+			  0x98, 0x7a, 0xcd, 0x15, 0xbe, 0xb6, 0xb6, 0x14, 0x49, 0x00, 0xfb, 0x18, 0x63, 0x3c, 0x8d, 0xa3,
+			  0x6f, 0x3c, 0xe4, 0x17, 0xbe, 0xb6, 0xb6, 0x14, 0x49, 0x00, 0xfb, 0x18, 0x6d, 0x2c, 0x75, 0x8e,
+			  0x98, 0x7a, 0xcd, 0x15, 0x49, 0x00, 0xfb, 0x18, 0x98, 0x7a, 0xcd, 0x15, 0x98, 0x7a, 0xcd, 0x15 } },
+	};
+
+	// the texel channels our decode of the reference blocks of format puts further than tolerance from
+	// the reference, each printed with the block it is in. tested counts the blocks
+	int CountMismatches(const DXGI_FORMAT format, const int tolerance, int& tested)
+	{
+		int mismatches = 0;
+		tested = 0;
+
+		for (const ReferenceBlock& reference : kReferenceBlocks)
+		{
+			if (reference.format != format)
+				continue;
+
+			uint8_t rgba[64];
+			BlockDecoder::DecodeBlock(format, reference.block, rgba);
+
+			for (int i = 0; i < 64; ++i)
+			{
+				if (std::abs(int(rgba[i]) - int(reference.rgba[i])) > tolerance)
+				{
+					std::printf("  %s: texel %d channel %d is %d, expected %d\n", reference.description, i / 4, i % 4, rgba[i], reference.rgba[i]);
+					++mismatches;
+				}
+			}
+
+			++tested;
+		}
+
+		return mismatches;
+	}
+}
+
+// BC1 to BC5 interpolate endpoints in a precision the API leaves to the hardware, the reference
+// truncates where we round, so those may be one off. BC7 interpolation is exact integer math
+
+UNIT_TEST(BlockDecoderBC1)
+{
+	int tested = 0;
+	CHECK(CountMismatches(DXGI_FORMAT_BC1_UNORM, 1, tested) == 0);
+	CHECK(tested == 5);
+}
+
+UNIT_TEST(BlockDecoderBC2)
+{
+	int tested = 0;
+	CHECK(CountMismatches(DXGI_FORMAT_BC2_UNORM, 1, tested) == 0);
+	CHECK(tested == 3);
+}
+
+UNIT_TEST(BlockDecoderBC3)
+{
+	int tested = 0;
+	CHECK(CountMismatches(DXGI_FORMAT_BC3_UNORM, 1, tested) == 0);
+	CHECK(tested == 3);
+}
+
+UNIT_TEST(BlockDecoderBC4)
+{
+	int tested = 0;
+	CHECK(CountMismatches(DXGI_FORMAT_BC4_UNORM, 1, tested) == 0);
+	CHECK(tested == 3);
+}
+
+UNIT_TEST(BlockDecoderBC5)
+{
+	int tested = 0;
+	CHECK(CountMismatches(DXGI_FORMAT_BC5_UNORM, 1, tested) == 0);
+	CHECK(tested == 2);
+}
+
+UNIT_TEST(BlockDecoderBC7)
+{
+	int tested = 0;
+	CHECK(CountMismatches(DXGI_FORMAT_BC7_UNORM, 0, tested) == 0);
+	CHECK(tested == 24);
+}
\ No newline at end of file
@@ -0,0 +1,372 @@
+#include "CPUProfiler.h"
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <tuple>
+
+#if defined(_M_X64) || defined(__x86_64__)
+#define CPU_PROFILER_RDTSC 1
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <x86intrin.h>
+#endif
+#else
+#define CPU_PROFILER_RDTSC 0
+#endif
+
+namespace
+{
+	constexpr uint32_t kCapacity = 1 << 14; // events per thread, a power of two
+
+	// single producer, its thread, and single consumer, EndFrame
+	struct ThreadBuffer
+	{
+		std::unique_ptr<CPUProfiler::Event[]> events = std::make_unique<CPUProfiler::Event[]>(kCapacity);
+		std::atomic<uint32_t> write = 0;
+		std::atomic<uint32_t> read = 0;
+		std::atomic<std::size_t> droppedEvents = 0;
+		std::atomic<bool> isRetired = false; // the thread exited, recycled once drained
+		uint32_t id = 0;
+		uint32_t depth = 0; // only touched by the owning thread
+
+		// free events the owning thread knows of; EndFrame only ever adds room, so read is loaded again
+		// once these are used up rather than on every scope
+		uint32_t room = 0;
+	};
+
+	struct Registry
+	{
+		std::mutex mutex; // guards the lists, not the rings
+		std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+		std::vector<ThreadBuffer*> freeBuffers;
+
+		std::vector<CPUProfiler::Event> events;
+		std::vector<CPUProfiler::Node> tree;
+		CPUProfiler::Stats stats;
+	};
+
+	Registry& GetRegistry()
+	{
+		static Registry registry;
+		return registry;
+	}
+
+	// hands the ring back when the thread exits, so threads that come and go don't pile up rings
+	struct ThreadOwner
+	{
+		ThreadBuffer* buffer = nullptr;
+
+		~ThreadOwner()
+		{
+			if (buffer)
+			{
+				buffer->isRetired.store(true, std::memory_order_release);
+			}
+		}
+	};
+
+	thread_local ThreadOwner tOwner;
+
+	// the same ring as tOwner's, a trivial thread_local is read without the guard of one with a destructor
+	thread_local ThreadBuffer* tBuffer = nullptr;
+
+	ThreadBuffer& GetThreadBuffer()
+	{
+		if (!tBuffer)
+		{
+			Registry& registry = GetRegistry();
+			std::lock_guard lock(registry.mutex);
+
+			if (registry.freeBuffers.empty())
+			{
+				registry.buffers.push_back(std::make_unique<ThreadBuffer>());
+				registry.buffers.back()->id = uint32_t(registry.buffers.size() - 1);
+				registry.freeBuffers.push_back(registry.buffers.back().get());
+			}
+
+			tOwner.buffer = registry.freeBuffers.back();
+			tBuffer = tOwner.buffer;
+			registry.freeBuffers.pop_back();
+		}
+
+		return *tBuffer;
+	}
+
+	void Drain(ThreadBuffer& buffer, std::vector<CPUProfiler::Event>& events)
+	{
+		const uint32_t read = buffer.read.load(std::memory_order_relaxed);
+		const uint32_t write = buffer.write.load(std::memory_order_acquire);
+
+		for (uint32_t i = read; i != write; ++i)
+		{
+			events.push_back(buffer.events[i & (kCapacity - 1)]);
+		}
+
+		buffer.read.store(write, std::memory_order_release);
+	}
+
+	// scopes are merged by name under their parent, nodes keep their children in first seen order
+	struct TreeNode
+	{
+		CPUProfiler::Node node;
+		double childMs = 0.0;
+		std::vector<uint32_t> children;
+	};
+
+	constexpr uint32_t kNoParent = ~0u;
+
+	// children is roots when there's no parent, which hold the roots of every thread; it's looked up again
+	// after the push that can move the nodes
+	uint32_t FindOrAddChild(std::vector<TreeNode>& nodes, std::vector<uint32_t>& roots, const uint32_t parent, const CPUProfiler::Event& event, const uint32_t depth)
+	{
+		for (const uint32_t child : (parent == kNoParent) ? roots : nodes[parent].children)
+		{
+			// the same literal can have a different address in every translation unit
+			if ((nodes[child].node.thread == event.thread) &&
+				((nodes[child].node.name == event.name) || (std::strcmp(nodes[child].node.name, event.name) == 0)))
+			{
+				return child;
+			}
+		}
+
+		TreeNode node;
+		node.node.name = event.name;
+		node.node.depth = depth;
+		node.node.thread = event.thread;
+
+		nodes.push_back(node);
+		((parent == kNoParent) ? roots : nodes[parent].children).push_back(uint32_t(nodes.size() - 1));
+
+		return uint32_t(nodes.size() - 1);
+	}
+
+	void AppendDepthFirst(const std::vector<TreeNode>& nodes, const uint32_t node, std::vector<CPUProfiler::Node>& tree)
+	{
+		tree.push_back(nodes[node].node);
+		tree.back().selfMs = std::max(0.0, nodes[node].node.totalMs - nodes[node].childMs);
+
+		for (const uint32_t child : nodes[node].children)
+		{
+			AppendDepthFirst(nodes, child, tree);
+		}
+	}
+}
+
+uint64_t CPUProfiler::Scope::Begin()
+{
+	++GetThreadBuffer().depth;
+	return GetTicks();
+}
+
+CPUProfiler::Scope::~Scope()
+{
+	const uint64_t end = GetTicks();
+
+	ThreadBuffer& buffer = *tBuffer;
+	const uint32_t depth = --buffer.depth;
+
+	const uint32_t write = buffer.write.load(std::memory_order_relaxed);
+
+	if (buffer.room == 0)
+	{
+		buffer.room = kCapacity - (write - buffer.read.load(std::memory_order_acquire));
+
+		if (buffer.room == 0)
+		{
+			buffer.droppedEvents.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+	}
+
+	--buffer.room;
+
+	CPUProfiler::Event& event = buffer.events[write & (kCapacity - 1)];
+	event.name = mName;
+	event.begin = mBegin;
+	event.end = end;
+	event.depth = depth;
+	event.thread = buffer.id;
+
+	buffer.write.store(write + 1, std::memory_order_release);
+}
+
+uint64_t CPUProfiler::GetTicks()
+{
+#if CPU_PROFILER_RDTSC
+	return __rdtsc();
+#else
+	return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+double CPUProfiler::GetTicksPerSecond()
+{
+#if CPU_PROFILER_RDTSC
+	using Clock = std::chrono::steady_clock;
+
+	// the counter is compared to steady_clock over the time since the first call, which gets more
+	// precise the longer it runs; after a second it's good enough to keep
+	static const uint64_t startTicks = GetTicks();
+	static const Clock::time_point startTime = Clock::now();
+	static std::atomic<double> cachedTicksPerSecond = 0.0;
+
+	if (const double ticksPerSecond = cachedTicksPerSecond.load(std::memory_order_relaxed); ticksPerSecond > 0.0)
+	{
+		return ticksPerSecond;
+	}
+
+	double seconds = 0.0;
+	uint64_t ticks = 0;
+
+	do
+	{
+		ticks = GetTicks();
+		seconds = std::chrono::duration<double>(Clock::now() - startTime).count();
+	}
+	while (seconds < 0.001);
+
+	const double ticksPerSecond = double(ticks - startTicks) / seconds;
+
+	if (seconds >= 1.0)
+	{
+		cachedTicksPerSecond.store(ticksPerSecond, std::memory_order_relaxed);
+	}
+
+	return ticksPerSecond;
+#else
+	return 1e9;
+#endif
+}
+
+void CPUProfiler::EndFrame()
+{
+	Registry& registry = GetRegistry();
+	std::lock_guard lock(registry.mutex);
+
+	registry.events.clear();
+	registry.stats.droppedEvents = 0;
+
+	for (const std::unique_ptr<ThreadBuffer>& buffer : registry.buffers)
+	{
+		// read the flag first, everything the thread recorded is visible once it's set
+		const bool isRetired = buffer->isRetired.load(std::memory_order_acquire);
+
+		Drain(*buffer, registry.events);
+
+		if (isRetired)
+		{
+			buffer->isRetired.store(false, std::memory_order_relaxed);
+			buffer->depth = 0;
+			registry.freeBuffers.push_back(buffer.get());
+		}
+
+		registry.stats.droppedEvents += buffer->droppedEvents.load(std::memory_order_relaxed);
+	}
+
+	registry.stats.eventCount += registry.events.size();
+	registry.stats.threadCount = registry.buffers.size();
+
+	// a parent begins before its children, and at the same tick it is the shallower one
+	std::sort(registry.events.begin(), registry.events.end(), [](const Event& a, const Event& b)
+	{
+		return std::tie(a.thread, a.begin, a.depth) < std::tie(b.thread, b.begin, b.depth);
+	});
+
+	std::vector<TreeNode> nodes;
+	std::vector<uint32_t> roots;
+
+	// the scopes enclosing the current one, the parents that are still open don't show up this frame
+	struct Open
+	{
+		uint32_t node;
+		uint64_t end;
+	};
+
+	std::vector<Open> open;
+	const double msPerTick = TicksToMs(1);
+
+	for (std::size_t i = 0; i < registry.events.size(); ++i)
+	{
+		const Event& event = registry.events[i];
+
+		if ((i == 0) || (registry.events[i - 1].thread != event.thread))
+		{
+			open.clear();
+		}
+
+		while (!open.empty() && (open.back().end < event.end))
+		{
+			open.pop_back();
+		}
+
+		const uint32_t depth = uint32_t(open.size());
+		const uint32_t node = FindOrAddChild(nodes, roots, open.empty() ? kNoParent : open.back().node, event, depth);
+		const double ms = double(event.end - event.begin) * msPerTick;
+
+		nodes[node].node.callCount += 1;
+		nodes[node].node.totalMs += ms;
+
+		if (!open.empty())
+		{
+			nodes[open.back().node].childMs += ms;
+		}
+
+		open.push_back({ node, event.end });
+	}
+
+	registry.tree.clear();
+
+	for (const uint32_t root : roots)
+	{
+		AppendDepthFirst(nodes, root, registry.tree);
+	}
+}
+
+const std::vector<CPUProfiler::Node>& CPUProfiler::GetFrameTree()
+{
+	return GetRegistry().tree;
+}
+
+const std::vector<CPUProfiler::Event>& CPUProfiler::GetFrameEvents()
+{
+	return GetRegistry().events;
+}
+
+const CPUProfiler::Stats& CPUProfiler::GetStats()
+{
+	return GetRegistry().stats;
+}
+
+double CPUProfiler::MeasureScopeOverheadNs(const std::size_t iterations)
+{
+	ThreadBuffer& buffer = GetThreadBuffer();
+
+	const uint32_t write = buffer.write.load(std::memory_order_relaxed);
+	const bool isEmpty = (buffer.read.load(std::memory_order_acquire) == write);
+
+	// past the free room the scopes are dropped, which is cheaper and would flatter the result
+	const std::size_t count = std::min<std::size_t>(iterations, kCapacity - (write - buffer.read.load(std::memory_order_acquire)));
+
+	const auto start = std::chrono::steady_clock::now();
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		Scope scope("scope overhead");
+	}
+
+	const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	// nothing else was waiting in the ring, so the measurement can be thrown away without losing any
+	if (isEmpty)
+	{
+		buffer.read.store(buffer.write.load(std::memory_order_relaxed), std::memory_order_release);
+	}
+
+	return count ? 1e9 * seconds / double(count) : 0.0;
+}
\ No newline at end of file
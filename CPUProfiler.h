@@ -0,0 +1,94 @@
+#pragma once
+
+// std
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// cpu timings of nested scopes on any thread. a scope is recorded when it ends, into a ring owned by its
+// thread that only that thread writes and only EndFrame reads, so recording takes no lock. EndFrame
+// collects what finished since the previous frame and builds a call tree per thread.
+// a scope costs a counter read at either end and a 32 byte ring write, the CPUProfilerScope micro
+// benchmark reports both
+class CPUProfiler
+{
+public:
+
+	// a finished scope, the times are in GetTicks units
+	struct Event
+	{
+		const char* name = nullptr;
+		uint64_t begin = 0;
+		uint64_t end = 0;
+		uint32_t depth = 0;  // scopes open on the thread when it began
+		uint32_t thread = 0; // the id of the ring, reused once a thread exits
+	};
+
+	// scopes of the same name under the same parent are merged
+	struct Node
+	{
+		const char* name = nullptr;
+		uint32_t depth = 0;
+		uint32_t thread = 0;
+		uint32_t callCount = 0;
+		double totalMs = 0.0;
+		double selfMs = 0.0; // totalMs minus that of the children
+	};
+
+	struct Stats
+	{
+		std::size_t eventCount = 0;    // totals since the start
+		std::size_t droppedEvents = 0; // the ring of the thread was full
+		std::size_t threadCount = 0;   // rings, busy or waiting to be reused
+	};
+
+	// names are string literals, only the pointer is kept
+	class Scope
+	{
+	public:
+
+		template<std::size_t N>
+		explicit Scope(const char (&name)[N]) :
+			mName(name),
+			mBegin(Begin())
+		{
+		}
+
+		~Scope();
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+
+		static uint64_t Begin();
+
+		const char* mName;
+		uint64_t mBegin;
+	};
+
+	// the cycle counter where there is one, steady_clock elsewhere
+	static uint64_t GetTicks();
+	static double GetTicksPerSecond();
+
+	static double TicksToMs(const uint64_t ticks)
+	{
+		return 1000.0 * double(ticks) / GetTicksPerSecond();
+	}
+
+	// collect the scopes that finished since the last call and build their tree; call from one thread,
+	// once a frame
+	static void EndFrame();
+
+	// the threads one after the other, each in depth first order with parents before their children
+	static const std::vector<Node>& GetFrameTree();
+
+	// what EndFrame collected, in the order the scopes began on each thread
+	static const std::vector<Event>& GetFrameEvents();
+
+	static const Stats& GetStats();
+
+	// average cost of an empty scope on the calling thread, its events are discarded; call between frames
+	// from the thread that calls EndFrame
+	static double MeasureScopeOverheadNs(const std::size_t iterations = 4096);
+};
\ No newline at end of file
@@ -0,0 +1,187 @@
+#include "UnitTest.h"
+
+// std
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "CPUProfiler.h"
+
+// the rings and the trees EndFrame builds out of them, on the calling thread and on short lived threads
+
+namespace
+{
+	// the events of the frame named name
+	std::vector<CPUProfiler::Event> FindEvents(const char* name)
+	{
+		std::vector<CPUProfiler::Event> events;
+
+		for (const CPUProfiler::Event& event : CPUProfiler::GetFrameEvents())
+		{
+			if (std::strcmp(event.name, name) == 0)
+			{
+				events.push_back(event);
+			}
+		}
+
+		return events;
+	}
+
+	// the nodes of the frame tree on thread
+	std::vector<CPUProfiler::Node> GetThreadTree(const uint32_t thread)
+	{
+		std::vector<CPUProfiler::Node> nodes;
+
+		for (const CPUProfiler::Node& node : CPUProfiler::GetFrameTree())
+		{
+			if (node.thread == thread)
+			{
+				nodes.push_back(node);
+			}
+		}
+
+		return nodes;
+	}
+}
+
+UNIT_TEST(CPUProfilerTree)
+{
+	CPUProfiler::EndFrame();
+
+	// a literal with the same text at another address merges with "draw"
+	static const char kDraw[] = "draw";
+
+	{
+		CPUProfiler::Scope frame("frame");
+
+		{
+			CPUProfiler::Scope update("update");
+		}
+
+		{
+			CPUProfiler::Scope draw("draw");
+			CPUProfiler::Scope submit("submit");
+		}
+
+		{
+			CPUProfiler::Scope draw(kDraw);
+		}
+	}
+
+	CPUProfiler::EndFrame();
+
+	CHECK(CPUProfiler::GetFrameEvents().size() == 5);
+
+	const std::vector<CPUProfiler::Event> frameEvents = FindEvents("frame");
+	CHECK(frameEvents.size() == 1);
+
+	if (frameEvents.size() != 1)
+	{
+		return;
+	}
+
+	// depth first, parents before their children, siblings in the order they were first seen
+	const std::vector<CPUProfiler::Node> tree = GetThreadTree(frameEvents[0].thread);
+
+	CHECK(tree.size() == 4);
+
+	if (tree.size() != 4)
+	{
+		return;
+	}
+
+	CHECK((std::strcmp(tree[0].name, "frame") == 0) && (tree[0].depth == 0) && (tree[0].callCount == 1));
+	CHECK((std::strcmp(tree[1].name, "update") == 0) && (tree[1].depth == 1) && (tree[1].callCount == 1));
+	CHECK((std::strcmp(tree[2].name, "draw") == 0) && (tree[2].depth == 1) && (tree[2].callCount == 2));
+	CHECK((std::strcmp(tree[3].name, "submit") == 0) && (tree[3].depth == 2) && (tree[3].callCount == 1));
+
+	// the time of a parent is its own plus that of its children
+	CHECK(tree[0].totalMs >= tree[1].totalMs + tree[2].totalMs);
+	CHECK_NEAR(tree[0].selfMs, tree[0].totalMs - tree[1].totalMs - tree[2].totalMs, 1e-9);
+	CHECK_NEAR(tree[2].selfMs, tree[2].totalMs - tree[3].totalMs, 1e-9);
+
+	// drained, the next frame starts empty
+	CPUProfiler::EndFrame();
+
+	CHECK(CPUProfiler::GetFrameEvents().empty());
+}
+
+// a full ring drops what doesn't fit until EndFrame drains it, and counts it
+UNIT_TEST(CPUProfilerRingFull)
+{
+	CPUProfiler::EndFrame();
+
+	const std::size_t droppedEvents = CPUProfiler::GetStats().droppedEvents;
+	const std::size_t count = 100000;
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		CPUProfiler::Scope scope("ring");
+	}
+
+	CPUProfiler::EndFrame();
+
+	const std::size_t recorded = FindEvents("ring").size();
+	const std::size_t dropped = CPUProfiler::GetStats().droppedEvents - droppedEvents;
+
+	CHECK((recorded > 0) && (recorded < count));
+	CHECK(recorded + dropped == count);
+
+	for (std::size_t i = 0; i < 10; ++i)
+	{
+		CPUProfiler::Scope scope("ring");
+	}
+
+	CPUProfiler::EndFrame();
+
+	CHECK(FindEvents("ring").size() == 10);
+	CHECK(CPUProfiler::GetStats().droppedEvents - droppedEvents == dropped);
+}
+
+// the scopes of a thread that exited are still collected, then its ring goes to the next thread
+UNIT_TEST(CPUProfilerThreadRecycling)
+{
+	CPUProfiler::EndFrame();
+
+	std::vector<uint32_t> threads;
+	std::size_t threadCount = 0;
+
+	for (int i = 0; i < 8; ++i)
+	{
+		std::thread thread([]()
+		{
+			CPUProfiler::Scope outer("worker");
+			CPUProfiler::Scope inner("job");
+		});
+
+		thread.join();
+
+		CPUProfiler::EndFrame();
+
+		const std::vector<CPUProfiler::Event> events = FindEvents("worker");
+
+		CHECK((events.size() == 1) && (FindEvents("job").size() == 1));
+
+		if (events.size() != 1)
+		{
+			return;
+		}
+
+		// the ring starts over at depth 0 and builds the same tree
+		const std::vector<CPUProfiler::Node> tree = GetThreadTree(events[0].thread);
+		CHECK((tree.size() == 2) && (tree[0].depth == 0) && (tree[1].depth == 1));
+
+		threads.push_back(events[0].thread);
+
+		if (i == 0)
+		{
+			threadCount = CPUProfiler::GetStats().threadCount;
+		}
+	}
+
+	// one thread at a time, they all got the first one's ring
+	CHECK(std::all_of(threads.begin(), threads.end(), [&](const uint32_t thread) { return thread == threads[0]; }));
+	CHECK(CPUProfiler::GetStats().threadCount == threadCount);
+}
\ No newline at end of file
@@ -0,0 +1,209 @@
+#include "CameraPath.h"
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <fstream>
+#include <sstream>
+
+void CameraPath::AddKey(const Key& key)
+{
+	assert(mKeys.empty() || (key.time >= mKeys.back().time));
+
+	mKeys.push_back(key);
+
+	// q and -q are the same rotation, keep neighbours in one hemisphere so the slerp takes the short way
+	if (mKeys.size() > 1)
+	{
+		const XMVECTOR previous = XMLoadFloat4(&mKeys[mKeys.size() - 2].orientation);
+		const XMVECTOR current = XMLoadFloat4(&mKeys.back().orientation);
+
+		if (XMVectorGetX(XMQuaternionDot(previous, current)) < 0.0f)
+		{
+			XMStoreFloat4(&mKeys.back().orientation, XMVectorNegate(current));
+		}
+	}
+}
+
+CameraPath::Key CameraPath::Sample(const double time) const
+{
+	assert(!mKeys.empty());
+
+	if (time <= mKeys.front().time)
+	{
+		return mKeys.front();
+	}
+
+	if (time >= mKeys.back().time)
+	{
+		return mKeys.back();
+	}
+
+	// the segment [i1, i2] holding time, its neighbours clamped at the ends
+	const auto it = std::upper_bound(mKeys.begin(), mKeys.end(), time, [](const double t, const Key& key) { return t < key.time; });
+
+	const std::size_t i2 = std::size_t(it - mKeys.begin());
+	const std::size_t i1 = i2 - 1;
+	const std::size_t i0 = (i1 > 0) ? i1 - 1 : i1;
+	const std::size_t i3 = std::min(i2 + 1, mKeys.size() - 1);
+
+	const double length = mKeys[i2].time - mKeys[i1].time;
+	const float t = (length > 0.0) ? float((time - mKeys[i1].time) / length) : 0.0f;
+
+	Key key;
+	key.time = time;
+
+	XMStoreFloat3(&key.position, XMVectorCatmullRom(XMLoadFloat3(&mKeys[i0].position),
+													XMLoadFloat3(&mKeys[i1].position),
+													XMLoadFloat3(&mKeys[i2].position),
+													XMLoadFloat3(&mKeys[i3].position),
+													t));
+
+	XMStoreFloat4(&key.orientation, XMQuaternionSlerp(XMLoadFloat4(&mKeys[i1].orientation), XMLoadFloat4(&mKeys[i2].orientation), t));
+
+	return key;
+}
+
+CameraPath::Key CameraPath::GetCameraKey(const Camera& camera, const double time)
+{
+	// the basis vectors are the rows of the camera's world rotation
+	XMMATRIX R = XMMatrixIdentity();
+	R.r[0] = camera.GetRightV();
+	R.r[1] = camera.GetUpV();
+	R.r[2] = camera.GetLookV();
+
+	Key key;
+	key.time = time;
+	key.position = camera.GetPositionF();
+	XMStoreFloat4(&key.orientation, XMQuaternionNormalize(XMQuaternionRotationMatrix(R)));
+
+	return key;
+}
+
+void CameraPath::SetCamera(const Key& key, Camera& camera)
+{
+	const XMMATRIX R = XMMatrixRotationQuaternion(XMQuaternionNormalize(XMLoadFloat4(&key.orientation)));
+	const XMVECTOR P = XMLoadFloat3(&key.position);
+
+	// LookAt orthonormalizes the basis again
+	camera.LookAt(P, XMVectorAdd(P, R.r[2]), R.r[1]);
+}
+
+bool CameraPath::Write(const std::string& path) const
+{
+	std::ofstream stream(path);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	stream.precision(9);
+
+	for (const Key& key : mKeys)
+	{
+		stream << key.time << '\t'
+			   << key.position.x << '\t' << key.position.y << '\t' << key.position.z << '\t'
+			   << key.orientation.x << '\t' << key.orientation.y << '\t' << key.orientation.z << '\t' << key.orientation.w << '\n';
+	}
+
+	return bool(stream);
+}
+
+bool CameraPath::Read(const std::string& path)
+{
+	std::ifstream stream(path);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	mKeys.clear();
+
+	std::string line;
+
+	while (std::getline(stream, line))
+	{
+		std::istringstream iss(line);
+
+		Key key;
+
+		if (iss >> key.time
+				>> key.position.x >> key.position.y >> key.position.z
+				>> key.orientation.x >> key.orientation.y >> key.orientation.z >> key.orientation.w)
+		{
+			if (!mKeys.empty() && (key.time < mKeys.back().time))
+			{
+				mKeys.clear();
+				return false;
+			}
+
+			AddKey(key);
+		}
+	}
+
+	return true;
+}
+
+void CameraPathRecorder::Start(const double interval)
+{
+	mPath.Clear();
+	mInterval = interval;
+	mIsRecording = true;
+}
+
+void CameraPathRecorder::Record(const double time, const Camera& camera)
+{
+	if (!mIsRecording)
+	{
+		return;
+	}
+
+	if (mPath.IsEmpty())
+	{
+		mStartTime = time;
+	}
+	else if ((time - mLastKeyTime) < mInterval)
+	{
+		return;
+	}
+
+	mLastKeyTime = time;
+	mPath.AddKey(CameraPath::GetCameraKey(camera, time - mStartTime));
+}
+
+void CameraPathPlayer::Start(const CameraPath& path, const double stepSeconds)
+{
+	assert(!path.IsEmpty() && (stepSeconds > 0.0));
+
+	mPath = path;
+	mStepSeconds = stepSeconds;
+	mStepCount = 0;
+	mIsPlaying = true;
+}
+
+void CameraPathPlayer::Step()
+{
+	if (!mIsPlaying)
+	{
+		return;
+	}
+
+	++mStepCount;
+
+	if (GetTime() >= mPath.GetEndTime())
+	{
+		mIsPlaying = false;
+	}
+}
+
+void CameraPathPlayer::Apply(Camera& camera, const double alpha) const
+{
+	if (mPath.IsEmpty())
+	{
+		return;
+	}
+
+	CameraPath::SetCamera(mPath.Sample(GetTime() + alpha * mStepSeconds), camera);
+}
\ No newline at end of file
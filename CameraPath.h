@@ -0,0 +1,108 @@
+#pragma once
+
+// std
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// d3d
+#include <directxmath.h>
+using namespace DirectX;
+
+//
+#include "Camera.h"
+
+// camera position and orientation keyed to time, the positions are played back along a catmull-rom
+// spline through the keys and the orientations slerped between them
+class CameraPath
+{
+public:
+
+	struct Key
+	{
+		double time = 0.0;
+		XMFLOAT3 position = { 0.0f, 0.0f, 0.0f };
+		XMFLOAT4 orientation = { 0.0f, 0.0f, 0.0f, 1.0f }; // of the camera's right/up/look basis
+	};
+
+	// keys come in time order
+	void AddKey(const Key& key);
+
+	void Clear() { mKeys.clear(); }
+
+	bool IsEmpty() const { return mKeys.empty(); }
+	std::size_t GetKeyCount() const { return mKeys.size(); }
+	const std::vector<Key>& GetKeys() const { return mKeys; }
+
+	double GetStartTime() const { return mKeys.empty() ? 0.0 : mKeys.front().time; }
+	double GetEndTime() const { return mKeys.empty() ? 0.0 : mKeys.back().time; }
+
+	// clamped to the first and the last key
+	Key Sample(const double time) const;
+
+	static Key GetCameraKey(const Camera& camera, const double time);
+	static void SetCamera(const Key& key, Camera& camera);
+
+	// a line per key, its time, position xyz and orientation xyzw separated by tabs
+	bool Write(const std::string& path) const;
+	bool Read(const std::string& path);
+
+private:
+
+	std::vector<Key> mKeys;
+};
+
+// keys from the camera as it moves, at most one per interval of the time it's given
+class CameraPathRecorder
+{
+public:
+
+	// the path starts at the time of the first Record
+	void Start(const double interval);
+	void Stop() { mIsRecording = false; }
+
+	bool IsRecording() const { return mIsRecording; }
+
+	// once a frame, after the camera moved; nothing while not recording
+	void Record(const double time, const Camera& camera);
+
+	const CameraPath& GetPath() const { return mPath; }
+
+private:
+
+	CameraPath mPath;
+
+	double mInterval = 0.0;
+	double mStartTime = 0.0;
+	double mLastKeyTime = 0.0;
+	bool mIsRecording = false;
+};
+
+// plays a path back in fixed steps, its time is the step count times the step so runs land on the
+// same poses however the frames are timed
+class CameraPathPlayer
+{
+public:
+
+	void Start(const CameraPath& path, const double stepSeconds);
+	void Stop() { mIsPlaying = false; }
+
+	// false once a step reached the last key
+	bool IsPlaying() const { return mIsPlaying; }
+
+	void Step();
+
+	double GetTime() const { return mPath.GetStartTime() + double(mStepCount) * mStepSeconds; }
+	uint64_t GetStepCount() const { return mStepCount; }
+
+	// alpha of the way to the next step, see Timer::GetInterpolationAlpha
+	void Apply(Camera& camera, const double alpha) const;
+
+private:
+
+	CameraPath mPath;
+
+	double mStepSeconds = 0.0;
+	uint64_t mStepCount = 0;
+	bool mIsPlaying = false;
+};
\ No newline at end of file
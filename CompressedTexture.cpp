@@ -0,0 +1,310 @@
+#include "CompressedTexture.h"
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+
+// d3d
+#include "DDSTextureLoader11.h"
+using namespace DirectX;
+
+//
+#include "Compression.h"
+
+namespace
+{
+	constexpr uint32_t kMagic = 0x5a534444; // "DDSZ"
+	constexpr uint32_t kVersion = 1;
+}
+
+bool CompressedTexture::IsCompressedTexture(const uint8_t* data, const std::size_t size)
+{
+	uint32_t magic = 0;
+
+	if (size >= sizeof(Header))
+	{
+		std::memcpy(&magic, data, sizeof(magic));
+	}
+
+	return magic == kMagic;
+}
+
+std::vector<uint8_t> CompressedTexture::Compress(const uint8_t* ddsData,
+												 const std::size_t ddsDataSize,
+												 const Settings& settings,
+												 Report* report)
+{
+	assert((settings.chunkSize >= 64 * 1024) && (settings.chunkSize <= 256 * 1024));
+
+	const auto start = std::chrono::steady_clock::now();
+
+	DDSTextureInfo info;
+	const uint8_t* bitData = nullptr;
+	std::size_t bitSize = 0;
+
+	ThrowIfFailed(GetDDSTextureInfoFromMemory(ddsData, ddsDataSize, &info, &bitData, &bitSize));
+
+	std::vector<D3D11_SUBRESOURCE_DATA> subresources(std::size_t(info.mipCount) * info.arraySize);
+	ThrowIfFailed(GetDDSSubresourceData(info, bitData, bitSize, subresources.data()));
+
+	const std::size_t ddsHeaderSize = bitData - ddsData;
+
+	// a subresource runs up to the next one, the last one to the end of the file
+	std::vector<std::size_t> starts(subresources.size() + 1, ddsDataSize);
+
+	for (std::size_t i = 0; i < subresources.size(); ++i)
+	{
+		starts[i] = static_cast<const uint8_t*>(subresources[i].pSysMem) - ddsData;
+	}
+
+	// small subresources, the mip tails, share chunks; large ones are split into chunks of their own
+	std::vector<Chunk> chunks;
+	std::vector<ChunkRange> ranges(subresources.size());
+
+	std::size_t chunkStart = ddsHeaderSize;
+
+	const auto closeChunk = [&](const std::size_t end)
+	{
+		if (end > chunkStart)
+		{
+			chunks.push_back({ chunkStart, 0, uint32_t(end - chunkStart), 0 });
+			chunkStart = end;
+		}
+	};
+
+	for (std::size_t i = 0; i < subresources.size(); ++i)
+	{
+		const std::size_t subresourceSize = starts[i + 1] - starts[i];
+
+		if (starts[i + 1] - chunkStart > settings.chunkSize)
+		{
+			closeChunk(starts[i]);
+		}
+
+		ranges[i].first = uint32_t(chunks.size());
+
+		if (subresourceSize > settings.chunkSize)
+		{
+			for (std::size_t offset = starts[i] + settings.chunkSize; offset < starts[i + 1]; offset += settings.chunkSize)
+			{
+				closeChunk(offset);
+			}
+
+			closeChunk(starts[i + 1]);
+		}
+
+		// the open chunk counts as well, it gets the next index when closed
+		ranges[i].count = uint32_t(chunks.size() - ranges[i].first) + ((chunkStart < starts[i + 1]) ? 1 : 0);
+	}
+
+	closeChunk(ddsDataSize);
+
+	Header header = {};
+	header.magic = kMagic;
+	header.version = kVersion;
+	header.ddsSize = ddsDataSize;
+	header.ddsHeaderSize = uint32_t(ddsHeaderSize);
+	header.chunkCount = uint32_t(chunks.size());
+	header.subresourceCount = uint32_t(subresources.size());
+	header.mipCount = info.mipCount;
+
+	std::vector<std::vector<uint8_t>> compressed(chunks.size());
+
+	ParallelFor(chunks.size(), [&](const std::size_t i)
+	{
+		Chunk& chunk = chunks[i];
+
+		compressed[i].resize(GetLZCompressBound(chunk.size));
+
+		const std::size_t compressedSize = LZCompress(ddsData + chunk.ddsOffset, chunk.size, compressed[i].data(), compressed[i].size());
+
+		// anything that doesn't shrink is cheaper to copy than to decode
+		if ((compressedSize > 0) && (compressedSize < chunk.size))
+		{
+			compressed[i].resize(compressedSize);
+		}
+		else
+		{
+			compressed[i].assign(ddsData + chunk.ddsOffset, ddsData + chunk.ddsOffset + chunk.size);
+		}
+
+		chunk.storedSize = uint32_t(compressed[i].size());
+	});
+
+	// the tables stay 8 byte aligned, the DDS headers and the chunks follow them
+	std::size_t offset = sizeof(Header) + chunks.size() * sizeof(Chunk) + ranges.size() * sizeof(ChunkRange) + ddsHeaderSize;
+
+	for (Chunk& chunk : chunks)
+	{
+		chunk.offset = offset;
+		offset += chunk.storedSize;
+	}
+
+	std::vector<uint8_t> result(offset);
+	uint8_t* dst = result.data();
+
+	std::memcpy(dst, &header, sizeof(header));
+	dst += sizeof(header);
+	std::memcpy(dst, chunks.data(), chunks.size() * sizeof(Chunk));
+	dst += chunks.size() * sizeof(Chunk);
+	std::memcpy(dst, ranges.data(), ranges.size() * sizeof(ChunkRange));
+	dst += ranges.size() * sizeof(ChunkRange);
+	std::memcpy(dst, ddsData, ddsHeaderSize);
+
+	for (std::size_t i = 0; i < chunks.size(); ++i)
+	{
+		std::memcpy(result.data() + chunks[i].offset, compressed[i].data(), compressed[i].size());
+	}
+
+	if (report)
+	{
+		*report = Report();
+		report->chunkCount = chunks.size();
+		report->originalBytes = ddsDataSize;
+		report->compressedBytes = result.size();
+		report->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		for (const Chunk& chunk : chunks)
+		{
+			report->storedChunkCount += (chunk.storedSize == chunk.size) ? 1 : 0;
+		}
+	}
+
+	return result;
+}
+
+void CompressedTexture::Compress(const std::string& sourcePath,
+								 const std::string& destinationPath,
+								 const Settings& settings,
+								 Report* report)
+{
+	std::vector<uint8_t> result;
+
+	{
+		MappedFile source(sourcePath);
+		assert(source.IsOpen());
+
+		result = Compress(source.GetData(), source.GetSize(), settings, report);
+	}
+
+	std::ofstream stream(destinationPath, std::ios::binary);
+	assert(stream);
+
+	stream.write(reinterpret_cast<const char*>(result.data()), result.size());
+}
+
+std::size_t CompressedTexture::GetDDSSize(const uint8_t* data, const std::size_t size)
+{
+	if (!IsCompressedTexture(data, size))
+	{
+		return 0;
+	}
+
+	Header header;
+	std::memcpy(&header, data, sizeof(header));
+
+	return (header.version == kVersion) ? std::size_t(header.ddsSize) : 0;
+}
+
+bool CompressedTexture::Decompress(const uint8_t* data,
+								   const std::size_t size,
+								   uint8_t* ddsData,
+								   const std::size_t ddsDataSize,
+								   const uint32_t mip,
+								   Report* report)
+{
+	const auto start = std::chrono::steady_clock::now();
+
+	if ((GetDDSSize(data, size) == 0) || (GetDDSSize(data, size) != ddsDataSize))
+	{
+		return false;
+	}
+
+	Header header;
+	std::memcpy(&header, data, sizeof(header));
+
+	const std::size_t tablesSize = sizeof(Header) + std::size_t(header.chunkCount) * sizeof(Chunk) + std::size_t(header.subresourceCount) * sizeof(ChunkRange);
+
+	if ((header.mipCount == 0) || (header.subresourceCount % header.mipCount != 0) || (tablesSize + header.ddsHeaderSize > size))
+	{
+		return false;
+	}
+
+	std::vector<Chunk> chunks(header.chunkCount);
+	std::vector<ChunkRange> ranges(header.subresourceCount);
+
+	std::memcpy(chunks.data(), data + sizeof(Header), chunks.size() * sizeof(Chunk));
+	std::memcpy(ranges.data(), data + sizeof(Header) + chunks.size() * sizeof(Chunk), ranges.size() * sizeof(ChunkRange));
+
+	// neighbouring subresources can share chunks, each is decompressed once
+	std::vector<uint8_t> isNeeded(chunks.size(), 0);
+
+	for (std::size_t i = 0; i < ranges.size(); ++i)
+	{
+		if ((i % header.mipCount >= mip) && (ranges[i].first <= chunks.size()) && (ranges[i].count <= chunks.size() - ranges[i].first))
+		{
+			std::fill_n(isNeeded.begin() + ranges[i].first, ranges[i].count, 1);
+		}
+		else if (i % header.mipCount >= mip)
+		{
+			return false;
+		}
+	}
+
+	std::vector<uint32_t> needed;
+
+	for (uint32_t i = 0; i < chunks.size(); ++i)
+	{
+		const Chunk& chunk = chunks[i];
+
+		if (!isNeeded[i])
+		{
+			continue;
+		}
+
+		if ((chunk.ddsOffset < header.ddsHeaderSize) || (chunk.ddsOffset > ddsDataSize) || (chunk.size > ddsDataSize - chunk.ddsOffset) ||
+			(chunk.offset > size) || (chunk.storedSize > size - chunk.offset) || (chunk.storedSize > chunk.size))
+		{
+			return false;
+		}
+
+		needed.push_back(i);
+	}
+
+	std::memcpy(ddsData, data + tablesSize, header.ddsHeaderSize);
+
+	std::atomic<bool> isValid = true;
+
+	ParallelFor(needed.size(), [&](const std::size_t i)
+	{
+		const Chunk& chunk = chunks[needed[i]];
+
+		if (chunk.storedSize == chunk.size)
+		{
+			std::memcpy(ddsData + chunk.ddsOffset, data + chunk.offset, chunk.size);
+		}
+		else if (!LZDecompress(data + chunk.offset, chunk.storedSize, ddsData + chunk.ddsOffset, chunk.size))
+		{
+			isValid = false;
+		}
+	});
+
+	if (report)
+	{
+		*report = Report();
+		report->chunkCount = needed.size();
+		report->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+		for (const uint32_t i : needed)
+		{
+			report->storedChunkCount += (chunks[i].storedSize == chunks[i].size) ? 1 : 0;
+			report->originalBytes += chunks[i].size;
+			report->compressedBytes += chunks[i].storedSize;
+		}
+	}
+
+	return isValid;
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+// std
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//
+#include "Utility.h"
+
+// DDS file whose texel data is cut into independently LZ compressed chunks. chunks never straddle two
+// subresources that don't fit in one chunk, so a mip range is decompressed without touching the rest,
+// and the chunks are spread across threads while being decompressed straight into the DDS buffer the
+// texture is created from
+class CompressedTexture
+{
+public:
+
+	struct Settings
+	{
+		std::size_t chunkSize = 128 * 1024; // 64 to 256 KiB, larger subresources are split
+	};
+
+	struct Report
+	{
+		std::size_t chunkCount = 0;       // chunks compressed or decompressed
+		std::size_t storedChunkCount = 0; // chunks kept uncompressed because they didn't shrink
+		std::size_t originalBytes = 0;
+		std::size_t compressedBytes = 0;
+		double seconds = 0.0;
+
+		double GetRatio() const
+		{
+			return compressedBytes ? double(originalBytes) / double(compressedBytes) : 0.0;
+		}
+
+		// of original bytes, the rate the texel data becomes available at
+		double GetThroughputMBs() const
+		{
+			return (seconds > 0.0) ? (originalBytes / (1024.0 * 1024.0)) / seconds : 0.0;
+		}
+	};
+
+	static bool IsCompressedTexture(const uint8_t* data, const std::size_t size);
+
+	static std::vector<uint8_t> Compress(const uint8_t* ddsData,
+										 const std::size_t ddsDataSize,
+										 const Settings& settings,
+										 Report* report = nullptr);
+
+	static void Compress(const std::string& sourcePath,
+						 const std::string& destinationPath,
+						 const Settings& settings,
+						 Report* report = nullptr);
+
+	// size of the DDS file in the container, 0 if it isn't one
+	static std::size_t GetDDSSize(const uint8_t* data, const std::size_t size);
+
+	// writes the DDS headers and the subresources from mip on, of every array item, to ddsData which
+	// holds GetDDSSize bytes; the skipped mips are left as they are, CreateDDSTextureFromMemory with the
+	// matching maxsize doesn't read them. returns false for malformed data
+	static bool Decompress(const uint8_t* data,
+						   const std::size_t size,
+						   uint8_t* ddsData,
+						   const std::size_t ddsDataSize,
+						   const uint32_t mip = 0,
+						   Report* report = nullptr);
+
+private:
+
+	struct Header
+	{
+		uint32_t magic;
+		uint32_t version;
+		uint64_t ddsSize;
+		uint32_t ddsHeaderSize;    // bytes before the texel data, kept uncompressed
+		uint32_t chunkCount;
+		uint32_t subresourceCount; // mipCount * arraySize, mip major within each item
+		uint32_t mipCount;
+	};
+
+	struct Chunk
+	{
+		uint64_t ddsOffset; // where the chunk goes in the DDS file
+		uint64_t offset;    // where it is in the container
+		uint32_t size;
+		uint32_t storedSize; // equal to size when the chunk is stored
+	};
+
+	// chunks holding a subresource
+	struct ChunkRange
+	{
+		uint32_t first;
+		uint32_t count;
+	};
+};
\ No newline at end of file
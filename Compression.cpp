@@ -0,0 +1,339 @@
+#include "Compression.h"
+
+// std
+#include <array>
+#include <cstring>
+#include <memory>
+
+namespace
+{
+	// slicing by 8: table k advances the crc of a byte followed by k zero bytes
+	using CrcTables = std::array<std::array<uint32_t, 256>, 8>;
+
+	constexpr CrcTables MakeCrcTables()
+	{
+		CrcTables tables = {};
+
+		for (uint32_t i = 0; i < 256; ++i)
+		{
+			uint32_t crc = i;
+
+			for (int bit = 0; bit < 8; ++bit)
+			{
+				crc = (crc >> 1) ^ ((crc & 1) ? 0xedb88320u : 0u);
+			}
+
+			tables[0][i] = crc;
+		}
+
+		for (uint32_t i = 0; i < 256; ++i)
+		{
+			for (std::size_t k = 1; k < 8; ++k)
+			{
+				tables[k][i] = (tables[k - 1][i] >> 8) ^ tables[0][tables[k - 1][i] & 0xff];
+			}
+		}
+
+		return tables;
+	}
+
+	constexpr CrcTables kCrcTables = MakeCrcTables();
+
+	constexpr std::size_t kMinMatch = 4;
+	constexpr std::size_t kLastLiterals = 5;   // the format ends with at least this many literals
+	constexpr std::size_t kMatchSearchEnd = 12; // and no match starts in the last 12 bytes
+	constexpr std::size_t kMaxOffset = 65535;
+	constexpr uint32_t kHashBits = 14;
+
+	uint32_t Read32(const uint8_t* p)
+	{
+		uint32_t value;
+		std::memcpy(&value, p, sizeof(value));
+		return value;
+	}
+
+	uint32_t Hash(const uint32_t sequence)
+	{
+		return (sequence * 2654435761u) >> (32 - kHashBits);
+	}
+
+	// 15 in the token, then bytes of 255 and the rest
+	uint8_t* WriteLength(uint8_t* out, std::size_t length)
+	{
+		for (; length >= 255; length -= 255)
+		{
+			*out++ = 255;
+		}
+
+		*out++ = uint8_t(length);
+
+		return out;
+	}
+
+	bool ReadLength(const uint8_t*& in, const uint8_t* end, std::size_t& length)
+	{
+		uint8_t byte = 255;
+
+		while (byte == 255)
+		{
+			if (in == end)
+			{
+				return false;
+			}
+
+			byte = *in++;
+			length += byte;
+		}
+
+		return true;
+	}
+}
+
+uint32_t Crc32(const void* data, const std::size_t size, const uint32_t crc)
+{
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	const uint8_t* end = bytes + size;
+
+	uint32_t value = ~crc;
+
+	for (; end - bytes >= 8; bytes += 8)
+	{
+		const uint32_t low = Read32(bytes) ^ value;
+		const uint32_t high = Read32(bytes + 4);
+
+		value = kCrcTables[7][low & 0xff] ^ kCrcTables[6][(low >> 8) & 0xff] ^
+				kCrcTables[5][(low >> 16) & 0xff] ^ kCrcTables[4][low >> 24] ^
+				kCrcTables[3][high & 0xff] ^ kCrcTables[2][(high >> 8) & 0xff] ^
+				kCrcTables[1][(high >> 16) & 0xff] ^ kCrcTables[0][high >> 24];
+	}
+
+	for (; bytes != end; ++bytes)
+	{
+		value = (value >> 8) ^ kCrcTables[0][(value ^ *bytes) & 0xff];
+	}
+
+	return ~value;
+}
+
+std::size_t GetLZCompressBound(const std::size_t size)
+{
+	return size + size / 255 + 16;
+}
+
+std::size_t LZCompress(const uint8_t* source, const std::size_t sourceSize, uint8_t* destination, const std::size_t capacity)
+{
+	// last position a match may start at, and one past the last byte it may cover
+	const std::size_t searchEnd = (sourceSize > kMatchSearchEnd) ? sourceSize - kMatchSearchEnd : 0;
+	const std::size_t matchEnd = (sourceSize > kLastLiterals) ? sourceSize - kLastLiterals : 0;
+
+	// position + 1 of the last occurrence of each hashed 4 byte sequence, 0 for none
+	const auto table = std::make_unique<uint32_t[]>(std::size_t(1) << kHashBits);
+
+	uint8_t* out = destination;
+	uint8_t* const outEnd = destination + capacity;
+
+	auto WriteSequence = [&](const std::size_t anchor, const std::size_t literalCount, const std::size_t offset, const std::size_t matchLength)
+	{
+		// token, both length extensions and the offset at most
+		if (std::size_t(outEnd - out) < literalCount + literalCount / 255 + matchLength / 255 + 8)
+		{
+			return false;
+		}
+
+		uint8_t* token = out++;
+		*token = uint8_t(std::min<std::size_t>(literalCount, 15) << 4);
+
+		if (literalCount >= 15)
+		{
+			out = WriteLength(out, literalCount - 15);
+		}
+
+		std::memcpy(out, source + anchor, literalCount);
+		out += literalCount;
+
+		// the last sequence has literals only
+		if (matchLength == 0)
+		{
+			return true;
+		}
+
+		*out++ = uint8_t(offset);
+		*out++ = uint8_t(offset >> 8);
+
+		*token |= uint8_t(std::min<std::size_t>(matchLength - kMinMatch, 15));
+
+		if (matchLength - kMinMatch >= 15)
+		{
+			out = WriteLength(out, matchLength - kMinMatch - 15);
+		}
+
+		return true;
+	};
+
+	std::size_t anchor = 0;
+	std::size_t position = 0;
+
+	while (position < searchEnd)
+	{
+		const uint32_t sequence = Read32(source + position);
+		uint32_t& entry = table[Hash(sequence)];
+
+		const std::size_t candidate = std::size_t(entry) - 1;
+		entry = uint32_t(position + 1);
+
+		if ((candidate == std::size_t(-1)) || (position - candidate > kMaxOffset) || (Read32(source + candidate) != sequence))
+		{
+			// step further the longer nothing matched, incompressible data goes by quickly
+			position += 1 + ((position - anchor) >> 6);
+			continue;
+		}
+
+		std::size_t start = position;
+		std::size_t reference = candidate;
+
+		while ((start > anchor) && (reference > 0) && (source[start - 1] == source[reference - 1]))
+		{
+			--start;
+			--reference;
+		}
+
+		std::size_t length = kMinMatch + (position - start);
+
+		while ((start + length < matchEnd) && (source[start + length] == source[reference + length]))
+		{
+			++length;
+		}
+
+		if (!WriteSequence(anchor, start - anchor, start - reference, length))
+		{
+			return 0;
+		}
+
+		position = start + length;
+		anchor = position;
+
+		// a position inside the match gives the next search a closer reference
+		if (position - 2 < searchEnd)
+		{
+			table[Hash(Read32(source + position - 2))] = uint32_t(position - 2 + 1);
+		}
+	}
+
+	if (!WriteSequence(anchor, sourceSize - anchor, 0, 0))
+	{
+		return 0;
+	}
+
+	return std::size_t(out - destination);
+}
+
+bool LZDecompress(const uint8_t* source, const std::size_t sourceSize, uint8_t* destination, const std::size_t destinationSize)
+{
+	const uint8_t* in = source;
+	const uint8_t* const inEnd = source + sourceSize;
+
+	uint8_t* out = destination;
+	uint8_t* const outEnd = destination + destinationSize;
+
+	while (in != inEnd)
+	{
+		const uint8_t token = *in++;
+
+		std::size_t literalCount = token >> 4;
+
+		if ((literalCount == 15) && !ReadLength(in, inEnd, literalCount))
+		{
+			return false;
+		}
+
+		if ((literalCount > std::size_t(inEnd - in)) || (literalCount > std::size_t(outEnd - out)))
+		{
+			return false;
+		}
+
+		// short runs go as one fixed size copy when both buffers have room for it
+		if ((literalCount <= 16) && (inEnd - in >= 16) && (outEnd - out >= 16))
+		{
+			std::memcpy(out, in, 16);
+		}
+		else
+		{
+			std::memcpy(out, in, literalCount);
+		}
+
+		in += literalCount;
+		out += literalCount;
+
+		if (in == inEnd)
+		{
+			break;
+		}
+
+		if (inEnd - in < 2)
+		{
+			return false;
+		}
+
+		const std::size_t offset = in[0] | (std::size_t(in[1]) << 8);
+		in += 2;
+
+		if ((offset == 0) || (offset > std::size_t(out - destination)))
+		{
+			return false;
+		}
+
+		std::size_t length = token & 15;
+
+		if ((length == 15) && !ReadLength(in, inEnd, length))
+		{
+			return false;
+		}
+
+		length += kMinMatch;
+
+		if (length > std::size_t(outEnd - out))
+		{
+			return false;
+		}
+
+		const uint8_t* match = out - offset;
+		const std::size_t room = std::size_t(outEnd - out);
+
+		std::size_t i = 0;
+
+		if (offset >= 16)
+		{
+			// the chunks never overlap, the overshoot is rewritten by what follows
+			for (; (i < length) && (i + 16 <= room); i += 16)
+			{
+				std::memcpy(out + i, match + i, 16);
+			}
+		}
+		else
+		{
+			// short repeats: a multiple of the offset at least 16 long is also a period of the output,
+			// once that much is written the rest can go in chunks
+			const std::size_t period = offset * ((16 + offset - 1) / offset);
+
+			for (; (i < period) && (i < length); ++i)
+			{
+				out[i] = match[i];
+			}
+
+			for (; (i < length) && (i + 16 <= room); i += 16)
+			{
+				std::memcpy(out + i, out + i - period, 16);
+			}
+		}
+
+		// the end of the buffer, one byte at a time
+		for (; i < length; ++i)
+		{
+			out[i] = match[i];
+		}
+
+		out += length;
+	}
+
+	return out == outEnd;
+}
\ No newline at end of file
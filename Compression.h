@@ -0,0 +1,20 @@
+#pragma once
+
+// std
+#include <cstdint>
+
+// crc32 with the zlib polynomial; pass a previous result as crc to continue a running checksum
+uint32_t Crc32(const void* data, const std::size_t size, const uint32_t crc = 0);
+
+// byte oriented lz compression in the lz4 block format: no entropy coding and no dependencies,
+// decoding runs at memory speed which is the point for load time data
+
+// worst case compressed size of size bytes, for incompressible data
+std::size_t GetLZCompressBound(const std::size_t size);
+
+// returns the compressed size, 0 if it doesn't fit in capacity
+std::size_t LZCompress(const uint8_t* source, const std::size_t sourceSize, uint8_t* destination, const std::size_t capacity);
+
+// every input is bounds checked; returns false for malformed data or when the result isn't exactly
+// destinationSize bytes
+bool LZDecompress(const uint8_t* source, const std::size_t sourceSize, uint8_t* destination, const std::size_t destinationSize);
\ No newline at end of file
@@ -21,6 +21,11 @@
 #include <memory>
 #include <new>
 
+#ifndef _WIN32
+#include <filesystem>
+#include <fstream>
+#endif
+
 #ifdef _MSC_VER
 // Off by default warnings
 #pragma warning(disable : 4619 4616 4061 4062 4623 4626 5027)
@@ -126,14 +131,18 @@ struct DDS_HEADER_DXT10
 
 #pragma pack(pop)
 
+static_assert(DDS_MAX_HEADER_SIZE == sizeof(uint32_t) + sizeof(DDS_HEADER) + sizeof(DDS_HEADER_DXT10), "DDS header size mismatch");
+
 //--------------------------------------------------------------------------------------
 namespace
 {
+#ifdef _WIN32
     struct handle_closer { void operator()(HANDLE h) noexcept { if (h) CloseHandle(h); } };
 
     using ScopedHandle = std::unique_ptr<void, handle_closer>;
 
     inline HANDLE safe_handle(HANDLE h) noexcept { return (h == INVALID_HANDLE_VALUE) ? nullptr : h; }
+#endif
 
     #if defined(_DEBUG) || defined(PROFILE)
     template<UINT TNameLength>
@@ -230,6 +239,7 @@ namespace
 
         *bitSize = 0;
 
+    #ifdef _WIN32
         // open the file
     #if (_WIN32_WINNT >= _WIN32_WINNT_WIN8)
         ScopedHandle hFile(safe_handle(CreateFile2(
@@ -295,6 +305,42 @@ namespace
             return E_FAIL;
         }
 
+        const size_t fileSize = fileInfo.EndOfFile.LowPart;
+    #else
+        // posix builds, the headless one; same checks as above
+        std::ifstream file(std::filesystem::path(fileName), std::ios::binary | std::ios::ate);
+        if (!file)
+        {
+            return E_FAIL;
+        }
+
+        const auto fileEnd = file.tellg();
+        if ((fileEnd < 0) || (uint64_t(fileEnd) > UINT32_MAX))
+        {
+            return E_FAIL;
+        }
+
+        const size_t fileSize = size_t(fileEnd);
+
+        if (fileSize < (sizeof(uint32_t) + sizeof(DDS_HEADER)))
+        {
+            return E_FAIL;
+        }
+
+        ddsData.reset(new (std::nothrow) uint8_t[fileSize]);
+        if (!ddsData)
+        {
+            return E_OUTOFMEMORY;
+        }
+
+        file.seekg(0);
+        if (!file.read(reinterpret_cast<char*>(ddsData.get()), std::streamsize(fileSize)))
+        {
+            ddsData.reset();
+            return E_FAIL;
+        }
+    #endif
+
         // DDS files always start with the same magic number ("DDS ")
         auto const dwMagicNumber = *reinterpret_cast<const uint32_t*>(ddsData.get());
         if (dwMagicNumber != DDS_MAGIC)
@@ -319,7 +365,7 @@ namespace
             (MAKEFOURCC('D', 'X', '1', '0') == hdr->ddspf.fourCC))
         {
             // Must be long enough for both headers and magic value
-            if (fileInfo.EndOfFile.LowPart < (sizeof(uint32_t) + sizeof(DDS_HEADER) + sizeof(DDS_HEADER_DXT10)))
+            if (fileSize < (sizeof(uint32_t) + sizeof(DDS_HEADER) + sizeof(DDS_HEADER_DXT10)))
             {
                 ddsData.reset();
                 return E_FAIL;
@@ -333,7 +379,7 @@ namespace
         auto offset = sizeof(uint32_t) + sizeof(DDS_HEADER)
             + (bDXT10Header ? sizeof(DDS_HEADER_DXT10) : 0u);
         *bitData = ddsData.get() + offset;
-        *bitSize = fileInfo.EndOfFile.LowPart - offset;
+        *bitSize = fileSize - offset;
 
         return S_OK;
     }
@@ -1318,23 +1364,10 @@ namespace
     }
 
     //--------------------------------------------------------------------------------------
-    HRESULT CreateTextureFromDDS(
-        _In_ ID3D11Device* d3dDevice,
-        _In_opt_ ID3D11DeviceContext* d3dContext,
+    HRESULT GetTextureInfo(
         _In_ const DDS_HEADER* header,
-        _In_reads_bytes_(bitSize) const uint8_t* bitData,
-        _In_ size_t bitSize,
-        _In_ size_t maxsize,
-        _In_ D3D11_USAGE usage,
-        _In_ unsigned int bindFlags,
-        _In_ unsigned int cpuAccessFlags,
-        _In_ unsigned int miscFlags,
-        _In_ DDS_LOADER_FLAGS loadFlags,
-        _Outptr_opt_ ID3D11Resource** texture,
-        _Outptr_opt_ ID3D11ShaderResourceView** textureView) noexcept
+        _Out_ DDSTextureInfo& info) noexcept
     {
-        HRESULT hr = S_OK;
-
         const UINT width = header->width;
         UINT height = header->height;
         UINT depth = header->depth;
@@ -1529,6 +1562,51 @@ namespace
             return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
         }
 
+        info.width = width;
+        info.height = height;
+        info.depth = depth;
+        info.mipCount = static_cast<uint32_t>(mipCount);
+        info.arraySize = arraySize;
+        info.format = format;
+        info.resourceDimension = resDim;
+        info.isCubeMap = isCubeMap ? 1u : 0u;
+
+        return S_OK;
+    }
+
+
+    //--------------------------------------------------------------------------------------
+    HRESULT CreateTextureFromDDS(
+        _In_ ID3D11Device* d3dDevice,
+        _In_opt_ ID3D11DeviceContext* d3dContext,
+        _In_ const DDS_HEADER* header,
+        _In_reads_bytes_(bitSize) const uint8_t* bitData,
+        _In_ size_t bitSize,
+        _In_ size_t maxsize,
+        _In_ D3D11_USAGE usage,
+        _In_ unsigned int bindFlags,
+        _In_ unsigned int cpuAccessFlags,
+        _In_ unsigned int miscFlags,
+        _In_ DDS_LOADER_FLAGS loadFlags,
+        _Outptr_opt_ ID3D11Resource** texture,
+        _Outptr_opt_ ID3D11ShaderResourceView** textureView) noexcept
+    {
+        DDSTextureInfo info = {};
+        HRESULT hr = GetTextureInfo(header, info);
+        if (FAILED(hr))
+        {
+            return hr;
+        }
+
+        const UINT width = info.width;
+        const UINT height = info.height;
+        const UINT depth = info.depth;
+        const uint32_t resDim = info.resourceDimension;
+        const UINT arraySize = info.arraySize;
+        const DXGI_FORMAT format = info.format;
+        const bool isCubeMap = info.isCubeMap != 0;
+        const size_t mipCount = info.mipCount;
+
         bool autogen = false;
         if (mipCount == 1 && d3dContext && textureView) // Must have context and shader-view to auto generate mipmaps
         {
@@ -1806,6 +1884,192 @@ namespace
     }
 } // anonymous namespace
 
+//--------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::GetDDSTextureInfoFromMemory(
+    const uint8_t* ddsData,
+    size_t ddsDataSize,
+    DDSTextureInfo* info,
+    const uint8_t** bitData,
+    size_t* bitSize) noexcept
+{
+    if (!ddsData || !info)
+    {
+        return E_INVALIDARG;
+    }
+
+    const DDS_HEADER* header = nullptr;
+    const uint8_t* data = nullptr;
+    size_t size = 0;
+
+    HRESULT hr = LoadTextureDataFromMemory(ddsData, ddsDataSize,
+        &header,
+        &data,
+        &size
+    );
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    hr = GetTextureInfo(header, *info);
+    if (FAILED(hr))
+    {
+        return hr;
+    }
+
+    if (bitData)
+    {
+        *bitData = data;
+    }
+    if (bitSize)
+    {
+        *bitSize = size;
+    }
+
+    return S_OK;
+}
+
+//--------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::GetDDSSubresourceData(
+    const DDSTextureInfo& info,
+    const uint8_t* bitData,
+    size_t bitSize,
+    D3D11_SUBRESOURCE_DATA* initData) noexcept
+{
+    size_t skipMip = 0;
+    size_t twidth = 0;
+    size_t theight = 0;
+    size_t tdepth = 0;
+
+    return FillInitData(info.width, info.height, info.depth, info.mipCount, info.arraySize,
+        info.format, 0, bitSize, bitData,
+        twidth, theight, tdepth, skipMip, initData);
+}
+
+//--------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::GetDDSSurfaceInfo(
+    size_t width,
+    size_t height,
+    DXGI_FORMAT format,
+    size_t* numBytes,
+    size_t* rowBytes,
+    size_t* numRows) noexcept
+{
+    if (!numBytes)
+    {
+        return E_INVALIDARG;
+    }
+
+    if (BitsPerPixel(format) == 0)
+    {
+        return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+    }
+
+    return GetSurfaceInfo(width, height, format, numBytes, rowBytes, numRows);
+}
+
+//--------------------------------------------------------------------------------------
+_Use_decl_annotations_
+HRESULT DirectX::SaveDDSTextureToMemory(
+    const DDSTextureInfo& info,
+    const D3D11_SUBRESOURCE_DATA* subresources,
+    uint8_t* ddsData,
+    size_t ddsDataSize,
+    size_t* requiredSize) noexcept
+{
+    if (!subresources || !requiredSize || !info.mipCount || !info.arraySize)
+    {
+        return E_INVALIDARG;
+    }
+
+    *requiredSize = 0;
+
+    if (info.resourceDimension != D3D11_RESOURCE_DIMENSION_TEXTURE2D || info.isCubeMap || info.depth > 1)
+    {
+        return HRESULT_FROM_WIN32(ERROR_NOT_SUPPORTED);
+    }
+
+    size_t size = DDS_MAX_HEADER_SIZE;
+
+    for (uint32_t mip = 0; mip < info.mipCount; ++mip)
+    {
+        size_t numBytes = 0;
+        HRESULT hr = GetSurfaceInfo(std::max(info.width >> mip, 1u), std::max(info.height >> mip, 1u), info.format, &numBytes, nullptr, nullptr);
+        if (FAILED(hr))
+            return hr;
+
+        size += numBytes * info.arraySize;
+    }
+
+    *requiredSize = size;
+
+    if (!ddsData)
+    {
+        return S_OK;
+    }
+
+    if (ddsDataSize < size)
+    {
+        return HRESULT_FROM_WIN32(ERROR_INSUFFICIENT_BUFFER);
+    }
+
+    *reinterpret_cast<uint32_t*>(ddsData) = DDS_MAGIC;
+
+    auto header = reinterpret_cast<DDS_HEADER*>(ddsData + sizeof(uint32_t));
+    memset(header, 0, sizeof(DDS_HEADER));
+    header->size = sizeof(DDS_HEADER);
+    header->flags = 0x00001007 /* DDSD_CAPS | DDSD_HEIGHT | DDSD_WIDTH | DDSD_PIXELFORMAT */ | ((info.mipCount > 1) ? 0x00020000 /* DDSD_MIPMAPCOUNT */ : 0);
+    header->height = info.height;
+    header->width = info.width;
+    header->depth = 1;
+    header->mipMapCount = info.mipCount;
+    header->ddspf.size = sizeof(DDS_PIXELFORMAT);
+    header->ddspf.flags = DDS_FOURCC;
+    header->ddspf.fourCC = MAKEFOURCC('D', 'X', '1', '0');
+    header->caps = 0x00001000 /* DDSCAPS_TEXTURE */ | ((info.mipCount > 1) ? 0x00400008 /* DDSCAPS_COMPLEX | DDSCAPS_MIPMAP */ : 0);
+
+    auto d3d10ext = reinterpret_cast<DDS_HEADER_DXT10*>(reinterpret_cast<uint8_t*>(header) + sizeof(DDS_HEADER));
+    memset(d3d10ext, 0, sizeof(DDS_HEADER_DXT10));
+    d3d10ext->dxgiFormat = info.format;
+    d3d10ext->resourceDimension = D3D11_RESOURCE_DIMENSION_TEXTURE2D;
+    d3d10ext->arraySize = info.arraySize;
+
+    uint8_t* dest = ddsData + DDS_MAX_HEADER_SIZE;
+
+    for (uint32_t item = 0; item < info.arraySize; ++item)
+    {
+        for (uint32_t mip = 0; mip < info.mipCount; ++mip)
+        {
+            const D3D11_SUBRESOURCE_DATA& subresource = subresources[item * info.mipCount + mip];
+
+            size_t numBytes = 0;
+            size_t rowBytes = 0;
+            size_t numRows = 0;
+            HRESULT hr = GetSurfaceInfo(std::max(info.width >> mip, 1u), std::max(info.height >> mip, 1u), info.format, &numBytes, &rowBytes, &numRows);
+            if (FAILED(hr))
+                return hr;
+
+            if (!subresource.pSysMem || subresource.SysMemPitch < rowBytes)
+            {
+                return E_INVALIDARG;
+            }
+
+            auto src = static_cast<const uint8_t*>(subresource.pSysMem);
+
+            for (size_t row = 0; row < numRows; ++row)
+            {
+                memcpy(dest, src + row * subresource.SysMemPitch, rowBytes);
+                dest += rowBytes;
+            }
+        }
+    }
+
+    return S_OK;
+}
+
 //--------------------------------------------------------------------------------------
 _Use_decl_annotations_
 HRESULT DirectX::CreateDDSTextureFromMemory(
@@ -60,6 +60,58 @@ namespace DirectX
 #endif
 #endif
 
+    // Magic number + DDS_HEADER + DDS_HEADER_DXT10, reading this many bytes is enough for GetDDSTextureInfoFromMemory
+    constexpr size_t DDS_MAX_HEADER_SIZE = sizeof(uint32_t) + 124 + 20;
+
+    // Resource description of a DDS file after header validation, legacy and DX10 headers
+    // describing the same resource produce the same values
+    struct DDSTextureInfo
+    {
+        uint32_t width;
+        uint32_t height;
+        uint32_t depth;
+        uint32_t mipCount;
+        uint32_t arraySize; // already multiplied by 6 for cubemaps
+        DXGI_FORMAT format;
+        uint32_t resourceDimension; // D3D11_RESOURCE_DIMENSION
+        uint32_t isCubeMap;
+    };
+
+    // Parse and validate the headers without touching the device, bitData points into ddsData
+    HRESULT GetDDSTextureInfoFromMemory(
+        _In_reads_bytes_(ddsDataSize) const uint8_t* ddsData,
+        _In_ size_t ddsDataSize,
+        _Out_ DDSTextureInfo* info,
+        _Outptr_opt_ const uint8_t** bitData = nullptr,
+        _Out_opt_ size_t* bitSize = nullptr) noexcept;
+
+    // Fill the subresource table (mipCount * arraySize entries, mip major within each item) with
+    // pointers into bitData, the same layout CreateDDSTextureFromMemory hands to the device
+    HRESULT GetDDSSubresourceData(
+        _In_ const DDSTextureInfo& info,
+        _In_reads_bytes_(bitSize) const uint8_t* bitData,
+        _In_ size_t bitSize,
+        _Out_writes_(info.mipCount*info.arraySize) D3D11_SUBRESOURCE_DATA* initData) noexcept;
+
+    // Bytes of a width x height surface of the format, its row size and row count (block rows for the
+    // compressed formats); fails for the formats without a size such as DXGI_FORMAT_UNKNOWN
+    HRESULT GetDDSSurfaceInfo(
+        _In_ size_t width,
+        _In_ size_t height,
+        _In_ DXGI_FORMAT format,
+        _Out_ size_t* numBytes,
+        _Out_opt_ size_t* rowBytes,
+        _Out_opt_ size_t* numRows) noexcept;
+
+    // Write a 2D texture (array) as a DDS file with a DX10 header, subresources are in the
+    // GetDDSSubresourceData layout and their rows may be padded; call with ddsData null to get requiredSize
+    HRESULT SaveDDSTextureToMemory(
+        _In_ const DDSTextureInfo& info,
+        _In_reads_(info.mipCount*info.arraySize) const D3D11_SUBRESOURCE_DATA* subresources,
+        _Out_writes_bytes_opt_(ddsDataSize) uint8_t* ddsData,
+        _In_ size_t ddsDataSize,
+        _Out_ size_t* requiredSize) noexcept;
+
     // Standard version
     HRESULT CreateDDSTextureFromMemory(
         _In_ ID3D11Device* d3dDevice,
@@ -0,0 +1,453 @@
+#include "FrameStatistics.h"
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+
+namespace
+{
+	constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+
+	// values up to kSketchMin share the first bucket, values past kSketchMax the last one
+	constexpr double kSketchAccuracy = 0.01;
+	constexpr double kSketchMin = 1e-3;
+	constexpr double kSketchMax = 1e9;
+
+	const double kSketchGamma = (1.0 + kSketchAccuracy) / (1.0 - kSketchAccuracy);
+	const double kSketchLogGamma = std::log(kSketchGamma);
+	const std::size_t kSketchBucketCount = std::size_t(std::ceil(std::log(kSketchMax / kSketchMin) / kSketchLogGamma)) + 1;
+
+	// nearest rank on sorted values
+	double GetSortedQuantile(const std::vector<float>& sorted, const double q)
+	{
+		return sorted.empty() ? 0.0 : sorted[std::size_t(q * (sorted.size() - 1) + 0.5)];
+	}
+
+	// a quoted csv field, quotes inside it are doubled
+	std::string QuoteCSV(const std::string& text)
+	{
+		std::string quoted = "\"";
+
+		for (const char c : text)
+		{
+			quoted += c;
+
+			if (c == '"')
+			{
+				quoted += c;
+			}
+		}
+
+		return quoted + '"';
+	}
+
+	// a json string, with quotes, backslashes and control characters escaped
+	std::string QuoteJSON(const std::string& text)
+	{
+		std::string quoted = "\"";
+
+		for (const char c : text)
+		{
+			if ((c == '"') || (c == '\\'))
+			{
+				quoted += '\\';
+				quoted += c;
+			}
+			else if (static_cast<unsigned char>(c) < 0x20)
+			{
+				char escaped[8];
+				std::snprintf(escaped, sizeof(escaped), "\\u%04x", unsigned(c));
+				quoted += escaped;
+			}
+			else
+			{
+				quoted += c;
+			}
+		}
+
+		return quoted + '"';
+	}
+}
+
+void FrameStatistics::Sketch::Add(const float value, const int32_t weight)
+{
+	if (mBuckets.empty())
+	{
+		mBuckets.resize(kSketchBucketCount, 0);
+	}
+
+	const std::size_t bucket = GetBucket(value);
+
+	assert((weight > 0) || (mBuckets[bucket] >= uint32_t(-weight)));
+
+	mBuckets[bucket] += weight;
+	mCount += weight;
+}
+
+double FrameStatistics::Sketch::GetQuantile(const double q) const
+{
+	if (mCount == 0)
+	{
+		return 0.0;
+	}
+
+	const double rank = q * double(mCount - 1);
+	std::size_t count = 0;
+
+	for (std::size_t i = 0; i < mBuckets.size(); ++i)
+	{
+		count += mBuckets[i];
+
+		if (double(count) > rank)
+		{
+			return GetBucketValue(i);
+		}
+	}
+
+	return GetBucketValue(mBuckets.size() - 1);
+}
+
+double FrameStatistics::Sketch::GetTopMean(const double fraction) const
+{
+	if (mCount == 0)
+	{
+		return 0.0;
+	}
+
+	const std::size_t topCount = std::max<std::size_t>(1, std::size_t(std::ceil(double(mCount) * fraction)));
+
+	std::size_t remaining = topCount;
+	double sum = 0.0;
+
+	for (std::size_t i = mBuckets.size(); (i-- > 0) && (remaining > 0);)
+	{
+		const std::size_t taken = std::min<std::size_t>(remaining, mBuckets[i]);
+
+		sum += double(taken) * GetBucketValue(i);
+		remaining -= taken;
+	}
+
+	return sum / double(topCount);
+}
+
+std::size_t FrameStatistics::Sketch::GetBucket(const float value)
+{
+	if (!(value > kSketchMin))
+	{
+		return 0;
+	}
+
+	const double bucket = std::ceil(std::log(double(value) / kSketchMin) / kSketchLogGamma);
+
+	return std::min(kSketchBucketCount - 1, std::size_t(bucket));
+}
+
+double FrameStatistics::Sketch::GetBucketValue(const std::size_t bucket)
+{
+	// the middle of (gamma^(i-1), gamma^i] in relative terms, within the accuracy of both ends
+	return (bucket == 0) ? 0.0 : kSketchMin * std::pow(kSketchGamma, double(bucket)) * 2.0 / (1.0 + kSketchGamma);
+}
+
+FrameStatistics::FrameStatistics(const std::size_t historySize) :
+	mHistorySize(historySize),
+	mValues(std::make_unique<std::atomic<float>[]>(historySize * kMaxChannels))
+{
+	assert(historySize > 0);
+
+	std::fill_n(mPending, kMaxChannels, kNaN);
+
+	for (std::size_t i = 0; i < historySize * kMaxChannels; ++i)
+	{
+		mValues[i].store(kNaN, std::memory_order_relaxed);
+	}
+}
+
+std::size_t FrameStatistics::GetChannel(const std::string& name)
+{
+	if (auto i = mLookup.find(name); i != mLookup.end())
+	{
+		return i->second;
+	}
+
+	const std::size_t channel = mChannelCount.load(std::memory_order_relaxed);
+	assert(channel < kMaxChannels);
+
+	mChannels[channel].name = name;
+	mLookup[name] = channel;
+
+	// the name is in place before readers can see the channel
+	mChannelCount.store(channel + 1, std::memory_order_release);
+
+	return channel;
+}
+
+void FrameStatistics::EndFrame()
+{
+	const uint64_t frame = mFrameCount.load(std::memory_order_relaxed);
+	std::atomic<float>* row = &mValues[(frame % mHistorySize) * kMaxChannels];
+
+	// a reader that copies any of the row below sees the frame started
+	mStartedFrameCount.store(frame + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	for (std::size_t i = 0; i < mChannelCount; ++i)
+	{
+		Channel& channel = mChannels[i];
+
+		// the frame that leaves the window leaves the sketch
+		if (const float old = row[i].load(std::memory_order_relaxed); (frame >= mHistorySize) && !std::isnan(old))
+		{
+			channel.sketch.Add(old, -1);
+			channel.sum -= old;
+		}
+
+		const float value = mPending[i];
+		row[i].store(value, std::memory_order_relaxed);
+
+		if (!std::isnan(value))
+		{
+			channel.sketch.Add(value, 1);
+			channel.sum += value;
+		}
+
+		mPending[i] = kNaN;
+	}
+
+	mFrameCount.store(frame + 1, std::memory_order_release);
+}
+
+FrameStatistics::Summary FrameStatistics::GetSummary(const std::size_t channel) const
+{
+	assert(channel < mChannelCount);
+
+	const Channel& data = mChannels[channel];
+
+	Summary summary;
+	summary.count = data.sketch.GetCount();
+
+	if (summary.count == 0)
+	{
+		return summary;
+	}
+
+	summary.mean = data.sum / double(summary.count);
+	summary.p50 = data.sketch.GetQuantile(0.50);
+	summary.p95 = data.sketch.GetQuantile(0.95);
+	summary.p99 = data.sketch.GetQuantile(0.99);
+	summary.onePercentHigh = data.sketch.GetTopMean(0.01);
+
+	// exact, the window is small enough to scan
+	const std::size_t rowCount = std::size_t(std::min<uint64_t>(mFrameCount.load(std::memory_order_relaxed), mHistorySize));
+
+	for (std::size_t row = 0; row < rowCount; ++row)
+	{
+		const float value = mValues[row * kMaxChannels + channel].load(std::memory_order_relaxed);
+
+		if (!std::isnan(value))
+		{
+			summary.max = std::max(summary.max, double(value));
+		}
+	}
+
+	return summary;
+}
+
+void FrameStatistics::GetHistory(const std::size_t channel, std::vector<float>& values) const
+{
+	std::vector<float> rows;
+	std::vector<uint64_t> frames;
+
+	const std::size_t rowCount = Snapshot(rows, frames);
+
+	values.resize(rowCount);
+
+	for (std::size_t row = 0; row < rowCount; ++row)
+	{
+		values[row] = rows[row * kMaxChannels + channel];
+	}
+}
+
+float FrameStatistics::GetHistogram(const std::size_t channel, const std::size_t binCount, std::vector<float>& counts) const
+{
+	assert(binCount > 0);
+
+	std::vector<float> values;
+	GetHistory(channel, values);
+
+	float max = 0.0f;
+
+	for (const float value : values)
+	{
+		max = std::isnan(value) ? max : std::max(max, value);
+	}
+
+	counts.assign(binCount, 0.0f);
+
+	for (const float value : values)
+	{
+		if (!std::isnan(value) && (max > 0.0f))
+		{
+			counts[std::min(binCount - 1, std::size_t(std::max(0.0f, value) / max * binCount))] += 1.0f;
+		}
+	}
+
+	return max;
+}
+
+bool FrameStatistics::WriteCSV(const std::string& path) const
+{
+	std::vector<float> rows;
+	std::vector<uint64_t> frames;
+
+	const std::size_t rowCount = Snapshot(rows, frames);
+	const std::size_t channelCount = mChannelCount.load(std::memory_order_acquire);
+
+	std::ofstream stream(path);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	stream << "frame";
+
+	for (std::size_t i = 0; i < channelCount; ++i)
+	{
+		stream << ',' << QuoteCSV(mChannels[i].name);
+	}
+
+	stream << '\n';
+
+	for (std::size_t row = 0; row < rowCount; ++row)
+	{
+		stream << frames[row];
+
+		// missing values are empty cells
+		for (std::size_t i = 0; i < channelCount; ++i)
+		{
+			stream << ',';
+
+			if (const float value = rows[row * kMaxChannels + i]; !std::isnan(value))
+			{
+				stream << value;
+			}
+		}
+
+		stream << '\n';
+	}
+
+	return bool(stream);
+}
+
+bool FrameStatistics::WriteJSON(const std::string& path) const
+{
+	std::vector<float> rows;
+	std::vector<uint64_t> frames;
+
+	const std::size_t rowCount = Snapshot(rows, frames);
+	const std::size_t channelCount = mChannelCount.load(std::memory_order_acquire);
+
+	std::ofstream stream(path);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	stream << "{\n\"firstFrame\": " << (rowCount ? frames[0] : 0) << ",\n\"channels\": [";
+
+	for (std::size_t i = 0; i < channelCount; ++i)
+	{
+		std::vector<float> values;
+		std::vector<float> sorted;
+
+		for (std::size_t row = 0; row < rowCount; ++row)
+		{
+			values.push_back(rows[row * kMaxChannels + i]);
+
+			if (!std::isnan(values.back()))
+			{
+				sorted.push_back(values.back());
+			}
+		}
+
+		// the copy is at hand, so the percentiles here are exact rather than from the sketch
+		std::sort(sorted.begin(), sorted.end());
+
+		double sum = 0.0;
+
+		for (const float value : sorted)
+		{
+			sum += value;
+		}
+
+		stream << (i ? ",\n" : "\n") << "{\"name\": " << QuoteJSON(mChannels[i].name)
+			   << ", \"count\": " << sorted.size()
+			   << ", \"mean\": " << (sorted.empty() ? 0.0 : sum / double(sorted.size()))
+			   << ", \"p50\": " << GetSortedQuantile(sorted, 0.50)
+			   << ", \"p95\": " << GetSortedQuantile(sorted, 0.95)
+			   << ", \"p99\": " << GetSortedQuantile(sorted, 0.99)
+			   << ", \"max\": " << (sorted.empty() ? 0.0 : sorted.back())
+			   << ", \"values\": [";
+
+		for (std::size_t row = 0; row < values.size(); ++row)
+		{
+			stream << (row ? "," : "");
+
+			// json has no NaN
+			if (std::isnan(values[row]))
+			{
+				stream << "null";
+			}
+			else
+			{
+				stream << values[row];
+			}
+		}
+
+		stream << "]}";
+	}
+
+	stream << "\n]\n}\n";
+
+	return bool(stream);
+}
+
+std::size_t FrameStatistics::Snapshot(std::vector<float>& rows, std::vector<uint64_t>& frames) const
+{
+	const uint64_t end = mFrameCount.load(std::memory_order_acquire);
+	const uint64_t begin = (end > mHistorySize) ? end - mHistorySize : 0;
+
+	rows.resize(std::size_t(end - begin) * kMaxChannels);
+
+	for (uint64_t frame = begin; frame < end; ++frame)
+	{
+		const std::atomic<float>* row = &mValues[(frame % mHistorySize) * kMaxChannels];
+
+		for (std::size_t i = 0; i < kMaxChannels; ++i)
+		{
+			rows[std::size_t(frame - begin) * kMaxChannels + i] = row[i].load(std::memory_order_relaxed);
+		}
+	}
+
+	// the frames started meanwhile, written or still being written, overwrote the oldest rows
+	std::atomic_thread_fence(std::memory_order_acquire);
+
+	const uint64_t started = mStartedFrameCount.load(std::memory_order_relaxed);
+	const uint64_t firstValid = std::max(begin, (started > mHistorySize) ? started - mHistorySize : 0);
+	const std::size_t skipped = std::size_t(std::min(firstValid, end) - begin);
+
+	rows.erase(rows.begin(), rows.begin() + skipped * kMaxChannels);
+
+	frames.resize(rows.size() / kMaxChannels);
+
+	for (std::size_t i = 0; i < frames.size(); ++i)
+	{
+		frames[i] = begin + skipped + i;
+	}
+
+	return frames.size();
+}
\ No newline at end of file
@@ -0,0 +1,126 @@
+#pragma once
+
+// std
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// rolling statistics of per-frame values: frame times, pass times and counters, one channel each. the
+// last historySize frames are kept in a ring that other threads can copy without a lock while the frame
+// loop writes it; every channel mirrors the window in a log bucket sketch, values go in as they enter
+// the window and out as they leave it, so quantiles come without sorting and within 1% of the value
+class FrameStatistics
+{
+public:
+
+	static constexpr std::size_t kMaxChannels = 32;
+
+	struct Summary
+	{
+		std::size_t count = 0; // frames in the window that have the value
+		double mean = 0.0;
+		double p50 = 0.0;
+		double p95 = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+		double onePercentHigh = 0.0; // mean of the largest 1%, 1000 over it is the 1% low fps of a frame time in ms
+	};
+
+	explicit FrameStatistics(const std::size_t historySize = 1024);
+
+	FrameStatistics(const FrameStatistics&) = delete;
+	FrameStatistics& operator=(const FrameStatistics&) = delete;
+
+	// the channel with that name, added the first time
+	std::size_t GetChannel(const std::string& name);
+
+	const std::string& GetChannelName(const std::size_t channel) const
+	{
+		assert(channel < mChannelCount);
+		return mChannels[channel].name;
+	}
+
+	std::size_t GetChannelCount() const
+	{
+		return mChannelCount;
+	}
+
+	// value of the current frame, channels without one this frame are left out of their statistics
+	void Record(const std::size_t channel, const double value)
+	{
+		assert(channel < mChannelCount);
+		mPending[channel] = float(value);
+	}
+
+	// commit the recorded values as a frame
+	void EndFrame();
+
+	// from the thread that calls EndFrame
+	Summary GetSummary(const std::size_t channel) const;
+
+	// the window oldest first, missing values are NaN; from any thread
+	void GetHistory(const std::size_t channel, std::vector<float>& values) const;
+
+	// counts of binCount equal bins from 0 to the largest value in the window, which is returned
+	float GetHistogram(const std::size_t channel, const std::size_t binCount, std::vector<float>& counts) const;
+
+	// a row per frame of the window, a column per channel
+	bool WriteCSV(const std::string& path) const;
+
+	// the summary and the window of every channel
+	bool WriteJSON(const std::string& path) const;
+
+private:
+
+	// DDSketch style: bucket i holds the values in (gamma^(i-1), gamma^i]
+	class Sketch
+	{
+	public:
+
+		void Add(const float value, const int32_t weight);
+
+		double GetQuantile(const double q) const;
+		double GetTopMean(const double fraction) const;
+
+		std::size_t GetCount() const
+		{
+			return mCount;
+		}
+
+	private:
+
+		static std::size_t GetBucket(const float value);
+		static double GetBucketValue(const std::size_t bucket);
+
+		std::vector<uint32_t> mBuckets;
+		std::size_t mCount = 0;
+	};
+
+	struct Channel
+	{
+		std::string name;
+		Sketch sketch;
+		double sum = 0.0;
+	};
+
+	// copy of the frames in the window as rows of kMaxChannels, oldest first
+	std::size_t Snapshot(std::vector<float>& rows, std::vector<uint64_t>& frames) const;
+
+	const std::size_t mHistorySize;
+
+	Channel mChannels[kMaxChannels];
+	std::atomic<std::size_t> mChannelCount = 0;
+	std::unordered_map<std::string, std::size_t> mLookup;
+
+	float mPending[kMaxChannels];
+
+	// rows of kMaxChannels values; mStartedFrameCount is published before a row is written and mFrameCount
+	// after, readers drop the rows that were overwritten while they copied
+	std::unique_ptr<std::atomic<float>[]> mValues;
+	std::atomic<uint64_t> mStartedFrameCount = 0;
+	std::atomic<uint64_t> mFrameCount = 0;
+};
\ No newline at end of file
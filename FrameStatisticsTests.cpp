@@ -0,0 +1,210 @@
+#include "UnitTest.h"
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "FrameStatistics.h"
+
+// the sketch quantiles against exact ones, the window sliding over them, and the lock free copy of the
+// ring while it's written
+
+namespace
+{
+	std::string ReadFile(const std::string& path)
+	{
+		std::ifstream stream(path);
+		return std::string(std::istreambuf_iterator<char>(stream), std::istreambuf_iterator<char>());
+	}
+
+	void RecordFrames(FrameStatistics& statistics, const std::size_t channel, const std::size_t count, const double value)
+	{
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			statistics.Record(channel, value);
+			statistics.EndFrame();
+		}
+	}
+
+	bool IsWithinPercent(const double value, const double expected)
+	{
+		return std::fabs(value - expected) <= 0.01 * std::fabs(expected);
+	}
+}
+
+// 1000 frame times spread evenly over 5 to 50 ms in a scrambled order
+UNIT_TEST(FrameStatisticsQuantiles)
+{
+	FrameStatistics statistics(1000);
+	const std::size_t channel = statistics.GetChannel("frame ms");
+
+	std::vector<float> values;
+
+	for (std::size_t i = 0; i < 1000; ++i)
+	{
+		values.push_back(5.0f + 45.0f * float((i * 7919) % 1000) / 999.0f);
+
+		statistics.Record(channel, values.back());
+		statistics.EndFrame();
+	}
+
+	std::sort(values.begin(), values.end());
+
+	const FrameStatistics::Summary summary = statistics.GetSummary(channel);
+
+	// the sketch ranks like the sorted values at floor(q * (n - 1))
+	CHECK(summary.count == 1000);
+	CHECK(IsWithinPercent(summary.p50, values[499]));
+	CHECK(IsWithinPercent(summary.p95, values[949]));
+	CHECK(IsWithinPercent(summary.p99, values[989]));
+	CHECK_NEAR(summary.mean, 27.5, 1e-3);
+	CHECK(summary.max == values.back());
+}
+
+// the mean of the largest 1%, which the sketch takes from its top buckets
+UNIT_TEST(FrameStatisticsTopMean)
+{
+	FrameStatistics statistics(1000);
+	const std::size_t channel = statistics.GetChannel("frame ms");
+
+	RecordFrames(statistics, channel, 10, 100.0);
+	RecordFrames(statistics, channel, 990, 10.0);
+
+	CHECK(IsWithinPercent(statistics.GetSummary(channel).onePercentHigh, 100.0));
+
+	// 5 of the spikes left the window, the top 1% is half spikes now
+	RecordFrames(statistics, channel, 5, 10.0);
+
+	CHECK(IsWithinPercent(statistics.GetSummary(channel).onePercentHigh, 55.0));
+}
+
+// what leaves the window leaves the sketch, and frames without a value don't count
+UNIT_TEST(FrameStatisticsWindow)
+{
+	FrameStatistics statistics(100);
+	const std::size_t channel = statistics.GetChannel("frame ms");
+
+	RecordFrames(statistics, channel, 100, 10.0);
+	RecordFrames(statistics, channel, 100, 20.0);
+
+	FrameStatistics::Summary summary = statistics.GetSummary(channel);
+
+	CHECK(summary.count == 100);
+	CHECK(IsWithinPercent(summary.p50, 20.0));
+	CHECK(IsWithinPercent(summary.p99, 20.0));
+	CHECK_NEAR(summary.mean, 20.0, 1e-6);
+	CHECK(summary.max == 20.0);
+
+	for (int i = 0; i < 50; ++i)
+	{
+		statistics.EndFrame();
+	}
+
+	summary = statistics.GetSummary(channel);
+
+	CHECK(summary.count == 50);
+	CHECK_NEAR(summary.mean, 20.0, 1e-6);
+
+	for (int i = 0; i < 50; ++i)
+	{
+		statistics.EndFrame();
+	}
+
+	CHECK(statistics.GetSummary(channel).count == 0);
+}
+
+// after the ring wrapped the history is the last frames, oldest first
+UNIT_TEST(FrameStatisticsSnapshotWraparound)
+{
+	FrameStatistics statistics(8);
+	const std::size_t channel = statistics.GetChannel("frame");
+
+	for (int frame = 0; frame < 20; ++frame)
+	{
+		statistics.Record(channel, frame);
+		statistics.EndFrame();
+	}
+
+	std::vector<float> values;
+	statistics.GetHistory(channel, values);
+
+	CHECK((values == std::vector<float>{ 12, 13, 14, 15, 16, 17, 18, 19 }));
+
+	CHECK(statistics.WriteCSV("frame_statistics.csv"));
+
+	const std::string csv = ReadFile("frame_statistics.csv");
+	std::remove("frame_statistics.csv");
+
+	CHECK(csv.find("frame,\"frame\"\n12,12\n") == 0);
+	CHECK(csv.find("19,19\n") != std::string::npos);
+	CHECK(csv.find("11,") == std::string::npos);
+}
+
+// a reader copying the ring while frames go in gets whole consecutive frames, never a torn or stale row
+UNIT_TEST(FrameStatisticsConcurrentSnapshot)
+{
+	FrameStatistics statistics(64);
+	const std::size_t channel = statistics.GetChannel("frame");
+
+	std::atomic<bool> isDone = false;
+	std::size_t badSnapshots = 0;
+
+	std::thread reader([&]()
+	{
+		std::vector<float> values;
+
+		while (!isDone.load())
+		{
+			statistics.GetHistory(channel, values);
+
+			for (std::size_t i = 1; i < values.size(); ++i)
+			{
+				if (values[i] != values[i - 1] + 1.0f)
+				{
+					++badSnapshots;
+					break;
+				}
+			}
+		}
+	});
+
+	for (int frame = 0; frame < 200000; ++frame)
+	{
+		statistics.Record(channel, frame);
+		statistics.EndFrame();
+	}
+
+	isDone = true;
+	reader.join();
+
+	CHECK(badSnapshots == 0);
+}
+
+// names are quoted and escaped for each format
+UNIT_TEST(FrameStatisticsNameEscaping)
+{
+	FrameStatistics statistics(4);
+	const std::size_t channel = statistics.GetChannel("pass \"a\\b\"");
+
+	statistics.Record(channel, 1.0);
+	statistics.EndFrame();
+
+	CHECK(statistics.WriteCSV("frame_statistics.csv"));
+	CHECK(statistics.WriteJSON("frame_statistics.json"));
+
+	const std::string csv = ReadFile("frame_statistics.csv");
+	const std::string json = ReadFile("frame_statistics.json");
+
+	std::remove("frame_statistics.csv");
+	std::remove("frame_statistics.json");
+
+	CHECK(csv.find("frame,\"pass \"\"a\\b\"\"\"\n") == 0);
+	CHECK(json.find("{\"name\": \"pass \\\"a\\\\b\\\"\",") != std::string::npos);
+}
\ No newline at end of file
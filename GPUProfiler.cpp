@@ -0,0 +1,231 @@
+#include "GPUProfiler.h"
+
+// std
+#include <algorithm>
+
+//
+#include "CPUProfiler.h"
+
+void GPUProfiler::Init(std::unique_ptr<Backend> backend, const Settings& settings)
+{
+	assert(backend);
+	assert((settings.frameLatency > 0) && (settings.maxTimestampsPerFrame >= 2));
+
+	mBackend = std::move(backend);
+	mSettings = settings;
+	mFrames.assign(settings.frameLatency, FrameSet());
+
+	// the frame begin and end, and room for a handful of scopes before the first growth
+	mTimestampCapacity = std::min<std::size_t>(32, settings.maxTimestampsPerFrame);
+	mBackend->Allocate(mFrames.size(), mTimestampCapacity);
+}
+
+void GPUProfiler::BeginFrame()
+{
+	if (!mBackend)
+	{
+		return;
+	}
+
+	assert(!mIsInFrame);
+
+	++mFrame;
+	mIsInFrame = true;
+
+	FrameSet& set = mFrames[mFrame % mFrames.size()];
+
+	// the gpu is further behind than the ring is deep, the oldest results are lost rather than waited for
+	if (set.isPending)
+	{
+		++mStats.droppedFrames;
+		mOldestPendingFrame = set.frame + 1;
+	}
+
+	set.frame = mFrame;
+	set.cpuBeginTicks = CPUProfiler::GetTicks();
+	set.records.clear();
+	set.timestampCount = 2; // 0 is the frame begin, 1 its end
+	set.isPending = false;
+	set.isOverflowed = false;
+
+	mBackend->BeginFrame(mFrame % mFrames.size());
+	mBackend->Timestamp(mFrame % mFrames.size(), 0);
+}
+
+void GPUProfiler::EndFrame()
+{
+	if (!mBackend)
+	{
+		return;
+	}
+
+	assert(mIsInFrame && mOpenScopes.empty());
+
+	FrameSet& set = mFrames[mFrame % mFrames.size()];
+
+	mBackend->Timestamp(mFrame % mFrames.size(), 1);
+	mBackend->EndFrame(mFrame % mFrames.size());
+
+	set.isPending = true;
+	mIsInFrame = false;
+
+	mStats.overflowedFrames += set.isOverflowed ? 1 : 0;
+
+	Resolve();
+}
+
+void GPUProfiler::BeginScope(const std::string_view name)
+{
+	uint32_t begin = 0;
+
+	if (!mIsInFrame || !ReserveTimestamps(2, begin))
+	{
+		mOpenScopes.push_back(kNoRecord);
+		return;
+	}
+
+	auto i = mScopeLookup.find(name);
+
+	if (i == mScopeLookup.end())
+	{
+		i = mScopeLookup.emplace(std::string(name), uint32_t(mScopeNames.size())).first;
+		mScopeNames.emplace_back(name);
+	}
+
+	FrameSet& set = mFrames[mFrame % mFrames.size()];
+
+	Record record;
+	record.scope = i->second;
+	record.depth = uint32_t(mOpenScopes.size());
+	record.begin = begin;
+
+	mOpenScopes.push_back(set.records.size());
+	set.records.push_back(record);
+
+	mBackend->BeginEvent(i->first);
+	mBackend->Timestamp(mFrame % mFrames.size(), begin);
+}
+
+void GPUProfiler::EndScope()
+{
+	assert(!mOpenScopes.empty());
+
+	const std::size_t record = mOpenScopes.back();
+	mOpenScopes.pop_back();
+
+	if (record == kNoRecord)
+	{
+		return;
+	}
+
+	const FrameSet& set = mFrames[mFrame % mFrames.size()];
+
+	mBackend->Timestamp(mFrame % mFrames.size(), set.records[record].begin + 1);
+	mBackend->EndEvent();
+}
+
+double GPUProfiler::GetScopeMs(const std::string_view name) const
+{
+	const auto i = mScopeLookup.find(name);
+
+	if (i == mScopeLookup.end())
+	{
+		return 0.0;
+	}
+
+	double ms = 0.0;
+
+	for (const ScopeResult& result : mResults)
+	{
+		ms += (result.scope == i->second) ? result.durationMs : 0.0;
+	}
+
+	return ms;
+}
+
+bool GPUProfiler::ReserveTimestamps(const uint32_t count, uint32_t& first)
+{
+	FrameSet& set = mFrames[mFrame % mFrames.size()];
+
+	if (set.timestampCount + count > mSettings.maxTimestampsPerFrame)
+	{
+		set.isOverflowed = true;
+		return false;
+	}
+
+	if (set.timestampCount + count > mTimestampCapacity)
+	{
+		mTimestampCapacity = std::min(mTimestampCapacity * 2, mSettings.maxTimestampsPerFrame);
+		mBackend->Allocate(mFrames.size(), mTimestampCapacity);
+	}
+
+	first = set.timestampCount;
+	set.timestampCount += count;
+
+	return true;
+}
+
+void GPUProfiler::Resolve()
+{
+	std::vector<uint64_t> timestamps;
+
+	mResolvedFrames.clear();
+
+	for (; mOldestPendingFrame <= mFrame; ++mOldestPendingFrame)
+	{
+		const std::size_t index = mOldestPendingFrame % mFrames.size();
+		FrameSet& set = mFrames[index];
+
+		assert(set.isPending && (set.frame == mOldestPendingFrame));
+
+		uint64_t frequency = 0;
+		bool isDisjoint = false;
+
+		if (!mBackend->GetFrameData(index, frequency, isDisjoint))
+		{
+			return;
+		}
+
+		timestamps.resize(set.timestampCount);
+
+		for (std::size_t i = 0; i < timestamps.size(); ++i)
+		{
+			if (!mBackend->GetTimestamp(index, i, timestamps[i]))
+			{
+				return;
+			}
+		}
+
+		set.isPending = false;
+
+		if (isDisjoint || (frequency == 0))
+		{
+			++mStats.disjointFrames;
+			continue;
+		}
+
+		const auto ToMs = [&](const uint64_t begin, const uint64_t end)
+		{
+			return (end > begin) ? 1000.0 * double(end - begin) / double(frequency) : 0.0;
+		};
+
+		mResults.resize(set.records.size());
+
+		for (std::size_t i = 0; i < set.records.size(); ++i)
+		{
+			const Record& record = set.records[i];
+
+			mResults[i].scope = record.scope;
+			mResults[i].depth = record.depth;
+			mResults[i].beginMs = ToMs(timestamps[0], timestamps[record.begin]);
+			mResults[i].durationMs = ToMs(timestamps[record.begin], timestamps[record.begin + 1]);
+		}
+
+		mFrameMs = ToMs(timestamps[0], timestamps[1]);
+		mResolvedFrame = set.frame;
+		mResolvedFrameTiming = { set.cpuBeginTicks, timestamps[0], frequency };
+		mResolvedFrames.push_back({ set.frame, mFrameMs });
+
+		++mStats.resolvedFrames;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,235 @@
+#pragma once
+
+// std
+#include <cassert>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// gpu timestamps of nested, named scopes that are registered the first time they are used. every frame
+// gets its own set of queries out of a ring, and the sets are read back only once the gpu is done with
+// them, so the results trail by a few frames but the cpu never waits. the queries go through Backend,
+// which keeps the bookkeeping free of device calls
+class GPUProfiler
+{
+public:
+
+	// the device queries of frameCount sets, each a disjoint query and timestampCount timestamps
+	class Backend
+	{
+	public:
+
+		virtual ~Backend() = default;
+
+		// called again with a larger timestampCount when a frame needs more, the existing queries are kept
+		virtual void Allocate(const std::size_t frameCount, const std::size_t timestampCount) = 0;
+
+		virtual void BeginFrame(const std::size_t set) = 0;
+		virtual void EndFrame(const std::size_t set) = 0;
+		virtual void Timestamp(const std::size_t set, const std::size_t index) = 0;
+
+		// false until the results are available, never waits for them
+		virtual bool GetFrameData(const std::size_t set, uint64_t& frequency, bool& isDisjoint) = 0;
+		virtual bool GetTimestamp(const std::size_t set, const std::size_t index, uint64_t& timestamp) = 0;
+
+		// markers for the graphics debuggers
+		virtual void BeginEvent(const std::string& name) {}
+		virtual void EndEvent() {}
+	};
+
+	struct Settings
+	{
+		std::size_t frameLatency = 5;            // query sets, more than the frames the gpu can trail behind
+		std::size_t maxTimestampsPerFrame = 256; // scopes past this are dropped for the frame
+	};
+
+	struct ScopeResult
+	{
+		uint32_t scope = 0;  // GetScopeName
+		uint32_t depth = 0;  // 0 for the outermost scopes
+		double beginMs = 0.0; // from the start of the frame
+		double durationMs = 0.0;
+	};
+
+	struct ResolvedFrame
+	{
+		uint64_t frame = 0;
+		double frameMs = 0.0;
+	};
+
+	struct Stats
+	{
+		std::size_t resolvedFrames = 0;
+		std::size_t droppedFrames = 0;    // overwritten before their results came back
+		std::size_t disjointFrames = 0;   // the gpu clock changed, the timestamps are meaningless
+		std::size_t overflowedFrames = 0; // had scopes dropped for lack of timestamps
+	};
+
+	// BeginScope and EndScope for the lifetime of the object
+	class Scope
+	{
+	public:
+
+		Scope(GPUProfiler& profiler, const std::string_view name) :
+			mProfiler(profiler)
+		{
+			mProfiler.BeginScope(name);
+		}
+
+		~Scope()
+		{
+			mProfiler.EndScope();
+		}
+
+		Scope(const Scope&) = delete;
+		Scope& operator=(const Scope&) = delete;
+
+	private:
+
+		GPUProfiler& mProfiler;
+	};
+
+	void Init(std::unique_ptr<Backend> backend, const Settings& settings);
+
+	void Shutdown()
+	{
+		mBackend.reset();
+		mFrames.clear();
+		mResolvedFrames.clear();
+	}
+
+	bool IsInitialized() const
+	{
+		return mBackend != nullptr;
+	}
+
+	// a frame is whatever the gpu executes between these, they do nothing before Init
+	void BeginFrame();
+	void EndFrame();
+
+	void BeginScope(const std::string_view name);
+	void EndScope();
+
+	// the scopes of the last resolved frame in the order they began, parents before their children
+	const std::vector<ScopeResult>& GetResults() const
+	{
+		return mResults;
+	}
+
+	// the names stay where they are for the lifetime of the profiler
+	const std::string& GetScopeName(const uint32_t scope) const
+	{
+		assert(scope < mScopeNames.size());
+		return mScopeNames[scope];
+	}
+
+	// total of the scopes with that name in the last resolved frame
+	double GetScopeMs(const std::string_view name) const;
+
+	double GetFrameMs() const
+	{
+		return mFrameMs;
+	}
+
+	// the frame BeginFrame began last, 0 before the first
+	uint64_t GetFrame() const
+	{
+		return mFrame;
+	}
+
+	// the frame the results are from, counted from 1 by BeginFrame, 0 while nothing was resolved
+	uint64_t GetResolvedFrame() const
+	{
+		return mResolvedFrame;
+	}
+
+	// every frame the last EndFrame resolved, oldest first, without the disjoint ones; a frame that came
+	// back late resolves along with the next ones, and GetResults and GetFrameMs only hold the last of them
+	const std::vector<ResolvedFrame>& GetResolvedFrames() const
+	{
+		return mResolvedFrames;
+	}
+
+	// when the resolved frame began on both clocks, to line the gpu timeline up with the cpu one
+	struct FrameTiming
+	{
+		uint64_t cpuBeginTicks = 0; // CPUProfiler::GetTicks at BeginFrame
+		uint64_t gpuBeginTicks = 0;
+		uint64_t gpuFrequency = 0;
+	};
+
+	const FrameTiming& GetResolvedFrameTiming() const
+	{
+		return mResolvedFrameTiming;
+	}
+
+	const Stats& GetStats() const
+	{
+		return mStats;
+	}
+
+private:
+
+	struct Record
+	{
+		uint32_t scope = 0;
+		uint32_t depth = 0;
+		uint32_t begin = 0; // timestamp index within the frame set, the end is the next one
+	};
+
+	struct FrameSet
+	{
+		uint64_t frame = 0;
+		uint64_t cpuBeginTicks = 0;
+		std::vector<Record> records;
+		uint32_t timestampCount = 0;
+		bool isPending = false;
+		bool isOverflowed = false;
+	};
+
+	// transparent, so lookups by string_view don't build a string
+	struct NameHash
+	{
+		using is_transparent = void;
+
+		std::size_t operator()(const std::string_view name) const
+		{
+			return std::hash<std::string_view>()(name);
+		}
+	};
+
+	// reserve count timestamps of the current frame, growing the query sets up to the maximum; false
+	// when the frame is out of them
+	bool ReserveTimestamps(const uint32_t count, uint32_t& first);
+
+	// read back the finished frames, oldest first, stopping at the first one that isn't done
+	void Resolve();
+
+	std::unique_ptr<Backend> mBackend;
+	Settings mSettings;
+	Stats mStats;
+
+	std::vector<FrameSet> mFrames;
+	std::size_t mTimestampCapacity = 0;
+	uint64_t mFrame = 0;
+	uint64_t mOldestPendingFrame = 1;
+	bool mIsInFrame = false;
+
+	// records of the scopes still open in the current frame, kNoRecord for the dropped ones
+	static constexpr std::size_t kNoRecord = ~std::size_t(0);
+	std::vector<std::size_t> mOpenScopes;
+
+	std::unordered_map<std::string, uint32_t, NameHash, std::equal_to<>> mScopeLookup;
+	std::deque<std::string> mScopeNames;
+
+	std::vector<ScopeResult> mResults;
+	double mFrameMs = 0.0;
+	uint64_t mResolvedFrame = 0;
+	std::vector<ResolvedFrame> mResolvedFrames;
+	FrameTiming mResolvedFrameTiming;
+};
\ No newline at end of file
@@ -0,0 +1,68 @@
+#include "GPUProfilerD3D11.h"
+
+//
+#include "Utility.h"
+
+void GPUProfilerD3D11::Allocate(const std::size_t frameCount, const std::size_t timestampCount)
+{
+	D3D11_QUERY_DESC desc;
+	desc.MiscFlags = 0;
+
+	desc.Query = D3D11_QUERY_TIMESTAMP_DISJOINT;
+
+	while (mDisjointQueries.size() < frameCount)
+	{
+		ThrowIfFailed(mDevice->CreateQuery(&desc, &mDisjointQueries.emplace_back()));
+	}
+
+	desc.Query = D3D11_QUERY_TIMESTAMP;
+
+	mTimestampQueries.resize(frameCount);
+
+	// only the new ones are created, queries of frames in flight must keep their results
+	for (std::vector<ComPtr<ID3D11Query>>& queries : mTimestampQueries)
+	{
+		while (queries.size() < timestampCount)
+		{
+			ThrowIfFailed(mDevice->CreateQuery(&desc, &queries.emplace_back()));
+		}
+	}
+}
+
+bool GPUProfilerD3D11::GetFrameData(const std::size_t set, uint64_t& frequency, bool& isDisjoint)
+{
+	D3D11_QUERY_DATA_TIMESTAMP_DISJOINT data;
+
+	// no flush either, present submits the frame
+	if (mContext->GetData(mDisjointQueries[set].Get(), &data, sizeof(data), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+	{
+		return false;
+	}
+
+	frequency = data.Frequency;
+	isDisjoint = data.Disjoint;
+
+	return true;
+}
+
+bool GPUProfilerD3D11::GetTimestamp(const std::size_t set, const std::size_t index, uint64_t& timestamp)
+{
+	UINT64 data = 0;
+
+	if (mContext->GetData(mTimestampQueries[set][index].Get(), &data, sizeof(data), D3D11_ASYNC_GETDATA_DONOTFLUSH) != S_OK)
+	{
+		return false;
+	}
+
+	timestamp = data;
+
+	return true;
+}
+
+void GPUProfilerD3D11::BeginEvent(const std::string& name)
+{
+	if (mAnnotation)
+	{
+		mAnnotation->BeginEvent(std::wstring(name.begin(), name.end()).c_str());
+	}
+}
\ No newline at end of file
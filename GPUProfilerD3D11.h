@@ -0,0 +1,69 @@
+#pragma once
+
+// windows
+#include <wrl.h>
+using Microsoft::WRL::ComPtr;
+
+// std
+#include <vector>
+
+// d3d
+#include <d3d11.h>
+#include <d3d11_1.h>
+
+//
+#include "GPUProfiler.h"
+
+// the GPUProfiler queries on a d3d11 device, the events go to the user defined annotations when there are any
+class GPUProfilerD3D11 : public GPUProfiler::Backend
+{
+public:
+
+	GPUProfilerD3D11(const ComPtr<ID3D11Device>& pDevice,
+					 const ComPtr<ID3D11DeviceContext>& pContext,
+					 const ComPtr<ID3DUserDefinedAnnotation>& pAnnotation = nullptr) :
+		mDevice(pDevice),
+		mContext(pContext),
+		mAnnotation(pAnnotation)
+	{
+	}
+
+	void Allocate(const std::size_t frameCount, const std::size_t timestampCount) override;
+
+	void BeginFrame(const std::size_t set) override
+	{
+		mContext->Begin(mDisjointQueries[set].Get());
+	}
+
+	void EndFrame(const std::size_t set) override
+	{
+		mContext->End(mDisjointQueries[set].Get());
+	}
+
+	void Timestamp(const std::size_t set, const std::size_t index) override
+	{
+		mContext->End(mTimestampQueries[set][index].Get());
+	}
+
+	bool GetFrameData(const std::size_t set, uint64_t& frequency, bool& isDisjoint) override;
+	bool GetTimestamp(const std::size_t set, const std::size_t index, uint64_t& timestamp) override;
+
+	void BeginEvent(const std::string& name) override;
+
+	void EndEvent() override
+	{
+		if (mAnnotation)
+		{
+			mAnnotation->EndEvent();
+		}
+	}
+
+private:
+
+	ComPtr<ID3D11Device> mDevice;
+	ComPtr<ID3D11DeviceContext> mContext;
+	ComPtr<ID3DUserDefinedAnnotation> mAnnotation;
+
+	std::vector<ComPtr<ID3D11Query>> mDisjointQueries;
+	std::vector<std::vector<ComPtr<ID3D11Query>>> mTimestampQueries;
+};
\ No newline at end of file
@@ -0,0 +1,278 @@
+#include "UnitTest.h"
+
+// std
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "GPUProfiler.h"
+
+// the query bookkeeping of GPUProfiler against a backend whose results come back when the test says so
+
+namespace
+{
+	// what the mock backend saw and holds, owned by the test since the profiler owns the backend
+	struct Device
+	{
+		std::vector<std::size_t> allocations; // timestampCount of every Allocate
+		std::vector<std::vector<uint64_t>> timestamps;
+		std::vector<bool> isDone;             // per set, the gpu finished it
+		std::size_t outOfRangeCount = 0;      // timestamps written past the allocation
+		uint64_t clock = 0;
+	};
+
+	// every timestamp a millisecond after the last one, at a MHz
+	class MockBackend : public GPUProfiler::Backend
+	{
+	public:
+
+		explicit MockBackend(Device& device) : mDevice(device) {}
+
+		void Allocate(const std::size_t frameCount, const std::size_t timestampCount) override
+		{
+			mDevice.allocations.push_back(timestampCount);
+			mDevice.timestamps.resize(frameCount);
+			mDevice.isDone.resize(frameCount, false);
+
+			for (std::vector<uint64_t>& timestamps : mDevice.timestamps)
+			{
+				timestamps.resize(timestampCount, 0);
+			}
+		}
+
+		void BeginFrame(const std::size_t set) override
+		{
+			mDevice.isDone[set] = false;
+		}
+
+		void EndFrame(const std::size_t set) override {}
+
+		void Timestamp(const std::size_t set, const std::size_t index) override
+		{
+			if (index >= mDevice.timestamps[set].size())
+			{
+				++mDevice.outOfRangeCount;
+				return;
+			}
+
+			mDevice.clock += 1000;
+			mDevice.timestamps[set][index] = mDevice.clock;
+		}
+
+		bool GetFrameData(const std::size_t set, uint64_t& frequency, bool& isDisjoint) override
+		{
+			frequency = 1000000;
+			isDisjoint = false;
+
+			return mDevice.isDone[set];
+		}
+
+		bool GetTimestamp(const std::size_t set, const std::size_t index, uint64_t& timestamp) override
+		{
+			if (!mDevice.isDone[set] || (index >= mDevice.timestamps[set].size()))
+			{
+				return false;
+			}
+
+			timestamp = mDevice.timestamps[set][index];
+
+			return true;
+		}
+
+	private:
+
+		Device& mDevice;
+	};
+
+	void Init(GPUProfiler& profiler, Device& device, const std::size_t frameLatency, const std::size_t maxTimestampsPerFrame)
+	{
+		GPUProfiler::Settings settings;
+		settings.frameLatency = frameLatency;
+		settings.maxTimestampsPerFrame = maxTimestampsPerFrame;
+
+		profiler.Init(std::make_unique<MockBackend>(device), settings);
+	}
+
+	std::vector<uint64_t> GetResolvedFrameNumbers(const GPUProfiler& profiler)
+	{
+		std::vector<uint64_t> frames;
+
+		for (const GPUProfiler::ResolvedFrame& resolved : profiler.GetResolvedFrames())
+		{
+			frames.push_back(resolved.frame);
+		}
+
+		return frames;
+	}
+
+	void SetAllDone(Device& device)
+	{
+		device.isDone.assign(device.isDone.size(), true);
+	}
+
+	void Frame(GPUProfiler& profiler, Device& device, const std::size_t scopeCount, const bool isDone)
+	{
+		profiler.BeginFrame();
+
+		for (std::size_t i = 0; i < scopeCount; ++i)
+		{
+			GPUProfiler::Scope scope(profiler, "scope" + std::to_string(i % 4));
+		}
+
+		if (isDone)
+		{
+			SetAllDone(device);
+		}
+
+		profiler.EndFrame();
+	}
+}
+
+UNIT_TEST(GPUProfilerScopeTimes)
+{
+	Device device;
+	GPUProfiler profiler;
+	Init(profiler, device, 3, 256);
+
+	profiler.BeginFrame();
+	{
+		GPUProfiler::Scope outer(profiler, "outer");
+		GPUProfiler::Scope inner(profiler, "inner");
+	}
+	SetAllDone(device);
+	profiler.EndFrame();
+
+	// frame begin, outer begin, inner begin, inner end, outer end, frame end a millisecond apart
+	const std::vector<GPUProfiler::ScopeResult>& results = profiler.GetResults();
+
+	CHECK(profiler.GetResolvedFrame() == 1);
+	CHECK(results.size() == 2);
+	CHECK((profiler.GetScopeName(results[0].scope) == "outer") && (results[0].depth == 0));
+	CHECK((profiler.GetScopeName(results[1].scope) == "inner") && (results[1].depth == 1));
+	CHECK_NEAR(results[0].beginMs, 1.0, 1e-9);
+	CHECK_NEAR(results[0].durationMs, 3.0, 1e-9);
+	CHECK_NEAR(results[1].durationMs, 1.0, 1e-9);
+	CHECK_NEAR(profiler.GetFrameMs(), 5.0, 1e-9);
+	CHECK_NEAR(profiler.GetScopeMs("inner"), 1.0, 1e-9);
+}
+
+// the sets start with 32 timestamps and double up to the maximum as a frame needs more
+UNIT_TEST(GPUProfilerQueryGrowth)
+{
+	Device device;
+	GPUProfiler profiler;
+	Init(profiler, device, 3, 256);
+
+	Frame(profiler, device, 40, true); // 82 timestamps
+
+	CHECK((device.allocations == std::vector<std::size_t>{ 32, 64, 128 }));
+	CHECK(device.outOfRangeCount == 0);
+	CHECK(profiler.GetResults().size() == 40);
+
+	// already big enough
+	Frame(profiler, device, 40, true);
+
+	CHECK(device.allocations.size() == 3);
+	CHECK(profiler.GetStats().overflowedFrames == 0);
+}
+
+// past maxTimestampsPerFrame the scopes are dropped for the frame, nested or not, and the rest balance
+UNIT_TEST(GPUProfilerOverflow)
+{
+	Device device;
+	GPUProfiler profiler;
+	Init(profiler, device, 3, 16);
+
+	profiler.BeginFrame();
+	{
+		GPUProfiler::Scope outer(profiler, "outer");
+
+		for (int i = 0; i < 10; ++i)
+		{
+			GPUProfiler::Scope inner(profiler, "inner");
+		}
+	}
+	SetAllDone(device);
+	profiler.EndFrame();
+
+	// the frame's own two and seven scopes
+	CHECK(device.outOfRangeCount == 0);
+	CHECK(device.allocations.back() == 16);
+	CHECK(profiler.GetStats().overflowedFrames == 1);
+	CHECK(profiler.GetResults().size() == 7);
+
+	Frame(profiler, device, 3, true);
+
+	CHECK(profiler.GetStats().overflowedFrames == 1);
+	CHECK(profiler.GetResults().size() == 3);
+}
+
+// a gpu further behind than the ring costs the oldest frames, the rest still resolve in order
+UNIT_TEST(GPUProfilerDroppedFrames)
+{
+	Device device;
+	GPUProfiler profiler;
+	Init(profiler, device, 3, 256);
+
+	for (int frame = 0; frame < 5; ++frame)
+	{
+		Frame(profiler, device, 1, false);
+	}
+
+	// frames 4 and 5 took the sets of 1 and 2
+	CHECK(profiler.GetStats().droppedFrames == 2);
+	CHECK(profiler.GetStats().resolvedFrames == 0);
+
+	// frame 6 takes the set of 3, then 4, 5 and 6 come back
+	Frame(profiler, device, 1, true);
+
+	CHECK(profiler.GetStats().droppedFrames == 3);
+	CHECK(profiler.GetStats().resolvedFrames == 3);
+	CHECK(profiler.GetResolvedFrame() == 6);
+	CHECK(GetResolvedFrameNumbers(profiler) == (std::vector<uint64_t>{ 4, 5, 6 }));
+}
+
+// frames resolve oldest first, one that isn't done holds back the later ones even when they are
+UNIT_TEST(GPUProfilerResolveOrder)
+{
+	Device device;
+	GPUProfiler profiler;
+	Init(profiler, device, 5, 256);
+
+	for (int frame = 0; frame < 3; ++frame)
+	{
+		Frame(profiler, device, 1, false);
+	}
+
+	// frames 2 and 3 are done, 1 isn't
+	device.isDone[2] = true;
+	device.isDone[3] = true;
+
+	profiler.BeginFrame();
+	profiler.EndFrame();
+
+	CHECK(profiler.GetStats().resolvedFrames == 0);
+	CHECK(profiler.GetResolvedFrame() == 0);
+	CHECK(profiler.GetResolvedFrames().empty());
+
+	// 1 to 3 come back, frame 4 isn't done and stops the resolve there
+	device.isDone[1] = true;
+
+	profiler.BeginFrame();
+	profiler.EndFrame();
+
+	CHECK(profiler.GetStats().resolvedFrames == 3);
+	CHECK(profiler.GetResolvedFrame() == 3);
+	CHECK(GetResolvedFrameNumbers(profiler) == (std::vector<uint64_t>{ 1, 2, 3 }));
+	CHECK_NEAR(profiler.GetResolvedFrames()[0].frameMs, 3.0, 1e-9);
+	CHECK(profiler.GetStats().droppedFrames == 0);
+
+	// the list is of the last EndFrame only
+	device.isDone[4] = true;
+
+	profiler.BeginFrame();
+	profiler.EndFrame();
+
+	CHECK(GetResolvedFrameNumbers(profiler) == (std::vector<uint64_t>{ 4 }));
+}
\ No newline at end of file
@@ -0,0 +1,250 @@
+#include "AppInst.h"
+
+// std
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "PlatformHeadless.h"
+#include "RenderDeviceNull.h"
+
+// the app without a window or a gpu, for build machines:
+// headless [--frames n] [--json path] [--csv path] [--print-frames] [--submission path] [--baseline path [--tolerance t]]
+//          [--camera-path path [--camera-step seconds] [--camera-benchmark path]] [--record-camera path]
+// --submission writes what the last frame submitted, --baseline compares it against one written before
+// and fails when a value moved by more than the relative tolerance. --camera-path replays a recorded
+// path one step per frame until it ends and --camera-benchmark writes the times of its frames;
+// --record-camera writes the path the camera took
+int main(int argc, char* argv[])
+{
+    uint64_t frameCount = 1000;
+    std::string jsonPath;
+    std::string csvPath;
+    bool printFrames = false;
+    std::string submissionPath;
+    std::string baselinePath;
+    double tolerance = 0.0;
+    bool hasFrameCount = false;
+    std::string cameraPath;
+    double cameraStep = 1.0 / 60.0;
+    std::string cameraBenchmarkPath;
+    std::string recordCameraPath;
+
+    for (int i = 1; i < argc; ++i)
+    {
+        const bool hasValue = (i + 1) < argc;
+
+        if ((std::strcmp(argv[i], "--frames") == 0) && hasValue)
+        {
+            frameCount = std::strtoull(argv[++i], nullptr, 10);
+            hasFrameCount = true;
+        }
+        else if ((std::strcmp(argv[i], "--json") == 0) && hasValue)
+        {
+            jsonPath = argv[++i];
+        }
+        else if ((std::strcmp(argv[i], "--csv") == 0) && hasValue)
+        {
+            csvPath = argv[++i];
+        }
+        else if (std::strcmp(argv[i], "--print-frames") == 0)
+        {
+            printFrames = true;
+        }
+        else if ((std::strcmp(argv[i], "--submission") == 0) && hasValue)
+        {
+            submissionPath = argv[++i];
+        }
+        else if ((std::strcmp(argv[i], "--baseline") == 0) && hasValue)
+        {
+            baselinePath = argv[++i];
+        }
+        else if ((std::strcmp(argv[i], "--tolerance") == 0) && hasValue)
+        {
+            tolerance = std::strtod(argv[++i], nullptr);
+        }
+        else if ((std::strcmp(argv[i], "--camera-path") == 0) && hasValue)
+        {
+            cameraPath = argv[++i];
+        }
+        else if ((std::strcmp(argv[i], "--camera-step") == 0) && hasValue)
+        {
+            cameraStep = std::strtod(argv[++i], nullptr);
+        }
+        else if ((std::strcmp(argv[i], "--camera-benchmark") == 0) && hasValue)
+        {
+            cameraBenchmarkPath = argv[++i];
+        }
+        else if ((std::strcmp(argv[i], "--record-camera") == 0) && hasValue)
+        {
+            recordCameraPath = argv[++i];
+        }
+        else
+        {
+            std::fprintf(stderr,
+                         "usage: %s [--frames n] [--json path] [--csv path] [--print-frames] [--submission path] [--baseline path [--tolerance t]]"
+                         " [--camera-path path [--camera-step seconds] [--camera-benchmark path]] [--record-camera path]\n",
+                         argv[0]);
+            return 1;
+        }
+    }
+
+    if (!cameraPath.empty() && !(cameraStep > 0.0))
+    {
+        std::fprintf(stderr, "--camera-step has to be positive\n");
+        return 1;
+    }
+
+    try
+    {
+        SubmissionStatistics::Values baseline;
+
+        CameraPath path;
+
+        if (!cameraPath.empty())
+        {
+            if (!path.Read(cameraPath) || path.IsEmpty())
+            {
+                std::fprintf(stderr, "can't read %s\n", cameraPath.c_str());
+                return 1;
+            }
+
+            // the path decides when the run ends
+            if (!hasFrameCount)
+            {
+                frameCount = std::numeric_limits<uint64_t>::max();
+            }
+        }
+
+        if (!baselinePath.empty() && !SubmissionStatistics::Read(baselinePath, baseline))
+        {
+            std::fprintf(stderr, "can't read %s\n", baselinePath.c_str());
+            return 1;
+        }
+
+        auto pRenderDevice = std::make_unique<RenderDeviceNull>();
+        const RenderDeviceNull& renderDevice = *pRenderDevice;
+
+        if (printFrames)
+        {
+            pRenderDevice->SetReportCallback([](const SubmissionStatistics::Report& report)
+            {
+                SubmissionStatistics::Print(report, std::cout);
+                std::cout << '\n';
+            });
+        }
+
+        AppInst app(std::make_unique<PlatformHeadless>(frameCount), std::move(pRenderDevice));
+
+        if (!app.Init())
+        {
+            return 1;
+        }
+
+        if (!path.IsEmpty())
+        {
+            app.PlayCameraPath(path, cameraStep, true);
+        }
+
+        if (!recordCameraPath.empty())
+        {
+            app.StartCameraRecording();
+        }
+
+        const auto start = std::chrono::steady_clock::now();
+        const int exitCode = app.Run();
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        if (!path.IsEmpty())
+        {
+            frameCount = app.GetCameraBenchmarkFrames().size();
+        }
+
+        std::printf("%llu frames in %.3f s, %.2f fps\n", (unsigned long long)frameCount, seconds, (seconds > 0.0) ? frameCount / seconds : 0.0);
+
+        const FrameStatistics& statistics = app.GetFrameStatistics();
+
+        for (std::size_t channel = 0; channel < statistics.GetChannelCount(); ++channel)
+        {
+            const FrameStatistics::Summary summary = statistics.GetSummary(channel);
+
+            std::printf("%-24s count %6zu  mean %8.3f  p50 %8.3f  p95 %8.3f  p99 %8.3f  max %8.3f\n",
+                        statistics.GetChannelName(channel).c_str(),
+                        summary.count,
+                        summary.mean,
+                        summary.p50,
+                        summary.p95,
+                        summary.p99,
+                        summary.max);
+        }
+
+        if (!jsonPath.empty() && !statistics.WriteJSON(jsonPath))
+        {
+            std::fprintf(stderr, "can't write %s\n", jsonPath.c_str());
+            return 1;
+        }
+
+        if (!csvPath.empty() && !statistics.WriteCSV(csvPath))
+        {
+            std::fprintf(stderr, "can't write %s\n", csvPath.c_str());
+            return 1;
+        }
+
+        if (!cameraBenchmarkPath.empty() && !app.WriteCameraBenchmark(cameraBenchmarkPath))
+        {
+            std::fprintf(stderr, "can't write %s\n", cameraBenchmarkPath.c_str());
+            return 1;
+        }
+
+        if (!recordCameraPath.empty() && !app.StopCameraRecording().Write(recordCameraPath))
+        {
+            std::fprintf(stderr, "can't write %s\n", recordCameraPath.c_str());
+            return 1;
+        }
+
+        const SubmissionStatistics::Report& report = renderDevice.GetSubmissionReport();
+
+        if (!submissionPath.empty() && !SubmissionStatistics::Write(report, submissionPath))
+        {
+            std::fprintf(stderr, "can't write %s\n", submissionPath.c_str());
+            return 1;
+        }
+
+        if (!baselinePath.empty())
+        {
+            SubmissionStatistics::Values current = SubmissionStatistics::Flatten(report);
+
+            // the run lengths may differ, what a frame submits may not
+            baseline.erase("frame");
+            current.erase("frame");
+
+            const std::vector<SubmissionStatistics::Difference> differences = SubmissionStatistics::Compare(baseline, current, tolerance);
+
+            for (const SubmissionStatistics::Difference& difference : differences)
+            {
+                std::printf("%-48s baseline %12llu  current %12llu\n",
+                            difference.name.c_str(),
+                            (unsigned long long)difference.baseline,
+                            (unsigned long long)difference.current);
+            }
+
+            if (!differences.empty())
+            {
+                std::fprintf(stderr, "%zu submission values differ from %s\n", differences.size(), baselinePath.c_str());
+                return 1;
+            }
+        }
+
+        return exitCode;
+    }
+    catch (Exception& exception)
+    {
+        std::wcerr << L"HR Failed\n" << exception.ToString();
+        return 1;
+    }
+}
\ No newline at end of file
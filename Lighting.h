@@ -4,6 +4,10 @@
 #include <directxmath.h>
 using namespace DirectX;
 
+// std
+#include <cassert>
+#include <vector>
+
 //
 #include "Timer.h"
 
@@ -27,7 +31,7 @@ public:
 
     void UpdateLights(const Timer& timer)
     {
-        mLightRotationAngle += 0.1f * timer.GetDeltaTime();
+        mLightRotationAngle += 0.1f * float(timer.GetDeltaTime());
 
         XMMATRIX R = XMMatrixRotationY(mLightRotationAngle);
         for (int i = 0; i < 3; ++i)
@@ -36,10 +40,36 @@ public:
             dir = XMVector3TransformNormal(dir, R);
             XMStoreFloat3(&mCurrentLightDirections[i], dir);
         }
+
+        for (size_t i = 0; i < mPointLights.size(); ++i)
+        {
+            XMVECTOR position = XMLoadFloat3(&mBeginPointLightPositions[i]);
+            position = XMVector3Transform(position, R);
+            XMStoreFloat3(&mPointLights[i].position, position);
+        }
     }
 
     const XMFLOAT3& GetLightDirection(const size_t i) const { return mCurrentLightDirections[i]; }
 
+    // point lights go after the directional ones in the main pass CB, see LIGHT_POINT_COUNT in
+    // LightingUtils.hlsl; they circle the origin the way the directional ones turn
+    size_t AddPointLight(const Light& light)
+    {
+        mPointLights.push_back(light);
+        mBeginPointLightPositions.push_back(light.position);
+
+        return mPointLights.size() - 1;
+    }
+
+    size_t GetPointLightCount() const { return mPointLights.size(); }
+
+    const Light& GetPointLight(const size_t i) const
+    {
+        assert(i < mPointLights.size());
+
+        return mPointLights[i];
+    }
+
 private:
 
     float mLightRotationAngle = 0.0f;
@@ -50,4 +80,7 @@ private:
         XMFLOAT3( 0.0f,     -0.707f,  -0.707f)
     };
     XMFLOAT3 mCurrentLightDirections[3];
+
+    std::vector<Light> mPointLights;
+    std::vector<XMFLOAT3> mBeginPointLightPositions;
 };
\ No newline at end of file
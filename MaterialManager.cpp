@@ -1 +1,248 @@
 #include "MaterialManager.h"
+
+// std
+#include <cstddef>
+#include <cstring>
+
+std::vector<MaterialManager::DirtyRange> MaterialManager::CoalesceDirtyRanges(const std::vector<std::uint32_t>& versions,
+                                                                              const std::vector<std::uint32_t>& uploadedVersions,
+                                                                              const std::size_t maxGap)
+{
+    assert(versions.size() == uploadedVersions.size());
+
+    std::vector<DirtyRange> ranges;
+
+    for (std::size_t i = 0; i < versions.size(); ++i)
+    {
+        if (versions[i] == uploadedVersions[i])
+        {
+            continue;
+        }
+
+        // extend the previous range if the clean gap is small enough, re-uploading
+        // a few clean materials is cheaper than issuing another UpdateSubresource
+        if (!ranges.empty() && (i - (ranges.back().first + ranges.back().count)) <= maxGap)
+        {
+            ranges.back().count = i - ranges.back().first + 1;
+        }
+        else
+        {
+            ranges.push_back({ i, 1 });
+        }
+    }
+
+    return ranges;
+}
+
+void MaterialManager::EncodeMaterials(const Material* materials,
+                                      PackedMaterial* packed,
+                                      const std::size_t count)
+{
+    // source float and destination half of every field that is stored as a half
+    struct HalfField
+    {
+        std::size_t src;
+        std::size_t dst;
+    };
+
+    static const HalfField fields[] =
+    {
+        { offsetof(Material, diffuse) + 0 * sizeof(float), offsetof(PackedMaterial, diffuse) + 0 * sizeof(PackedVector::HALF) },
+        { offsetof(Material, diffuse) + 1 * sizeof(float), offsetof(PackedMaterial, diffuse) + 1 * sizeof(PackedVector::HALF) },
+        { offsetof(Material, diffuse) + 2 * sizeof(float), offsetof(PackedMaterial, diffuse) + 2 * sizeof(PackedVector::HALF) },
+        { offsetof(Material, diffuse) + 3 * sizeof(float), offsetof(PackedMaterial, diffuse) + 3 * sizeof(PackedVector::HALF) },
+
+        { offsetof(Material, fresnel) + 0 * sizeof(float), offsetof(PackedMaterial, fresnelRoughness) + 0 * sizeof(PackedVector::HALF) },
+        { offsetof(Material, fresnel) + 1 * sizeof(float), offsetof(PackedMaterial, fresnelRoughness) + 1 * sizeof(PackedVector::HALF) },
+        { offsetof(Material, fresnel) + 2 * sizeof(float), offsetof(PackedMaterial, fresnelRoughness) + 2 * sizeof(PackedVector::HALF) },
+        { offsetof(Material, roughness),                   offsetof(PackedMaterial, fresnelRoughness) + 3 * sizeof(PackedVector::HALF) },
+
+        // only the 2d affine part of uvTransform is meaningful
+        { offsetof(Material, uvTransform) + offsetof(XMFLOAT4X4, _11), offsetof(PackedMaterial, uvScaleRotation) + 0 * sizeof(PackedVector::HALF) },
+        { offsetof(Material, uvTransform) + offsetof(XMFLOAT4X4, _12), offsetof(PackedMaterial, uvScaleRotation) + 1 * sizeof(PackedVector::HALF) },
+        { offsetof(Material, uvTransform) + offsetof(XMFLOAT4X4, _21), offsetof(PackedMaterial, uvScaleRotation) + 2 * sizeof(PackedVector::HALF) },
+        { offsetof(Material, uvTransform) + offsetof(XMFLOAT4X4, _22), offsetof(PackedMaterial, uvScaleRotation) + 3 * sizeof(PackedVector::HALF) },
+        { offsetof(Material, uvTransform) + offsetof(XMFLOAT4X4, _41), offsetof(PackedMaterial, uvTranslation) + 0 * sizeof(PackedVector::HALF) },
+        { offsetof(Material, uvTransform) + offsetof(XMFLOAT4X4, _42), offsetof(PackedMaterial, uvTranslation) + 1 * sizeof(PackedVector::HALF) },
+    };
+
+    if (count == 0)
+    {
+        return;
+    }
+
+    const uint8_t* src = reinterpret_cast<const uint8_t*>(materials);
+    uint8_t* dst = reinterpret_cast<uint8_t*>(packed);
+
+    for (const HalfField& field : fields)
+    {
+        PackedVector::XMConvertFloatToHalfStream(reinterpret_cast<PackedVector::HALF*>(dst + field.dst),
+                                                 sizeof(PackedMaterial),
+                                                 reinterpret_cast<const float*>(src + field.src),
+                                                 sizeof(Material),
+                                                 count);
+    }
+
+    auto PackTextureIndex = [](const int index) -> uint16_t
+    {
+        assert(index >= -1 && index < 0xffff);
+        return (index < 0) ? uint16_t(0xffff) : uint16_t(index);
+    };
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        packed[i].diffuseTextureIndex = PackTextureIndex(materials[i].diffuseTextureIndex);
+        packed[i].normalTextureIndex = PackTextureIndex(materials[i].normalTextureIndex);
+    }
+}
+
+void MaterialManager::ApplyAtlasPlacement(Material& material, const XMFLOAT2& uvScale, const XMFLOAT2& uvOffset)
+{
+    const XMMATRIX placement = XMMatrixScaling(uvScale.x, uvScale.y, 1.0f) *
+                               XMMatrixTranslation(uvOffset.x, uvOffset.y, 0.0f);
+
+    XMStoreFloat4x4(&material.uvTransform, XMLoadFloat4x4(&material.uvTransform) * placement);
+}
+
+uint64_t MaterialManager::HashMaterial(const Material& material)
+{
+    // hash field by field to not depend on the struct layout
+    uint64_t hash = HashBytes(&material.diffuse, sizeof(material.diffuse));
+    hash = HashBytes(&material.fresnel, sizeof(material.fresnel), hash);
+    hash = HashBytes(&material.roughness, sizeof(material.roughness), hash);
+    hash = HashBytes(&material.diffuseTextureIndex, sizeof(material.diffuseTextureIndex), hash);
+    hash = HashBytes(&material.normalTextureIndex, sizeof(material.normalTextureIndex), hash);
+    hash = HashBytes(&material.diffuseTextureArray, sizeof(material.diffuseTextureArray), hash);
+    hash = HashBytes(&material.normalTextureArray, sizeof(material.normalTextureArray), hash);
+    hash = HashBytes(&material.uvTransform, sizeof(material.uvTransform), hash);
+
+    return hash;
+}
+
+bool MaterialManager::AreMaterialsEqual(const Material& a, const Material& b)
+{
+    return (std::memcmp(&a.diffuse, &b.diffuse, sizeof(a.diffuse)) == 0) &&
+           (std::memcmp(&a.fresnel, &b.fresnel, sizeof(a.fresnel)) == 0) &&
+           (std::memcmp(&a.roughness, &b.roughness, sizeof(a.roughness)) == 0) &&
+           (a.diffuseTextureIndex == b.diffuseTextureIndex) &&
+           (a.normalTextureIndex == b.normalTextureIndex) &&
+           (a.diffuseTextureArray == b.diffuseTextureArray) &&
+           (a.normalTextureArray == b.normalTextureArray) &&
+           (std::memcmp(&a.uvTransform, &b.uvTransform, sizeof(a.uvTransform)) == 0);
+}
+
+std::size_t MaterialManager::AddMaterial(const std::string& name, const Material& material)
+{
+    assert(!mLookup.contains(name));
+
+    ++mDeduplicationStats.requestCount;
+
+    KeyEditedEntries();
+
+    const uint64_t hash = HashMaterial(material);
+    std::size_t entry = mMaterials.size();
+
+    // a 64 bit hash match alone could alias different materials, compare the content
+    const auto range = mContentLookup.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (AreMaterialsEqual(mMaterials[it->second], material))
+        {
+            entry = it->second;
+            break;
+        }
+    }
+
+    if (entry < mMaterials.size())
+    {
+        ++mHandleCounts[entry];
+        mDeduplicationStats.savedBytes += sizeof(PackedMaterial);
+    }
+    else
+    {
+        mMaterials.push_back(material);
+        mHandleCounts.push_back(1);
+        mHashes.push_back(hash);
+        mIsEdited.push_back(false);
+        mContentLookup.emplace(hash, entry);
+
+        // version 0 is never uploaded, so new materials start dirty
+        mVersions.push_back(1);
+        mUploadedVersions.push_back(0);
+    }
+
+    mHandleEntries.push_back(entry);
+    mLookup[name] = mHandleEntries.size() - 1;
+
+    return mHandleEntries.size() - 1;
+}
+
+Material& MaterialManager::EditMaterial(const std::size_t handle)
+{
+    assert(handle < mHandleEntries.size());
+
+    std::size_t& entry = mHandleEntries[handle];
+
+    // copy on write, the handle leaves the entry it shares to the others
+    if (mHandleCounts[entry] > 1)
+    {
+        --mHandleCounts[entry];
+        mDeduplicationStats.savedBytes -= sizeof(PackedMaterial);
+
+        mMaterials.push_back(mMaterials[entry]);
+        mHandleCounts.push_back(1);
+        mHashes.push_back(mHashes[entry]);
+        mIsEdited.push_back(true);
+        mVersions.push_back(1);
+        mUploadedVersions.push_back(0);
+
+        entry = mMaterials.size() - 1;
+        mEditedEntries.push_back(entry);
+
+        return mMaterials[entry];
+    }
+
+    // the content is about to change, the entry is keyed again by what it has after the edit
+    if (!mIsEdited[entry])
+    {
+        const auto range = mContentLookup.equal_range(mHashes[entry]);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second == entry)
+            {
+                mContentLookup.erase(it);
+                break;
+            }
+        }
+
+        mIsEdited[entry] = true;
+        mEditedEntries.push_back(entry);
+    }
+
+    ++mVersions[entry];
+    return mMaterials[entry];
+}
+
+void MaterialManager::KeyEditedEntries()
+{
+    for (const std::size_t entry : mEditedEntries)
+    {
+        mHashes[entry] = HashMaterial(mMaterials[entry]);
+        mContentLookup.emplace(mHashes[entry], entry);
+        mIsEdited[entry] = false;
+    }
+
+    mEditedEntries.clear();
+}
+
+std::size_t MaterialManager::GetGrownCapacity(const std::size_t capacity, const std::size_t required)
+{
+    std::size_t result = std::max<std::size_t>(capacity, 16);
+
+    while (result < required)
+    {
+        result += result / 2;
+    }
+
+    return result;
+}
@@ -1,12 +1,16 @@
 #pragma once
 
 // std
+#include <algorithm>
 #include <cassert>
+#include <cstdint>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 // d3d
 #include <directxmath.h>
+#include <directxpackedvector.h>
 using namespace DirectX;
 
 //
@@ -23,13 +27,31 @@ struct Material
     XMFLOAT3 fresnel = XMFLOAT3(0.01f, 0.01f, 0.01f);
     float    roughness = 0.25f;
 
+    // slices in the diffuse/normal Texture2DArrays, see TextureManager::LoadTexturesIntoArrays
     int diffuseTextureIndex = -1;
     int normalTextureIndex = -1;
-    XMFLOAT2 padding;
+
+    // CPU only, texture index of the arrays the slices above belong to, so that draws
+    // only rebind SRVs when two consecutive materials use different arrays
+    int diffuseTextureArray = -1;
+    int normalTextureArray = -1;
 
     XMFLOAT4X4 uvTransform;
 };
 
+// GPU side material record, see MaterialData and LoadMaterial in Common.hlsl
+struct PackedMaterial
+{
+    PackedVector::XMHALF4 diffuse;
+    PackedVector::XMHALF4 fresnelRoughness; // xyz = fresnel, w = roughness
+    PackedVector::XMHALF4 uvScaleRotation;  // uvTransform _11 _12 _21 _22
+    PackedVector::XMHALF2 uvTranslation;    // uvTransform _41 _42
+    uint16_t diffuseTextureIndex;           // 0xffff = no texture
+    uint16_t normalTextureIndex;            // 0xffff = no texture
+};
+
+static_assert(sizeof(PackedMaterial) == 32, "PackedMaterial must match PackedMaterialData in Common.hlsl");
+
 class MaterialManager
 {
 public:
@@ -41,61 +63,106 @@ public:
         mContext = pContext;
     }
 
+    // a contiguous run of materials [first, first + count) to upload
+    struct DirtyRange
+    {
+        std::size_t first;
+        std::size_t count;
+    };
+
+    // collect the materials whose version differs from the uploaded one and
+    // merge runs separated by at most maxGap clean materials into one range
+    static std::vector<DirtyRange> CoalesceDirtyRanges(const std::vector<std::uint32_t>& versions,
+                                                       const std::vector<std::uint32_t>& uploadedVersions,
+                                                       const std::size_t maxGap);
+
+    // convert count CPU materials into their GPU records, the half conversions run
+    // field by field over the whole batch so they go through the SIMD stream converter
+    static void EncodeMaterials(const Material* materials,
+                                PackedMaterial* packed,
+                                const std::size_t count);
+
+    // grow geometrically so that adding materials one at a time doesn't recreate the buffer every frame
+    static std::size_t GetGrownCapacity(const std::size_t capacity, const std::size_t required);
+
     void UpdateBuffer()
     {
-        if (mMaterialCount != mMaterials.size())
+        KeyEditedEntries();
+
+        if (mBufferCapacity < mMaterials.size())
         {
-            if (mMaterialCount < mMaterials.size())
-            {
-                mBuffer.Reset();
-                mBufferSRV.Reset();
+            mBuffer.Reset();
+            mBufferSRV.Reset();
+
+            mBufferCapacity = GetGrownCapacity(mBufferCapacity, mMaterials.size());
+
+            D3D11_BUFFER_DESC desc;
+            desc.ByteWidth = sizeof(PackedMaterial) * UINT(mBufferCapacity);
+            desc.Usage = D3D11_USAGE_DEFAULT;
+            desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+            desc.CPUAccessFlags = 0;
+            desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+            desc.StructureByteStride = sizeof(PackedMaterial);
+
+            ThrowIfFailed(mDevice->CreateBuffer(&desc, nullptr, &mBuffer));
+            NameResource(mBuffer.Get(), "MaterialsSB");
+
+            ThrowIfFailed(mDevice->CreateShaderResourceView(mBuffer.Get(), nullptr, &mBufferSRV));
+            NameResource(mBufferSRV.Get(), "MaterialsBufferSRV");
 
-                //mMaterialCount = std::size_t(1.5f * mMaterials.size());
-                mMaterialCount = mMaterials.size();
+            // the new buffer is empty, every material has to be uploaded again
+            std::fill(mUploadedVersions.begin(), mUploadedVersions.end(), 0);
+        }
 
-                D3D11_BUFFER_DESC desc;
-                desc.ByteWidth = sizeof(Material) * UINT(mMaterialCount);
-                desc.Usage = D3D11_USAGE_DEFAULT;
-                desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-                desc.CPUAccessFlags = 0;
-                desc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
-                desc.StructureByteStride = sizeof(Material);
+        const std::vector<DirtyRange> ranges = CoalesceDirtyRanges(mVersions, mUploadedVersions, mMaxDirtyGap);
 
-                ThrowIfFailed(mDevice->CreateBuffer(&desc, nullptr, &mBuffer));
-                NameResource(mBuffer.Get(), "MaterialsSB");
+        mPackedMaterials.resize(mMaterials.size());
 
-                ThrowIfFailed(mDevice->CreateShaderResourceView(mBuffer.Get(), nullptr, &mBufferSRV));
-                NameResource(mBufferSRV.Get(), "MaterialsBufferSRV");
-            }
+        for (const DirtyRange& range : ranges)
+        {
+            EncodeMaterials(&mMaterials[range.first], &mPackedMaterials[range.first], range.count);
 
             D3D11_BOX box;
-            box.left = 0;
+            box.left = sizeof(PackedMaterial) * UINT(range.first);
             box.top = 0;
             box.front = 0;
-            box.right = sizeof(Material) * UINT(mMaterials.size());
+            box.right = sizeof(PackedMaterial) * UINT(range.first + range.count);
             box.bottom = 1;
             box.back = 1;
 
-            mContext->UpdateSubresource(mBuffer.Get(), 0, &box, mMaterials.data(), 0, 0);
+            mContext->UpdateSubresource(mBuffer.Get(), 0, &box, &mPackedMaterials[range.first], 0, 0);
+
+            std::copy(mVersions.begin() + range.first,
+                      mVersions.begin() + range.first + range.count,
+                      mUploadedVersions.begin() + range.first);
         }
     }
 
-    std::size_t AddMaterial(const std::string& name,
-                     const Material& material)
-    {
-        assert(!mLookup.contains(name));
+    // fold the uv scale and offset of a texture placed in an atlas (see TextureManager::GetAtlasSlot)
+    // after the material's own uvTransform; only right for uvs in 0-1, wrapping would read the neighbours
+    static void ApplyAtlasPlacement(Material& material, const XMFLOAT2& uvScale, const XMFLOAT2& uvOffset);
+
+    static uint64_t HashMaterial(const Material& material);
+    static bool AreMaterialsEqual(const Material& a, const Material& b);
 
-        mMaterials.push_back(material);
-        mLookup[name] = mMaterials.size() - 1;
+    // every name gets a handle of its own, handles with the same content share one entry of MaterialsSB
+    // until one of them is written through SetMaterial/EditMaterial, which moves it to an entry of its
+    // own first; the other handles keep theirs
+    std::size_t AddMaterial(const std::string& name, const Material& material);
 
-        return mMaterials.size() - 1;
+    void SetMaterial(const std::size_t handle, const Material& material)
+    {
+        EditMaterial(handle) = material;
     }
 
-    const Material& GetMaterial(const std::size_t i) const
+    // returns a writable reference and marks the material dirty, don't hold on to it across frames
+    Material& EditMaterial(const std::size_t handle);
+
+    const Material& GetMaterial(const std::size_t handle) const
     {
-        assert(i < mMaterials.size());
+        assert(handle < mHandleEntries.size());
 
-        return mMaterials[i];
+        return mMaterials[mHandleEntries[handle]];
     }
 
     const std::size_t GetMaterial(const std::string& name) const
@@ -106,11 +173,37 @@ public:
         return i->second;
     }
 
+    std::size_t GetMaterialCount() const
+    {
+        return mHandleEntries.size();
+    }
+
+    // where the material of the handle is in MaterialsSB, the index the shaders get; it changes when
+    // the handle is written while it shares its entry
+    std::size_t GetBufferIndex(const std::size_t handle) const
+    {
+        assert(handle < mHandleEntries.size());
+
+        return mHandleEntries[handle];
+    }
+
+    // the distinct materials, in MaterialsSB order
     const std::vector<Material>& GetMaterials() const
     {
         return mMaterials;
     }
 
+    struct DeduplicationStats
+    {
+        std::size_t requestCount = 0; // AddMaterial calls
+        std::size_t savedBytes = 0;   // MaterialsSB bytes not allocated thanks to aliasing, net of the writes that split them
+    };
+
+    const DeduplicationStats& GetDeduplicationStats() const
+    {
+        return mDeduplicationStats;
+    }
+
     ID3D11ShaderResourceView* GetBufferSRV()
     {
         return mBufferSRV.Get();
@@ -123,8 +216,23 @@ public:
 
 private:
 
-    std::unordered_map<std::string, std::size_t> mLookup;
+    // hash the entries written through EditMaterial since the last call back into mContentLookup
+    void KeyEditedEntries();
+
+    std::unordered_map<std::string, std::size_t> mLookup; // name to handle
+    std::vector<std::size_t> mHandleEntries;               // handle to entry
+
+    // entries, in MaterialsSB order
     std::vector<Material> mMaterials;
+    std::vector<std::size_t> mHandleCounts; // handles sharing each entry
+    std::vector<uint64_t> mHashes;          // what each entry is keyed by in mContentLookup, while it is
+
+    // entries by content, the ones in mEditedEntries are left out until their edit is over
+    std::unordered_multimap<uint64_t, std::size_t> mContentLookup;
+    std::vector<std::size_t> mEditedEntries;
+    std::vector<bool> mIsEdited;
+
+    std::vector<PackedMaterial> mPackedMaterials;
 
     ComPtr<ID3D11Device> mDevice;
     ComPtr<ID3D11DeviceContext> mContext;
@@ -132,5 +240,12 @@ private:
     ComPtr<ID3D11Buffer> mBuffer;
     ComPtr<ID3D11ShaderResourceView> mBufferSRV;
 
-    std::size_t mMaterialCount = 0;
+    // per entry edit counter and the value it had at the last upload
+    std::vector<std::uint32_t> mVersions;
+    std::vector<std::uint32_t> mUploadedVersions;
+
+    std::size_t mBufferCapacity = 0;
+    std::size_t mMaxDirtyGap = 4;
+
+    DeduplicationStats mDeduplicationStats;
 };
\ No newline at end of file
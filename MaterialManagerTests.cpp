@@ -0,0 +1,402 @@
+#include "UnitTest.h"
+
+// std
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#include "MaterialManager.h"
+
+// dirty range coalescing and buffer growth of MaterialManager, the parts UpdateBuffer decides with
+// before it touches the device, the entries handles of equal materials share until written, and the
+// packed records as the shaders decode them
+
+namespace
+{
+	// PackedMaterialData and LoadMaterial of Common.hlsl, line for line
+	struct PackedMaterialData
+	{
+		uint32_t diffuse[2];
+		uint32_t fresnelRoughness[2];
+		uint32_t uvScaleRotation[2];
+		uint32_t uvTranslation;
+		uint32_t textureIndices;
+	};
+
+	static_assert(sizeof(PackedMaterialData) == sizeof(PackedMaterial));
+
+	struct MaterialData
+	{
+		float diffuse[4];
+		float fresnel[3];
+		float roughness;
+		int diffuseTextureIndex;
+		int normalTextureIndex;
+		float uvTransform[4][4]; // [row][column] as the shader indexes it
+	};
+
+	// the low 16 bits, denormals included, as f16tof32 does
+	float f16tof32(const uint32_t packed)
+	{
+		const uint32_t sign = (packed >> 15) & 1;
+		const int exponent = int((packed >> 10) & 0x1f);
+		const uint32_t mantissa = packed & 0x3ff;
+
+		const float magnitude = (exponent == 0) ? std::ldexp(float(mantissa), -24) :
+												  std::ldexp(float(mantissa | 0x400), exponent - 25);
+
+		return sign ? -magnitude : magnitude;
+	}
+
+	void UnpackHalf2(const uint32_t packed, float* xy)
+	{
+		xy[0] = f16tof32(packed);
+		xy[1] = f16tof32(packed >> 16);
+	}
+
+	void UnpackHalf4(const uint32_t packed[2], float* xyzw)
+	{
+		UnpackHalf2(packed[0], &xyzw[0]);
+		UnpackHalf2(packed[1], &xyzw[2]);
+	}
+
+	int UnpackTextureIndex(const uint32_t packed)
+	{
+		return (packed == 0xffff) ? -1 : int(packed);
+	}
+
+	MaterialData LoadMaterial(const PackedMaterial& record)
+	{
+		PackedMaterialData packed;
+		std::memcpy(&packed, &record, sizeof(packed));
+
+		MaterialData material = {};
+
+		UnpackHalf4(packed.diffuse, material.diffuse);
+
+		float fresnelRoughness[4];
+		UnpackHalf4(packed.fresnelRoughness, fresnelRoughness);
+		material.fresnel[0] = fresnelRoughness[0];
+		material.fresnel[1] = fresnelRoughness[1];
+		material.fresnel[2] = fresnelRoughness[2];
+		material.roughness = fresnelRoughness[3];
+
+		material.diffuseTextureIndex = UnpackTextureIndex(packed.textureIndices & 0xffff);
+		material.normalTextureIndex = UnpackTextureIndex(packed.textureIndices >> 16);
+
+		float scaleRotation[4];
+		float translation[2];
+		UnpackHalf4(packed.uvScaleRotation, scaleRotation);
+		UnpackHalf2(packed.uvTranslation, translation);
+
+		const float uvTransform[4][4] =
+		{
+			{ scaleRotation[0], scaleRotation[2], 0.0f, translation[0] },
+			{ scaleRotation[1], scaleRotation[3], 0.0f, translation[1] },
+			{ 0.0f,             0.0f,             1.0f, 0.0f },
+			{ 0.0f,             0.0f,             0.0f, 1.0f },
+		};
+
+		std::memcpy(material.uvTransform, uvTransform, sizeof(uvTransform));
+
+		return material;
+	}
+
+	// half of a half step at value: round to nearest is off by at most that, 2^-25 below the normals
+	float GetHalfError(const float value)
+	{
+		return std::fmax(std::fabs(value) * std::ldexp(1.0f, -11), std::ldexp(1.0f, -25));
+	}
+
+	// versions of count materials all uploaded, the ones in dirty edited once since
+	void MakeVersions(const std::size_t count, const std::vector<std::size_t>& dirty,
+					  std::vector<std::uint32_t>& versions, std::vector<std::uint32_t>& uploadedVersions)
+	{
+		versions.assign(count, 1);
+		uploadedVersions.assign(count, 1);
+
+		for (const std::size_t i : dirty)
+		{
+			++versions[i];
+		}
+	}
+}
+
+UNIT_TEST(MaterialRangesNoneDirty)
+{
+	std::vector<std::uint32_t> versions;
+	std::vector<std::uint32_t> uploadedVersions;
+	MakeVersions(32, {}, versions, uploadedVersions);
+
+	CHECK(MaterialManager::CoalesceDirtyRanges(versions, uploadedVersions, 4).empty());
+}
+
+UNIT_TEST(MaterialRangesAdjacentMerge)
+{
+	std::vector<std::uint32_t> versions;
+	std::vector<std::uint32_t> uploadedVersions;
+	MakeVersions(32, { 3, 4, 5 }, versions, uploadedVersions);
+
+	const std::vector<MaterialManager::DirtyRange> ranges = MaterialManager::CoalesceDirtyRanges(versions, uploadedVersions, 0);
+
+	CHECK(ranges.size() == 1);
+	CHECK((ranges[0].first == 3) && (ranges[0].count == 3));
+}
+
+// the same material edited again before the upload is still one material to upload
+UNIT_TEST(MaterialRangesOverlappingEdits)
+{
+	std::vector<std::uint32_t> versions;
+	std::vector<std::uint32_t> uploadedVersions;
+	MakeVersions(32, { 7, 7, 7, 8 }, versions, uploadedVersions);
+
+	const std::vector<MaterialManager::DirtyRange> ranges = MaterialManager::CoalesceDirtyRanges(versions, uploadedVersions, 0);
+
+	CHECK(ranges.size() == 1);
+	CHECK((ranges[0].first == 7) && (ranges[0].count == 2));
+}
+
+UNIT_TEST(MaterialRangesGapMerge)
+{
+	std::vector<std::uint32_t> versions;
+	std::vector<std::uint32_t> uploadedVersions;
+
+	// 4 clean materials between 0 and 5 fit a gap of 4
+	MakeVersions(32, { 0, 5 }, versions, uploadedVersions);
+	std::vector<MaterialManager::DirtyRange> ranges = MaterialManager::CoalesceDirtyRanges(versions, uploadedVersions, 4);
+
+	CHECK(ranges.size() == 1);
+	CHECK((ranges[0].first == 0) && (ranges[0].count == 6));
+
+	// 5 don't
+	MakeVersions(32, { 0, 6 }, versions, uploadedVersions);
+	ranges = MaterialManager::CoalesceDirtyRanges(versions, uploadedVersions, 4);
+
+	CHECK(ranges.size() == 2);
+	CHECK((ranges[0].first == 0) && (ranges[0].count == 1));
+	CHECK((ranges[1].first == 6) && (ranges[1].count == 1));
+
+	// the last material ends its range
+	MakeVersions(32, { 29, 31 }, versions, uploadedVersions);
+	ranges = MaterialManager::CoalesceDirtyRanges(versions, uploadedVersions, 4);
+
+	CHECK(ranges.size() == 1);
+	CHECK((ranges[0].first == 29) && (ranges[0].count == 3));
+}
+
+UNIT_TEST(MaterialBufferGrowth)
+{
+	// never below 16
+	CHECK(MaterialManager::GetGrownCapacity(0, 1) == 16);
+	CHECK(MaterialManager::GetGrownCapacity(0, 16) == 16);
+
+	// x1.5 steps
+	CHECK(MaterialManager::GetGrownCapacity(16, 17) == 24);
+	CHECK(MaterialManager::GetGrownCapacity(24, 25) == 36);
+	CHECK(MaterialManager::GetGrownCapacity(0, 100) == 121); // 16 24 36 54 81 121
+
+	// enough already, no change
+	CHECK(MaterialManager::GetGrownCapacity(121, 50) == 121);
+}
+
+// UpdateBuffer's sequence when the 17th material is added: the buffer grows, its uploaded versions are
+// zeroed and everything goes up in one range; an edit after that uploads that material alone
+UNIT_TEST(MaterialEditAfterGrowth)
+{
+	std::vector<std::uint32_t> versions;
+	std::vector<std::uint32_t> uploadedVersions;
+	MakeVersions(16, {}, versions, uploadedVersions);
+
+	versions.push_back(1);
+	uploadedVersions.push_back(0);
+
+	const std::size_t capacity = MaterialManager::GetGrownCapacity(16, versions.size());
+	CHECK(capacity == 24);
+
+	std::fill(uploadedVersions.begin(), uploadedVersions.end(), 0);
+
+	std::vector<MaterialManager::DirtyRange> ranges = MaterialManager::CoalesceDirtyRanges(versions, uploadedVersions, 4);
+
+	CHECK(ranges.size() == 1);
+	CHECK((ranges[0].first == 0) && (ranges[0].count == 17));
+
+	uploadedVersions = versions;
+	++versions[9];
+
+	ranges = MaterialManager::CoalesceDirtyRanges(versions, uploadedVersions, 4);
+
+	CHECK(ranges.size() == 1);
+	CHECK((ranges[0].first == 9) && (ranges[0].count == 1));
+	CHECK(MaterialManager::GetGrownCapacity(capacity, versions.size()) == capacity);
+}
+
+// equal materials share an entry until one of them is written, then it gets its own and the others keep
+// the shared one
+UNIT_TEST(MaterialCopyOnWrite)
+{
+	MaterialManager materialManager;
+
+	Material rock;
+	rock.roughness = 0.5f;
+
+	const std::size_t dry = materialManager.AddMaterial("rock", rock);
+	const std::size_t wet = materialManager.AddMaterial("rock_wet", rock);
+	const std::size_t moss = materialManager.AddMaterial("rock_moss", rock);
+
+	CHECK((dry != wet) && (wet != moss));
+	CHECK(materialManager.GetMaterial("rock_wet") == wet);
+	CHECK(materialManager.GetBufferIndex(dry) == materialManager.GetBufferIndex(wet));
+	CHECK(materialManager.GetMaterials().size() == 1);
+	CHECK(materialManager.GetDeduplicationStats().savedBytes == 2 * sizeof(PackedMaterial));
+
+	materialManager.EditMaterial(wet).roughness = 0.1f;
+
+	CHECK(materialManager.GetMaterial(dry).roughness == 0.5f);
+	CHECK(materialManager.GetMaterial(moss).roughness == 0.5f);
+	CHECK(materialManager.GetMaterial(wet).roughness == 0.1f);
+	CHECK(materialManager.GetBufferIndex(wet) != materialManager.GetBufferIndex(dry));
+	CHECK(materialManager.GetBufferIndex(moss) == materialManager.GetBufferIndex(dry));
+	CHECK(materialManager.GetMaterials().size() == 2);
+	CHECK(materialManager.GetDeduplicationStats().savedBytes == sizeof(PackedMaterial));
+
+	// the handle is alone on its entry now, writing it again stays there
+	const std::size_t wetIndex = materialManager.GetBufferIndex(wet);
+
+	rock.roughness = 0.2f;
+	materialManager.SetMaterial(wet, rock);
+
+	CHECK(materialManager.GetBufferIndex(wet) == wetIndex);
+	CHECK(materialManager.GetMaterial(wet).roughness == 0.2f);
+	CHECK(materialManager.GetMaterial(dry).roughness == 0.5f);
+
+	// the last sharer of the first entry, SetMaterial splits it just the same
+	Material lichen = rock;
+	lichen.roughness = 0.7f;
+	materialManager.SetMaterial(moss, lichen);
+
+	CHECK(materialManager.GetMaterial(moss).roughness == 0.7f);
+	CHECK(materialManager.GetMaterial(dry).roughness == 0.5f);
+	CHECK(materialManager.GetMaterials().size() == 3);
+	CHECK(materialManager.GetDeduplicationStats().savedBytes == 0);
+}
+
+// an edited entry is found by its new content, not by what it was added with
+UNIT_TEST(MaterialContentRekeyedAfterEdit)
+{
+	MaterialManager materialManager;
+
+	Material a;
+	a.roughness = 0.3f;
+
+	Material b;
+	b.roughness = 0.9f;
+
+	const std::size_t first = materialManager.AddMaterial("first", a);
+	materialManager.EditMaterial(first) = b;
+
+	CHECK(materialManager.GetBufferIndex(materialManager.AddMaterial("like the edit", b)) == materialManager.GetBufferIndex(first));
+	CHECK(materialManager.GetBufferIndex(materialManager.AddMaterial("like the original", a)) != materialManager.GetBufferIndex(first));
+	CHECK(materialManager.GetMaterials().size() == 2);
+
+	// edited twice before anything looks, keyed once by the last content
+	const std::size_t third = materialManager.AddMaterial("third", Material());
+	materialManager.EditMaterial(third).roughness = 0.4f;
+	materialManager.EditMaterial(third).roughness = 0.6f;
+
+	Material c;
+	c.roughness = 0.6f;
+
+	CHECK(materialManager.GetBufferIndex(materialManager.AddMaterial("like the third", c)) == materialManager.GetBufferIndex(third));
+}
+
+// every field EncodeMaterials packs comes back from the shader's decode within half a half step,
+// and the uv transform moves uvs as the float one does within the sum of those errors
+UNIT_TEST(MaterialEncodeDecode)
+{
+	std::vector<Material> materials;
+	uint32_t random = 777;
+
+	const auto Random = [&](const float low, const float high)
+	{
+		random = random * 1664525u + 1013904223u;
+		return low + (high - low) * float(random >> 8) / float(1 << 24);
+	};
+
+	// 2x3 transforms: identity, scale and rotation, atlas placements, and translations where the
+	// half step is 1/1024 up to 1.0 at 1024
+	const float translations[] = { 0.0f, 0.7f, 1.3f, -3.9f, 17.25f, 300.1f, 1024.3f, -1500.6f };
+
+	for (const float translation : translations)
+	{
+		Material material;
+		material.diffuse = XMFLOAT4(Random(0.0f, 1.0f), Random(0.0f, 1.0f), Random(0.0f, 1.0f), Random(0.0f, 1.0f));
+		material.fresnel = XMFLOAT3(Random(0.0f, 0.1f), Random(0.0f, 0.1f), Random(0.0f, 0.1f));
+		material.roughness = Random(0.0f, 1.0f);
+		material.diffuseTextureIndex = int(materials.size()) - 1;
+		material.normalTextureIndex = (materials.size() % 2) ? 0xfffe : -1;
+
+		const XMMATRIX transform = XMMatrixScaling(Random(0.5f, 4.0f), Random(0.5f, 4.0f), 1.0f) *
+								   XMMatrixRotationZ(Random(-3.0f, 3.0f)) *
+								   XMMatrixTranslation(translation, -0.5f * translation, 0.0f);
+
+		XMStoreFloat4x4(&material.uvTransform, transform);
+		materials.push_back(material);
+
+		MaterialManager::ApplyAtlasPlacement(material, XMFLOAT2(0.03125f, 0.0625f), XMFLOAT2(0.5078125f, 0.25f));
+		materials.push_back(material);
+	}
+
+	materials.push_back(Material());
+
+	std::vector<PackedMaterial> packed(materials.size());
+	MaterialManager::EncodeMaterials(materials.data(), packed.data(), materials.size());
+
+	for (std::size_t i = 0; i < materials.size(); ++i)
+	{
+		const Material& m = materials[i];
+		const MaterialData decoded = LoadMaterial(packed[i]);
+
+		CHECK_NEAR(decoded.diffuse[0], m.diffuse.x, GetHalfError(m.diffuse.x));
+		CHECK_NEAR(decoded.diffuse[1], m.diffuse.y, GetHalfError(m.diffuse.y));
+		CHECK_NEAR(decoded.diffuse[2], m.diffuse.z, GetHalfError(m.diffuse.z));
+		CHECK_NEAR(decoded.diffuse[3], m.diffuse.w, GetHalfError(m.diffuse.w));
+		CHECK_NEAR(decoded.fresnel[0], m.fresnel.x, GetHalfError(m.fresnel.x));
+		CHECK_NEAR(decoded.fresnel[1], m.fresnel.y, GetHalfError(m.fresnel.y));
+		CHECK_NEAR(decoded.fresnel[2], m.fresnel.z, GetHalfError(m.fresnel.z));
+		CHECK_NEAR(decoded.roughness, m.roughness, GetHalfError(m.roughness));
+
+		CHECK(decoded.diffuseTextureIndex == m.diffuseTextureIndex);
+		CHECK(decoded.normalTextureIndex == m.normalTextureIndex);
+
+		// the shader's mul(uvTransform, uv) against the row vector product on the CPU
+		const XMFLOAT4X4& t = m.uvTransform;
+
+		CHECK_NEAR(decoded.uvTransform[0][0], t._11, GetHalfError(t._11));
+		CHECK_NEAR(decoded.uvTransform[1][0], t._12, GetHalfError(t._12));
+		CHECK_NEAR(decoded.uvTransform[0][1], t._21, GetHalfError(t._21));
+		CHECK_NEAR(decoded.uvTransform[1][1], t._22, GetHalfError(t._22));
+		CHECK_NEAR(decoded.uvTransform[0][3], t._41, GetHalfError(t._41));
+		CHECK_NEAR(decoded.uvTransform[1][3], t._42, GetHalfError(t._42));
+
+		for (const XMFLOAT2 uv : { XMFLOAT2(0.0f, 0.0f), XMFLOAT2(1.0f, 1.0f), XMFLOAT2(0.25f, 0.75f), XMFLOAT2(-2.0f, 3.0f) })
+		{
+			const float u = uv.x * t._11 + uv.y * t._21 + t._41;
+			const float v = uv.x * t._12 + uv.y * t._22 + t._42;
+
+			const float* row0 = decoded.uvTransform[0];
+			const float* row1 = decoded.uvTransform[1];
+
+			const float errorU = std::fabs(uv.x) * GetHalfError(t._11) + std::fabs(uv.y) * GetHalfError(t._21) + GetHalfError(t._41);
+			const float errorV = std::fabs(uv.x) * GetHalfError(t._12) + std::fabs(uv.y) * GetHalfError(t._22) + GetHalfError(t._42);
+
+			// and a few float roundings of the products on either side
+			CHECK_NEAR(row0[0] * uv.x + row0[1] * uv.y + row0[3], u, errorU + 1e-4f * (1.0f + std::fabs(u)));
+			CHECK_NEAR(row1[0] * uv.x + row1[1] * uv.y + row1[3], v, errorV + 1e-4f * (1.0f + std::fabs(v)));
+		}
+	}
+
+	// the half step at 1024 is 1.0, a translation there is off by up to half of it
+	CHECK(std::fabs(LoadMaterial(packed[12]).uvTransform[0][3] - 1024.3f) <= 0.5f);
+	CHECK(std::fabs(LoadMaterial(packed[12]).uvTransform[0][3] - 1024.3f) > 0.25f);
+}
\ No newline at end of file
@@ -3,6 +3,7 @@
 // std
 #include <cassert>
 #include <fstream>
+#include <sstream>
 #include <string>
 
 VertexData::VertexData()
@@ -160,15 +161,36 @@ MeshData MeshManager::CreateGrid(const float width, const float depth, const std
 }
 
 MeshData MeshManager::LoadModel(const std::string& path)
+{
+	std::ifstream stream(path);
+	assert(stream);
+
+	return LoadModel(stream);
+}
+
+MeshData MeshManager::LoadModel(const uint8_t* data, const std::size_t size)
+{
+	std::istringstream stream(std::string(reinterpret_cast<const char*>(data), size));
+
+	return LoadModel(stream);
+}
+
+MeshData MeshManager::LoadModel(const AssetArchive& archive, const std::string& name)
+{
+	std::vector<uint8_t> storage;
+	const std::span<const uint8_t> data = archive.GetEntry(name, storage);
+	assert(!data.empty());
+
+	return LoadModel(data.data(), data.size());
+}
+
+MeshData MeshManager::LoadModel(std::istream& stream)
 {
 	MeshData mesh;
 
 
 	std::vector<VertexData>& vertices = mesh.vertices;
 
-	std::ifstream stream(path);
-	assert(stream);
-
 
 
 	std::string line;
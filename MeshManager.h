@@ -7,6 +7,7 @@ using Microsoft::WRL::ComPtr;
 
 // std
 #include <cassert>
+#include <istream>
 #include <unordered_map>
 #include <vector>
 
@@ -16,6 +17,7 @@ using Microsoft::WRL::ComPtr;
 using namespace DirectX;
 
 //
+#include "AssetArchive.h"
 #include "Utility.h"
 
 struct VertexData
@@ -159,9 +161,13 @@ public:
 	static MeshData CreateGrid(const float width, const float depth, const std::size_t m, const std::size_t n);
 
 	static MeshData LoadModel(const std::string& path);
+	static MeshData LoadModel(const uint8_t* data, const std::size_t size);
+	static MeshData LoadModel(const AssetArchive& archive, const std::string& name);
 
 private:
 
+	static MeshData LoadModel(std::istream& stream);
+
 	std::unordered_map<std::string, std::size_t> mLookup;
 	std::vector<MeshData> mMeshes;
 
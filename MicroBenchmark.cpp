@@ -0,0 +1,198 @@
+#include "MicroBenchmark.h"
+
+// std
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+
+namespace
+{
+	struct Case
+	{
+		std::string name;
+		MicroBenchmark::Function function;
+		std::vector<std::size_t> sizes;
+	};
+
+	// registered from static initializers, so created on first use
+	std::vector<Case>& GetCases()
+	{
+		static std::vector<Case> cases;
+		return cases;
+	}
+
+	MicroBenchmark::State RunIterations(const MicroBenchmark::Function& function, const std::size_t size, const uint64_t iterations)
+	{
+		MicroBenchmark::State state(size, iterations);
+		function(state);
+
+		return state;
+	}
+}
+
+bool MicroBenchmark::Register(const std::string& name, Function function, std::vector<std::size_t> sizes)
+{
+	if (sizes.empty())
+	{
+		sizes.push_back(0);
+	}
+
+	GetCases().push_back({ name, std::move(function), std::move(sizes) });
+
+	return true;
+}
+
+std::vector<MicroBenchmark::Result> MicroBenchmark::Run(const Settings& settings)
+{
+	std::vector<Result> results;
+
+	for (const Case& benchmark : GetCases())
+	{
+		for (const std::size_t size : benchmark.sizes)
+		{
+			const std::string name = benchmark.name + "/" + std::to_string(size);
+
+			if (!settings.filter.empty() && (name.find(settings.filter) == std::string::npos))
+			{
+				continue;
+			}
+
+			// grow the iteration count tenfold until a run takes a tenth of the time, then scale it up to
+			// the whole time
+			uint64_t iterations = 1;
+			double seconds = RunIterations(benchmark.function, size, iterations).GetSeconds();
+
+			while ((seconds < 0.1 * settings.minSeconds) && (iterations < (uint64_t(1) << 40)))
+			{
+				iterations *= 10;
+				seconds = RunIterations(benchmark.function, size, iterations).GetSeconds();
+			}
+
+			if (seconds < settings.minSeconds)
+			{
+				const double scale = (seconds > 0.0) ? settings.minSeconds / seconds : 10.0;
+				iterations = std::max<uint64_t>(iterations, uint64_t(double(iterations) * std::min(scale, 100.0)));
+			}
+
+			std::vector<Result> repetitions;
+
+			for (int i = 0; i < std::max(1, settings.repetitions); ++i)
+			{
+				const State state = RunIterations(benchmark.function, size, iterations);
+				const double stateSeconds = std::max(state.GetSeconds(), 1e-12);
+
+				Result result;
+				result.name = name;
+				result.iterations = iterations;
+				result.nsPerIteration = stateSeconds * 1e9 / double(iterations);
+				result.itemsPerSecond = double(state.GetItemsProcessed()) / stateSeconds;
+				result.bytesPerSecond = double(state.GetBytesProcessed()) / stateSeconds;
+				result.counters = state.GetCounters();
+
+				repetitions.push_back(result);
+			}
+
+			std::sort(repetitions.begin(), repetitions.end(), [](const Result& a, const Result& b) { return a.nsPerIteration < b.nsPerIteration; });
+
+			results.push_back(repetitions[repetitions.size() / 2]);
+		}
+	}
+
+	return results;
+}
+
+bool MicroBenchmark::Write(const std::vector<Result>& results, const std::string& path)
+{
+	std::ofstream stream(path);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	for (const Result& result : results)
+	{
+		stream << result.name << '\t' << result.nsPerIteration << '\n';
+	}
+
+	return bool(stream);
+}
+
+bool MicroBenchmark::Read(const std::string& path, Baseline& baseline)
+{
+	std::ifstream stream(path);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	baseline.clear();
+
+	std::string line;
+
+	while (std::getline(stream, line))
+	{
+		const std::size_t tab = line.rfind('\t');
+
+		if (tab == std::string::npos)
+		{
+			continue;
+		}
+
+		baseline[line.substr(0, tab)] = std::strtod(line.c_str() + tab + 1, nullptr);
+	}
+
+	return true;
+}
+
+std::vector<MicroBenchmark::Difference> MicroBenchmark::Compare(const Baseline& baseline, const std::vector<Result>& results, const double tolerance)
+{
+	std::vector<Difference> differences;
+
+	for (const Result& result : results)
+	{
+		const auto it = baseline.find(result.name);
+
+		if ((it != baseline.end()) && (result.nsPerIteration > it->second * (1.0 + tolerance)))
+		{
+			differences.push_back({ result.name, it->second, result.nsPerIteration });
+		}
+	}
+
+	return differences;
+}
+
+bool MicroBenchmark::WriteJSON(const std::vector<Result>& results, const std::string& path)
+{
+	std::ofstream stream(path);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	stream << "{\n\"benchmarks\": [";
+
+	for (std::size_t i = 0; i < results.size(); ++i)
+	{
+		const Result& result = results[i];
+
+		stream << (i ? ",\n" : "\n") << "{\"name\": \"" << result.name << "\""
+			   << ", \"iterations\": " << result.iterations
+			   << ", \"nsPerIteration\": " << result.nsPerIteration
+			   << ", \"itemsPerSecond\": " << result.itemsPerSecond
+			   << ", \"bytesPerSecond\": " << result.bytesPerSecond;
+
+		for (const auto& [name, value] : result.counters)
+		{
+			stream << ", \"" << name << "\": " << value;
+		}
+
+		stream << "}";
+	}
+
+	stream << "\n]\n}\n";
+
+	return bool(stream);
+}
\ No newline at end of file
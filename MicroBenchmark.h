@@ -0,0 +1,175 @@
+#pragma once
+
+// std
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// timing loop for the hot paths, in the style of google benchmark: a case is registered once with the
+// sizes it runs at and times its loop body,
+//
+//     void BM_Sort(MicroBenchmark::State& state)
+//     {
+//         while (state.KeepRunning()) { ... state.GetSize() ... }
+//         state.SetItemsProcessed(state.GetIterations() * state.GetSize());
+//     }
+//     MICRO_BENCHMARK(BM_Sort, 64, 4096);
+//
+// and runs as "BM_Sort/64" and "BM_Sort/4096"
+class MicroBenchmark
+{
+public:
+
+	class State
+	{
+	public:
+
+		State(const std::size_t size, const uint64_t iterations) : mSize(size), mIterations(iterations), mRemaining(iterations) {}
+
+		// the clock runs from the first call to the one that returns false
+		bool KeepRunning()
+		{
+			if (mRemaining == 0)
+			{
+				if (!mIsPaused)
+				{
+					mElapsed += Clock::now() - mStart;
+					mIsPaused = true;
+				}
+
+				return false;
+			}
+
+			if (mRemaining == mIterations)
+			{
+				mStart = Clock::now();
+				mIsPaused = false;
+			}
+
+			--mRemaining;
+
+			return true;
+		}
+
+		// around per-iteration setup that isn't part of the case
+		void PauseTiming()
+		{
+			mElapsed += Clock::now() - mStart;
+			mIsPaused = true;
+		}
+
+		void ResumeTiming()
+		{
+			mStart = Clock::now();
+			mIsPaused = false;
+		}
+
+		std::size_t GetSize() const { return mSize; }
+		uint64_t GetIterations() const { return mIterations; }
+
+		void SetItemsProcessed(const uint64_t count) { mItemCount = count; }
+		void SetBytesProcessed(const uint64_t count) { mByteCount = count; }
+
+		// anything else the case measured, reported next to its time
+		void SetCounter(const std::string& name, const double value) { mCounters[name] = value; }
+		const std::map<std::string, double>& GetCounters() const { return mCounters; }
+
+		double GetSeconds() const { return std::chrono::duration<double>(mElapsed).count(); }
+		uint64_t GetItemsProcessed() const { return mItemCount; }
+		uint64_t GetBytesProcessed() const { return mByteCount; }
+
+	private:
+
+		using Clock = std::chrono::steady_clock;
+
+		std::size_t mSize = 0;
+		uint64_t mIterations = 0;
+		uint64_t mRemaining = 0;
+
+		Clock::time_point mStart;
+		Clock::duration mElapsed = Clock::duration::zero();
+		bool mIsPaused = true;
+
+		uint64_t mItemCount = 0;
+		uint64_t mByteCount = 0;
+
+		std::map<std::string, double> mCounters;
+	};
+
+	using Function = std::function<void(State&)>;
+
+	struct Settings
+	{
+		std::string filter;        // runs the cases whose name contains it, all when empty
+		double minSeconds = 0.25;  // timed per repetition
+		int repetitions = 3;       // the median is reported
+	};
+
+	struct Result
+	{
+		std::string name; // "case/size"
+		uint64_t iterations = 0;
+		double nsPerIteration = 0.0;
+		double itemsPerSecond = 0.0;
+		double bytesPerSecond = 0.0;
+		std::map<std::string, double> counters; // of the median repetition
+	};
+
+	// name to ns per iteration, as written by Write
+	using Baseline = std::map<std::string, double>;
+
+	struct Difference
+	{
+		std::string name;
+		double baselineNs = 0.0;
+		double currentNs = 0.0;
+
+		double GetRatio() const { return (baselineNs > 0.0) ? currentNs / baselineNs : 0.0; }
+	};
+
+	// for MICRO_BENCHMARK, returns true so it can initialize a static
+	static bool Register(const std::string& name, Function function, std::vector<std::size_t> sizes);
+
+	static std::vector<Result> Run(const Settings& settings);
+
+	// a line per result, its name and ns per iteration separated by a tab
+	static bool Write(const std::vector<Result>& results, const std::string& path);
+	static bool Read(const std::string& path, Baseline& baseline);
+
+	// results slower than the baseline by more than tolerance, relative; results without a baseline are
+	// left out
+	static std::vector<Difference> Compare(const Baseline& baseline, const std::vector<Result>& results, const double tolerance);
+
+	static bool WriteJSON(const std::vector<Result>& results, const std::string& path);
+
+	// keeps the compiler from dropping the computation of value
+	template<typename T>
+	static void DoNotOptimize(const T& value)
+	{
+#if defined(_MSC_VER)
+		const volatile char* pValue = reinterpret_cast<const volatile char*>(&value);
+		(void)*pValue;
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+
+	// memory written before it counts as read
+	static void ClobberMemory()
+	{
+#if defined(_MSC_VER)
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : : "memory");
+#endif
+	}
+};
+
+#define MICRO_BENCHMARK_CONCAT_(a, b) a##b
+#define MICRO_BENCHMARK_CONCAT(a, b) MICRO_BENCHMARK_CONCAT_(a, b)
+
+#define MICRO_BENCHMARK(function, ...) static const bool MICRO_BENCHMARK_CONCAT(function##Registered, __LINE__) = MicroBenchmark::Register(#function, function, { __VA_ARGS__ })
\ No newline at end of file
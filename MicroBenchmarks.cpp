@@ -0,0 +1,1168 @@
+#include "MicroBenchmark.h"
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+// posix
+#include <fcntl.h>
+#include <unistd.h>
+#endif // __linux__
+
+#include "AssetArchive.h"
+#include "BlockCompressor.h"
+#include "BlockDecoder.h"
+#include "Camera.h"
+#include "CompressedTexture.h"
+#include "CPUProfiler.h"
+#include "DDSTextureLoader11.h"
+#include "MaterialManager.h"
+#include "MeshManager.h"
+#include "MipGenerator.h"
+#include "ObjectManager.h"
+#include "RenderDeviceNull.h"
+#include "TextureManager.h"
+
+// microbenchmarks of the cpu hot paths, each at a few sizes, compared against a stored baseline so a
+// change that slows one of them down fails the run:
+// microbenchmarks [--filter text] [--min-time seconds] [--repetitions n] [--json path] [--save path]
+//                 [--baseline path] [--tolerance t]
+
+namespace
+{
+	// cameras
+
+	void CameraUpdateViewMatrix(MicroBenchmark::State& state)
+	{
+		std::vector<Camera> cameras(state.GetSize());
+
+		for (std::size_t i = 0; i < cameras.size(); ++i)
+		{
+			cameras[i].SetPosition(float(i), 2.0f, -10.0f);
+		}
+
+		while (state.KeepRunning())
+		{
+			for (Camera& camera : cameras)
+			{
+				camera.Walk(0.01f);
+				camera.RotateY(0.001f);
+				camera.UpdateViewMatrix();
+			}
+
+			MicroBenchmark::ClobberMemory();
+		}
+
+		state.SetItemsProcessed(state.GetIterations() * cameras.size());
+	}
+
+	MICRO_BENCHMARK(CameraUpdateViewMatrix, 1, 64, 4096);
+
+	// SetLens recomputes the projection and the frustum cache
+	void CameraSetLens(MicroBenchmark::State& state)
+	{
+		std::vector<Camera> cameras(state.GetSize());
+		float aspectRatio = 1.0f;
+
+		while (state.KeepRunning())
+		{
+			aspectRatio = (aspectRatio > 2.0f) ? 1.0f : aspectRatio + 0.001f;
+
+			for (Camera& camera : cameras)
+			{
+				camera.SetLens(0.25f * XM_PI, aspectRatio, 1.0f, 1000.0f);
+			}
+
+			MicroBenchmark::ClobberMemory();
+		}
+
+		state.SetItemsProcessed(state.GetIterations() * cameras.size());
+	}
+
+	MICRO_BENCHMARK(CameraSetLens, 1, 64, 4096);
+
+	// profiling
+
+	// an empty CPUProfiler scope, drained before its ring fills, where dropping would be cheaper. the
+	// counters split the cost: a scope alone, as MeasureScopeOverheadNs times it, and the counter read
+	// it makes at either end, which is most of it where reading the counter traps to the hypervisor
+	void CPUProfilerScope(MicroBenchmark::State& state)
+	{
+		CPUProfiler::EndFrame();
+
+		uint64_t i = 0;
+
+		while (state.KeepRunning())
+		{
+			if ((++i % 4096) == 0)
+			{
+				state.PauseTiming();
+				CPUProfiler::EndFrame();
+				state.ResumeTiming();
+			}
+
+			CPUProfiler::Scope scope("benchmark scope");
+		}
+
+		CPUProfiler::EndFrame();
+
+		const std::size_t readCount = 1 << 16;
+		uint64_t ticks = 0;
+
+		const auto start = std::chrono::steady_clock::now();
+
+		for (std::size_t read = 0; read < readCount; ++read)
+		{
+			ticks += CPUProfiler::GetTicks();
+		}
+
+		const double readNs = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / double(readCount);
+		MicroBenchmark::DoNotOptimize(ticks);
+
+		state.SetCounter("ns/scope", CPUProfiler::MeasureScopeOverheadNs());
+		state.SetCounter("ns/counter read", readNs);
+		state.SetItemsProcessed(state.GetIterations());
+	}
+
+	MICRO_BENCHMARK(CPUProfilerScope);
+
+	// meshes
+
+	// a size x size vertex grid, past 256 the 16-bit indices wrap but the work is the same
+	void CreateGrid(MicroBenchmark::State& state)
+	{
+		const std::size_t size = state.GetSize();
+
+		while (state.KeepRunning())
+		{
+			const MeshData mesh = MeshManager::CreateGrid(100.0f, 100.0f, size, size);
+			MicroBenchmark::DoNotOptimize(mesh.vertices.data());
+		}
+
+		state.SetItemsProcessed(state.GetIterations() * size * size);
+	}
+
+	MICRO_BENCHMARK(CreateGrid, 64, 256, 1024);
+
+	// size vertex lines in the text format of the models
+	std::string CreateModelText(const std::size_t vertexCount)
+	{
+		std::string text = "header\n";
+
+		for (std::size_t i = 0; i < vertexCount; ++i)
+		{
+			char line[256];
+			std::snprintf(line, sizeof(line),
+						  "%zu;%zu;%zu ;%.4f ;%.4f ;%.4f ;0 ;0 ;0 ;0 ;255 ;0 ;0 ;0 ;%zu ;%zu ;%zu ;0 ;0 ;0 ;0 ;0 ;%zu ;%zu ;%zu ;0 ;%zu ;%zu ;0 ;0 ;0 ;0 ;0 ;0\n",
+						  i, i, i, 0.01f * float(i % 97), 0.02f * float(i % 89), 0.03f * float(i % 83),
+						  i % 255, (i * 7) % 255, (i * 13) % 255,
+						  (i * 3) % 255, (i * 5) % 255, (i * 11) % 255,
+						  i % 256, (i / 256) % 256);
+			text += line;
+		}
+
+		return text;
+	}
+
+	void LoadModel(MicroBenchmark::State& state)
+	{
+		const std::string text = CreateModelText(state.GetSize());
+
+		while (state.KeepRunning())
+		{
+			const MeshData mesh = MeshManager::LoadModel(reinterpret_cast<const uint8_t*>(text.data()), text.size());
+			MicroBenchmark::DoNotOptimize(mesh.vertices.data());
+		}
+
+		state.SetItemsProcessed(state.GetIterations() * state.GetSize());
+		state.SetBytesProcessed(state.GetIterations() * text.size());
+	}
+
+	MICRO_BENCHMARK(LoadModel, 1000, 10000, 100000);
+
+	// textures
+
+	// a 256x256 BC1 array of size slices with full mip chains
+	std::vector<uint8_t> CreateArrayDDS(const std::size_t arraySize)
+	{
+		constexpr uint32_t kSize = 256;
+		constexpr uint32_t kMipCount = 9;
+
+		DDSTextureInfo info;
+		info.width = kSize;
+		info.height = kSize;
+		info.depth = 1;
+		info.mipCount = kMipCount;
+		info.arraySize = uint32_t(arraySize);
+		info.format = DXGI_FORMAT_BC1_UNORM;
+		info.resourceDimension = D3D11_RESOURCE_DIMENSION_TEXTURE2D;
+		info.isCubeMap = 0;
+
+		// every subresource reads from the top mip's blocks, they're the largest
+		std::size_t topBytes = 0;
+		ThrowIfFailed(GetDDSSurfaceInfo(kSize, kSize, info.format, &topBytes, nullptr, nullptr));
+
+		std::vector<uint8_t> blocks(topBytes);
+
+		for (std::size_t i = 0; i < blocks.size(); ++i)
+		{
+			blocks[i] = uint8_t(i * 31);
+		}
+
+		std::vector<D3D11_SUBRESOURCE_DATA> subresources(kMipCount * arraySize);
+
+		for (std::size_t item = 0; item < arraySize; ++item)
+		{
+			for (uint32_t mip = 0; mip < kMipCount; ++mip)
+			{
+				std::size_t numBytes = 0;
+				std::size_t rowBytes = 0;
+				ThrowIfFailed(GetDDSSurfaceInfo(std::max(1u, kSize >> mip), std::max(1u, kSize >> mip), info.format, &numBytes, &rowBytes, nullptr));
+
+				D3D11_SUBRESOURCE_DATA& subresource = subresources[item * kMipCount + mip];
+				subresource.pSysMem = blocks.data();
+				subresource.SysMemPitch = UINT(rowBytes);
+				subresource.SysMemSlicePitch = UINT(numBytes);
+			}
+		}
+
+		std::size_t size = 0;
+		ThrowIfFailed(SaveDDSTextureToMemory(info, subresources.data(), nullptr, 0, &size));
+
+		std::vector<uint8_t> dds(size);
+		ThrowIfFailed(SaveDDSTextureToMemory(info, subresources.data(), dds.data(), dds.size(), &size));
+
+		return dds;
+	}
+
+	void DDSHeader(MicroBenchmark::State& state)
+	{
+		const std::vector<uint8_t> dds = CreateArrayDDS(state.GetSize());
+
+		while (state.KeepRunning())
+		{
+			DDSTextureInfo info;
+			const uint8_t* bitData = nullptr;
+			std::size_t bitSize = 0;
+
+			ThrowIfFailed(GetDDSTextureInfoFromMemory(dds.data(), dds.size(), &info, &bitData, &bitSize));
+			MicroBenchmark::DoNotOptimize(info);
+			MicroBenchmark::DoNotOptimize(bitData);
+		}
+
+		state.SetItemsProcessed(state.GetIterations());
+	}
+
+	MICRO_BENCHMARK(DDSHeader, 1, 16, 256);
+
+	// the subresource table CreateDDSTextureFromMemory hands to the device
+	void FillInitData(MicroBenchmark::State& state)
+	{
+		const std::vector<uint8_t> dds = CreateArrayDDS(state.GetSize());
+
+		DDSTextureInfo info;
+		const uint8_t* bitData = nullptr;
+		std::size_t bitSize = 0;
+		ThrowIfFailed(GetDDSTextureInfoFromMemory(dds.data(), dds.size(), &info, &bitData, &bitSize));
+
+		std::vector<D3D11_SUBRESOURCE_DATA> initData(info.mipCount * info.arraySize);
+
+		while (state.KeepRunning())
+		{
+			ThrowIfFailed(GetDDSSubresourceData(info, bitData, bitSize, initData.data()));
+			MicroBenchmark::ClobberMemory();
+		}
+
+		state.SetItemsProcessed(state.GetIterations() * initData.size());
+	}
+
+	MICRO_BENCHMARK(FillInitData, 1, 16, 256);
+
+	// the Texture2DArray loads of TextureManager, with the files read into heap copies as before and
+	// mapped as now; every texel is hashed in place of the driver's upload copy, which the null device
+	// doesn't make. peak rss is the high water mark over the run and anon rss the heap part of it while
+	// the files are loaded, mapped pages only count in the former and the kernel can drop them
+	constexpr uint32_t kLoadTextureSize = 1024;
+	constexpr std::size_t kLoadFileCount = 16;
+
+	// a 1024x1024 rgba8 texture with its full mip chain
+	std::vector<uint8_t> CreateLoadDDS(const std::size_t seed)
+	{
+		DDSTextureInfo info;
+		info.width = kLoadTextureSize;
+		info.height = kLoadTextureSize;
+		info.depth = 1;
+		info.mipCount = 11;
+		info.arraySize = 1;
+		info.format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		info.resourceDimension = D3D11_RESOURCE_DIMENSION_TEXTURE2D;
+		info.isCubeMap = 0;
+
+		std::vector<uint8_t> texels(std::size_t(kLoadTextureSize) * kLoadTextureSize * 4);
+
+		for (std::size_t i = 0; i < texels.size(); ++i)
+		{
+			texels[i] = uint8_t(i * 31 + seed);
+		}
+
+		std::vector<D3D11_SUBRESOURCE_DATA> subresources(info.mipCount);
+
+		for (uint32_t mip = 0; mip < info.mipCount; ++mip)
+		{
+			const uint32_t size = std::max(1u, kLoadTextureSize >> mip);
+
+			subresources[mip].pSysMem = texels.data();
+			subresources[mip].SysMemPitch = size * 4;
+			subresources[mip].SysMemSlicePitch = size * size * 4;
+		}
+
+		std::size_t size = 0;
+		ThrowIfFailed(SaveDDSTextureToMemory(info, subresources.data(), nullptr, 0, &size));
+
+		std::vector<uint8_t> dds(size);
+		ThrowIfFailed(SaveDDSTextureToMemory(info, subresources.data(), dds.data(), dds.size(), &size));
+
+		return dds;
+	}
+
+	// written once into the temp directory and removed at exit
+	struct LoadFiles
+	{
+		std::vector<std::string> paths;
+
+		LoadFiles()
+		{
+			for (std::size_t i = 0; i < kLoadFileCount; ++i)
+			{
+				paths.push_back((std::filesystem::temp_directory_path() / ("microbenchmark" + std::to_string(i) + ".dds")).string());
+
+				const std::vector<uint8_t> dds = CreateLoadDDS(i);
+				std::ofstream stream(paths.back(), std::ios::binary);
+				stream.write(reinterpret_cast<const char*>(dds.data()), std::streamsize(dds.size()));
+
+				if (!stream)
+				{
+					ThrowIfFailed(E_FAIL);
+				}
+			}
+		}
+
+		~LoadFiles()
+		{
+			std::error_code error;
+
+			for (const std::string& path : paths)
+			{
+				std::filesystem::remove(path, error);
+			}
+		}
+	};
+
+	const std::vector<std::string>& GetLoadFiles()
+	{
+		static const LoadFiles files;
+		return files.paths;
+	}
+
+#ifdef __linux__
+	// a "VmHWM:" like field of /proc/self/status in MB
+	double ReadProcessStatus(const char* field)
+	{
+		std::ifstream stream("/proc/self/status");
+		std::string line;
+
+		while (std::getline(stream, line))
+		{
+			if (line.compare(0, std::strlen(field), field) == 0)
+			{
+				return std::strtod(line.c_str() + std::strlen(field), nullptr) / 1024.0;
+			}
+		}
+
+		return 0.0;
+	}
+
+	// VmHWM starts over from the current rss
+	void ResetPeakRSS()
+	{
+		std::ofstream("/proc/self/clear_refs") << "5";
+	}
+#endif // __linux__
+
+	// the array out of the loaded files, as LoadTexturesIntoTexture2DArray creates it
+	void CreateLoadArray(ID3D11Device* device, const std::vector<std::pair<const uint8_t*, std::size_t>>& files)
+	{
+		std::vector<D3D11_SUBRESOURCE_DATA> initData;
+		DDSTextureInfo info;
+		uint64_t hash = 0;
+
+		for (const auto& [data, size] : files)
+		{
+			const uint8_t* bitData = nullptr;
+			std::size_t bitSize = 0;
+			ThrowIfFailed(GetDDSTextureInfoFromMemory(data, size, &info, &bitData, &bitSize));
+
+			const std::size_t first = initData.size();
+			initData.resize(first + info.mipCount);
+			ThrowIfFailed(GetDDSSubresourceData(info, bitData, bitSize, initData.data() + first));
+
+			for (std::size_t i = first; i < initData.size(); ++i)
+			{
+				hash = HashBytes(initData[i].pSysMem, initData[i].SysMemSlicePitch, hash);
+			}
+		}
+
+		MicroBenchmark::DoNotOptimize(hash);
+
+		D3D11_TEXTURE2D_DESC desc = {};
+		desc.Width = info.width;
+		desc.Height = info.height;
+		desc.MipLevels = info.mipCount;
+		desc.ArraySize = UINT(files.size());
+		desc.Format = info.format;
+		desc.SampleDesc.Count = 1;
+		desc.Usage = D3D11_USAGE_IMMUTABLE;
+		desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+		ComPtr<ID3D11Texture2D> texture;
+		ThrowIfFailed(device->CreateTexture2D(&desc, initData.data(), &texture));
+	}
+
+	template<bool isMapped>
+	void TextureArrayLoad(MicroBenchmark::State& state)
+	{
+		ComPtr<ID3D11Device> device;
+		ComPtr<ID3D11DeviceContext> context;
+		RenderDeviceNull::CreateDevice(device, context);
+
+		const std::vector<std::string> paths(GetLoadFiles().begin(), GetLoadFiles().begin() + state.GetSize());
+		std::size_t byteCount = 0;
+		double anonMB = 0.0;
+
+#ifdef __linux__
+		const double startMB = ReadProcessStatus("VmRSS:");
+		const double startAnonMB = ReadProcessStatus("RssAnon:");
+		ResetPeakRSS();
+#endif // __linux__
+
+		while (state.KeepRunning())
+		{
+			std::vector<MappedFile> mappedFiles(paths.size());
+			std::vector<std::vector<uint8_t>> readFiles(paths.size());
+			std::vector<std::pair<const uint8_t*, std::size_t>> files;
+
+			for (std::size_t i = 0; i < paths.size(); ++i)
+			{
+				if constexpr (isMapped)
+				{
+					if (!mappedFiles[i].Open(paths[i]))
+					{
+						ThrowIfFailed(E_FAIL);
+					}
+
+					files.emplace_back(mappedFiles[i].GetData(), mappedFiles[i].GetSize());
+				}
+				else
+				{
+					std::ifstream stream(paths[i], std::ios::binary | std::ios::ate);
+
+					if (!stream)
+					{
+						ThrowIfFailed(E_FAIL);
+					}
+
+					readFiles[i].resize(std::size_t(stream.tellg()));
+					stream.seekg(0);
+					stream.read(reinterpret_cast<char*>(readFiles[i].data()), std::streamsize(readFiles[i].size()));
+
+					files.emplace_back(readFiles[i].data(), readFiles[i].size());
+				}
+
+				byteCount += files.back().second;
+			}
+
+			CreateLoadArray(device.Get(), files);
+
+#ifdef __linux__
+			state.PauseTiming();
+			anonMB = std::max(anonMB, ReadProcessStatus("RssAnon:") - startAnonMB);
+			state.ResumeTiming();
+#endif // __linux__
+		}
+
+#ifdef __linux__
+		state.SetCounter("peak rss MB", ReadProcessStatus("VmHWM:") - startMB);
+		state.SetCounter("anon rss MB", anonMB);
+#endif // __linux__
+
+		state.SetItemsProcessed(state.GetIterations() * paths.size());
+		state.SetBytesProcessed(byteCount);
+	}
+
+	void TextureArrayLoadRead(MicroBenchmark::State& state) { TextureArrayLoad<false>(state); }
+	void TextureArrayLoadMapped(MicroBenchmark::State& state) { TextureArrayLoad<true>(state); }
+
+	MICRO_BENCHMARK(TextureArrayLoadRead, 4, 16);
+	MICRO_BENCHMARK(TextureArrayLoadMapped, 4, 16);
+
+	// the worker half of LoadTextureAsync, mapping, parsing and hashing the files on the pool, and the
+	// null device's half of FlushAsyncLoads polled until every slot is ready; a new TextureManager per
+	// iteration so no load is aliased to the last one's, its pool threads start inside the timing
+	void TextureAsyncLoad(MicroBenchmark::State& state)
+	{
+		ComPtr<ID3D11Device> device;
+		ComPtr<ID3D11DeviceContext> context;
+		RenderDeviceNull::CreateDevice(device, context);
+
+		const std::vector<std::string> paths(GetLoadFiles().begin(), GetLoadFiles().begin() + state.GetSize());
+		double parseMs = 0.0;
+		std::size_t byteCount = 0;
+
+		while (state.KeepRunning())
+		{
+			TextureManager textureManager;
+			textureManager.Init(device, context);
+
+			for (const std::string& path : paths)
+			{
+				textureManager.LoadTextureAsync(path);
+			}
+
+			for (std::size_t count = 0; count < paths.size(); )
+			{
+				count += textureManager.FlushAsyncLoads();
+				std::this_thread::yield();
+			}
+
+			parseMs += textureManager.GetAsyncLoadStats().totalParseMs;
+			byteCount += textureManager.GetAsyncLoadStats().bytes;
+		}
+
+		state.SetCounter("parse ms/file", parseMs / double(state.GetIterations() * paths.size()));
+		state.SetItemsProcessed(state.GetIterations() * paths.size());
+		state.SetBytesProcessed(byteCount);
+	}
+
+	MICRO_BENCHMARK(TextureAsyncLoad, 1, 4, 16);
+
+	// archives
+
+	// size 64 KiB files read whole as loose files and as the stored entries of an AssetArchive, which
+	// costs one open and one mapping instead of one per file; cold runs drop the page cache of the files
+	// before each iteration, which only linux does here
+	struct ArchiveFiles
+	{
+		std::vector<std::string> names;
+		std::vector<std::string> paths;
+		std::string archivePath;
+
+		explicit ArchiveFiles(const std::size_t count)
+		{
+			const std::filesystem::path directory = std::filesystem::temp_directory_path();
+			uint32_t random = 0x2545f491u;
+
+			std::vector<AssetArchive::Input> inputs;
+
+			for (std::size_t i = 0; i < count; ++i)
+			{
+				names.push_back("file" + std::to_string(i));
+				paths.push_back((directory / ("microbenchmark_" + std::to_string(count) + "_" + names.back())).string());
+
+				std::vector<uint8_t> data(64 * 1024);
+
+				for (uint8_t& byte : data)
+				{
+					random = random * 1664525u + 1013904223u;
+					byte = uint8_t(random >> 24);
+				}
+
+				std::ofstream stream(paths.back(), std::ios::binary);
+				stream.write(reinterpret_cast<const char*>(data.data()), std::streamsize(data.size()));
+
+				inputs.push_back({ names.back(), paths.back() });
+			}
+
+			// stored, so both read the same bytes and only the layout differs
+			AssetArchive::Settings settings;
+			settings.compress = false;
+
+			archivePath = (directory / ("microbenchmark_" + std::to_string(count) + ".archive")).string();
+			AssetArchive::Build(inputs, archivePath, settings);
+		}
+
+		~ArchiveFiles()
+		{
+			std::error_code error;
+
+			for (const std::string& path : paths)
+			{
+				std::filesystem::remove(path, error);
+			}
+
+			std::filesystem::remove(archivePath, error);
+		}
+	};
+
+	const ArchiveFiles& GetArchiveFiles(const std::size_t count)
+	{
+		static std::map<std::size_t, std::unique_ptr<ArchiveFiles>> files;
+
+		std::unique_ptr<ArchiveFiles>& entry = files[count];
+
+		if (!entry)
+		{
+			entry = std::make_unique<ArchiveFiles>(count);
+		}
+
+		return *entry;
+	}
+
+	void DropPageCache(const std::string& path)
+	{
+#ifdef __linux__
+		const int file = open(path.c_str(), O_RDONLY);
+
+		if (file >= 0)
+		{
+			posix_fadvise(file, 0, 0, POSIX_FADV_DONTNEED);
+			close(file);
+		}
+#endif // __linux__
+	}
+
+	template<bool isArchive, bool isCold>
+	void AssetLoad(MicroBenchmark::State& state)
+	{
+		const ArchiveFiles& files = GetArchiveFiles(state.GetSize());
+		std::size_t byteCount = 0;
+
+		while (state.KeepRunning())
+		{
+			if constexpr (isCold)
+			{
+				state.PauseTiming();
+
+				for (const std::string& path : files.paths)
+				{
+					DropPageCache(path);
+				}
+
+				DropPageCache(files.archivePath);
+
+				state.ResumeTiming();
+			}
+
+			uint64_t hash = 0;
+
+			if constexpr (isArchive)
+			{
+				AssetArchive archive;
+
+				if (!archive.Open(files.archivePath))
+				{
+					ThrowIfFailed(E_FAIL);
+				}
+
+				std::vector<uint8_t> storage;
+
+				for (const std::string& name : files.names)
+				{
+					const std::span<const uint8_t> data = archive.GetEntry(name, storage);
+					hash = HashBytes(data.data(), data.size(), hash);
+					byteCount += data.size();
+				}
+			}
+			else
+			{
+				for (const std::string& path : files.paths)
+				{
+					const MappedFile file(path);
+
+					if (!file.IsOpen())
+					{
+						ThrowIfFailed(E_FAIL);
+					}
+
+					hash = HashBytes(file.GetData(), file.GetSize(), hash);
+					byteCount += file.GetSize();
+				}
+			}
+
+			MicroBenchmark::DoNotOptimize(hash);
+		}
+
+		state.SetItemsProcessed(state.GetIterations() * files.names.size());
+		state.SetBytesProcessed(byteCount);
+	}
+
+	void ArchiveLoadWarm(MicroBenchmark::State& state) { AssetLoad<true, false>(state); }
+	void LooseFilesLoadWarm(MicroBenchmark::State& state) { AssetLoad<false, false>(state); }
+
+	MICRO_BENCHMARK(ArchiveLoadWarm, 64, 512);
+	MICRO_BENCHMARK(LooseFilesLoadWarm, 64, 512);
+
+#ifdef __linux__
+	void ArchiveLoadCold(MicroBenchmark::State& state) { AssetLoad<true, true>(state); }
+	void LooseFilesLoadCold(MicroBenchmark::State& state) { AssetLoad<false, true>(state); }
+
+	MICRO_BENCHMARK(ArchiveLoadCold, 64, 512);
+	MICRO_BENCHMARK(LooseFilesLoadCold, 64, 512);
+#endif // __linux__
+
+	// block compression
+
+	// size x size texels of format decoded per iteration through DecodeSubresource, the blocks are the
+	// compressor's encoding of a gradient where it supports the format and pseudo random bits otherwise
+	template<DXGI_FORMAT format>
+	void BCDecode(MicroBenchmark::State& state)
+	{
+		const uint32_t size = uint32_t(state.GetSize());
+		const uint32_t blocksAcross = size / 4;
+		const std::size_t blockSize = BlockDecoder::GetBlockSize(format);
+
+		std::vector<uint8_t> blocks(std::size_t(blocksAcross) * blocksAcross * blockSize);
+		uint32_t random = 0x12345678u;
+
+		for (uint32_t by = 0; by < blocksAcross; ++by)
+		{
+			for (uint32_t bx = 0; bx < blocksAcross; ++bx)
+			{
+				uint8_t* block = &blocks[(std::size_t(by) * blocksAcross + bx) * blockSize];
+
+				if (BlockCompressor::IsSupportedFormat(format))
+				{
+					uint8_t rgba[64];
+
+					for (uint32_t i = 0; i < 16; ++i)
+					{
+						rgba[i * 4 + 0] = uint8_t(bx * 4 + i % 4);
+						rgba[i * 4 + 1] = uint8_t(by * 4 + i / 4);
+						rgba[i * 4 + 2] = uint8_t((bx + by) * 8);
+						rgba[i * 4 + 3] = uint8_t(255 - i * 8);
+					}
+
+					BlockCompressor::EncodeBlock(format, rgba, block, BlockCompressor::Quality::Normal);
+				}
+				else
+				{
+					for (std::size_t i = 0; i < blockSize; ++i)
+					{
+						random = random * 1664525u + 1013904223u;
+						block[i] = uint8_t(random >> 24);
+					}
+
+					// bc6h mode 1, random bits are as likely to land on a reserved mode that decodes to black
+					if (format == DXGI_FORMAT_BC6H_UF16)
+					{
+						block[0] &= 0xfc;
+					}
+				}
+			}
+		}
+
+		D3D11_SUBRESOURCE_DATA subresource = {};
+		subresource.pSysMem = blocks.data();
+		subresource.SysMemPitch = UINT(blocksAcross * blockSize);
+		subresource.SysMemSlicePitch = UINT(blocks.size());
+
+		std::vector<uint8_t> rgba;
+		std::vector<XMFLOAT4> texels;
+
+		if (BlockDecoder::IsUNormFormat(format))
+		{
+			rgba.resize(std::size_t(size) * size * 4);
+		}
+		else
+		{
+			texels.resize(std::size_t(size) * size);
+		}
+
+		while (state.KeepRunning())
+		{
+			if (BlockDecoder::IsUNormFormat(format))
+			{
+				BlockDecoder::DecodeSubresource(format, subresource, size, size, rgba.data(), std::size_t(size) * 4);
+			}
+			else
+			{
+				BlockDecoder::DecodeSubresource(format, subresource, size, size, texels.data(), std::size_t(size) * sizeof(XMFLOAT4));
+			}
+
+			MicroBenchmark::ClobberMemory();
+		}
+
+		const uint64_t texelCount = state.GetIterations() * size * size;
+
+		state.SetCounter("MP/s", double(texelCount) / 1000000.0 / std::max(state.GetSeconds(), 1e-12));
+		state.SetItemsProcessed(texelCount);
+		state.SetBytesProcessed(state.GetIterations() * blocks.size());
+	}
+
+	void BC1Decode(MicroBenchmark::State& state) { BCDecode<DXGI_FORMAT_BC1_UNORM>(state); }
+	void BC2Decode(MicroBenchmark::State& state) { BCDecode<DXGI_FORMAT_BC2_UNORM>(state); }
+	void BC3Decode(MicroBenchmark::State& state) { BCDecode<DXGI_FORMAT_BC3_UNORM>(state); }
+	void BC4Decode(MicroBenchmark::State& state) { BCDecode<DXGI_FORMAT_BC4_UNORM>(state); }
+	void BC5Decode(MicroBenchmark::State& state) { BCDecode<DXGI_FORMAT_BC5_UNORM>(state); }
+	void BC6HDecode(MicroBenchmark::State& state) { BCDecode<DXGI_FORMAT_BC6H_UF16>(state); }
+	void BC7Decode(MicroBenchmark::State& state) { BCDecode<DXGI_FORMAT_BC7_UNORM>(state); }
+
+	MICRO_BENCHMARK(BC1Decode, 256, 1024);
+	MICRO_BENCHMARK(BC2Decode, 256, 1024);
+	MICRO_BENCHMARK(BC3Decode, 256, 1024);
+	MICRO_BENCHMARK(BC4Decode, 256, 1024);
+	MICRO_BENCHMARK(BC5Decode, 256, 1024);
+	MICRO_BENCHMARK(BC6HDecode, 256, 1024);
+	MICRO_BENCHMARK(BC7Decode, 256, 1024);
+
+	// compressed textures
+
+	// a size x size image with its mips in format, rgba8 smooth gradients with a little noise the way
+	// albedo maps are, block compressed from it for the bc formats; made once per format and size
+	const std::vector<uint8_t>& GetImageDDS(const DXGI_FORMAT format, const uint32_t size)
+	{
+		static std::map<std::pair<DXGI_FORMAT, uint32_t>, std::vector<uint8_t>> images;
+
+		std::vector<uint8_t>& image = images[{ format, size }];
+
+		if (!image.empty())
+		{
+			return image;
+		}
+
+		DDSTextureInfo info;
+		info.width = size;
+		info.height = size;
+		info.depth = 1;
+		info.mipCount = 1;
+		info.arraySize = 1;
+		info.format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		info.resourceDimension = D3D11_RESOURCE_DIMENSION_TEXTURE2D;
+		info.isCubeMap = 0;
+
+		std::vector<uint8_t> texels(std::size_t(size) * size * 4);
+		uint32_t random = 0x9e3779b9u;
+
+		for (uint32_t y = 0; y < size; ++y)
+		{
+			for (uint32_t x = 0; x < size; ++x)
+			{
+				random = random * 1664525u + 1013904223u;
+				const uint32_t noise = (random >> 28);
+
+				uint8_t* texel = &texels[(std::size_t(y) * size + x) * 4];
+				texel[0] = uint8_t(x * 255 / size + noise);
+				texel[1] = uint8_t(y * 255 / size + noise);
+				texel[2] = uint8_t(((x / 32 + y / 32) % 2) ? 200 : 40);
+				texel[3] = 255;
+			}
+		}
+
+		D3D11_SUBRESOURCE_DATA subresource = {};
+		subresource.pSysMem = texels.data();
+		subresource.SysMemPitch = size * 4;
+		subresource.SysMemSlicePitch = UINT(texels.size());
+
+		std::size_t ddsSize = 0;
+		ThrowIfFailed(SaveDDSTextureToMemory(info, &subresource, nullptr, 0, &ddsSize));
+
+		std::vector<uint8_t> dds(ddsSize);
+		ThrowIfFailed(SaveDDSTextureToMemory(info, &subresource, dds.data(), dds.size(), &ddsSize));
+
+		image = MipGenerator::GenerateMips(dds.data(), dds.size(), {});
+
+		if (format != DXGI_FORMAT_R8G8B8A8_UNORM)
+		{
+			BlockCompressor::Settings settings;
+			settings.format = format;
+			settings.quality = BlockCompressor::Quality::Fast;
+			settings.verify = false;
+
+			image = BlockCompressor::Compress(image.data(), image.size(), settings);
+		}
+
+		return image;
+	}
+
+	// every mip decompressed from a CompressedTexture, the ratio is of its texel data against the chunks
+	template<DXGI_FORMAT format>
+	void CompressedTextureDecompress(MicroBenchmark::State& state)
+	{
+		const std::vector<uint8_t>& dds = GetImageDDS(format, uint32_t(state.GetSize()));
+
+		CompressedTexture::Report compressReport;
+		const std::vector<uint8_t> compressed = CompressedTexture::Compress(dds.data(), dds.size(), {}, &compressReport);
+
+		std::vector<uint8_t> ddsData(CompressedTexture::GetDDSSize(compressed.data(), compressed.size()));
+		std::size_t byteCount = 0;
+
+		while (state.KeepRunning())
+		{
+			CompressedTexture::Report report;
+
+			if (!CompressedTexture::Decompress(compressed.data(), compressed.size(), ddsData.data(), ddsData.size(), 0, &report))
+			{
+				ThrowIfFailed(E_FAIL);
+			}
+
+			byteCount += report.originalBytes;
+		}
+
+		state.SetCounter("ratio", compressReport.GetRatio());
+		state.SetCounter("MB/s", double(byteCount) / (1024.0 * 1024.0) / std::max(state.GetSeconds(), 1e-12));
+		state.SetBytesProcessed(byteCount);
+	}
+
+	void CompressedTextureRGBA8(MicroBenchmark::State& state) { CompressedTextureDecompress<DXGI_FORMAT_R8G8B8A8_UNORM>(state); }
+	void CompressedTextureBC1(MicroBenchmark::State& state) { CompressedTextureDecompress<DXGI_FORMAT_BC1_UNORM>(state); }
+	void CompressedTextureBC7(MicroBenchmark::State& state) { CompressedTextureDecompress<DXGI_FORMAT_BC7_UNORM>(state); }
+
+	MICRO_BENCHMARK(CompressedTextureRGBA8, 256, 1024);
+	MICRO_BENCHMARK(CompressedTextureBC1, 256, 1024);
+	MICRO_BENCHMARK(CompressedTextureBC7, 256, 1024);
+
+	// objects and materials
+
+	// the ObjectCB of every object packed and uploaded, as SceneBenchmark draws them
+	void ObjectCBPacking(MicroBenchmark::State& state)
+	{
+		ComPtr<ID3D11Device> device;
+		ComPtr<ID3D11DeviceContext> context;
+		RenderDeviceNull::CreateDevice(device, context);
+
+		ObjectManager objectManager;
+		objectManager.Init(device, context);
+
+		MaterialManager materialManager;
+
+		for (std::size_t i = 0; i < 64; ++i)
+		{
+			Material material;
+			material.roughness = float(i) / 64.0f;
+
+			materialManager.AddMaterial("material" + std::to_string(i), material);
+		}
+
+		for (std::size_t i = 0; i < state.GetSize(); ++i)
+		{
+			Object object;
+			object.mesh = i % 16;
+			object.material = i % 64;
+			XMStoreFloat4x4(&object.world, XMMatrixTranslation(float(i % 100), 0.0f, float(i / 100)));
+
+			objectManager.AddObject(object);
+		}
+
+		while (state.KeepRunning())
+		{
+			for (std::size_t i = 0; i < state.GetSize(); ++i)
+			{
+				objectManager.UpdateBuffer(i, materialManager);
+			}
+		}
+
+		state.SetItemsProcessed(state.GetIterations() * state.GetSize());
+		state.SetBytesProcessed(state.GetIterations() * state.GetSize() * sizeof(ObjectManager::ObjectCB));
+	}
+
+	MICRO_BENCHMARK(ObjectCBPacking, 1000, 100000);
+
+	std::vector<Material> CreateMaterials(const std::size_t count)
+	{
+		std::vector<Material> materials(count);
+
+		for (std::size_t i = 0; i < count; ++i)
+		{
+			materials[i].diffuse = XMFLOAT4(float(i % 7) / 6.0f, float(i % 11) / 10.0f, float(i % 13) / 12.0f, 1.0f);
+			materials[i].roughness = 0.1f + 0.8f * float(i % 17) / 16.0f;
+			materials[i].diffuseTextureIndex = int(i % 16);
+		}
+
+		return materials;
+	}
+
+	void EncodeMaterials(MicroBenchmark::State& state)
+	{
+		const std::vector<Material> materials = CreateMaterials(state.GetSize());
+		std::vector<PackedMaterial> packed(materials.size());
+
+		while (state.KeepRunning())
+		{
+			MaterialManager::EncodeMaterials(materials.data(), packed.data(), materials.size());
+			MicroBenchmark::ClobberMemory();
+		}
+
+		state.SetItemsProcessed(state.GetIterations() * materials.size());
+		state.SetBytesProcessed(state.GetIterations() * materials.size() * sizeof(PackedMaterial));
+	}
+
+	MICRO_BENCHMARK(EncodeMaterials, 64, 4096, 65536);
+
+	// every 8th material edited between the uploads, the dirty ranges coalesce into a few uploads
+	void MaterialUpdateBuffer(MicroBenchmark::State& state)
+	{
+		ComPtr<ID3D11Device> device;
+		ComPtr<ID3D11DeviceContext> context;
+		RenderDeviceNull::CreateDevice(device, context);
+
+		MaterialManager materialManager;
+		materialManager.Init(device, context);
+
+		const std::vector<Material> materials = CreateMaterials(state.GetSize());
+
+		for (std::size_t i = 0; i < materials.size(); ++i)
+		{
+			materialManager.AddMaterial("material" + std::to_string(i), materials[i]);
+		}
+
+		materialManager.UpdateBuffer();
+
+		const std::size_t count = materialManager.GetMaterialCount();
+
+		while (state.KeepRunning())
+		{
+			state.PauseTiming();
+
+			for (std::size_t i = 0; i < count; i += 8)
+			{
+				materialManager.EditMaterial(i).roughness += 0.001f;
+			}
+
+			state.ResumeTiming();
+
+			materialManager.UpdateBuffer();
+		}
+
+		state.SetItemsProcessed(state.GetIterations() * ((count + 7) / 8));
+	}
+
+	MICRO_BENCHMARK(MaterialUpdateBuffer, 64, 4096, 65536);
+}
+
+int main(int argc, char* argv[])
+{
+	MicroBenchmark::Settings settings;
+	std::string jsonPath;
+	std::string savePath;
+	std::string baselinePath;
+	double tolerance = 0.10;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const bool hasValue = (i + 1) < argc;
+
+		if ((std::strcmp(argv[i], "--filter") == 0) && hasValue)
+		{
+			settings.filter = argv[++i];
+		}
+		else if ((std::strcmp(argv[i], "--min-time") == 0) && hasValue)
+		{
+			settings.minSeconds = std::strtod(argv[++i], nullptr);
+		}
+		else if ((std::strcmp(argv[i], "--repetitions") == 0) && hasValue)
+		{
+			settings.repetitions = std::max(1, std::atoi(argv[++i]));
+		}
+		else if ((std::strcmp(argv[i], "--json") == 0) && hasValue)
+		{
+			jsonPath = argv[++i];
+		}
+		else if ((std::strcmp(argv[i], "--save") == 0) && hasValue)
+		{
+			savePath = argv[++i];
+		}
+		else if ((std::strcmp(argv[i], "--baseline") == 0) && hasValue)
+		{
+			baselinePath = argv[++i];
+		}
+		else if ((std::strcmp(argv[i], "--tolerance") == 0) && hasValue)
+		{
+			tolerance = std::strtod(argv[++i], nullptr);
+		}
+		else
+		{
+			std::fprintf(stderr,
+						 "usage: %s [--filter text] [--min-time seconds] [--repetitions n] [--json path] [--save path] [--baseline path] [--tolerance t]\n",
+						 argv[0]);
+			return 1;
+		}
+	}
+
+	try
+	{
+		const std::vector<MicroBenchmark::Result> results = MicroBenchmark::Run(settings);
+
+		std::printf("%-32s %14s %14s %14s %14s\n", "benchmark", "iterations", "ns", "items/s", "bytes/s");
+
+		for (const MicroBenchmark::Result& result : results)
+		{
+			std::printf("%-32s %14llu %14.1f %14.4g %14.4g",
+						result.name.c_str(),
+						(unsigned long long)result.iterations,
+						result.nsPerIteration,
+						result.itemsPerSecond,
+						result.bytesPerSecond);
+
+			for (const auto& [name, value] : result.counters)
+			{
+				std::printf("  %s %.4g", name.c_str(), value);
+			}
+
+			std::printf("\n");
+		}
+
+		if (!jsonPath.empty() && !MicroBenchmark::WriteJSON(results, jsonPath))
+		{
+			std::fprintf(stderr, "can't write %s\n", jsonPath.c_str());
+			return 1;
+		}
+
+		if (!savePath.empty() && !MicroBenchmark::Write(results, savePath))
+		{
+			std::fprintf(stderr, "can't write %s\n", savePath.c_str());
+			return 1;
+		}
+
+		if (!baselinePath.empty())
+		{
+			MicroBenchmark::Baseline baseline;
+
+			if (!MicroBenchmark::Read(baselinePath, baseline))
+			{
+				std::fprintf(stderr, "can't read %s\n", baselinePath.c_str());
+				return 1;
+			}
+
+			const std::vector<MicroBenchmark::Difference> differences = MicroBenchmark::Compare(baseline, results, tolerance);
+
+			for (const MicroBenchmark::Difference& difference : differences)
+			{
+				std::printf("regression %s: %.1f ns -> %.1f ns (%.2fx)\n",
+							difference.name.c_str(), difference.baselineNs, difference.currentNs, difference.GetRatio());
+			}
+
+			if (!differences.empty())
+			{
+				return 1;
+			}
+		}
+
+		return 0;
+	}
+	catch (Exception& exception)
+	{
+		std::wcerr << L"HR Failed\n" << exception.ToString();
+		return 1;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,383 @@
+#include "MipGenerator.h"
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+
+// d3d
+#include <directxmath.h>
+#include <directxpackedvector.h>
+#include "DDSTextureLoader11.h"
+using namespace DirectX;
+using namespace DirectX::PackedVector;
+
+//
+#include "Utility.h"
+
+namespace
+{
+	// rows handed to a thread at a time, small enough to balance the last mips
+	constexpr std::size_t kRowsPerBand = 16;
+
+	struct Image
+	{
+		uint32_t width = 0;
+		uint32_t height = 0;
+		std::vector<XMVECTOR> texels;
+	};
+
+	// weights of the source texels contributing to every destination texel along one axis
+	struct Kernel
+	{
+		uint32_t tapCount = 0;
+		std::vector<int> first;     // per destination texel, may be out of range, clamped on use
+		std::vector<float> weights; // tapCount per destination texel, normalized
+	};
+
+	float BesselI0(const float x)
+	{
+		// power series, converges quickly for the alphas used by kaiser windows
+		float sum = 1.0f;
+		float term = 1.0f;
+
+		for (int k = 1; k < 32; ++k)
+		{
+			term *= (0.5f * x / k) * (0.5f * x / k);
+			sum += term;
+
+			if (term < sum * 1e-7f)
+			{
+				break;
+			}
+		}
+
+		return sum;
+	}
+
+	float Sinc(const float x)
+	{
+		return (std::abs(x) < 1e-5f) ? 1.0f : std::sin(XM_PI * x) / (XM_PI * x);
+	}
+
+	Kernel BuildKernel(const uint32_t srcSize, const uint32_t dstSize, const MipGenerator::Settings& settings)
+	{
+		const float scale = float(srcSize) / float(dstSize);
+		const float support = (settings.filter == MipGenerator::Filter::Box) ? 0.5f : settings.kaiserWidth;
+		const float radius = support * scale;
+
+		Kernel kernel;
+		kernel.tapCount = uint32_t(std::ceil(2.0f * radius)) + 1;
+		kernel.first.resize(dstSize);
+		kernel.weights.resize(std::size_t(dstSize) * kernel.tapCount, 0.0f);
+
+		const float i0Alpha = BesselI0(settings.kaiserAlpha);
+
+		for (uint32_t i = 0; i < dstSize; ++i)
+		{
+			const float center = (i + 0.5f) * scale;
+			const int first = int(std::floor(center - radius));
+
+			float* weights = &kernel.weights[std::size_t(i) * kernel.tapCount];
+			float sum = 0.0f;
+
+			for (uint32_t k = 0; k < kernel.tapCount; ++k)
+			{
+				const float texel = float(first + int(k));
+				float weight = 0.0f;
+
+				if (settings.filter == MipGenerator::Filter::Box)
+				{
+					// overlap of the source texel with the destination footprint, handles odd sizes
+					weight = std::max(0.0f, std::min(texel + 1.0f, center + radius) - std::max(texel, center - radius));
+				}
+				else
+				{
+					const float t = (texel + 0.5f - center) / scale;
+					const float r = t / settings.kaiserWidth;
+
+					if (std::abs(r) < 1.0f)
+					{
+						weight = Sinc(t) * BesselI0(settings.kaiserAlpha * std::sqrt(1.0f - r * r)) / i0Alpha;
+					}
+				}
+
+				weights[k] = weight;
+				sum += weight;
+			}
+
+			for (uint32_t k = 0; k < kernel.tapCount; ++k)
+			{
+				weights[k] /= sum;
+			}
+
+			kernel.first[i] = first;
+		}
+
+		return kernel;
+	}
+
+	int Clamp(const int i, const uint32_t size)
+	{
+		return std::clamp(i, 0, int(size) - 1);
+	}
+
+	// separable downsample, horizontal then vertical, both passes split in bands of rows
+	Image Downsample(const Image& src, const MipGenerator::Settings& settings)
+	{
+		Image dst;
+		dst.width = std::max(1u, src.width / 2);
+		dst.height = std::max(1u, src.height / 2);
+		dst.texels.resize(std::size_t(dst.width) * dst.height);
+
+		const Kernel kernelX = BuildKernel(src.width, dst.width, settings);
+		const Kernel kernelY = BuildKernel(src.height, dst.height, settings);
+
+		std::vector<XMVECTOR> temp(std::size_t(dst.width) * src.height);
+
+		ParallelFor((src.height + kRowsPerBand - 1) / kRowsPerBand, [&](const std::size_t band)
+		{
+			const std::size_t end = std::min<std::size_t>(src.height, (band + 1) * kRowsPerBand);
+
+			for (std::size_t y = band * kRowsPerBand; y < end; ++y)
+			{
+				const XMVECTOR* srcRow = &src.texels[y * src.width];
+				XMVECTOR* tempRow = &temp[y * dst.width];
+
+				for (uint32_t x = 0; x < dst.width; ++x)
+				{
+					const float* weights = &kernelX.weights[std::size_t(x) * kernelX.tapCount];
+					XMVECTOR sum = XMVectorZero();
+
+					for (uint32_t k = 0; k < kernelX.tapCount; ++k)
+					{
+						sum = XMVectorMultiplyAdd(XMVectorReplicate(weights[k]), srcRow[Clamp(kernelX.first[x] + int(k), src.width)], sum);
+					}
+
+					tempRow[x] = sum;
+				}
+			}
+		});
+
+		ParallelFor((dst.height + kRowsPerBand - 1) / kRowsPerBand, [&](const std::size_t band)
+		{
+			const std::size_t end = std::min<std::size_t>(dst.height, (band + 1) * kRowsPerBand);
+
+			for (std::size_t y = band * kRowsPerBand; y < end; ++y)
+			{
+				const float* weights = &kernelY.weights[y * kernelY.tapCount];
+				XMVECTOR* dstRow = &dst.texels[y * dst.width];
+
+				std::fill(dstRow, dstRow + dst.width, XMVectorZero());
+
+				// whole rows at a time, the inner loop walks memory linearly
+				for (uint32_t k = 0; k < kernelY.tapCount; ++k)
+				{
+					const XMVECTOR weight = XMVectorReplicate(weights[k]);
+					const XMVECTOR* tempRow = &temp[std::size_t(Clamp(kernelY.first[y] + int(k), src.height)) * dst.width];
+
+					for (uint32_t x = 0; x < dst.width; ++x)
+					{
+						dstRow[x] = XMVectorMultiplyAdd(weight, tempRow[x], dstRow[x]);
+					}
+				}
+			}
+		});
+
+		return dst;
+	}
+
+	float ComputeAlphaCoverage(const Image& image, const float alphaReference, const float alphaScale)
+	{
+		std::size_t count = 0;
+
+		for (const XMVECTOR& texel : image.texels)
+		{
+			count += (XMVectorGetW(texel) * alphaScale > alphaReference) ? 1 : 0;
+		}
+
+		return float(count) / float(image.texels.size());
+	}
+
+	// coverage only grows with the scale, bisect for the one matching the top level
+	float FindAlphaScale(const Image& image, const float alphaReference, const float coverage)
+	{
+		float low = 0.0f;
+		float high = 4.0f;
+
+		for (int i = 0; i < 16; ++i)
+		{
+			const float middle = 0.5f * (low + high);
+
+			if (ComputeAlphaCoverage(image, alphaReference, middle) < coverage)
+			{
+				low = middle;
+			}
+			else
+			{
+				high = middle;
+			}
+		}
+
+		return 0.5f * (low + high);
+	}
+
+	bool IsSRGB(const DXGI_FORMAT format)
+	{
+		return (format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB) || (format == DXGI_FORMAT_B8G8R8A8_UNORM_SRGB);
+	}
+
+	// channel order doesn't matter to the filters, bgra is processed as is
+	Image Decode(const D3D11_SUBRESOURCE_DATA& subresource, const uint32_t width, const uint32_t height, const bool isSRGB)
+	{
+		Image image;
+		image.width = width;
+		image.height = height;
+		image.texels.resize(std::size_t(width) * height);
+
+		ParallelFor((height + kRowsPerBand - 1) / kRowsPerBand, [&](const std::size_t band)
+		{
+			const std::size_t end = std::min<std::size_t>(height, (band + 1) * kRowsPerBand);
+
+			for (std::size_t y = band * kRowsPerBand; y < end; ++y)
+			{
+				const XMUBYTEN4* row = reinterpret_cast<const XMUBYTEN4*>(static_cast<const uint8_t*>(subresource.pSysMem) + y * subresource.SysMemPitch);
+
+				for (uint32_t x = 0; x < width; ++x)
+				{
+					const XMVECTOR texel = XMLoadUByteN4(&row[x]);
+					image.texels[y * width + x] = isSRGB ? XMColorSRGBToRGB(texel) : texel;
+				}
+			}
+		});
+
+		return image;
+	}
+
+	std::vector<uint8_t> Encode(const Image& image, const bool isSRGB, const float alphaScale)
+	{
+		std::vector<uint8_t> data(image.texels.size() * sizeof(XMUBYTEN4));
+		XMUBYTEN4* texels = reinterpret_cast<XMUBYTEN4*>(data.data());
+
+		const XMVECTOR scale = XMVectorSet(1.0f, 1.0f, 1.0f, alphaScale);
+
+		ParallelFor((image.height + kRowsPerBand - 1) / kRowsPerBand, [&](const std::size_t band)
+		{
+			const std::size_t first = band * kRowsPerBand * image.width;
+			const std::size_t end = std::min<std::size_t>(image.height, (band + 1) * kRowsPerBand) * image.width;
+
+			for (std::size_t i = first; i < end; ++i)
+			{
+				// kaiser lobes overshoot, saturate before going back to srgb
+				const XMVECTOR texel = XMVectorSaturate(XMVectorMultiply(image.texels[i], scale));
+				XMStoreUByteN4(&texels[i], isSRGB ? XMColorRGBToSRGB(texel) : texel);
+			}
+		});
+
+		return data;
+	}
+}
+
+bool MipGenerator::IsSupportedFormat(const DXGI_FORMAT format)
+{
+	return (format == DXGI_FORMAT_R8G8B8A8_UNORM) ||
+		   (format == DXGI_FORMAT_R8G8B8A8_UNORM_SRGB) ||
+		   (format == DXGI_FORMAT_B8G8R8A8_UNORM) ||
+		   (format == DXGI_FORMAT_B8G8R8A8_UNORM_SRGB);
+}
+
+std::vector<uint8_t> MipGenerator::GenerateMips(const uint8_t* ddsData, const std::size_t ddsDataSize, const Settings& settings)
+{
+	DDSTextureInfo info;
+	const uint8_t* bitData = nullptr;
+	std::size_t bitSize = 0;
+
+	ThrowIfFailed(GetDDSTextureInfoFromMemory(ddsData, ddsDataSize, &info, &bitData, &bitSize));
+
+	// only what the filters can read, anything else is the caller's mistake and fails in release too
+	const bool isSupported = (info.resourceDimension == D3D11_RESOURCE_DIMENSION_TEXTURE2D) &&
+							 (info.isCubeMap == 0) &&
+							 IsSupportedFormat(info.format);
+
+	ThrowIfFailed(isSupported ? S_OK : E_INVALIDARG);
+
+	std::vector<D3D11_SUBRESOURCE_DATA> srcData(std::size_t(info.mipCount) * info.arraySize);
+	ThrowIfFailed(GetDDSSubresourceData(info, bitData, bitSize, srcData.data()));
+
+	const bool isSRGB = IsSRGB(info.format);
+
+	DDSTextureInfo dstInfo = info;
+	dstInfo.mipCount = 1;
+
+	while ((info.width >> dstInfo.mipCount) || (info.height >> dstInfo.mipCount))
+	{
+		++dstInfo.mipCount;
+	}
+
+	std::vector<std::vector<uint8_t>> levels;
+	levels.reserve(std::size_t(dstInfo.mipCount) * info.arraySize);
+
+	for (uint32_t item = 0; item < info.arraySize; ++item)
+	{
+		const D3D11_SUBRESOURCE_DATA& top = srcData[std::size_t(item) * info.mipCount];
+
+		Image image = Decode(top, info.width, info.height, isSRGB);
+
+		const float coverage = settings.preserveAlphaCoverage ? ComputeAlphaCoverage(image, settings.alphaReference, 1.0f) : 0.0f;
+
+		// the top level is copied as is, a round trip through float could move srgb values by one
+		std::vector<uint8_t>& level = levels.emplace_back(std::size_t(info.width) * info.height * sizeof(XMUBYTEN4));
+
+		for (uint32_t y = 0; y < info.height; ++y)
+		{
+			std::memcpy(&level[std::size_t(y) * info.width * sizeof(XMUBYTEN4)],
+						static_cast<const uint8_t*>(top.pSysMem) + std::size_t(y) * top.SysMemPitch,
+						info.width * sizeof(XMUBYTEN4));
+		}
+
+		for (uint32_t mip = 1; mip < dstInfo.mipCount; ++mip)
+		{
+			// the chain keeps filtering the unscaled alpha, the scale only applies to what is stored
+			image = Downsample(image, settings);
+
+			const float alphaScale = settings.preserveAlphaCoverage ? FindAlphaScale(image, settings.alphaReference, coverage) : 1.0f;
+
+			levels.push_back(Encode(image, isSRGB, alphaScale));
+		}
+	}
+
+	std::vector<D3D11_SUBRESOURCE_DATA> dstData(levels.size());
+
+	for (std::size_t i = 0; i < levels.size(); ++i)
+	{
+		dstData[i].pSysMem = levels[i].data();
+		dstData[i].SysMemPitch = UINT(std::max(1u, info.width >> (i % dstInfo.mipCount)) * sizeof(XMUBYTEN4));
+		dstData[i].SysMemSlicePitch = UINT(levels[i].size());
+	}
+
+	std::size_t size = 0;
+	ThrowIfFailed(SaveDDSTextureToMemory(dstInfo, dstData.data(), nullptr, 0, &size));
+
+	std::vector<uint8_t> result(size);
+	ThrowIfFailed(SaveDDSTextureToMemory(dstInfo, dstData.data(), result.data(), result.size(), &size));
+
+	return result;
+}
+
+void MipGenerator::GenerateMips(const std::string& sourcePath, const std::string& destinationPath, const Settings& settings)
+{
+	std::vector<uint8_t> result;
+
+	{
+		MappedFile source(sourcePath);
+		ThrowIfFailed(source.IsOpen() ? S_OK : E_FAIL);
+
+		result = GenerateMips(source.GetData(), source.GetSize(), settings);
+	}
+
+	std::ofstream stream(destinationPath, std::ios::binary);
+	stream.write(reinterpret_cast<const char*>(result.data()), result.size());
+
+	ThrowIfFailed(stream ? S_OK : E_FAIL);
+}
\ No newline at end of file
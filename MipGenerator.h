@@ -0,0 +1,45 @@
+#pragma once
+
+// std
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// d3d
+#include <d3d11.h>
+
+// builds full mip chains on the cpu at import time for DDS files that ship with a single level, so
+// the loader never falls back to GenerateMips; levels are filtered from the previous one with a
+// separable kernel, in linear space for srgb formats, split across threads in bands of rows
+class MipGenerator
+{
+public:
+
+	enum class Filter
+	{
+		Box,
+		Kaiser,
+	};
+
+	struct Settings
+	{
+		Filter filter = Filter::Kaiser;
+		float kaiserWidth = 3.0f; // radius in destination texels
+		float kaiserAlpha = 4.0f;
+
+		// scale the alpha of every mip so the fraction of texels passing the alpha test stays the
+		// same as in the top level, otherwise alpha tested foliage thins out in the distance
+		bool preserveAlphaCoverage = false;
+		float alphaReference = 0.5f;
+	};
+
+	// 8 bit rgba and bgra, srgb or not
+	static bool IsSupportedFormat(const DXGI_FORMAT format);
+
+	// the top level of every item of a 2D DDS (array) becomes a full chain, mips already in the file are replaced;
+	// throws E_INVALIDARG for cubemaps, volumes and formats IsSupportedFormat doesn't take
+	static std::vector<uint8_t> GenerateMips(const uint8_t* ddsData, const std::size_t ddsDataSize, const Settings& settings);
+
+	// throws when the source can't be read or the destination written
+	static void GenerateMips(const std::string& sourcePath, const std::string& destinationPath, const Settings& settings);
+};
\ No newline at end of file
@@ -0,0 +1,109 @@
+#include "UnitTest.h"
+
+// std
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <vector>
+
+// d3d
+#include "DDSTextureLoader11.h"
+using namespace DirectX;
+
+#include "MipGenerator.h"
+#include "Utility.h"
+
+// what GenerateMips accepts and what it turns away
+
+namespace
+{
+	// a single mip size x size 2D DDS of arraySize items, every byte the same
+	std::vector<uint8_t> CreateDDS(const uint32_t size, const DXGI_FORMAT format, const uint32_t arraySize = 1)
+	{
+		DDSTextureInfo info;
+		info.width = size;
+		info.height = size;
+		info.depth = 1;
+		info.mipCount = 1;
+		info.arraySize = arraySize;
+		info.format = format;
+		info.resourceDimension = D3D11_RESOURCE_DIMENSION_TEXTURE2D;
+		info.isCubeMap = 0;
+
+		std::size_t numBytes = 0;
+		std::size_t rowBytes = 0;
+		ThrowIfFailed(GetDDSSurfaceInfo(size, size, format, &numBytes, &rowBytes, nullptr));
+
+		const std::vector<uint8_t> bytes(numBytes, 0x80);
+		std::vector<D3D11_SUBRESOURCE_DATA> subresources(arraySize);
+
+		for (D3D11_SUBRESOURCE_DATA& subresource : subresources)
+		{
+			subresource.pSysMem = bytes.data();
+			subresource.SysMemPitch = UINT(rowBytes);
+			subresource.SysMemSlicePitch = UINT(numBytes);
+		}
+
+		std::size_t ddsSize = 0;
+		ThrowIfFailed(SaveDDSTextureToMemory(info, subresources.data(), nullptr, 0, &ddsSize));
+
+		std::vector<uint8_t> dds(ddsSize);
+		ThrowIfFailed(SaveDDSTextureToMemory(info, subresources.data(), dds.data(), dds.size(), &ddsSize));
+
+		return dds;
+	}
+
+	bool IsRejected(const std::function<void()>& f)
+	{
+		try
+		{
+			f();
+		}
+		catch (Exception&)
+		{
+			return true;
+		}
+
+		return false;
+	}
+}
+
+UNIT_TEST(MipGeneratorFullChain)
+{
+	const std::vector<uint8_t> dds = CreateDDS(16, DXGI_FORMAT_R8G8B8A8_UNORM);
+	const std::vector<uint8_t> result = MipGenerator::GenerateMips(dds.data(), dds.size(), {});
+
+	DDSTextureInfo info;
+	const uint8_t* bitData = nullptr;
+	std::size_t bitSize = 0;
+
+	CHECK(SUCCEEDED(GetDDSTextureInfoFromMemory(result.data(), result.size(), &info, &bitData, &bitSize)));
+	CHECK(info.mipCount == 5);
+
+	// a flat colour filters to itself
+	CHECK((bitSize > 0) && (bitData[bitSize - 1] == 0x80));
+}
+
+UNIT_TEST(MipGeneratorRejectsUnsupported)
+{
+	const std::vector<uint8_t> bc1 = CreateDDS(16, DXGI_FORMAT_BC1_UNORM);
+	CHECK(IsRejected([&]() { MipGenerator::GenerateMips(bc1.data(), bc1.size(), {}); }));
+
+	// six faces saved as an array, then flagged a cubemap in the DX10 header
+	std::vector<uint8_t> cube = CreateDDS(16, DXGI_FORMAT_R8G8B8A8_UNORM, 6);
+
+	const std::size_t extOffset = sizeof(uint32_t) + 124; // magic and DDS_HEADER
+	const uint32_t miscFlag = D3D11_RESOURCE_MISC_TEXTURECUBE;
+	const uint32_t arraySize = 1;
+	std::memcpy(&cube[extOffset + 8], &miscFlag, sizeof(miscFlag));
+	std::memcpy(&cube[extOffset + 12], &arraySize, sizeof(arraySize));
+
+	DDSTextureInfo info;
+	const uint8_t* bitData = nullptr;
+	std::size_t bitSize = 0;
+
+	CHECK(SUCCEEDED(GetDDSTextureInfoFromMemory(cube.data(), cube.size(), &info, &bitData, &bitSize)) && info.isCubeMap);
+	CHECK(IsRejected([&]() { MipGenerator::GenerateMips(cube.data(), cube.size(), {}); }));
+
+	CHECK(IsRejected([]() { MipGenerator::GenerateMips("missing.dds", "missing_mips.dds", {}); }));
+}
\ No newline at end of file
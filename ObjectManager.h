@@ -16,6 +16,7 @@ using namespace DirectX;
 #include <unordered_map>
 
 //
+#include "MaterialManager.h"
 #include "Utility.h"
 
 struct Object
@@ -30,7 +31,7 @@ struct Object
     }
 
     std::size_t mesh;
-    std::size_t material;
+    std::size_t material; // handle from MaterialManager::AddMaterial
     XMFLOAT4X4  world;
     XMFLOAT4X4  uvTransform;
 
@@ -78,14 +79,15 @@ public:
         NameResource(mBuffer.Get(), "ObjectCB");
     }
 
-    void UpdateBuffer(const std::size_t i)
+    // the material handle is looked up at every update, its place in MaterialsSB can change
+    void UpdateBuffer(const std::size_t i, const MaterialManager& materialManager)
     {
         const Object& object = GetObject(i);
 
         ObjectCB buffer;
         buffer.world    = object.world;
         buffer.uvTransform = object.uvTransform;
-        buffer.material = UINT(object.material);
+        buffer.material = UINT(materialManager.GetBufferIndex(object.material));
 
         mContext->UpdateSubresource(mBuffer.Get(), 0, nullptr, &buffer, 0, 0);
     }
@@ -108,6 +110,14 @@ public:
         return mObjects[i];
     }
 
+    // for moving objects, the constant buffer is filled from the object when it's drawn
+    Object& EditObject(const std::size_t i)
+    {
+        assert(i < mObjects.size());
+
+        return mObjects[i];
+    }
+
     const std::vector<Object>& GetObjects() const
     {
         return mObjects;
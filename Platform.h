@@ -0,0 +1,60 @@
+#pragma once
+
+// windows
+#include <windows.h>
+
+// std
+#include <string>
+
+// imgui, it needs the win32 window
+#ifdef _WIN32
+#define IMGUI _DEBUG || 1
+#else
+#define IMGUI 0
+#endif // _WIN32
+
+// window, input and event loop of the app; AppBase only reaches the os through it, so the same
+// Init/Update/Draw loop also runs headless on a build machine
+class Platform
+{
+public:
+
+	// what the window reports back to the app
+	class Listener
+	{
+	public:
+
+		virtual ~Listener() = default;
+
+		// deactivated, minimized or being resized
+		virtual void OnPause(const bool isPaused) = 0;
+
+		// new client area, OnResize follows once the size settles
+		virtual void OnWindowSize(const UINT width, const UINT height) = 0;
+		virtual void OnResize() = 0;
+
+		// state has the MK_ button flags
+		virtual void OnMouseDown(WPARAM state, int x, int y) = 0;
+		virtual void OnMouseUp(WPARAM state, int x, int y) = 0;
+		virtual void OnMouseMove(WPARAM state, int x, int y) = 0;
+	};
+
+	virtual ~Platform() = default;
+
+	virtual bool Init(Listener& listener, const std::wstring& name, const UINT width, const UINT height) = 0;
+
+	// handles the pending events, false once the app has to quit
+	virtual bool PumpEvents() = 0;
+
+	virtual int GetExitCode() const = 0;
+
+	// virtual key codes, 'W' or VK_LSHIFT
+	virtual bool IsKeyDown(const int key) const = 0;
+
+	virtual void SetMouseCapture(const bool isCaptured) = 0;
+
+	// for the swap chain and imgui, there's none when headless
+	virtual HWND GetWindow() const = 0;
+
+	virtual bool IsHeadless() const = 0;
+};
\ No newline at end of file
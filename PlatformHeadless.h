@@ -0,0 +1,37 @@
+#pragma once
+
+// std
+#include <cstdint>
+
+//
+#include "Platform.h"
+
+// no window and no input, the app runs a fixed number of frames and quits; used on build machines
+// together with RenderDeviceNull
+class PlatformHeadless : public Platform
+{
+public:
+
+	explicit PlatformHeadless(const uint64_t frameCount) : mFrameCount(frameCount) {}
+
+	bool Init(Listener& listener, const std::wstring& name, const UINT width, const UINT height) override { return true; }
+
+	bool PumpEvents() override { return mFrame++ < mFrameCount; }
+
+	int GetExitCode() const override { return 0; }
+
+	bool IsKeyDown(const int key) const override { return false; }
+
+	void SetMouseCapture(const bool isCaptured) override {}
+
+	HWND GetWindow() const override { return nullptr; }
+
+	bool IsHeadless() const override { return true; }
+
+	uint64_t GetFrameCount() const { return mFrameCount; }
+
+private:
+
+	uint64_t mFrameCount = 0;
+	uint64_t mFrame = 0;
+};
\ No newline at end of file
@@ -0,0 +1,264 @@
+#include "PlatformWin32.h"
+
+// windows
+#include <windowsx.h>
+
+// std
+#include <cassert>
+
+#if IMGUI
+// imgui
+#include "../imgui/imgui.h"
+#include "../imgui/backends/imgui_impl_win32.h"
+
+extern IMGUI_IMPL_API LRESULT ImGui_ImplWin32_WndProcHandler(HWND hWnd, UINT msg, WPARAM wParam, LPARAM lParam);
+#endif // IMGUI
+
+LRESULT CALLBACK MainWndProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
+{
+	// forward hwnd on because we can get messages (e.g., WM_CREATE)
+	// before CreateWindow returns, and thus before mWindow is valid
+	return PlatformWin32::GetPlatform()->MsgProc(hwnd, msg, wParam, lParam);
+}
+
+PlatformWin32* PlatformWin32::mPlatform = nullptr;
+
+PlatformWin32::PlatformWin32(HINSTANCE instance)
+	: mInstance(instance)
+{
+	assert(mPlatform == nullptr);
+	mPlatform = this;
+}
+
+PlatformWin32::~PlatformWin32()
+{
+	mPlatform = nullptr;
+}
+
+bool PlatformWin32::Init(Listener& listener, const std::wstring& name, const UINT width, const UINT height)
+{
+	mListener = &listener;
+
+	WNDCLASS wc;
+	wc.style = CS_HREDRAW | CS_VREDRAW;
+	wc.lpfnWndProc = MainWndProc;
+	wc.cbClsExtra = 0;
+	wc.cbWndExtra = 0;
+	wc.hInstance = mInstance;
+	wc.hIcon = LoadIcon(0, IDI_APPLICATION);
+	wc.hCursor = LoadCursor(0, IDC_ARROW);
+	wc.hbrBackground = HBRUSH(GetStockObject(NULL_BRUSH));
+	wc.lpszMenuName = 0;
+	wc.lpszClassName = L"MainWnd";
+
+	if (!RegisterClass(&wc))
+	{
+		MessageBox(0, L"RegisterClass Failed.", 0, 0);
+		return false;
+	}
+
+	RECT rect = {0, 0, LONG(width), LONG(height)};
+	AdjustWindowRect(&rect, WS_OVERLAPPEDWINDOW, false);
+	int windowWidth = rect.right - rect.left;
+	int windowHeight = rect.bottom - rect.top;
+
+	mWindow = CreateWindow(L"MainWnd",
+						   name.c_str(),
+						   WS_OVERLAPPEDWINDOW,
+						   CW_USEDEFAULT,
+						   CW_USEDEFAULT,
+						   windowWidth,
+						   windowHeight,
+						   0,
+						   0,
+						   mInstance,
+						   0);
+	if (!mWindow)
+	{
+		MessageBox(0, L"CreateWindow Failed.", 0, 0);
+		return false;
+	}
+
+	ShowWindow(mWindow, SW_SHOW);
+	UpdateWindow(mWindow);
+
+	return true;
+}
+
+bool PlatformWin32::PumpEvents()
+{
+	MSG msg = {0};
+
+	while (PeekMessage(&msg, 0, 0, 0, PM_REMOVE))
+	{
+		if (msg.message == WM_QUIT)
+		{
+			mExitCode = int(msg.wParam);
+			return false;
+		}
+
+		TranslateMessage(&msg);
+		DispatchMessage(&msg);
+	}
+
+	return true;
+}
+
+void PlatformWin32::SetMouseCapture(const bool isCaptured)
+{
+	if (isCaptured)
+	{
+		SetCapture(mWindow);
+	}
+	else
+	{
+		ReleaseCapture();
+	}
+}
+
+LRESULT PlatformWin32::MsgProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam)
+{
+#if IMGUI
+	if (ImGui_ImplWin32_WndProcHandler(mWindow, msg, wParam, lParam))
+	{
+		return true;
+	}
+#endif // IMGUI
+
+	// CreateWindow sends a few before Init is done with it
+	if (mListener == nullptr)
+	{
+		return DefWindowProc(hwnd, msg, wParam, lParam);
+	}
+
+	switch (msg)
+	{
+	// WM_ACTIVATE is sent when the window is activated or deactivated
+	// we pause the game when the window is deactivated and unpause it when it becomes active
+	case WM_ACTIVATE:
+	{
+		mListener->OnPause(LOWORD(wParam) == WA_INACTIVE);
+		return 0;
+	}
+	// WM_SIZE is sent when the user resizes the window
+	case WM_SIZE:
+	{
+		// new client area dimensions
+		mListener->OnWindowSize(LOWORD(lParam), HIWORD(lParam));
+
+		switch (wParam)
+		{
+
+		case SIZE_MINIMIZED:
+		{
+			mListener->OnPause(true);
+			mIsWindowMinimized = true;
+			mIsWindowMaximized = false;
+		}
+		case SIZE_MAXIMIZED:
+		{
+			mListener->OnPause(false);
+			mIsWindowMinimized = false;
+			mIsWindowMaximized = true;
+			mListener->OnResize();
+		}
+		case SIZE_RESTORED:
+		{
+			// restoring from minimized state?
+			if (mIsWindowMinimized)
+			{
+				mListener->OnPause(false);
+				mIsWindowMinimized = false;
+				mListener->OnResize();
+			}
+			// restoring from maximized state?
+			else if (mIsWindowMaximized)
+			{
+				mListener->OnPause(false);
+				mIsWindowMaximized = false;
+				mListener->OnResize();
+			}
+			else if (mIsWindowResizing)
+			{
+				// If user is dragging the resize bars, we do not resize
+				// the buffers here because as the user continuously
+				// drags the resize bars, a stream of WM_SIZE messages are
+				// sent to the window, and it would be pointless (and slow)
+				// to resize for each WM_SIZE message received from dragging
+				// the resize bars. So instead, we reset after the user is
+				// done resizing the window and releases the resize bars, which
+				// sends a WM_EXITSIZEMOVE message.
+			}
+			else // API call such as SetWindowPos or mSwapChain->SetFullscreenState.
+			{
+				mListener->OnResize();
+			}
+		}
+		}
+		return 0;
+	}
+	// WM_EXITSIZEMOVE is sent when the user grabs the resize bars
+	case WM_ENTERSIZEMOVE:
+	{
+		mListener->OnPause(true);
+		mIsWindowResizing = true;
+		return 0;
+	}
+	// WM_EXITSIZEMOVE is sent when the user releases the resize bars
+	case WM_EXITSIZEMOVE:
+	{
+		mListener->OnPause(false);
+		mIsWindowResizing = false;
+		mListener->OnResize(); // we reset everything based on the new window dimensions
+		return 0;
+	}
+	// WM_DESTROY is sent when the window is being destroyed
+	case WM_DESTROY:
+	{
+		PostQuitMessage(0);
+		return 0;
+	}
+	// WM_MENUCHAR is sent when a menu is active and the user presses a key that does not correspond to any mnemonic or accelerator key
+	case WM_MENUCHAR:
+	{
+		// don't beep when we alt-enter
+		return MAKELRESULT(0, MNC_CLOSE);
+	}
+	// catch this message so to prevent the window from becoming too small
+	case WM_GETMINMAXINFO:
+	{
+		((MINMAXINFO *)lParam)->ptMinTrackSize.x = 200;
+		((MINMAXINFO *)lParam)->ptMinTrackSize.y = 200;
+		return 0;
+	}
+	case WM_LBUTTONDOWN:
+	case WM_MBUTTONDOWN:
+	case WM_RBUTTONDOWN:
+	{
+		mListener->OnMouseDown(wParam, GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam));
+		return 0;
+	}
+	case WM_LBUTTONUP:
+	case WM_MBUTTONUP:
+	case WM_RBUTTONUP:
+	{
+		mListener->OnMouseUp(wParam, GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam));
+		return 0;
+	}
+	case WM_MOUSEMOVE:
+	{
+		mListener->OnMouseMove(wParam, GET_X_LPARAM(lParam), GET_Y_LPARAM(lParam));
+		return 0;
+	}
+	case WM_KEYUP:
+	{
+		if (wParam == VK_ESCAPE)
+		{
+			PostQuitMessage(0);
+		}
+		return 0;
+	}
+	}
+
+	return DefWindowProc(hwnd, msg, wParam, lParam);
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#pragma once
+
+//
+#include "Platform.h"
+
+// win32 window and message loop, input through GetAsyncKeyState
+class PlatformWin32 : public Platform
+{
+public:
+
+	explicit PlatformWin32(HINSTANCE instance);
+	~PlatformWin32();
+
+	PlatformWin32(const PlatformWin32&) = delete;
+	PlatformWin32& operator=(const PlatformWin32&) = delete;
+
+	bool Init(Listener& listener, const std::wstring& name, const UINT width, const UINT height) override;
+
+	bool PumpEvents() override;
+
+	int GetExitCode() const override { return mExitCode; }
+
+	bool IsKeyDown(const int key) const override { return (GetAsyncKeyState(key) & 0x8000) != 0; }
+
+	void SetMouseCapture(const bool isCaptured) override;
+
+	HWND GetWindow() const override { return mWindow; }
+
+	bool IsHeadless() const override { return false; }
+
+	LRESULT MsgProc(HWND hwnd, UINT msg, WPARAM wParam, LPARAM lParam);
+
+	static PlatformWin32* GetPlatform() { return mPlatform; }
+
+private:
+
+	static PlatformWin32* mPlatform;
+
+	Listener* mListener = nullptr;
+
+	HINSTANCE mInstance = nullptr;
+	HWND mWindow = nullptr;
+
+	bool mIsWindowMinimized = false;
+	bool mIsWindowMaximized = false;
+	bool mIsWindowResizing = false;
+
+	int mExitCode = 0;
+};
\ No newline at end of file
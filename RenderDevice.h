@@ -0,0 +1,52 @@
+#pragma once
+
+// windows
+#include <wrl.h>
+using Microsoft::WRL::ComPtr;
+
+// d3d
+#include <d3d11.h>
+#include <d3d11_1.h>
+
+// std
+#include <string>
+
+//
+#include "Platform.h"
+#include "Utility.h"
+
+// the d3d11 device and immediate context of the app and what presents its frames; AppBase and the
+// managers keep calling d3d11 directly, only where the device comes from changes
+class RenderDevice
+{
+public:
+
+	virtual ~RenderDevice() = default;
+
+	// device, context and swap chain for the window of the platform
+	virtual void Init(Platform& platform, const UINT width, const UINT height) = 0;
+
+	// views of the previous back buffer must be released before
+	virtual ComPtr<ID3D11Resource> ResizeBackBuffer(const UINT width, const UINT height) = 0;
+
+	virtual void Present() = 0;
+
+	virtual ComPtr<ID3DBlob> CompileShader(const std::wstring& fileName,
+										   const D3D_SHADER_MACRO* defines,
+										   const std::string& entryPoint,
+										   const ShaderTarget target) = 0;
+
+	const ComPtr<ID3D11Device>& GetDevice() const { return mDevice; }
+	const ComPtr<ID3D11DeviceContext>& GetContext() const { return mContext; }
+	const ComPtr<ID3DUserDefinedAnnotation>& GetAnnotation() const { return mAnnotation; }
+
+	const std::wstring& GetName() const { return mName; }
+
+protected:
+
+	ComPtr<ID3D11Device> mDevice;
+	ComPtr<ID3D11DeviceContext> mContext;
+	ComPtr<ID3DUserDefinedAnnotation> mAnnotation;
+
+	std::wstring mName;
+};
\ No newline at end of file
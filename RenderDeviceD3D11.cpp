@@ -0,0 +1,103 @@
+#include "RenderDeviceD3D11.h"
+
+// std
+#include <cassert>
+
+void RenderDeviceD3D11::Init(Platform& platform, const UINT width, const UINT height)
+{
+	ComPtr<IDXGIFactory1> pFactory; // IDXGIFactory4
+	ThrowIfFailed(CreateDXGIFactory1(__uuidof(IDXGIFactory1),
+									 reinterpret_cast<void**>(pFactory.GetAddressOf())));
+
+#if 0 // TODO: switch GPU at runtime
+	IDXGIAdapter1* pAdapter;
+	std::vector<ComPtr<IDXGIAdapter1>> pAdapters;
+
+	for (UINT i = 0; pFactory->EnumAdapters1(i, &pAdapter) != DXGI_ERROR_NOT_FOUND; ++i)
+	{
+		pAdapters.push_back(pAdapter);
+	}
+
+	for (const auto& pAdapter : pAdapters)
+	{
+		DXGI_ADAPTER_DESC desc;
+		ThrowIfFailed(pAdapter->GetDesc(&desc));
+	}
+#endif
+
+	// device & context
+	{
+		ComPtr<IDXGIAdapter1> pAdapter;
+		ThrowIfFailed(pFactory->EnumAdapters1(mAdapterIndex, &pAdapter));
+
+		// get GPU name
+		{
+			DXGI_ADAPTER_DESC desc;
+			ThrowIfFailed(pAdapter->GetDesc(&desc));
+
+			mName = desc.Description;
+			mIsNvidia = desc.VendorId == 4318;
+		}
+
+		UINT flags = 0;
+#ifdef _DEBUG
+		flags |= D3D11_CREATE_DEVICE_DEBUG;
+#endif // _DEBUG
+
+		D3D_FEATURE_LEVEL featureLevel;
+
+		ThrowIfFailed(D3D11CreateDevice(pAdapter.Get(),
+										D3D_DRIVER_TYPE_UNKNOWN, // D3D_DRIVER_TYPE_HARDWARE,
+										nullptr,
+										flags,
+										nullptr,
+										0,
+										D3D11_SDK_VERSION,
+										&mDevice,
+										&featureLevel,
+										&mContext));
+
+		assert(featureLevel >= D3D_FEATURE_LEVEL_11_0);
+
+		ThrowIfFailed(mContext->QueryInterface(__uuidof(mAnnotation.Get()),
+											   reinterpret_cast<void**>(mAnnotation.GetAddressOf())));
+	}
+
+	// swap chain
+	{
+		DXGI_SWAP_CHAIN_DESC desc;
+		desc.BufferDesc.Width = width;
+		desc.BufferDesc.Height = height;
+		desc.BufferDesc.RefreshRate.Numerator = 60;
+		desc.BufferDesc.RefreshRate.Denominator = 1;
+		desc.BufferDesc.Format = mSwapChainFormat;
+		desc.BufferDesc.ScanlineOrdering = DXGI_MODE_SCANLINE_ORDER_UNSPECIFIED;
+		desc.BufferDesc.Scaling = DXGI_MODE_SCALING_UNSPECIFIED;
+		desc.SampleDesc.Count = 1;
+		desc.SampleDesc.Quality = 0;
+		desc.BufferUsage = DXGI_USAGE_RENDER_TARGET_OUTPUT;
+		desc.BufferCount = min(mSwapChainBufferCount, DXGI_MAX_SWAP_CHAIN_BUFFERS);
+		desc.OutputWindow = platform.GetWindow();
+		desc.Windowed = true;
+		desc.SwapEffect = DXGI_SWAP_EFFECT_FLIP_DISCARD;
+		desc.Flags = mSwapChainFlags;
+
+		ThrowIfFailed(pFactory->CreateSwapChain(mDevice.Get(), &desc, &mSwapChain));
+	}
+}
+
+ComPtr<ID3D11Resource> RenderDeviceD3D11::ResizeBackBuffer(const UINT width, const UINT height)
+{
+	ThrowIfFailed(mSwapChain->ResizeBuffers(min(mSwapChainBufferCount, DXGI_MAX_SWAP_CHAIN_BUFFERS),
+											width,
+											height,
+											mSwapChainFormat,
+											mSwapChainFlags));
+
+	ComPtr<ID3D11Resource> pBackBuffer;
+	ThrowIfFailed(mSwapChain->GetBuffer(0,
+										__uuidof(ID3D11Resource),
+										reinterpret_cast<void**>(pBackBuffer.GetAddressOf())));
+
+	return pBackBuffer;
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+
+// d3d
+#include <dxgi.h>
+
+//
+#include "RenderDevice.h"
+
+// hardware device on the second adapter and a flip model swap chain on the window
+class RenderDeviceD3D11 : public RenderDevice
+{
+public:
+
+	void Init(Platform& platform, const UINT width, const UINT height) override;
+
+	ComPtr<ID3D11Resource> ResizeBackBuffer(const UINT width, const UINT height) override;
+
+	void Present() override
+	{
+		ThrowIfFailed(mSwapChain->Present(0, 0));
+	}
+
+	ComPtr<ID3DBlob> CompileShader(const std::wstring& fileName,
+								   const D3D_SHADER_MACRO* defines,
+								   const std::string& entryPoint,
+								   const ShaderTarget target) override
+	{
+		return ::CompileShader(fileName, defines, entryPoint, target);
+	}
+
+	bool IsNvidia() const { return mIsNvidia; }
+
+private:
+
+	UINT mAdapterIndex = 1;
+	bool mIsNvidia = false;
+
+	UINT mSwapChainBufferCount = 2;
+	DXGI_FORMAT mSwapChainFormat = DXGI_FORMAT_R8G8B8A8_UNORM;
+	UINT mSwapChainFlags = 0;
+
+	ComPtr<IDXGISwapChain> mSwapChain;
+};
\ No newline at end of file
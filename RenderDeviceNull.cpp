@@ -0,0 +1,1793 @@
+#include "RenderDeviceNull.h"
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstring>
+#include <map>
+#include <mutex>
+#include <type_traits>
+#include <unordered_map>
+#include <unordered_set>
+#include <string>
+#include <utility>
+#include <vector>
+
+//
+#include "DDSTextureLoader11.h"
+#include "Timer.h"
+
+namespace
+{
+	// what SetPrivateData stored, mostly the names from NameResource
+	class PrivateData
+	{
+	public:
+
+		HRESULT Get(REFGUID guid, UINT* pDataSize, void* pData) const
+		{
+			if (pDataSize == nullptr)
+			{
+				return E_INVALIDARG;
+			}
+
+			std::lock_guard<std::mutex> lock(mMutex);
+
+			const auto it = Find(guid);
+
+			if (it == mEntries.end())
+			{
+				*pDataSize = 0;
+				return DXGI_ERROR_NOT_FOUND;
+			}
+
+			const UINT size = UINT(it->second.size());
+
+			if (pData == nullptr)
+			{
+				*pDataSize = size;
+				return S_OK;
+			}
+
+			if (*pDataSize < size)
+			{
+				*pDataSize = size;
+				return DXGI_ERROR_MORE_DATA;
+			}
+
+			std::memcpy(pData, it->second.data(), size);
+			*pDataSize = size;
+
+			return S_OK;
+		}
+
+		// what NameResource set, empty without a name
+		std::string GetName() const
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+
+			const auto it = Find(WKPDID_D3DDebugObjectName);
+
+			return (it != mEntries.end()) ? std::string(it->second.begin(), it->second.end()) : std::string();
+		}
+
+		// no data removes the entry
+		HRESULT Set(REFGUID guid, const UINT dataSize, const void* pData)
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+
+			const auto it = Find(guid);
+
+			if ((pData == nullptr) || (dataSize == 0))
+			{
+				if (it != mEntries.end())
+				{
+					mEntries.erase(it);
+				}
+
+				return S_OK;
+			}
+
+			const uint8_t* bytes = static_cast<const uint8_t*>(pData);
+
+			if (it != mEntries.end())
+			{
+				it->second.assign(bytes, bytes + dataSize);
+			}
+			else
+			{
+				mEntries.emplace_back(guid, std::vector<uint8_t>(bytes, bytes + dataSize));
+			}
+
+			return S_OK;
+		}
+
+	private:
+
+		using Entry = std::pair<GUID, std::vector<uint8_t>>;
+
+		std::vector<Entry>::const_iterator Find(REFGUID guid) const
+		{
+			return std::find_if(mEntries.begin(), mEntries.end(), [&](const Entry& entry) { return entry.first == guid; });
+		}
+
+		std::vector<Entry>::iterator Find(REFGUID guid)
+		{
+			return std::find_if(mEntries.begin(), mEntries.end(), [&](const Entry& entry) { return entry.first == guid; });
+		}
+
+		mutable std::mutex mMutex;
+		std::vector<Entry> mEntries;
+	};
+
+	// IUnknown and ID3D11DeviceChild of every object the null device creates, they keep the device alive
+	template<typename Interface>
+	class NullDeviceChild : public Interface
+	{
+	public:
+
+		explicit NullDeviceChild(ID3D11Device* pDevice) : mDevice(pDevice) {}
+		virtual ~NullDeviceChild() = default;
+
+		NullDeviceChild(const NullDeviceChild&) = delete;
+		NullDeviceChild& operator=(const NullDeviceChild&) = delete;
+
+		HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppObject) override
+		{
+			if (ppObject == nullptr)
+			{
+				return E_POINTER;
+			}
+
+			if (!IsInterface(riid))
+			{
+				*ppObject = nullptr;
+				return E_NOINTERFACE;
+			}
+
+			*ppObject = static_cast<Interface*>(this);
+			AddRef();
+
+			return S_OK;
+		}
+
+		ULONG STDMETHODCALLTYPE AddRef() override
+		{
+			return ++mRefCount;
+		}
+
+		ULONG STDMETHODCALLTYPE Release() override
+		{
+			const ULONG refCount = --mRefCount;
+
+			if (refCount == 0)
+			{
+				delete this;
+			}
+
+			return refCount;
+		}
+
+		void STDMETHODCALLTYPE GetDevice(ID3D11Device** ppDevice) override
+		{
+			mDevice->AddRef();
+			*ppDevice = mDevice.Get();
+		}
+
+		HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID guid, UINT* pDataSize, void* pData) override
+		{
+			return mPrivateData.Get(guid, pDataSize, pData);
+		}
+
+		HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID guid, UINT dataSize, const void* pData) override
+		{
+			return mPrivateData.Set(guid, dataSize, pData);
+		}
+
+		HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID guid, const IUnknown* pData) override
+		{
+			return S_OK;
+		}
+
+		std::string GetName() const { return mPrivateData.GetName(); }
+
+	private:
+
+		static bool IsInterface(REFIID riid)
+		{
+			return (riid == __uuidof(IUnknown)) ||
+				   (riid == __uuidof(ID3D11DeviceChild)) ||
+				   (riid == __uuidof(Interface)) ||
+				   (std::is_base_of_v<ID3D11Resource, Interface> && (riid == __uuidof(ID3D11Resource))) ||
+				   (std::is_base_of_v<ID3D11View, Interface> && (riid == __uuidof(ID3D11View))) ||
+				   (std::is_base_of_v<ID3D11Asynchronous, Interface> && (riid == __uuidof(ID3D11Asynchronous))) ||
+				   (std::is_base_of_v<ID3D11Query, Interface> && (riid == __uuidof(ID3D11Query)));
+		}
+
+		std::atomic<ULONG> mRefCount = 1;
+
+		ComPtr<ID3D11Device> mDevice;
+		PrivateData mPrivateData;
+	};
+
+	// every mip of the chain when MipLevels is 0
+	UINT GetMipCount(const UINT mipLevels, const UINT width, const UINT height = 1, const UINT depth = 1)
+	{
+		if (mipLevels != 0)
+		{
+			return mipLevels;
+		}
+
+		UINT size = std::max({width, height, depth, 1u});
+		UINT count = 1;
+
+		while (size > 1)
+		{
+			size /= 2;
+			++count;
+		}
+
+		return count;
+	}
+
+	// bytes of a surface of the format, tightly packed rows; formats without a size count 16 bytes per
+	// texel, the largest there is
+	std::size_t GetSurfaceLayout(const DXGI_FORMAT format, const UINT width, const UINT height, UINT& rowPitch)
+	{
+		std::size_t numBytes = 0;
+		std::size_t rowBytes = 0;
+
+		if (FAILED(DirectX::GetDDSSurfaceInfo(std::max(width, 1u), std::max(height, 1u), format, &numBytes, &rowBytes, nullptr)))
+		{
+			rowBytes = std::size_t(std::max(width, 1u)) * 16;
+			numBytes = rowBytes * std::max(height, 1u);
+		}
+
+		rowPitch = UINT(rowBytes);
+
+		return numBytes;
+	}
+
+	class ResourceRegistry;
+
+	// every resource counts its uploads of the frame and hands out memory to Map, which is kept per
+	// subresource until the resource goes away
+	class NullResourceBase
+	{
+	public:
+
+		explicit NullResourceBase(ResourceRegistry& registry) : mRegistry(registry) {}
+		virtual ~NullResourceBase() = default;
+
+		void* Map(const UINT subresource, UINT& rowPitch, UINT& depthPitch)
+		{
+			const std::size_t size = GetSubresourceLayout(subresource, rowPitch, depthPitch);
+
+			if (mMappedMemory.size() <= subresource)
+			{
+				mMappedMemory.resize(subresource + 1);
+			}
+
+			std::vector<uint8_t>& memory = mMappedMemory[subresource];
+			memory.resize(size);
+
+			return memory.data();
+		}
+
+		// what UpdateSubresource sends for the box, or for the whole subresource without one
+		virtual std::size_t GetUploadSize(const UINT subresource, const D3D11_BOX* pBox) const = 0;
+
+		// all subresources
+		virtual std::size_t GetMemorySize() const = 0;
+
+		// the NameResource name, else the kind of resource
+		virtual std::string GetCategory() const = 0;
+
+		void AddUpload(const std::size_t bytes) { mUploadBytes += bytes; }
+		std::size_t TakeUploadBytes() { return std::exchange(mUploadBytes, 0); }
+
+	protected:
+
+		virtual std::size_t GetSubresourceLayout(const UINT subresource, UINT& rowPitch, UINT& depthPitch) const = 0;
+
+		ResourceRegistry& mRegistry;
+
+	private:
+
+		std::vector<std::vector<uint8_t>> mMappedMemory;
+		std::size_t mUploadBytes = 0; // since the last report
+	};
+
+	// the live resources of a device, for the memory and upload totals of the reports; resources can
+	// be created and released on any thread
+	class ResourceRegistry
+	{
+	public:
+
+		void Add(NullResourceBase* pResource, const std::size_t initialDataBytes)
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+
+			mResources.insert(pResource);
+
+			pResource->AddUpload(initialDataBytes);
+
+			++mCreateCount;
+			mInitialDataBytes += initialDataBytes;
+		}
+
+		// the uploads of the frame still show up in the report
+		void Remove(NullResourceBase* pResource)
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+
+			mResources.erase(pResource);
+
+			if (const std::size_t bytes = pResource->TakeUploadBytes(); bytes != 0)
+			{
+				mReleasedUploadBytes[pResource->GetCategory()] += bytes;
+			}
+		}
+
+		void Collect(SubmissionStatistics::Report& report)
+		{
+			std::lock_guard<std::mutex> lock(mMutex);
+
+			report.createCount = std::exchange(mCreateCount, 0);
+			report.initialDataBytes = std::exchange(mInitialDataBytes, 0);
+
+			report.uploadBytes.clear();
+			report.memoryBytes.clear();
+			report.resourceCounts.clear();
+
+			for (NullResourceBase* pResource : mResources)
+			{
+				const std::string category = pResource->GetCategory();
+
+				report.memoryBytes[category] += pResource->GetMemorySize();
+				++report.resourceCounts[category];
+
+				if (const std::size_t bytes = pResource->TakeUploadBytes(); bytes != 0)
+				{
+					report.uploadBytes[category] += bytes;
+				}
+			}
+
+			for (const auto& [category, bytes] : mReleasedUploadBytes)
+			{
+				report.uploadBytes[category] += bytes;
+			}
+
+			mReleasedUploadBytes.clear();
+		}
+
+	private:
+
+		std::mutex mMutex;
+
+		std::unordered_set<NullResourceBase*> mResources;
+		std::unordered_map<std::string, std::size_t> mReleasedUploadBytes;
+
+		uint64_t mCreateCount = 0;
+		uint64_t mInitialDataBytes = 0;
+	};
+
+	template<typename Interface, typename Desc, D3D11_RESOURCE_DIMENSION dimension>
+	class NullResource : public NullDeviceChild<Interface>, public NullResourceBase
+	{
+	public:
+
+		NullResource(ID3D11Device* pDevice, ResourceRegistry& registry, const Desc& desc) :
+			NullDeviceChild<Interface>(pDevice),
+			NullResourceBase(registry),
+			mDesc(desc)
+		{
+			if constexpr (dimension == D3D11_RESOURCE_DIMENSION_BUFFER)
+			{
+				mMemorySize = mDesc.ByteWidth;
+			}
+			else
+			{
+				for (UINT mip = 0; mip < mDesc.MipLevels; ++mip)
+				{
+					UINT rowPitch = 0;
+					UINT depthPitch = 0;
+
+					mMemorySize += GetSubresourceLayout(mip, rowPitch, depthPitch);
+				}
+
+				if constexpr (dimension != D3D11_RESOURCE_DIMENSION_TEXTURE3D)
+				{
+					mMemorySize *= mDesc.ArraySize;
+				}
+			}
+		}
+
+		// the registry has it from the device's Create call on
+		~NullResource()
+		{
+			mRegistry.Remove(this);
+		}
+
+		void STDMETHODCALLTYPE GetType(D3D11_RESOURCE_DIMENSION* pDimension) override
+		{
+			*pDimension = dimension;
+		}
+
+		void STDMETHODCALLTYPE SetEvictionPriority(UINT evictionPriority) override
+		{
+			mEvictionPriority = evictionPriority;
+		}
+
+		UINT STDMETHODCALLTYPE GetEvictionPriority() override
+		{
+			return mEvictionPriority;
+		}
+
+		void STDMETHODCALLTYPE GetDesc(Desc* pDesc) override
+		{
+			*pDesc = mDesc;
+		}
+
+		std::size_t GetUploadSize(const UINT subresource, const D3D11_BOX* pBox) const override
+		{
+			if constexpr (dimension == D3D11_RESOURCE_DIMENSION_BUFFER)
+			{
+				return pBox ? std::size_t(pBox->right - pBox->left) : std::size_t(mDesc.ByteWidth);
+			}
+			else
+			{
+				if (pBox == nullptr)
+				{
+					UINT rowPitch = 0;
+					UINT depthPitch = 0;
+
+					return GetSubresourceLayout(subresource, rowPitch, depthPitch);
+				}
+
+				UINT rowPitch = 0;
+
+				return GetSurfaceLayout(mDesc.Format, pBox->right - pBox->left, pBox->bottom - pBox->top, rowPitch) * (pBox->back - pBox->front);
+			}
+		}
+
+		std::size_t GetMemorySize() const override
+		{
+			return mMemorySize;
+		}
+
+		std::string GetCategory() const override
+		{
+			std::string name = this->GetName();
+
+			if (!name.empty())
+			{
+				return name;
+			}
+
+			switch (dimension)
+			{
+				case D3D11_RESOURCE_DIMENSION_BUFFER:
+					return "unnamed buffer";
+				case D3D11_RESOURCE_DIMENSION_TEXTURE1D:
+					return "unnamed texture1d";
+				case D3D11_RESOURCE_DIMENSION_TEXTURE2D:
+					return "unnamed texture2d";
+				default:
+					return "unnamed texture3d";
+			}
+		}
+
+		const Desc& GetDesc() const { return mDesc; }
+
+	protected:
+
+		std::size_t GetSubresourceLayout(const UINT subresource, UINT& rowPitch, UINT& depthPitch) const override
+		{
+			if constexpr (dimension == D3D11_RESOURCE_DIMENSION_BUFFER)
+			{
+				rowPitch = mDesc.ByteWidth;
+				depthPitch = mDesc.ByteWidth;
+
+				return mDesc.ByteWidth;
+			}
+			else
+			{
+				const UINT mip = subresource % mDesc.MipLevels;
+
+				UINT height = 1;
+				UINT depth = 1;
+
+				if constexpr (dimension != D3D11_RESOURCE_DIMENSION_TEXTURE1D)
+				{
+					height = std::max(1u, mDesc.Height >> mip);
+				}
+
+				if constexpr (dimension == D3D11_RESOURCE_DIMENSION_TEXTURE3D)
+				{
+					depth = std::max(1u, mDesc.Depth >> mip);
+				}
+
+				const std::size_t size = GetSurfaceLayout(mDesc.Format, std::max(1u, mDesc.Width >> mip), height, rowPitch);
+				depthPitch = UINT(size);
+
+				return size * depth;
+			}
+		}
+
+	private:
+
+		Desc mDesc;
+		UINT mEvictionPriority = 0;
+
+		std::size_t mMemorySize = 0;
+	};
+
+	using NullBuffer = NullResource<ID3D11Buffer, D3D11_BUFFER_DESC, D3D11_RESOURCE_DIMENSION_BUFFER>;
+	using NullTexture1D = NullResource<ID3D11Texture1D, D3D11_TEXTURE1D_DESC, D3D11_RESOURCE_DIMENSION_TEXTURE1D>;
+	using NullTexture2D = NullResource<ID3D11Texture2D, D3D11_TEXTURE2D_DESC, D3D11_RESOURCE_DIMENSION_TEXTURE2D>;
+	using NullTexture3D = NullResource<ID3D11Texture3D, D3D11_TEXTURE3D_DESC, D3D11_RESOURCE_DIMENSION_TEXTURE3D>;
+
+	// every resource the context sees was created by the null device
+	NullResourceBase* GetNullResource(ID3D11Resource* pResource)
+	{
+		D3D11_RESOURCE_DIMENSION dimension = D3D11_RESOURCE_DIMENSION_UNKNOWN;
+		pResource->GetType(&dimension);
+
+		switch (dimension)
+		{
+			case D3D11_RESOURCE_DIMENSION_BUFFER:
+				return static_cast<NullBuffer*>(static_cast<ID3D11Buffer*>(pResource));
+			case D3D11_RESOURCE_DIMENSION_TEXTURE1D:
+				return static_cast<NullTexture1D*>(static_cast<ID3D11Texture1D*>(pResource));
+			case D3D11_RESOURCE_DIMENSION_TEXTURE2D:
+				return static_cast<NullTexture2D*>(static_cast<ID3D11Texture2D*>(pResource));
+			case D3D11_RESOURCE_DIMENSION_TEXTURE3D:
+				return static_cast<NullTexture3D*>(static_cast<ID3D11Texture3D*>(pResource));
+			default:
+				return nullptr;
+		}
+	}
+
+	template<typename Interface, typename Desc>
+	class NullView : public NullDeviceChild<Interface>
+	{
+	public:
+
+		NullView(ID3D11Device* pDevice, ID3D11Resource* pResource, const Desc* pDesc) :
+			NullDeviceChild<Interface>(pDevice),
+			mResource(pResource),
+			mDesc(pDesc ? *pDesc : Desc())
+		{
+		}
+
+		void STDMETHODCALLTYPE GetResource(ID3D11Resource** ppResource) override
+		{
+			mResource->AddRef();
+			*ppResource = mResource.Get();
+		}
+
+		void STDMETHODCALLTYPE GetDesc(Desc* pDesc) override
+		{
+			*pDesc = mDesc;
+		}
+
+	private:
+
+		ComPtr<ID3D11Resource> mResource;
+		Desc mDesc;
+	};
+
+	// blend, depth stencil, rasterizer and sampler states
+	template<typename Interface, typename Desc>
+	class NullState : public NullDeviceChild<Interface>
+	{
+	public:
+
+		NullState(ID3D11Device* pDevice, const Desc& desc) : NullDeviceChild<Interface>(pDevice), mDesc(desc) {}
+
+		void STDMETHODCALLTYPE GetDesc(Desc* pDesc) override
+		{
+			*pDesc = mDesc;
+		}
+
+	private:
+
+		Desc mDesc;
+	};
+
+	// queries and predicates; results are ready as soon as they are asked for, timestamps are the cpu
+	// time of End in nanoseconds so the gpu profiler measures submission
+	class NullQuery : public NullDeviceChild<ID3D11Predicate>
+	{
+	public:
+
+		NullQuery(ID3D11Device* pDevice, const D3D11_QUERY_DESC& desc) : NullDeviceChild<ID3D11Predicate>(pDevice), mDesc(desc) {}
+
+		UINT STDMETHODCALLTYPE GetDataSize() override
+		{
+			switch (mDesc.Query)
+			{
+				case D3D11_QUERY_EVENT:
+				case D3D11_QUERY_OCCLUSION_PREDICATE:
+				case D3D11_QUERY_SO_OVERFLOW_PREDICATE:
+					return sizeof(BOOL);
+				case D3D11_QUERY_TIMESTAMP_DISJOINT:
+					return sizeof(D3D11_QUERY_DATA_TIMESTAMP_DISJOINT);
+				case D3D11_QUERY_PIPELINE_STATISTICS:
+					return sizeof(D3D11_QUERY_DATA_PIPELINE_STATISTICS);
+				case D3D11_QUERY_SO_STATISTICS:
+					return sizeof(D3D11_QUERY_DATA_SO_STATISTICS);
+				default:
+					return sizeof(UINT64);
+			}
+		}
+
+		void STDMETHODCALLTYPE GetDesc(D3D11_QUERY_DESC* pDesc) override
+		{
+			*pDesc = mDesc;
+		}
+
+		void End()
+		{
+			mTimestamp = UINT64(Timer::GetSystemTicks());
+		}
+
+		HRESULT GetData(void* pData, const UINT dataSize) const
+		{
+			if ((pData == nullptr) || (dataSize == 0))
+			{
+				return S_OK;
+			}
+
+			std::memset(pData, 0, dataSize);
+
+			switch (mDesc.Query)
+			{
+				case D3D11_QUERY_EVENT:
+				{
+					const BOOL isDone = TRUE;
+					std::memcpy(pData, &isDone, std::min<std::size_t>(dataSize, sizeof(isDone)));
+					break;
+				}
+				case D3D11_QUERY_TIMESTAMP:
+				{
+					std::memcpy(pData, &mTimestamp, std::min<std::size_t>(dataSize, sizeof(mTimestamp)));
+					break;
+				}
+				case D3D11_QUERY_TIMESTAMP_DISJOINT:
+				{
+					D3D11_QUERY_DATA_TIMESTAMP_DISJOINT data;
+					data.Frequency = UINT64(Timer::kTicksPerSecond);
+					data.Disjoint = FALSE;
+
+					std::memcpy(pData, &data, std::min<std::size_t>(dataSize, sizeof(data)));
+					break;
+				}
+				default:
+					break;
+			}
+
+			return S_OK;
+		}
+
+	private:
+
+		D3D11_QUERY_DESC mDesc;
+		UINT64 mTimestamp = 0;
+	};
+
+	// bytecode of the shaders the null device doesn't compile
+	class NullBlob : public ID3DBlob
+	{
+	public:
+
+		HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppObject) override
+		{
+			if (ppObject == nullptr)
+			{
+				return E_POINTER;
+			}
+
+			if ((riid != __uuidof(IUnknown)) && (riid != __uuidof(ID3D10Blob)))
+			{
+				*ppObject = nullptr;
+				return E_NOINTERFACE;
+			}
+
+			*ppObject = static_cast<ID3DBlob*>(this);
+			AddRef();
+
+			return S_OK;
+		}
+
+		ULONG STDMETHODCALLTYPE AddRef() override
+		{
+			return ++mRefCount;
+		}
+
+		ULONG STDMETHODCALLTYPE Release() override
+		{
+			const ULONG refCount = --mRefCount;
+
+			if (refCount == 0)
+			{
+				delete this;
+			}
+
+			return refCount;
+		}
+
+		LPVOID STDMETHODCALLTYPE GetBufferPointer() override { return nullptr; }
+		SIZE_T STDMETHODCALLTYPE GetBufferSize() override { return 0; }
+
+	private:
+
+		std::atomic<ULONG> mRefCount = 1;
+	};
+
+	template<typename T>
+	void ClearOutputs(T** ppOutputs, const UINT count)
+	{
+		if (ppOutputs != nullptr)
+		{
+			std::fill_n(ppOutputs, count, nullptr);
+		}
+	}
+
+	// immediate context, part of the device and sharing its reference count the way the d3d11 one does;
+	// binds and draws are counted and dropped, the getters report nothing bound
+	class NullContext : public ID3D11DeviceContext, public ID3DUserDefinedAnnotation
+	{
+	public:
+
+		explicit NullContext(ID3D11Device& device) : mDevice(device), mPass(&mPasses[mPassPath]) {}
+
+		NullContext(const NullContext&) = delete;
+		NullContext& operator=(const NullContext&) = delete;
+
+		// IUnknown
+
+		HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppObject) override
+		{
+			if (ppObject == nullptr)
+			{
+				return E_POINTER;
+			}
+
+			if ((riid == __uuidof(IUnknown)) || (riid == __uuidof(ID3D11DeviceChild)) || (riid == __uuidof(ID3D11DeviceContext)))
+			{
+				*ppObject = static_cast<ID3D11DeviceContext*>(this);
+			}
+			else if (riid == __uuidof(ID3DUserDefinedAnnotation))
+			{
+				*ppObject = static_cast<ID3DUserDefinedAnnotation*>(this);
+			}
+			else
+			{
+				*ppObject = nullptr;
+				return E_NOINTERFACE;
+			}
+
+			AddRef();
+
+			return S_OK;
+		}
+
+		ULONG STDMETHODCALLTYPE AddRef() override { return mDevice.AddRef(); }
+		ULONG STDMETHODCALLTYPE Release() override { return mDevice.Release(); }
+
+		// ID3D11DeviceChild
+
+		void STDMETHODCALLTYPE GetDevice(ID3D11Device** ppDevice) override
+		{
+			mDevice.AddRef();
+			*ppDevice = &mDevice;
+		}
+
+		HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID guid, UINT* pDataSize, void* pData) override { return mPrivateData.Get(guid, pDataSize, pData); }
+		HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID guid, UINT dataSize, const void* pData) override { return mPrivateData.Set(guid, dataSize, pData); }
+		HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID guid, const IUnknown* pData) override { return S_OK; }
+
+		// ID3DUserDefinedAnnotation
+
+		// the events nest into the pass paths the counters go by
+		INT STDMETHODCALLTYPE BeginEvent(LPCWSTR name) override
+		{
+			mPassPathLengths.push_back(mPassPath.size());
+
+			if (!mPassPath.empty())
+			{
+				mPassPath += '/';
+			}
+
+			for (const wchar_t* pChar = name; (pChar != nullptr) && (*pChar != L'\0'); ++pChar)
+			{
+				mPassPath += ((*pChar > 0) && (*pChar < 0x80)) ? char(*pChar) : '?';
+			}
+
+			mPass = &mPasses[mPassPath];
+
+			return INT(mPassPathLengths.size());
+		}
+
+		INT STDMETHODCALLTYPE EndEvent() override
+		{
+			if (mPassPathLengths.empty())
+			{
+				return -1;
+			}
+
+			mPassPath.resize(mPassPathLengths.back());
+			mPassPathLengths.pop_back();
+
+			mPass = &mPasses[mPassPath];
+
+			return INT(mPassPathLengths.size());
+		}
+		void STDMETHODCALLTYPE SetMarker(LPCWSTR name) override {}
+		BOOL STDMETHODCALLTYPE GetStatus() override { return FALSE; }
+
+		// input assembler
+
+		void STDMETHODCALLTYPE IASetInputLayout(ID3D11InputLayout* pInputLayout) override { Bind(kFixedFunction, kInputLayout, 0, { Value(pInputLayout) }); }
+
+		void STDMETHODCALLTYPE IASetVertexBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* ppVertexBuffers, const UINT* pStrides, const UINT* pOffsets) override
+		{
+			Bind(kFixedFunction, kVertexBuffers, startSlot, { Array(ppVertexBuffers, numBuffers), Array(pStrides, numBuffers), Array(pOffsets, numBuffers) });
+		}
+
+		void STDMETHODCALLTYPE IASetIndexBuffer(ID3D11Buffer* pIndexBuffer, DXGI_FORMAT format, UINT offset) override
+		{
+			Bind(kFixedFunction, kIndexBuffer, 0, { Value(pIndexBuffer), Value(format), Value(offset) });
+		}
+
+		void STDMETHODCALLTYPE IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY topology) override
+		{
+			Bind(kFixedFunction, kTopology, 0, { Value(topology) });
+			mTopology = topology;
+		}
+
+		void STDMETHODCALLTYPE IAGetInputLayout(ID3D11InputLayout** ppInputLayout) override { ClearOutputs(ppInputLayout, 1); }
+
+		void STDMETHODCALLTYPE IAGetVertexBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer** ppVertexBuffers, UINT* pStrides, UINT* pOffsets) override
+		{
+			ClearOutputs(ppVertexBuffers, numBuffers);
+
+			if (pStrides != nullptr)
+			{
+				std::fill_n(pStrides, numBuffers, 0);
+			}
+
+			if (pOffsets != nullptr)
+			{
+				std::fill_n(pOffsets, numBuffers, 0);
+			}
+		}
+
+		void STDMETHODCALLTYPE IAGetIndexBuffer(ID3D11Buffer** pIndexBuffer, DXGI_FORMAT* format, UINT* offset) override
+		{
+			ClearOutputs(pIndexBuffer, 1);
+
+			if (format != nullptr)
+			{
+				*format = DXGI_FORMAT_UNKNOWN;
+			}
+
+			if (offset != nullptr)
+			{
+				*offset = 0;
+			}
+		}
+
+		void STDMETHODCALLTYPE IAGetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY* pTopology) override { *pTopology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED; }
+
+		// shader stages
+
+		void STDMETHODCALLTYPE VSSetShader(ID3D11VertexShader* pShader, ID3D11ClassInstance* const* ppClassInstances, UINT numClassInstances) override { Bind(kVertexShader, kShader, 0, { Value(pShader), Array(ppClassInstances, numClassInstances) }); }
+		void STDMETHODCALLTYPE VSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* ppConstantBuffers) override { Bind(kVertexShader, kConstantBuffers, startSlot, { Array(ppConstantBuffers, numBuffers) }); }
+		void STDMETHODCALLTYPE VSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* ppShaderResourceViews) override { Bind(kVertexShader, kShaderResources, startSlot, { Array(ppShaderResourceViews, numViews) }); }
+		void STDMETHODCALLTYPE VSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* ppSamplers) override { Bind(kVertexShader, kSamplers, startSlot, { Array(ppSamplers, numSamplers) }); }
+
+		void STDMETHODCALLTYPE HSSetShader(ID3D11HullShader* pShader, ID3D11ClassInstance* const* ppClassInstances, UINT numClassInstances) override { Bind(kHullShader, kShader, 0, { Value(pShader), Array(ppClassInstances, numClassInstances) }); }
+		void STDMETHODCALLTYPE HSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* ppConstantBuffers) override { Bind(kHullShader, kConstantBuffers, startSlot, { Array(ppConstantBuffers, numBuffers) }); }
+		void STDMETHODCALLTYPE HSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* ppShaderResourceViews) override { Bind(kHullShader, kShaderResources, startSlot, { Array(ppShaderResourceViews, numViews) }); }
+		void STDMETHODCALLTYPE HSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* ppSamplers) override { Bind(kHullShader, kSamplers, startSlot, { Array(ppSamplers, numSamplers) }); }
+
+		void STDMETHODCALLTYPE DSSetShader(ID3D11DomainShader* pShader, ID3D11ClassInstance* const* ppClassInstances, UINT numClassInstances) override { Bind(kDomainShader, kShader, 0, { Value(pShader), Array(ppClassInstances, numClassInstances) }); }
+		void STDMETHODCALLTYPE DSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* ppConstantBuffers) override { Bind(kDomainShader, kConstantBuffers, startSlot, { Array(ppConstantBuffers, numBuffers) }); }
+		void STDMETHODCALLTYPE DSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* ppShaderResourceViews) override { Bind(kDomainShader, kShaderResources, startSlot, { Array(ppShaderResourceViews, numViews) }); }
+		void STDMETHODCALLTYPE DSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* ppSamplers) override { Bind(kDomainShader, kSamplers, startSlot, { Array(ppSamplers, numSamplers) }); }
+
+		void STDMETHODCALLTYPE GSSetShader(ID3D11GeometryShader* pShader, ID3D11ClassInstance* const* ppClassInstances, UINT numClassInstances) override { Bind(kGeometryShader, kShader, 0, { Value(pShader), Array(ppClassInstances, numClassInstances) }); }
+		void STDMETHODCALLTYPE GSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* ppConstantBuffers) override { Bind(kGeometryShader, kConstantBuffers, startSlot, { Array(ppConstantBuffers, numBuffers) }); }
+		void STDMETHODCALLTYPE GSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* ppShaderResourceViews) override { Bind(kGeometryShader, kShaderResources, startSlot, { Array(ppShaderResourceViews, numViews) }); }
+		void STDMETHODCALLTYPE GSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* ppSamplers) override { Bind(kGeometryShader, kSamplers, startSlot, { Array(ppSamplers, numSamplers) }); }
+
+		void STDMETHODCALLTYPE PSSetShader(ID3D11PixelShader* pShader, ID3D11ClassInstance* const* ppClassInstances, UINT numClassInstances) override { Bind(kPixelShader, kShader, 0, { Value(pShader), Array(ppClassInstances, numClassInstances) }); }
+		void STDMETHODCALLTYPE PSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* ppConstantBuffers) override { Bind(kPixelShader, kConstantBuffers, startSlot, { Array(ppConstantBuffers, numBuffers) }); }
+		void STDMETHODCALLTYPE PSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* ppShaderResourceViews) override { Bind(kPixelShader, kShaderResources, startSlot, { Array(ppShaderResourceViews, numViews) }); }
+		void STDMETHODCALLTYPE PSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* ppSamplers) override { Bind(kPixelShader, kSamplers, startSlot, { Array(ppSamplers, numSamplers) }); }
+
+		void STDMETHODCALLTYPE CSSetShader(ID3D11ComputeShader* pShader, ID3D11ClassInstance* const* ppClassInstances, UINT numClassInstances) override { Bind(kComputeShader, kShader, 0, { Value(pShader), Array(ppClassInstances, numClassInstances) }); }
+		void STDMETHODCALLTYPE CSSetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer* const* ppConstantBuffers) override { Bind(kComputeShader, kConstantBuffers, startSlot, { Array(ppConstantBuffers, numBuffers) }); }
+		void STDMETHODCALLTYPE CSSetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView* const* ppShaderResourceViews) override { Bind(kComputeShader, kShaderResources, startSlot, { Array(ppShaderResourceViews, numViews) }); }
+		void STDMETHODCALLTYPE CSSetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState* const* ppSamplers) override { Bind(kComputeShader, kSamplers, startSlot, { Array(ppSamplers, numSamplers) }); }
+		void STDMETHODCALLTYPE CSSetUnorderedAccessViews(UINT startSlot, UINT numUAVs, ID3D11UnorderedAccessView* const* ppUnorderedAccessViews, const UINT* pUAVInitialCounts) override
+		{
+			Bind(kComputeShader, kUnorderedAccessViews, startSlot, { Array(ppUnorderedAccessViews, numUAVs), Array(pUAVInitialCounts, numUAVs) });
+		}
+
+		void STDMETHODCALLTYPE VSGetShader(ID3D11VertexShader** ppShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances) override { GetShader(ppShader, pNumClassInstances); }
+		void STDMETHODCALLTYPE VSGetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer** ppConstantBuffers) override { ClearOutputs(ppConstantBuffers, numBuffers); }
+		void STDMETHODCALLTYPE VSGetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView** ppShaderResourceViews) override { ClearOutputs(ppShaderResourceViews, numViews); }
+		void STDMETHODCALLTYPE VSGetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState** ppSamplers) override { ClearOutputs(ppSamplers, numSamplers); }
+
+		void STDMETHODCALLTYPE HSGetShader(ID3D11HullShader** ppShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances) override { GetShader(ppShader, pNumClassInstances); }
+		void STDMETHODCALLTYPE HSGetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer** ppConstantBuffers) override { ClearOutputs(ppConstantBuffers, numBuffers); }
+		void STDMETHODCALLTYPE HSGetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView** ppShaderResourceViews) override { ClearOutputs(ppShaderResourceViews, numViews); }
+		void STDMETHODCALLTYPE HSGetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState** ppSamplers) override { ClearOutputs(ppSamplers, numSamplers); }
+
+		void STDMETHODCALLTYPE DSGetShader(ID3D11DomainShader** ppShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances) override { GetShader(ppShader, pNumClassInstances); }
+		void STDMETHODCALLTYPE DSGetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer** ppConstantBuffers) override { ClearOutputs(ppConstantBuffers, numBuffers); }
+		void STDMETHODCALLTYPE DSGetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView** ppShaderResourceViews) override { ClearOutputs(ppShaderResourceViews, numViews); }
+		void STDMETHODCALLTYPE DSGetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState** ppSamplers) override { ClearOutputs(ppSamplers, numSamplers); }
+
+		void STDMETHODCALLTYPE GSGetShader(ID3D11GeometryShader** ppShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances) override { GetShader(ppShader, pNumClassInstances); }
+		void STDMETHODCALLTYPE GSGetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer** ppConstantBuffers) override { ClearOutputs(ppConstantBuffers, numBuffers); }
+		void STDMETHODCALLTYPE GSGetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView** ppShaderResourceViews) override { ClearOutputs(ppShaderResourceViews, numViews); }
+		void STDMETHODCALLTYPE GSGetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState** ppSamplers) override { ClearOutputs(ppSamplers, numSamplers); }
+
+		void STDMETHODCALLTYPE PSGetShader(ID3D11PixelShader** ppShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances) override { GetShader(ppShader, pNumClassInstances); }
+		void STDMETHODCALLTYPE PSGetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer** ppConstantBuffers) override { ClearOutputs(ppConstantBuffers, numBuffers); }
+		void STDMETHODCALLTYPE PSGetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView** ppShaderResourceViews) override { ClearOutputs(ppShaderResourceViews, numViews); }
+		void STDMETHODCALLTYPE PSGetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState** ppSamplers) override { ClearOutputs(ppSamplers, numSamplers); }
+
+		void STDMETHODCALLTYPE CSGetShader(ID3D11ComputeShader** ppShader, ID3D11ClassInstance** ppClassInstances, UINT* pNumClassInstances) override { GetShader(ppShader, pNumClassInstances); }
+		void STDMETHODCALLTYPE CSGetConstantBuffers(UINT startSlot, UINT numBuffers, ID3D11Buffer** ppConstantBuffers) override { ClearOutputs(ppConstantBuffers, numBuffers); }
+		void STDMETHODCALLTYPE CSGetShaderResources(UINT startSlot, UINT numViews, ID3D11ShaderResourceView** ppShaderResourceViews) override { ClearOutputs(ppShaderResourceViews, numViews); }
+		void STDMETHODCALLTYPE CSGetSamplers(UINT startSlot, UINT numSamplers, ID3D11SamplerState** ppSamplers) override { ClearOutputs(ppSamplers, numSamplers); }
+		void STDMETHODCALLTYPE CSGetUnorderedAccessViews(UINT startSlot, UINT numUAVs, ID3D11UnorderedAccessView** ppUnorderedAccessViews) override { ClearOutputs(ppUnorderedAccessViews, numUAVs); }
+
+		// stream output, rasterizer and output merger
+
+		void STDMETHODCALLTYPE SOSetTargets(UINT numBuffers, ID3D11Buffer* const* ppSOTargets, const UINT* pOffsets) override
+		{
+			Bind(kFixedFunction, kStreamOutput, 0, { Array(ppSOTargets, numBuffers), Array(pOffsets, numBuffers) });
+		}
+
+		void STDMETHODCALLTYPE SOGetTargets(UINT numBuffers, ID3D11Buffer** ppSOTargets) override { ClearOutputs(ppSOTargets, numBuffers); }
+
+		void STDMETHODCALLTYPE RSSetState(ID3D11RasterizerState* pRasterizerState) override { Bind(kFixedFunction, kRasterizerState, 0, { Value(pRasterizerState) }); }
+		void STDMETHODCALLTYPE RSSetViewports(UINT numViewports, const D3D11_VIEWPORT* pViewports) override { Bind(kFixedFunction, kViewports, 0, { Array(pViewports, numViewports) }); }
+		void STDMETHODCALLTYPE RSSetScissorRects(UINT numRects, const D3D11_RECT* pRects) override { Bind(kFixedFunction, kScissorRects, 0, { Array(pRects, numRects) }); }
+
+		void STDMETHODCALLTYPE RSGetState(ID3D11RasterizerState** ppRasterizerState) override { ClearOutputs(ppRasterizerState, 1); }
+		void STDMETHODCALLTYPE RSGetViewports(UINT* pNumViewports, D3D11_VIEWPORT* pViewports) override { *pNumViewports = 0; }
+		void STDMETHODCALLTYPE RSGetScissorRects(UINT* pNumRects, D3D11_RECT* pRects) override { *pNumRects = 0; }
+
+		void STDMETHODCALLTYPE OMSetRenderTargets(UINT numViews, ID3D11RenderTargetView* const* ppRenderTargetViews, ID3D11DepthStencilView* pDepthStencilView) override
+		{
+			Bind(kFixedFunction, kRenderTargets, 0, { Array(ppRenderTargetViews, numViews), Value(pDepthStencilView) });
+		}
+
+		void STDMETHODCALLTYPE OMSetRenderTargetsAndUnorderedAccessViews(UINT numRTVs,
+																		 ID3D11RenderTargetView* const* ppRenderTargetViews,
+																		 ID3D11DepthStencilView* pDepthStencilView,
+																		 UINT uavStartSlot,
+																		 UINT numUAVs,
+																		 ID3D11UnorderedAccessView* const* ppUnorderedAccessViews,
+																		 const UINT* pUAVInitialCounts) override
+		{
+			if (numRTVs != D3D11_KEEP_RENDER_TARGETS_AND_DEPTH_STENCIL)
+			{
+				Bind(kFixedFunction, kRenderTargets, 0, { Array(ppRenderTargetViews, numRTVs), Value(pDepthStencilView) });
+			}
+
+			if (numUAVs != D3D11_KEEP_UNORDERED_ACCESS_VIEWS)
+			{
+				Bind(kPixelShader, kUnorderedAccessViews, uavStartSlot, { Array(ppUnorderedAccessViews, numUAVs), Array(pUAVInitialCounts, numUAVs) });
+			}
+		}
+
+		void STDMETHODCALLTYPE OMSetBlendState(ID3D11BlendState* pBlendState, const FLOAT blendFactor[4], UINT sampleMask) override
+		{
+			Bind(kFixedFunction, kBlendState, 0, { Value(pBlendState), Array(blendFactor, blendFactor ? 4 : 0), Value(sampleMask) });
+		}
+
+		void STDMETHODCALLTYPE OMSetDepthStencilState(ID3D11DepthStencilState* pDepthStencilState, UINT stencilRef) override
+		{
+			Bind(kFixedFunction, kDepthStencilState, 0, { Value(pDepthStencilState), Value(stencilRef) });
+		}
+
+		void STDMETHODCALLTYPE OMGetRenderTargets(UINT numViews, ID3D11RenderTargetView** ppRenderTargetViews, ID3D11DepthStencilView** ppDepthStencilView) override
+		{
+			ClearOutputs(ppRenderTargetViews, numViews);
+			ClearOutputs(ppDepthStencilView, 1);
+		}
+
+		void STDMETHODCALLTYPE OMGetRenderTargetsAndUnorderedAccessViews(UINT numRTVs,
+																		 ID3D11RenderTargetView** ppRenderTargetViews,
+																		 ID3D11DepthStencilView** ppDepthStencilView,
+																		 UINT uavStartSlot,
+																		 UINT numUAVs,
+																		 ID3D11UnorderedAccessView** ppUnorderedAccessViews) override
+		{
+			ClearOutputs(ppRenderTargetViews, numRTVs);
+			ClearOutputs(ppDepthStencilView, 1);
+			ClearOutputs(ppUnorderedAccessViews, numUAVs);
+		}
+
+		void STDMETHODCALLTYPE OMGetBlendState(ID3D11BlendState** ppBlendState, FLOAT blendFactor[4], UINT* pSampleMask) override
+		{
+			ClearOutputs(ppBlendState, 1);
+
+			if (blendFactor != nullptr)
+			{
+				std::fill_n(blendFactor, 4, 1.0f);
+			}
+
+			if (pSampleMask != nullptr)
+			{
+				*pSampleMask = 0xffffffff;
+			}
+		}
+
+		void STDMETHODCALLTYPE OMGetDepthStencilState(ID3D11DepthStencilState** ppDepthStencilState, UINT* pStencilRef) override
+		{
+			ClearOutputs(ppDepthStencilState, 1);
+
+			if (pStencilRef != nullptr)
+			{
+				*pStencilRef = 0;
+			}
+		}
+
+		// draws and dispatches
+
+		void STDMETHODCALLTYPE Draw(UINT vertexCount, UINT startVertexLocation) override { CountDraw(vertexCount, 1); }
+		void STDMETHODCALLTYPE DrawIndexed(UINT indexCount, UINT startIndexLocation, INT baseVertexLocation) override { CountDraw(indexCount, 1); }
+		void STDMETHODCALLTYPE DrawInstanced(UINT vertexCountPerInstance, UINT instanceCount, UINT startVertexLocation, UINT startInstanceLocation) override { CountDraw(vertexCountPerInstance, instanceCount); }
+
+		void STDMETHODCALLTYPE DrawIndexedInstanced(UINT indexCountPerInstance, UINT instanceCount, UINT startIndexLocation, INT baseVertexLocation, UINT startInstanceLocation) override
+		{
+			CountDraw(indexCountPerInstance, instanceCount);
+		}
+
+		// the arguments are on the gpu, only the draws count
+		void STDMETHODCALLTYPE DrawAuto() override { ++mPass->drawCount; }
+		void STDMETHODCALLTYPE DrawIndexedInstancedIndirect(ID3D11Buffer* pBufferForArgs, UINT alignedByteOffsetForArgs) override { ++mPass->drawCount; }
+		void STDMETHODCALLTYPE DrawInstancedIndirect(ID3D11Buffer* pBufferForArgs, UINT alignedByteOffsetForArgs) override { ++mPass->drawCount; }
+
+		void STDMETHODCALLTYPE Dispatch(UINT threadGroupCountX, UINT threadGroupCountY, UINT threadGroupCountZ) override { ++mPass->dispatchCount; }
+		void STDMETHODCALLTYPE DispatchIndirect(ID3D11Buffer* pBufferForArgs, UINT alignedByteOffsetForArgs) override { ++mPass->dispatchCount; }
+
+		// resources
+
+		HRESULT STDMETHODCALLTYPE Map(ID3D11Resource* pResource, UINT subresource, D3D11_MAP mapType, UINT mapFlags, D3D11_MAPPED_SUBRESOURCE* pMappedResource) override
+		{
+			NullResourceBase* pNullResource = pResource ? GetNullResource(pResource) : nullptr;
+
+			if (pNullResource == nullptr)
+			{
+				return E_INVALIDARG;
+			}
+
+			D3D11_MAPPED_SUBRESOURCE mapped;
+			mapped.pData = pNullResource->Map(subresource, mapped.RowPitch, mapped.DepthPitch);
+
+			if (mapType != D3D11_MAP_READ)
+			{
+				CountUpload(pNullResource, pNullResource->GetUploadSize(subresource, nullptr));
+			}
+
+			if (pMappedResource != nullptr)
+			{
+				*pMappedResource = mapped;
+			}
+
+			return S_OK;
+		}
+
+		void STDMETHODCALLTYPE Unmap(ID3D11Resource* pResource, UINT subresource) override {}
+
+		void STDMETHODCALLTYPE UpdateSubresource(ID3D11Resource* pDstResource, UINT dstSubresource, const D3D11_BOX* pDstBox, const void* pSrcData, UINT srcRowPitch, UINT srcDepthPitch) override
+		{
+			if (NullResourceBase* pNullResource = pDstResource ? GetNullResource(pDstResource) : nullptr)
+			{
+				CountUpload(pNullResource, pNullResource->GetUploadSize(dstSubresource, pDstBox));
+			}
+		}
+
+		void STDMETHODCALLTYPE CopySubresourceRegion(ID3D11Resource* pDstResource,
+													 UINT dstSubresource,
+													 UINT dstX,
+													 UINT dstY,
+													 UINT dstZ,
+													 ID3D11Resource* pSrcResource,
+													 UINT srcSubresource,
+													 const D3D11_BOX* pSrcBox) override
+		{
+			if (NullResourceBase* pNullResource = pSrcResource ? GetNullResource(pSrcResource) : nullptr)
+			{
+				mPass->copyBytes += pNullResource->GetUploadSize(srcSubresource, pSrcBox);
+			}
+		}
+
+		void STDMETHODCALLTYPE CopyResource(ID3D11Resource* pDstResource, ID3D11Resource* pSrcResource) override
+		{
+			if (NullResourceBase* pNullResource = pSrcResource ? GetNullResource(pSrcResource) : nullptr)
+			{
+				mPass->copyBytes += pNullResource->GetMemorySize();
+			}
+		}
+
+		void STDMETHODCALLTYPE CopyStructureCount(ID3D11Buffer* pDstBuffer, UINT dstAlignedByteOffset, ID3D11UnorderedAccessView* pSrcView) override { mPass->copyBytes += sizeof(UINT); }
+
+		void STDMETHODCALLTYPE ResolveSubresource(ID3D11Resource* pDstResource, UINT dstSubresource, ID3D11Resource* pSrcResource, UINT srcSubresource, DXGI_FORMAT format) override
+		{
+			if (NullResourceBase* pNullResource = pDstResource ? GetNullResource(pDstResource) : nullptr)
+			{
+				mPass->copyBytes += pNullResource->GetUploadSize(dstSubresource, nullptr);
+			}
+		}
+		void STDMETHODCALLTYPE GenerateMips(ID3D11ShaderResourceView* pShaderResourceView) override {}
+
+		void STDMETHODCALLTYPE SetResourceMinLOD(ID3D11Resource* pResource, FLOAT minLOD) override {}
+		FLOAT STDMETHODCALLTYPE GetResourceMinLOD(ID3D11Resource* pResource) override { return 0.0f; }
+
+		void STDMETHODCALLTYPE ClearRenderTargetView(ID3D11RenderTargetView* pRenderTargetView, const FLOAT colorRGBA[4]) override { ++mPass->clearCount; }
+		void STDMETHODCALLTYPE ClearUnorderedAccessViewUint(ID3D11UnorderedAccessView* pUnorderedAccessView, const UINT values[4]) override { ++mPass->clearCount; }
+		void STDMETHODCALLTYPE ClearUnorderedAccessViewFloat(ID3D11UnorderedAccessView* pUnorderedAccessView, const FLOAT values[4]) override { ++mPass->clearCount; }
+		void STDMETHODCALLTYPE ClearDepthStencilView(ID3D11DepthStencilView* pDepthStencilView, UINT clearFlags, FLOAT depth, UINT8 stencil) override { ++mPass->clearCount; }
+
+		// queries
+
+		void STDMETHODCALLTYPE Begin(ID3D11Asynchronous* pAsync) override {}
+
+		void STDMETHODCALLTYPE End(ID3D11Asynchronous* pAsync) override
+		{
+			static_cast<NullQuery*>(pAsync)->End();
+		}
+
+		HRESULT STDMETHODCALLTYPE GetData(ID3D11Asynchronous* pAsync, void* pData, UINT dataSize, UINT getDataFlags) override
+		{
+			return static_cast<NullQuery*>(pAsync)->GetData(pData, dataSize);
+		}
+
+		void STDMETHODCALLTYPE SetPredication(ID3D11Predicate* pPredicate, BOOL predicateValue) override {}
+
+		void STDMETHODCALLTYPE GetPredication(ID3D11Predicate** ppPredicate, BOOL* pPredicateValue) override
+		{
+			ClearOutputs(ppPredicate, 1);
+
+			if (pPredicateValue != nullptr)
+			{
+				*pPredicateValue = FALSE;
+			}
+		}
+
+		// command lists and the context itself
+
+		void STDMETHODCALLTYPE ExecuteCommandList(ID3D11CommandList* pCommandList, BOOL restoreContextState) override {}
+		HRESULT STDMETHODCALLTYPE FinishCommandList(BOOL restoreDeferredContextState, ID3D11CommandList** ppCommandList) override { return DXGI_ERROR_INVALID_CALL; }
+
+		void STDMETHODCALLTYPE ClearState() override
+		{
+			mBindings.clear();
+			mTopology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+		}
+		void STDMETHODCALLTYPE Flush() override {}
+
+		D3D11_DEVICE_CONTEXT_TYPE STDMETHODCALLTYPE GetType() override { return D3D11_DEVICE_CONTEXT_IMMEDIATE; }
+		UINT STDMETHODCALLTYPE GetContextFlags() override { return 0; }
+
+		// the counters since the previous call by pass, the open events carry over
+		void EndFrame(SubmissionStatistics::Report& report)
+		{
+			report.passes = std::move(mPasses);
+			report.total = {};
+
+			for (const auto& [path, counters] : report.passes)
+			{
+				report.total.Add(counters);
+			}
+
+			mPasses.clear();
+			mPass = &mPasses[mPassPath];
+		}
+
+	private:
+
+		enum Stage : uint32_t
+		{
+			kVertexShader,
+			kHullShader,
+			kDomainShader,
+			kGeometryShader,
+			kPixelShader,
+			kComputeShader,
+			kFixedFunction
+		};
+
+		enum Kind : uint32_t
+		{
+			kShader,
+			kConstantBuffers,
+			kShaderResources,
+			kSamplers,
+			kUnorderedAccessViews,
+			kInputLayout,
+			kVertexBuffers,
+			kIndexBuffer,
+			kTopology,
+			kStreamOutput,
+			kRasterizerState,
+			kViewports,
+			kScissorRects,
+			kRenderTargets,
+			kBlendState,
+			kDepthStencilState
+		};
+
+		// the arguments of a bind, arrays can be null
+		struct Bytes
+		{
+			const void* data;
+			std::size_t size;
+		};
+
+		template<typename T>
+		static Bytes Value(const T& value) { return { &value, sizeof(T) }; }
+
+		template<typename T>
+		static Bytes Array(const T* values, const UINT count) { return { values, sizeof(T) * count }; }
+
+		// a bind is redundant when its arguments hash to what was bound last at the same stage, kind and
+		// first slot; binds of overlapping slot ranges aren't matched up
+		void Bind(const Stage stage, const Kind kind, const UINT startSlot, const std::initializer_list<Bytes> arguments)
+		{
+			uint64_t hash = 0;
+
+			for (const Bytes& argument : arguments)
+			{
+				hash = argument.data ? HashBytes(argument.data, argument.size, hash) : HashBytes(&argument.size, sizeof(argument.size), hash);
+			}
+
+			++mPass->stateChangeCount;
+
+			const auto [it, inserted] = mBindings.try_emplace((stage << 24) | (kind << 16) | (startSlot & 0xffff), hash);
+
+			if (!inserted)
+			{
+				if (it->second == hash)
+				{
+					++mPass->redundantStateCount;
+				}
+
+				it->second = hash;
+			}
+		}
+
+		void CountDraw(const UINT vertexCount, const UINT instanceCount)
+		{
+			uint64_t triangleCount = 0;
+
+			switch (mTopology)
+			{
+				case D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST:
+					triangleCount = vertexCount / 3;
+					break;
+				case D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP:
+					triangleCount = (vertexCount > 2) ? (vertexCount - 2) : 0;
+					break;
+				case D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST_ADJ:
+					triangleCount = vertexCount / 6;
+					break;
+				case D3D11_PRIMITIVE_TOPOLOGY_TRIANGLESTRIP_ADJ:
+					triangleCount = (vertexCount > 4) ? (vertexCount - 4) / 2 : 0;
+					break;
+				default:
+					break;
+			}
+
+			++mPass->drawCount;
+			mPass->instanceCount += instanceCount;
+			mPass->vertexCount += uint64_t(vertexCount) * instanceCount;
+			mPass->triangleCount += triangleCount * instanceCount;
+		}
+
+		void CountUpload(NullResourceBase* pResource, const std::size_t bytes)
+		{
+			++mPass->uploadCount;
+			mPass->uploadBytes += bytes;
+
+			pResource->AddUpload(bytes);
+		}
+
+		template<typename Shader>
+		static void GetShader(Shader** ppShader, UINT* pNumClassInstances)
+		{
+			ClearOutputs(ppShader, 1);
+
+			if (pNumClassInstances != nullptr)
+			{
+				*pNumClassInstances = 0;
+			}
+		}
+
+		ID3D11Device& mDevice;
+		PrivateData mPrivateData;
+
+		std::map<std::string, SubmissionStatistics::Counters> mPasses;
+		std::string mPassPath;
+		std::vector<std::size_t> mPassPathLengths;
+		SubmissionStatistics::Counters* mPass;
+
+		std::unordered_map<uint32_t, uint64_t> mBindings;
+		D3D11_PRIMITIVE_TOPOLOGY mTopology = D3D11_PRIMITIVE_TOPOLOGY_UNDEFINED;
+	};
+
+	class NullDevice : public ID3D11Device
+	{
+	public:
+
+		NullDevice() : mContext(*this) {}
+		virtual ~NullDevice() = default;
+
+		NullDevice(const NullDevice&) = delete;
+		NullDevice& operator=(const NullDevice&) = delete;
+
+		// IUnknown
+
+		HRESULT STDMETHODCALLTYPE QueryInterface(REFIID riid, void** ppObject) override
+		{
+			if (ppObject == nullptr)
+			{
+				return E_POINTER;
+			}
+
+			if ((riid != __uuidof(IUnknown)) && (riid != __uuidof(ID3D11Device)))
+			{
+				*ppObject = nullptr;
+				return E_NOINTERFACE;
+			}
+
+			*ppObject = static_cast<ID3D11Device*>(this);
+			AddRef();
+
+			return S_OK;
+		}
+
+		ULONG STDMETHODCALLTYPE AddRef() override
+		{
+			return ++mRefCount;
+		}
+
+		ULONG STDMETHODCALLTYPE Release() override
+		{
+			const ULONG refCount = --mRefCount;
+
+			if (refCount == 0)
+			{
+				delete this;
+			}
+
+			return refCount;
+		}
+
+		// resources
+
+		HRESULT STDMETHODCALLTYPE CreateBuffer(const D3D11_BUFFER_DESC* pDesc, const D3D11_SUBRESOURCE_DATA* pInitialData, ID3D11Buffer** ppBuffer) override
+		{
+			if (pDesc == nullptr)
+			{
+				return E_INVALIDARG;
+			}
+
+			return CreateResource<NullBuffer>(ppBuffer, *pDesc, pInitialData);
+		}
+
+		HRESULT STDMETHODCALLTYPE CreateTexture1D(const D3D11_TEXTURE1D_DESC* pDesc, const D3D11_SUBRESOURCE_DATA* pInitialData, ID3D11Texture1D** ppTexture1D) override
+		{
+			if (pDesc == nullptr)
+			{
+				return E_INVALIDARG;
+			}
+
+			D3D11_TEXTURE1D_DESC desc = *pDesc;
+			desc.MipLevels = GetMipCount(desc.MipLevels, desc.Width);
+
+			return CreateResource<NullTexture1D>(ppTexture1D, desc, pInitialData);
+		}
+
+		HRESULT STDMETHODCALLTYPE CreateTexture2D(const D3D11_TEXTURE2D_DESC* pDesc, const D3D11_SUBRESOURCE_DATA* pInitialData, ID3D11Texture2D** ppTexture2D) override
+		{
+			if (pDesc == nullptr)
+			{
+				return E_INVALIDARG;
+			}
+
+			D3D11_TEXTURE2D_DESC desc = *pDesc;
+			desc.MipLevels = GetMipCount(desc.MipLevels, desc.Width, desc.Height);
+
+			return CreateResource<NullTexture2D>(ppTexture2D, desc, pInitialData);
+		}
+
+		HRESULT STDMETHODCALLTYPE CreateTexture3D(const D3D11_TEXTURE3D_DESC* pDesc, const D3D11_SUBRESOURCE_DATA* pInitialData, ID3D11Texture3D** ppTexture3D) override
+		{
+			if (pDesc == nullptr)
+			{
+				return E_INVALIDARG;
+			}
+
+			D3D11_TEXTURE3D_DESC desc = *pDesc;
+			desc.MipLevels = GetMipCount(desc.MipLevels, desc.Width, desc.Height, desc.Depth);
+
+			return CreateResource<NullTexture3D>(ppTexture3D, desc, pInitialData);
+		}
+
+		// views
+
+		HRESULT STDMETHODCALLTYPE CreateShaderResourceView(ID3D11Resource* pResource, const D3D11_SHADER_RESOURCE_VIEW_DESC* pDesc, ID3D11ShaderResourceView** ppSRView) override
+		{
+			return CreateView<NullView<ID3D11ShaderResourceView, D3D11_SHADER_RESOURCE_VIEW_DESC>>(ppSRView, pResource, pDesc);
+		}
+
+		HRESULT STDMETHODCALLTYPE CreateUnorderedAccessView(ID3D11Resource* pResource, const D3D11_UNORDERED_ACCESS_VIEW_DESC* pDesc, ID3D11UnorderedAccessView** ppUAView) override
+		{
+			return CreateView<NullView<ID3D11UnorderedAccessView, D3D11_UNORDERED_ACCESS_VIEW_DESC>>(ppUAView, pResource, pDesc);
+		}
+
+		HRESULT STDMETHODCALLTYPE CreateRenderTargetView(ID3D11Resource* pResource, const D3D11_RENDER_TARGET_VIEW_DESC* pDesc, ID3D11RenderTargetView** ppRTView) override
+		{
+			return CreateView<NullView<ID3D11RenderTargetView, D3D11_RENDER_TARGET_VIEW_DESC>>(ppRTView, pResource, pDesc);
+		}
+
+		HRESULT STDMETHODCALLTYPE CreateDepthStencilView(ID3D11Resource* pResource, const D3D11_DEPTH_STENCIL_VIEW_DESC* pDesc, ID3D11DepthStencilView** ppDepthStencilView) override
+		{
+			return CreateView<NullView<ID3D11DepthStencilView, D3D11_DEPTH_STENCIL_VIEW_DESC>>(ppDepthStencilView, pResource, pDesc);
+		}
+
+		// shaders, the bytecode isn't looked at
+
+		HRESULT STDMETHODCALLTYPE CreateInputLayout(const D3D11_INPUT_ELEMENT_DESC* pInputElementDescs,
+													UINT numElements,
+													const void* pShaderBytecodeWithInputSignature,
+													SIZE_T bytecodeLength,
+													ID3D11InputLayout** ppInputLayout) override
+		{
+			return Create<NullDeviceChild<ID3D11InputLayout>>(ppInputLayout);
+		}
+
+		HRESULT STDMETHODCALLTYPE CreateVertexShader(const void* pShaderBytecode, SIZE_T bytecodeLength, ID3D11ClassLinkage* pClassLinkage, ID3D11VertexShader** ppVertexShader) override
+		{
+			return Create<NullDeviceChild<ID3D11VertexShader>>(ppVertexShader);
+		}
+
+		HRESULT STDMETHODCALLTYPE CreateGeometryShader(const void* pShaderBytecode, SIZE_T bytecodeLength, ID3D11ClassLinkage* pClassLinkage, ID3D11GeometryShader** ppGeometryShader) override
+		{
+			return Create<NullDeviceChild<ID3D11GeometryShader>>(ppGeometryShader);
+		}
+
+		HRESULT STDMETHODCALLTYPE CreateGeometryShaderWithStreamOutput(const void* pShaderBytecode,
+																	   SIZE_T bytecodeLength,
+																	   const D3D11_SO_DECLARATION_ENTRY* pSODeclaration,
+																	   UINT numEntries,
+																	   const UINT* pBufferStrides,
+																	   UINT numStrides,
+																	   UINT rasterizedStream,
+																	   ID3D11ClassLinkage* pClassLinkage,
+																	   ID3D11GeometryShader** ppGeometryShader) override
+		{
+			return Create<NullDeviceChild<ID3D11GeometryShader>>(ppGeometryShader);
+		}
+
+		HRESULT STDMETHODCALLTYPE CreatePixelShader(const void* pShaderBytecode, SIZE_T bytecodeLength, ID3D11ClassLinkage* pClassLinkage, ID3D11PixelShader** ppPixelShader) override
+		{
+			return Create<NullDeviceChild<ID3D11PixelShader>>(ppPixelShader);
+		}
+
+		HRESULT STDMETHODCALLTYPE CreateHullShader(const void* pShaderBytecode, SIZE_T bytecodeLength, ID3D11ClassLinkage* pClassLinkage, ID3D11HullShader** ppHullShader) override
+		{
+			return Create<NullDeviceChild<ID3D11HullShader>>(ppHullShader);
+		}
+
+		HRESULT STDMETHODCALLTYPE CreateDomainShader(const void* pShaderBytecode, SIZE_T bytecodeLength, ID3D11ClassLinkage* pClassLinkage, ID3D11DomainShader** ppDomainShader) override
+		{
+			return Create<NullDeviceChild<ID3D11DomainShader>>(ppDomainShader);
+		}
+
+		HRESULT STDMETHODCALLTYPE CreateComputeShader(const void* pShaderBytecode, SIZE_T bytecodeLength, ID3D11ClassLinkage* pClassLinkage, ID3D11ComputeShader** ppComputeShader) override
+		{
+			return Create<NullDeviceChild<ID3D11ComputeShader>>(ppComputeShader);
+		}
+
+		HRESULT STDMETHODCALLTYPE CreateClassLinkage(ID3D11ClassLinkage** ppLinkage) override
+		{
+			return E_NOTIMPL;
+		}
+
+		// states
+
+		HRESULT STDMETHODCALLTYPE CreateBlendState(const D3D11_BLEND_DESC* pBlendStateDesc, ID3D11BlendState** ppBlendState) override
+		{
+			if (pBlendStateDesc == nullptr)
+			{
+				return E_INVALIDARG;
+			}
+
+			return Create<NullState<ID3D11BlendState, D3D11_BLEND_DESC>>(ppBlendState, *pBlendStateDesc);
+		}
+
+		HRESULT STDMETHODCALLTYPE CreateDepthStencilState(const D3D11_DEPTH_STENCIL_DESC* pDepthStencilDesc, ID3D11DepthStencilState** ppDepthStencilState) override
+		{
+			if (pDepthStencilDesc == nullptr)
+			{
+				return E_INVALIDARG;
+			}
+
+			return Create<NullState<ID3D11DepthStencilState, D3D11_DEPTH_STENCIL_DESC>>(ppDepthStencilState, *pDepthStencilDesc);
+		}
+
+		HRESULT STDMETHODCALLTYPE CreateRasterizerState(const D3D11_RASTERIZER_DESC* pRasterizerDesc, ID3D11RasterizerState** ppRasterizerState) override
+		{
+			if (pRasterizerDesc == nullptr)
+			{
+				return E_INVALIDARG;
+			}
+
+			return Create<NullState<ID3D11RasterizerState, D3D11_RASTERIZER_DESC>>(ppRasterizerState, *pRasterizerDesc);
+		}
+
+		HRESULT STDMETHODCALLTYPE CreateSamplerState(const D3D11_SAMPLER_DESC* pSamplerDesc, ID3D11SamplerState** ppSamplerState) override
+		{
+			if (pSamplerDesc == nullptr)
+			{
+				return E_INVALIDARG;
+			}
+
+			return Create<NullState<ID3D11SamplerState, D3D11_SAMPLER_DESC>>(ppSamplerState, *pSamplerDesc);
+		}
+
+		// queries
+
+		HRESULT STDMETHODCALLTYPE CreateQuery(const D3D11_QUERY_DESC* pQueryDesc, ID3D11Query** ppQuery) override
+		{
+			if (pQueryDesc == nullptr)
+			{
+				return E_INVALIDARG;
+			}
+
+			return Create<NullQuery>(ppQuery, *pQueryDesc);
+		}
+
+		HRESULT STDMETHODCALLTYPE CreatePredicate(const D3D11_QUERY_DESC* pPredicateDesc, ID3D11Predicate** ppPredicate) override
+		{
+			if (pPredicateDesc == nullptr)
+			{
+				return E_INVALIDARG;
+			}
+
+			return Create<NullQuery>(ppPredicate, *pPredicateDesc);
+		}
+
+		HRESULT STDMETHODCALLTYPE CreateCounter(const D3D11_COUNTER_DESC* pCounterDesc, ID3D11Counter** ppCounter) override
+		{
+			return E_NOTIMPL;
+		}
+
+		// what the device is and can do
+
+		HRESULT STDMETHODCALLTYPE CreateDeferredContext(UINT contextFlags, ID3D11DeviceContext** ppDeferredContext) override
+		{
+			return E_NOTIMPL;
+		}
+
+		HRESULT STDMETHODCALLTYPE OpenSharedResource(HANDLE hResource, REFIID returnedInterface, void** ppResource) override
+		{
+			return E_NOTIMPL;
+		}
+
+		HRESULT STDMETHODCALLTYPE CheckFormatSupport(DXGI_FORMAT format, UINT* pFormatSupport) override
+		{
+			*pFormatSupport = 0xffffffff;
+			return S_OK;
+		}
+
+		HRESULT STDMETHODCALLTYPE CheckMultisampleQualityLevels(DXGI_FORMAT format, UINT sampleCount, UINT* pNumQualityLevels) override
+		{
+			*pNumQualityLevels = 1;
+			return S_OK;
+		}
+
+		void STDMETHODCALLTYPE CheckCounterInfo(D3D11_COUNTER_INFO* pCounterInfo) override
+		{
+			std::memset(pCounterInfo, 0, sizeof(D3D11_COUNTER_INFO));
+		}
+
+		HRESULT STDMETHODCALLTYPE CheckCounter(const D3D11_COUNTER_DESC* pDesc,
+											   D3D11_COUNTER_TYPE* pType,
+											   UINT* pActiveCounters,
+											   LPSTR szName,
+											   UINT* pNameLength,
+											   LPSTR szUnits,
+											   UINT* pUnitsLength,
+											   LPSTR szDescription,
+											   UINT* pDescriptionLength) override
+		{
+			return E_INVALIDARG;
+		}
+
+		// no optional features
+		HRESULT STDMETHODCALLTYPE CheckFeatureSupport(D3D11_FEATURE feature, void* pFeatureSupportData, UINT featureSupportDataSize) override
+		{
+			std::memset(pFeatureSupportData, 0, featureSupportDataSize);
+			return S_OK;
+		}
+
+		HRESULT STDMETHODCALLTYPE GetPrivateData(REFGUID guid, UINT* pDataSize, void* pData) override { return mPrivateData.Get(guid, pDataSize, pData); }
+		HRESULT STDMETHODCALLTYPE SetPrivateData(REFGUID guid, UINT dataSize, const void* pData) override { return mPrivateData.Set(guid, dataSize, pData); }
+		HRESULT STDMETHODCALLTYPE SetPrivateDataInterface(REFGUID guid, const IUnknown* pData) override { return S_OK; }
+
+		D3D_FEATURE_LEVEL STDMETHODCALLTYPE GetFeatureLevel() override { return D3D_FEATURE_LEVEL_11_0; }
+		UINT STDMETHODCALLTYPE GetCreationFlags() override { return 0; }
+		HRESULT STDMETHODCALLTYPE GetDeviceRemovedReason() override { return S_OK; }
+
+		void STDMETHODCALLTYPE GetImmediateContext(ID3D11DeviceContext** ppImmediateContext) override
+		{
+			mContext.AddRef();
+			*ppImmediateContext = &mContext;
+		}
+
+		HRESULT STDMETHODCALLTYPE SetExceptionMode(UINT raiseFlags) override
+		{
+			mExceptionMode = raiseFlags;
+			return S_OK;
+		}
+
+		UINT STDMETHODCALLTYPE GetExceptionMode() override { return mExceptionMode; }
+
+		void EndFrame(SubmissionStatistics::Report& report)
+		{
+			mContext.EndFrame(report);
+			mRegistry.Collect(report);
+		}
+
+	private:
+
+		// no output pointer only validates the call, as on d3d11
+		template<typename Object, typename Interface, typename... Args>
+		HRESULT Create(Interface** ppObject, Args&&... args)
+		{
+			if (ppObject == nullptr)
+			{
+				return S_FALSE;
+			}
+
+			*ppObject = new Object(this, std::forward<Args>(args)...);
+
+			return S_OK;
+		}
+
+		// initial data fills every subresource
+		template<typename Resource, typename Interface, typename Desc>
+		HRESULT CreateResource(Interface** ppResource, const Desc& desc, const D3D11_SUBRESOURCE_DATA* pInitialData)
+		{
+			if (ppResource == nullptr)
+			{
+				return S_FALSE;
+			}
+
+			Resource* pResource = new Resource(this, mRegistry, desc);
+			mRegistry.Add(pResource, pInitialData ? pResource->GetMemorySize() : 0);
+
+			*ppResource = pResource;
+
+			return S_OK;
+		}
+
+		template<typename View, typename Interface, typename Desc>
+		HRESULT CreateView(Interface** ppView, ID3D11Resource* pResource, const Desc* pDesc)
+		{
+			if (pResource == nullptr)
+			{
+				return E_INVALIDARG;
+			}
+
+			return Create<View>(ppView, pResource, pDesc);
+		}
+
+		std::atomic<ULONG> mRefCount = 1;
+
+		ResourceRegistry mRegistry;
+		NullContext mContext;
+		PrivateData mPrivateData;
+
+		UINT mExceptionMode = 0;
+	};
+
+	// private data every null device carries, so objects of other devices can be told apart
+	// {43dc0425-4754-4e43-bcb8-f362738ec1b9}
+	const GUID kNullDeviceGuid = { 0x43dc0425, 0x4754, 0x4e43, { 0xbc, 0xb8, 0xf3, 0x62, 0x73, 0x8e, 0xc1, 0xb9 } };
+
+	// the NameResource hook of builds that leave hardware objects unnamed, the reports are grouped by name
+	void NameNullObject(ID3D11DeviceChild* pDeviceChild, const std::string& name)
+	{
+		ComPtr<ID3D11Device> pDevice;
+		pDeviceChild->GetDevice(&pDevice);
+
+		UINT size = 0;
+
+		if (pDevice && (pDevice->GetPrivateData(kNullDeviceGuid, &size, nullptr) == S_OK))
+		{
+			pDeviceChild->SetPrivateData(WKPDID_D3DDebugObjectName, UINT(name.length()), name.data());
+		}
+	}
+}
+
+void RenderDeviceNull::CreateDevice(ComPtr<ID3D11Device>& pDevice, ComPtr<ID3D11DeviceContext>& pContext)
+{
+	const uint8_t isNullDevice = 1;
+
+	pDevice.Attach(new NullDevice());
+	pDevice->SetPrivateData(kNullDeviceGuid, sizeof(isNullDevice), &isNullDevice);
+	pDevice->GetImmediateContext(pContext.ReleaseAndGetAddressOf());
+
+	SetNameResourceHook(NameNullObject);
+}
+
+void RenderDeviceNull::Init(Platform& platform, const UINT width, const UINT height)
+{
+	CreateDevice(mDevice, mContext);
+
+	ThrowIfFailed(mContext->QueryInterface(__uuidof(mAnnotation.Get()),
+										   reinterpret_cast<void**>(mAnnotation.GetAddressOf())));
+
+	mName = L"Null device";
+}
+
+void RenderDeviceNull::Present()
+{
+	++mReport.frame;
+
+	static_cast<NullDevice*>(mDevice.Get())->EndFrame(mReport);
+
+	if (mReportCallback)
+	{
+		mReportCallback(mReport);
+	}
+}
+
+ComPtr<ID3D11Resource> RenderDeviceNull::ResizeBackBuffer(const UINT width, const UINT height)
+{
+	D3D11_TEXTURE2D_DESC desc;
+	desc.Width = width;
+	desc.Height = height;
+	desc.MipLevels = 1;
+	desc.ArraySize = 1;
+	desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	desc.SampleDesc.Count = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.BindFlags = D3D11_BIND_RENDER_TARGET;
+	desc.CPUAccessFlags = 0;
+	desc.MiscFlags = 0;
+
+	ComPtr<ID3D11Texture2D> pBackBuffer;
+	ThrowIfFailed(mDevice->CreateTexture2D(&desc, nullptr, &pBackBuffer));
+
+	return pBackBuffer;
+}
+
+ComPtr<ID3DBlob> RenderDeviceNull::CompileShader(const std::wstring& fileName,
+												 const D3D_SHADER_MACRO* defines,
+												 const std::string& entryPoint,
+												 const ShaderTarget target)
+{
+	ComPtr<ID3DBlob> pCode;
+	pCode.Attach(new NullBlob());
+
+	return pCode;
+}
\ No newline at end of file
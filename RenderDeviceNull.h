@@ -0,0 +1,43 @@
+#pragma once
+
+// std
+#include <functional>
+
+//
+#include "RenderDevice.h"
+#include "SubmissionStatistics.h"
+
+// device without a gpu: its d3d11 device and context implement every call, the objects they create
+// keep their descriptions and nothing else and nothing is drawn. the app makes the same calls as on
+// hardware, headless and where there are no d3d11 drivers at all
+class RenderDeviceNull : public RenderDevice
+{
+public:
+
+	// the null device and its immediate context alone, for tools that don't need a RenderDevice
+	static void CreateDevice(ComPtr<ID3D11Device>& pDevice, ComPtr<ID3D11DeviceContext>& pContext);
+
+	void Init(Platform& platform, const UINT width, const UINT height) override;
+
+	ComPtr<ID3D11Resource> ResizeBackBuffer(const UINT width, const UINT height) override;
+
+	// ends the frame of the submission report
+	void Present() override;
+
+	// nothing to compile for, the shaders are created from empty bytecode
+	ComPtr<ID3DBlob> CompileShader(const std::wstring& fileName,
+								   const D3D_SHADER_MACRO* defines,
+								   const std::string& entryPoint,
+								   const ShaderTarget target) override;
+
+	// what the last frame submitted, up to date after Present
+	const SubmissionStatistics::Report& GetSubmissionReport() const { return mReport; }
+
+	// called from Present with every report
+	void SetReportCallback(std::function<void(const SubmissionStatistics::Report&)> callback) { mReportCallback = std::move(callback); }
+
+private:
+
+	SubmissionStatistics::Report mReport;
+	std::function<void(const SubmissionStatistics::Report&)> mReportCallback;
+};
\ No newline at end of file
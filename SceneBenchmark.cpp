@@ -0,0 +1,557 @@
+#include "AppBase.h"
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include "PlatformHeadless.h"
+#include "RenderDeviceNull.h"
+
+// scene-scale benchmark: procedural scenes of boxes and grids on the null device, the cpu side of their
+// frames timed per object so runs on different commits compare:
+// scenebenchmark [--objects n,n,...] [--meshes n] [--materials n] [--textures n] [--lights n] [--frames n]
+//                [--json path] [--csv path]
+
+namespace
+{
+	struct SceneSettings
+	{
+		std::size_t objectCount = 1000;
+		std::size_t meshCount = 16;
+		std::size_t materialCount = 64;
+		std::size_t textureCount = 16;
+		std::size_t lightCount = 4; // point lights, at most LIGHT_MAX_COUNT - 3 reach the main pass CB
+	};
+
+	struct Result
+	{
+		SceneSettings scene;
+		uint64_t frameCount = 0;
+
+		double buildSeconds = 0.0;
+		double runSeconds = 0.0;
+
+		// summed over the frames
+		double objectSeconds = 0.0;
+		double drawListSeconds = 0.0;
+		double submitSeconds = 0.0;
+
+		double cpuFrameP50 = 0.0;
+		double cpuFrameP95 = 0.0;
+
+		uint64_t drawCount = 0; // of the last frame
+
+		double GetFramesPerSecond() const { return (runSeconds > 0.0) ? frameCount / runSeconds : 0.0; }
+
+		double GetNsPerObject(const double seconds) const
+		{
+			const double objectFrames = double(frameCount) * double(scene.objectCount);
+			return (objectFrames > 0.0) ? seconds * 1e9 / objectFrames : 0.0;
+		}
+	};
+
+	double GetSeconds(const std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	// small uncompressed texture of a single color, different for every index so TextureManager doesn't
+	// merge them
+	std::vector<uint8_t> CreateTextureDDS(const std::size_t index)
+	{
+		constexpr uint32_t kSize = 64;
+
+		std::vector<uint32_t> texels(kSize * kSize, 0xff000000u | uint32_t(HashBytes(&index, sizeof(index)) & 0x00ffffffu));
+
+		DDSTextureInfo info;
+		info.width = kSize;
+		info.height = kSize;
+		info.depth = 1;
+		info.mipCount = 1;
+		info.arraySize = 1;
+		info.format = DXGI_FORMAT_R8G8B8A8_UNORM;
+		info.resourceDimension = D3D11_RESOURCE_DIMENSION_TEXTURE2D;
+		info.isCubeMap = 0;
+
+		D3D11_SUBRESOURCE_DATA subresource;
+		subresource.pSysMem = texels.data();
+		subresource.SysMemPitch = kSize * sizeof(uint32_t);
+		subresource.SysMemSlicePitch = kSize * kSize * sizeof(uint32_t);
+
+		std::size_t size = 0;
+		ThrowIfFailed(SaveDDSTextureToMemory(info, &subresource, nullptr, 0, &size));
+
+		std::vector<uint8_t> dds(size);
+		ThrowIfFailed(SaveDDSTextureToMemory(info, &subresource, dds.data(), dds.size(), &size));
+
+		return dds;
+	}
+
+	class SceneBenchmarkApp : public AppBase
+	{
+	public:
+
+		SceneBenchmarkApp(const SceneSettings& scene, const uint64_t frameCount) :
+			AppBase(std::make_unique<PlatformHeadless>(frameCount), std::make_unique<RenderDeviceNull>()),
+			mScene(scene)
+		{}
+
+		bool Init() override
+		{
+			if (!AppBase::Init())
+			{
+				return false;
+			}
+
+			BuildScene();
+
+			return true;
+		}
+
+		// the camera circles the scene, every object turns about its own axis
+		void Update(const Timer& timer) override
+		{
+			mCamera.RotateY(0.1f * float(timer.GetDeltaTime()));
+
+			AppBase::Update(timer);
+
+			const auto start = std::chrono::steady_clock::now();
+
+			{
+				CPUProfiler::Scope scope("objects");
+
+				const float time = float(timer.GetTotalTime());
+
+				for (std::size_t i = 0; i < mPositions.size(); ++i)
+				{
+					const XMFLOAT4& position = mPositions[i];
+
+					const XMMATRIX world = XMMatrixRotationY(time * position.w) * XMMatrixTranslation(position.x, position.y, position.z);
+
+					XMStoreFloat4x4(&mObjectManager.EditObject(i).world, world);
+				}
+			}
+
+			mObjectSeconds += GetSeconds(start);
+		}
+
+		// objects sorted by texture, then mesh and material, the way a forward pass draws them
+		void Draw(const Timer& timer) override
+		{
+			auto start = std::chrono::steady_clock::now();
+
+			{
+				CPUProfiler::Scope scope("draw list");
+
+				const std::vector<Object>& objects = mObjectManager.GetObjects();
+
+				mDrawList.resize(objects.size());
+
+				for (std::size_t i = 0; i < objects.size(); ++i)
+				{
+					const Object& object = objects[i];
+					const uint64_t texture = uint64_t(mMaterialManager.GetMaterial(object.material).diffuseTextureArray + 1);
+					const uint64_t material = uint64_t(mMaterialManager.GetBufferIndex(object.material));
+
+					mDrawList[i].key = (texture << 48) | ((uint64_t(object.mesh) & 0xffffff) << 24) | (material & 0xffffff);
+					mDrawList[i].object = uint32_t(i);
+				}
+
+				std::sort(mDrawList.begin(), mDrawList.end(), [](const DrawItem& a, const DrawItem& b) { return a.key < b.key; });
+			}
+
+			const auto drawListEnd = std::chrono::steady_clock::now();
+			mDrawListSeconds += std::chrono::duration<double>(drawListEnd - start).count();
+			start = drawListEnd;
+
+			{
+				CPUProfiler::Scope cpuScope("submit");
+				GPUProfiler::Scope scope(mGPUProfiler, "opaque");
+
+				const FLOAT clearColor[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+
+				mContext->ClearRenderTargetView(mBackBufferRTV.Get(), clearColor);
+				mContext->ClearDepthStencilView(mDepthStencilBufferDSV.Get(), D3D11_CLEAR_DEPTH | D3D11_CLEAR_STENCIL, 1.0f, 0);
+
+				mContext->OMSetRenderTargets(1, mBackBufferRTV.GetAddressOf(), mDepthStencilBufferDSV.Get());
+				mContext->RSSetViewports(1, &mViewport);
+
+				const UINT stride = sizeof(VertexData);
+				const UINT offset = 0;
+
+				mContext->IASetInputLayout(mInputLayout.Get());
+				mContext->IASetVertexBuffers(0, 1, mMeshManager.GetAddressOfVertexBuffer(), &stride, &offset);
+				mContext->IASetIndexBuffer(mMeshManager.GetIndexBuffer(), mMeshManager.GetIndexBufferFormat(), 0);
+				mContext->IASetPrimitiveTopology(mPrimitiveTopology);
+
+				mContext->VSSetShader(mDefaultVS.Get(), nullptr, 0);
+				mContext->PSSetShader(mDefaultPS.Get(), nullptr, 0);
+
+				ID3D11Buffer* constantBuffers[] = { *mObjectManager.GetAddressOfBuffer(), mMainPassCB.Get() };
+
+				mContext->VSSetConstantBuffers(0, 2, constantBuffers);
+				mContext->PSSetConstantBuffers(0, 2, constantBuffers);
+				mContext->PSSetShaderResources(0, 1, mMaterialManager.GetAddressOfBufferSRV());
+				mContext->PSSetSamplers(0, 1, mSamplerLinearWrap.GetAddressOf());
+
+				const std::vector<Object>& objects = mObjectManager.GetObjects();
+
+				int boundTexture = -2;
+
+				for (const DrawItem& item : mDrawList)
+				{
+					const Object& object = objects[item.object];
+					const int texture = mMaterialManager.GetMaterial(object.material).diffuseTextureArray;
+
+					if (texture != boundTexture)
+					{
+						ID3D11ShaderResourceView* pSRV = (texture >= 0) ? mTextureManager.GetSRV(texture) : nullptr;
+						mContext->PSSetShaderResources(1, 1, &pSRV);
+
+						boundTexture = texture;
+					}
+
+					mObjectManager.UpdateBuffer(item.object, mMaterialManager);
+
+					const MeshData& mesh = mMeshManager.GetMesh(object.mesh);
+					mContext->DrawIndexed(mesh.indexCount, mesh.indexStart, mesh.vertexBase);
+				}
+			}
+
+			mSubmitSeconds += GetSeconds(start);
+		}
+
+		void AddTimings(Result& result) const
+		{
+			result.objectSeconds = mObjectSeconds;
+			result.drawListSeconds = mDrawListSeconds;
+			result.submitSeconds = mSubmitSeconds;
+
+			result.drawCount = static_cast<const RenderDeviceNull&>(*mRenderDevice).GetSubmissionReport().total.drawCount;
+		}
+
+	private:
+
+		struct DrawItem
+		{
+			uint64_t key;
+			uint32_t object;
+		};
+
+		// the objects fill a cube, spaced apart by a few units
+		void BuildScene()
+		{
+			for (std::size_t i = 0; i < mScene.meshCount; ++i)
+			{
+				const float size = 0.5f + 0.25f * float(i % 4);
+
+				MeshData mesh = (i % 2 == 0) ? MeshManager::CreateBox(size, size, size)
+											 : MeshManager::CreateGrid(size, size, 2 + i % 15, 2 + i % 15);
+
+				mMeshManager.AddMesh("mesh" + std::to_string(i), mesh);
+			}
+
+			mMeshManager.UpdateBuffers();
+
+			for (std::size_t i = 0; i < mScene.textureCount; ++i)
+			{
+				const std::vector<uint8_t> dds = CreateTextureDDS(i);
+				mTextureManager.LoadTexture("texture" + std::to_string(i), dds.data(), dds.size());
+			}
+
+			for (std::size_t i = 0; i < mScene.materialCount; ++i)
+			{
+				Material material;
+				material.diffuse = XMFLOAT4(float(i % 7) / 6.0f, float(i % 11) / 10.0f, float(i % 13) / 12.0f, 1.0f);
+				material.roughness = 0.1f + 0.8f * float(i % 17) / 16.0f;
+
+				if (mScene.textureCount != 0)
+				{
+					material.diffuseTextureArray = int(i % mScene.textureCount);
+					material.diffuseTextureIndex = 0;
+				}
+
+				mMaterialManager.AddMaterial("material" + std::to_string(i), material);
+			}
+
+			for (std::size_t i = 0; i < mScene.lightCount; ++i)
+			{
+				const float angle = XM_2PI * float(i) / float(mScene.lightCount);
+
+				Lighting::Light light;
+				light.position = XMFLOAT3(20.0f * std::cos(angle), 5.0f, 20.0f * std::sin(angle));
+				light.falloffEnd = 30.0f;
+
+				mLighting.AddPointLight(light);
+			}
+
+			const std::size_t side = std::max<std::size_t>(1, std::size_t(std::ceil(std::cbrt(double(mScene.objectCount)))));
+			const float spacing = 3.0f;
+			const float half = 0.5f * spacing * float(side - 1);
+
+			mPositions.reserve(mScene.objectCount);
+
+			for (std::size_t i = 0; i < mScene.objectCount; ++i)
+			{
+				const std::size_t x = i % side;
+				const std::size_t y = (i / side) % side;
+				const std::size_t z = i / (side * side);
+
+				// spin speed in w
+				mPositions.emplace_back(spacing * x - half, spacing * y - half, spacing * z - half, 0.25f + 0.05f * float(i % 16));
+
+				// the materials shuffled over the objects, so the draw list has to sort them
+				Object object;
+				object.mesh = (mScene.meshCount != 0) ? i % mScene.meshCount : 0;
+				object.material = (mScene.materialCount != 0) ? (i * 7919) % mScene.materialCount : 0;
+
+				mObjectManager.AddObject(object);
+			}
+
+			mCamera.LookAt(XMFLOAT3(0.0f, half + 10.0f, -3.0f * half - 20.0f), XMFLOAT3(0.0f, 0.0f, 0.0f), XMFLOAT3(0.0f, 1.0f, 0.0f));
+		}
+
+		SceneSettings mScene;
+
+		std::vector<XMFLOAT4> mPositions;
+		std::vector<DrawItem> mDrawList;
+
+		double mObjectSeconds = 0.0;
+		double mDrawListSeconds = 0.0;
+		double mSubmitSeconds = 0.0;
+	};
+
+	Result RunScene(const SceneSettings& scene, const uint64_t frameCount)
+	{
+		Result result;
+		result.scene = scene;
+		result.frameCount = frameCount;
+
+		SceneBenchmarkApp app(scene, frameCount);
+
+		auto start = std::chrono::steady_clock::now();
+
+		if (!app.Init())
+		{
+			throw std::runtime_error("can't init the app");
+		}
+
+		result.buildSeconds = GetSeconds(start);
+
+		start = std::chrono::steady_clock::now();
+		app.Run();
+		result.runSeconds = GetSeconds(start);
+
+		app.AddTimings(result);
+
+		const FrameStatistics& statistics = app.GetFrameStatistics();
+
+		for (std::size_t channel = 0; channel < statistics.GetChannelCount(); ++channel)
+		{
+			if (statistics.GetChannelName(channel) == "cpu frame ms")
+			{
+				const FrameStatistics::Summary cpu = statistics.GetSummary(channel);
+
+				result.cpuFrameP50 = cpu.p50;
+				result.cpuFrameP95 = cpu.p95;
+			}
+		}
+
+		return result;
+	}
+
+	std::vector<std::size_t> ParseCounts(const char* text)
+	{
+		std::vector<std::size_t> counts;
+
+		for (const char* p = text; *p != '\0';)
+		{
+			char* end = nullptr;
+			counts.push_back(std::strtoull(p, &end, 10));
+
+			p = (*end == ',') ? end + 1 : end;
+
+			if (end == p)
+			{
+				break;
+			}
+		}
+
+		return counts;
+	}
+
+	bool WriteJSON(const std::vector<Result>& results, const std::string& path)
+	{
+		std::ofstream stream(path);
+
+		if (!stream)
+		{
+			return false;
+		}
+
+		stream << "{\n\"results\": [";
+
+		for (std::size_t i = 0; i < results.size(); ++i)
+		{
+			const Result& result = results[i];
+
+			stream << (i ? ",\n" : "\n") << "{\"objects\": " << result.scene.objectCount
+				   << ", \"meshes\": " << result.scene.meshCount
+				   << ", \"materials\": " << result.scene.materialCount
+				   << ", \"textures\": " << result.scene.textureCount
+				   << ", \"lights\": " << result.scene.lightCount
+				   << ", \"frames\": " << result.frameCount
+				   << ", \"draws\": " << result.drawCount
+				   << ", \"buildSeconds\": " << result.buildSeconds
+				   << ", \"framesPerSecond\": " << result.GetFramesPerSecond()
+				   << ", \"nsPerObject\": " << result.GetNsPerObject(result.runSeconds)
+				   << ", \"objectUpdateNsPerObject\": " << result.GetNsPerObject(result.objectSeconds)
+				   << ", \"drawListNsPerObject\": " << result.GetNsPerObject(result.drawListSeconds)
+				   << ", \"submitNsPerObject\": " << result.GetNsPerObject(result.submitSeconds)
+				   << ", \"cpuFrameP50\": " << result.cpuFrameP50
+				   << ", \"cpuFrameP95\": " << result.cpuFrameP95 << "}";
+		}
+
+		stream << "\n]\n}\n";
+
+		return bool(stream);
+	}
+
+	bool WriteCSV(const std::vector<Result>& results, const std::string& path)
+	{
+		std::ofstream stream(path);
+
+		if (!stream)
+		{
+			return false;
+		}
+
+		stream << "objects,meshes,materials,textures,lights,frames,draws,build s,frames/s,ns/object,object update ns/object,draw list ns/object,submit ns/object,cpu frame p50 ms,cpu frame p95 ms\n";
+
+		for (const Result& result : results)
+		{
+			stream << result.scene.objectCount << ','
+				   << result.scene.meshCount << ','
+				   << result.scene.materialCount << ','
+				   << result.scene.textureCount << ','
+				   << result.scene.lightCount << ','
+				   << result.frameCount << ','
+				   << result.drawCount << ','
+				   << result.buildSeconds << ','
+				   << result.GetFramesPerSecond() << ','
+				   << result.GetNsPerObject(result.runSeconds) << ','
+				   << result.GetNsPerObject(result.objectSeconds) << ','
+				   << result.GetNsPerObject(result.drawListSeconds) << ','
+				   << result.GetNsPerObject(result.submitSeconds) << ','
+				   << result.cpuFrameP50 << ','
+				   << result.cpuFrameP95 << '\n';
+		}
+
+		return bool(stream);
+	}
+}
+
+int main(int argc, char* argv[])
+{
+	std::vector<std::size_t> objectCounts = { 1000, 10000, 100000, 1000000 };
+	SceneSettings scene;
+	uint64_t frameCount = 60;
+	std::string jsonPath;
+	std::string csvPath;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const bool hasValue = (i + 1) < argc;
+
+		if ((std::strcmp(argv[i], "--objects") == 0) && hasValue)
+		{
+			objectCounts = ParseCounts(argv[++i]);
+		}
+		else if ((std::strcmp(argv[i], "--meshes") == 0) && hasValue)
+		{
+			scene.meshCount = std::max<std::size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+		}
+		else if ((std::strcmp(argv[i], "--materials") == 0) && hasValue)
+		{
+			scene.materialCount = std::max<std::size_t>(1, std::strtoull(argv[++i], nullptr, 10));
+		}
+		else if ((std::strcmp(argv[i], "--textures") == 0) && hasValue)
+		{
+			scene.textureCount = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if ((std::strcmp(argv[i], "--lights") == 0) && hasValue)
+		{
+			scene.lightCount = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if ((std::strcmp(argv[i], "--frames") == 0) && hasValue)
+		{
+			frameCount = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if ((std::strcmp(argv[i], "--json") == 0) && hasValue)
+		{
+			jsonPath = argv[++i];
+		}
+		else if ((std::strcmp(argv[i], "--csv") == 0) && hasValue)
+		{
+			csvPath = argv[++i];
+		}
+		else
+		{
+			std::fprintf(stderr,
+						 "usage: %s [--objects n,n,...] [--meshes n] [--materials n] [--textures n] [--lights n] [--frames n] [--json path] [--csv path]\n",
+						 argv[0]);
+			return 1;
+		}
+	}
+
+	try
+	{
+		std::vector<Result> results;
+
+		std::printf("%10s %8s %10s %12s %12s %12s %12s\n", "objects", "draws", "frames/s", "ns/object", "update", "draw list", "submit");
+
+		for (const std::size_t objectCount : objectCounts)
+		{
+			scene.objectCount = objectCount;
+
+			const Result& result = results.emplace_back(RunScene(scene, frameCount));
+
+			std::printf("%10zu %8llu %10.2f %12.2f %12.2f %12.2f %12.2f\n",
+						result.scene.objectCount,
+						(unsigned long long)result.drawCount,
+						result.GetFramesPerSecond(),
+						result.GetNsPerObject(result.runSeconds),
+						result.GetNsPerObject(result.objectSeconds),
+						result.GetNsPerObject(result.drawListSeconds),
+						result.GetNsPerObject(result.submitSeconds));
+		}
+
+		if (!jsonPath.empty() && !WriteJSON(results, jsonPath))
+		{
+			std::fprintf(stderr, "can't write %s\n", jsonPath.c_str());
+			return 1;
+		}
+
+		if (!csvPath.empty() && !WriteCSV(results, csvPath))
+		{
+			std::fprintf(stderr, "can't write %s\n", csvPath.c_str());
+			return 1;
+		}
+
+		return 0;
+	}
+	catch (Exception& exception)
+	{
+		std::wcerr << L"HR Failed\n" << exception.ToString();
+		return 1;
+	}
+}
\ No newline at end of file
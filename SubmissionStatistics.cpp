@@ -0,0 +1,180 @@
+#include "SubmissionStatistics.h"
+
+// std
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+
+namespace
+{
+	void AddCounters(SubmissionStatistics::Values& values, const std::string& prefix, const SubmissionStatistics::Counters& counters, const bool skipZero)
+	{
+		const std::pair<const char*, uint64_t> fields[] =
+		{
+			{ "draws", counters.drawCount },
+			{ "instances", counters.instanceCount },
+			{ "vertices", counters.vertexCount },
+			{ "triangles", counters.triangleCount },
+			{ "dispatches", counters.dispatchCount },
+			{ "clears", counters.clearCount },
+			{ "state changes", counters.stateChangeCount },
+			{ "redundant state changes", counters.redundantStateCount },
+			{ "uploads", counters.uploadCount },
+			{ "upload bytes", counters.uploadBytes },
+			{ "copy bytes", counters.copyBytes },
+		};
+
+		for (const auto& [name, value] : fields)
+		{
+			if (!skipZero || (value != 0))
+			{
+				values[prefix + name] = value;
+			}
+		}
+	}
+}
+
+void SubmissionStatistics::Counters::Add(const Counters& other)
+{
+	drawCount += other.drawCount;
+	instanceCount += other.instanceCount;
+	vertexCount += other.vertexCount;
+	triangleCount += other.triangleCount;
+	dispatchCount += other.dispatchCount;
+	clearCount += other.clearCount;
+	stateChangeCount += other.stateChangeCount;
+	redundantStateCount += other.redundantStateCount;
+	uploadCount += other.uploadCount;
+	uploadBytes += other.uploadBytes;
+	copyBytes += other.copyBytes;
+}
+
+SubmissionStatistics::Values SubmissionStatistics::Flatten(const Report& report)
+{
+	Values values;
+
+	values["frame"] = report.frame;
+	values["creates"] = report.createCount;
+	values["initial data bytes"] = report.initialDataBytes;
+
+	AddCounters(values, "", report.total, false);
+
+	for (const auto& [pass, counters] : report.passes)
+	{
+		AddCounters(values, "pass." + (pass.empty() ? std::string("(none)") : pass) + ".", counters, true);
+	}
+
+	uint64_t memoryBytes = 0;
+
+	for (const auto& [name, bytes] : report.memoryBytes)
+	{
+		values["memory." + name] = bytes;
+		memoryBytes += bytes;
+	}
+
+	values["memory bytes"] = memoryBytes;
+
+	for (const auto& [name, count] : report.resourceCounts)
+	{
+		values["resources." + name] = count;
+	}
+
+	for (const auto& [name, bytes] : report.uploadBytes)
+	{
+		values["upload." + name] = bytes;
+	}
+
+	return values;
+}
+
+void SubmissionStatistics::Print(const Report& report, std::ostream& stream)
+{
+	for (const auto& [name, value] : Flatten(report))
+	{
+		stream << name << '\t' << value << '\n';
+	}
+}
+
+bool SubmissionStatistics::Write(const Report& report, const std::string& path)
+{
+	std::ofstream stream(path);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	Print(report, stream);
+
+	return bool(stream);
+}
+
+bool SubmissionStatistics::Read(const std::string& path, Values& values)
+{
+	std::ifstream stream(path);
+
+	if (!stream)
+	{
+		return false;
+	}
+
+	values.clear();
+
+	std::string line;
+
+	while (std::getline(stream, line))
+	{
+		// names can have spaces, never tabs
+		const std::size_t tab = line.rfind('\t');
+
+		if (tab == std::string::npos)
+		{
+			continue;
+		}
+
+		values[line.substr(0, tab)] = std::strtoull(line.c_str() + tab + 1, nullptr, 10);
+	}
+
+	return true;
+}
+
+std::vector<SubmissionStatistics::Difference> SubmissionStatistics::Compare(const Values& baseline, const Values& current, const double tolerance)
+{
+	std::vector<Difference> differences;
+
+	const auto Check = [&](const std::string& name, const uint64_t baselineValue, const uint64_t currentValue)
+	{
+		const double delta = std::fabs(double(currentValue) - double(baselineValue));
+
+		if (delta > tolerance * double(baselineValue))
+		{
+			differences.push_back({ name, baselineValue, currentValue });
+		}
+	};
+
+	// both maps are sorted, walk them together
+	auto b = baseline.begin();
+	auto c = current.begin();
+
+	while ((b != baseline.end()) || (c != current.end()))
+	{
+		if ((c == current.end()) || ((b != baseline.end()) && (b->first < c->first)))
+		{
+			Check(b->first, b->second, 0);
+			++b;
+		}
+		else if ((b == baseline.end()) || (c->first < b->first))
+		{
+			Check(c->first, 0, c->second);
+			++c;
+		}
+		else
+		{
+			Check(b->first, b->second, c->second);
+			++b;
+			++c;
+		}
+	}
+
+	return differences;
+}
\ No newline at end of file
@@ -0,0 +1,73 @@
+#pragma once
+
+// std
+#include <cstdint>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+// what a frame submitted before it reached a driver, counted by RenderDeviceNull. a report flattens to
+// sorted name/value pairs, the same names in every build, so two runs can be compared value by value
+class SubmissionStatistics
+{
+public:
+
+	// context calls, of the frame or of an annotated pass
+	struct Counters
+	{
+		uint64_t drawCount = 0;
+		uint64_t instanceCount = 0;
+		uint64_t vertexCount = 0;          // indices for indexed draws, all instances
+		uint64_t triangleCount = 0;
+		uint64_t dispatchCount = 0;
+		uint64_t clearCount = 0;
+		uint64_t stateChangeCount = 0;     // binds of shaders, states, buffers, views and targets
+		uint64_t redundantStateCount = 0;  // the ones that bound what was bound already
+		uint64_t uploadCount = 0;          // UpdateSubresource and maps for writing
+		uint64_t uploadBytes = 0;
+		uint64_t copyBytes = 0;
+
+		void Add(const Counters& other);
+	};
+
+	struct Report
+	{
+		uint64_t frame = 0;
+
+		Counters total;
+
+		// by annotation path, "Shadows/Cascade0" for nested events and "" outside of any
+		std::map<std::string, Counters> passes;
+
+		// device calls since the previous report, from any thread
+		uint64_t createCount = 0;
+		uint64_t initialDataBytes = 0;
+
+		// by NameResource name, unnamed resources go by their kind
+		std::map<std::string, uint64_t> uploadBytes; // initial data included
+		std::map<std::string, uint64_t> memoryBytes; // of the live resources
+		std::map<std::string, uint64_t> resourceCounts;
+	};
+
+	using Values = std::map<std::string, uint64_t>;
+
+	// "draws", "pass.GBuffer.draws", "upload.ObjectCB", "memory.GBuffer", ...; zero counters are left
+	// out of the passes and the resources, values missing from a report are zero
+	static Values Flatten(const Report& report);
+
+	// a line per value, its name and the value separated by a tab
+	static void Print(const Report& report, std::ostream& stream);
+	static bool Write(const Report& report, const std::string& path);
+	static bool Read(const std::string& path, Values& values);
+
+	struct Difference
+	{
+		std::string name;
+		uint64_t baseline = 0;
+		uint64_t current = 0;
+	};
+
+	// values that moved by more than tolerance relative to the baseline, by name
+	static std::vector<Difference> Compare(const Values& baseline, const Values& current, const double tolerance = 0.0);
+};
\ No newline at end of file
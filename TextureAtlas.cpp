@@ -0,0 +1,442 @@
+#include "TextureAtlas.h"
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+
+// d3d
+#include "BlockDecoder.h"
+
+//
+#include "Utility.h"
+
+namespace
+{
+	struct Rect
+	{
+		uint32_t x = 0;
+		uint32_t y = 0;
+		uint32_t width = 0;
+		uint32_t height = 0;
+	};
+
+	bool Contains(const Rect& outer, const Rect& inner)
+	{
+		return (inner.x >= outer.x) && (inner.y >= outer.y) &&
+			   (inner.x + inner.width <= outer.x + outer.width) &&
+			   (inner.y + inner.height <= outer.y + outer.height);
+	}
+
+	bool Overlaps(const Rect& a, const Rect& b)
+	{
+		return (a.x < b.x + b.width) && (b.x < a.x + a.width) &&
+			   (a.y < b.y + b.height) && (b.y < a.y + a.height);
+	}
+
+	// one page of the MaxRects packer, the free space is kept as the list of maximal free
+	// rectangles, which overlap each other
+	class MaxRectsPage
+	{
+	public:
+
+		explicit MaxRectsPage(const uint32_t size)
+			: mFreeRects{ { 0, 0, size, size } }
+		{
+		}
+
+		// best short side fit: the free rectangle that leaves the smallest leftover along either side
+		bool Insert(const uint32_t width, const uint32_t height, Rect& placed)
+		{
+			uint32_t bestShortSide = UINT32_MAX;
+			uint32_t bestLongSide = UINT32_MAX;
+
+			for (const Rect& free : mFreeRects)
+			{
+				if ((free.width < width) || (free.height < height))
+				{
+					continue;
+				}
+
+				const uint32_t shortSide = std::min(free.width - width, free.height - height);
+				const uint32_t longSide = std::max(free.width - width, free.height - height);
+
+				if ((shortSide < bestShortSide) || ((shortSide == bestShortSide) && (longSide < bestLongSide)))
+				{
+					placed = { free.x, free.y, width, height };
+					bestShortSide = shortSide;
+					bestLongSide = longSide;
+				}
+			}
+
+			if (bestShortSide == UINT32_MAX)
+			{
+				return false;
+			}
+
+			Split(placed);
+
+			return true;
+		}
+
+	private:
+
+		void Split(const Rect& used)
+		{
+			std::vector<Rect> freeRects;
+			freeRects.reserve(mFreeRects.size() + 4);
+
+			for (const Rect& free : mFreeRects)
+			{
+				if (!Overlaps(free, used))
+				{
+					freeRects.push_back(free);
+					continue;
+				}
+
+				// what is left of free on each side of used, the four parts overlap at the corners
+				if (used.x > free.x)
+				{
+					freeRects.push_back({ free.x, free.y, used.x - free.x, free.height });
+				}
+
+				if (used.x + used.width < free.x + free.width)
+				{
+					freeRects.push_back({ used.x + used.width, free.y, free.x + free.width - used.x - used.width, free.height });
+				}
+
+				if (used.y > free.y)
+				{
+					freeRects.push_back({ free.x, free.y, free.width, used.y - free.y });
+				}
+
+				if (used.y + used.height < free.y + free.height)
+				{
+					freeRects.push_back({ free.x, used.y + used.height, free.width, free.y + free.height - used.y - used.height });
+				}
+			}
+
+			// drop the rectangles inside another one, of two equal ones the first is kept
+			mFreeRects.clear();
+
+			for (std::size_t i = 0; i < freeRects.size(); ++i)
+			{
+				bool isContained = false;
+
+				for (std::size_t j = 0; (j < freeRects.size()) && !isContained; ++j)
+				{
+					isContained = (i != j) && Contains(freeRects[j], freeRects[i]) &&
+								  (!Contains(freeRects[i], freeRects[j]) || (j < i));
+				}
+
+				if (!isContained)
+				{
+					mFreeRects.push_back(freeRects[i]);
+				}
+			}
+		}
+
+		std::vector<Rect> mFreeRects;
+	};
+
+	// texels along the side of a block, the unit the atlas places things in
+	uint32_t GetBlockDimension(const DXGI_FORMAT format)
+	{
+		return BlockDecoder::IsSupportedFormat(format) ? 4 : 1;
+	}
+
+	// bytes of a block, or of a texel for uncompressed formats
+	std::size_t GetElementSize(const DXGI_FORMAT format)
+	{
+		return BlockDecoder::IsSupportedFormat(format) ? BlockDecoder::GetBlockSize(format) : 4;
+	}
+
+	// copy a width x height grid of elements to (x, y) of the page and repeat its edges gutter elements
+	// outwards, so filtering across the border reads the texture's own edge; block compressed formats
+	// repeat whole edge blocks, which is close to but not exactly a clamp
+	void CopyWithGutter(const D3D11_SUBRESOURCE_DATA& source,
+						const uint32_t width,
+						const uint32_t height,
+						const D3D11_SUBRESOURCE_DATA& page,
+						const uint32_t x,
+						const uint32_t y,
+						const uint32_t gutter,
+						const std::size_t elementSize)
+	{
+		for (uint32_t row = 0; row < height + 2 * gutter; ++row)
+		{
+			const uint32_t sourceRow = std::min(std::max(row, gutter) - gutter, height - 1);
+
+			const uint8_t* src = static_cast<const uint8_t*>(source.pSysMem) + std::size_t(sourceRow) * source.SysMemPitch;
+			uint8_t* dst = static_cast<uint8_t*>(const_cast<void*>(page.pSysMem)) +
+						   std::size_t(y - gutter + row) * page.SysMemPitch + std::size_t(x - gutter) * elementSize;
+
+			for (uint32_t i = 0; i < gutter; ++i)
+			{
+				std::memcpy(dst + i * elementSize, src, elementSize);
+				std::memcpy(dst + (gutter + width + i) * elementSize, src + (width - 1) * elementSize, elementSize);
+			}
+
+			std::memcpy(dst + gutter * elementSize, src, width * elementSize);
+		}
+	}
+}
+
+bool TextureAtlas::IsSupportedFormat(const DXGI_FORMAT format)
+{
+	switch (format)
+	{
+		case DXGI_FORMAT_R8G8B8A8_UNORM:
+		case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+		case DXGI_FORMAT_B8G8R8A8_UNORM:
+		case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+			return true;
+		default:
+			return BlockDecoder::IsSupportedFormat(format);
+	}
+}
+
+TextureAtlas::Layout TextureAtlas::Pack(const std::vector<DDSTextureInfo>& infos, const Settings& settings, Report* report)
+{
+	assert(!infos.empty());
+	assert((settings.pageSize & (settings.pageSize - 1)) == 0);
+
+	const auto start = std::chrono::steady_clock::now();
+
+	Layout layout;
+	layout.format = infos[0].format;
+	layout.pageSize = settings.pageSize;
+	layout.mipCount = std::max(1u, settings.maxMipCount);
+
+	assert(IsSupportedFormat(layout.format));
+
+	const uint32_t blockDimension = GetBlockDimension(layout.format);
+
+	// the most mips that every texture has and that still start on a whole block
+	for (const DDSTextureInfo& info : infos)
+	{
+		assert(info.resourceDimension == D3D11_RESOURCE_DIMENSION_TEXTURE2D);
+		assert((info.arraySize == 1) && (info.isCubeMap == 0));
+		assert(info.format == layout.format);
+		assert((info.width % blockDimension == 0) && (info.height % blockDimension == 0));
+
+		while ((layout.mipCount > 1) &&
+			   ((info.mipCount < layout.mipCount) ||
+				(info.width % (blockDimension << (layout.mipCount - 1)) != 0) ||
+				(info.height % (blockDimension << (layout.mipCount - 1)) != 0)))
+		{
+			--layout.mipCount;
+		}
+	}
+
+	// placing on a grid of this many texels keeps every placement block aligned down to the last mip
+	const uint32_t alignment = blockDimension << (layout.mipCount - 1);
+	const uint32_t gridSize = settings.pageSize / alignment;
+
+	assert(settings.pageSize % alignment == 0);
+
+	layout.gutter = ((settings.gutter + blockDimension - 1) / blockDimension) * alignment;
+
+	// largest first, by the longer side and then by area
+	std::vector<std::size_t> order(infos.size());
+	std::iota(order.begin(), order.end(), std::size_t(0));
+
+	std::stable_sort(order.begin(), order.end(), [&](const std::size_t a, const std::size_t b)
+	{
+		const uint32_t sideA = std::max(infos[a].width, infos[a].height);
+		const uint32_t sideB = std::max(infos[b].width, infos[b].height);
+
+		if (sideA != sideB)
+		{
+			return sideA > sideB;
+		}
+
+		return uint64_t(infos[a].width) * infos[a].height > uint64_t(infos[b].width) * infos[b].height;
+	});
+
+	std::vector<MaxRectsPage> pages;
+	layout.placements.resize(infos.size());
+
+	std::size_t packedTexels = 0;
+	std::size_t textureTexels = 0;
+
+	for (const std::size_t i : order)
+	{
+		const DDSTextureInfo& info = infos[i];
+
+		// in grid cells, gutter included
+		const uint32_t width = (info.width + 2 * layout.gutter) / alignment;
+		const uint32_t height = (info.height + 2 * layout.gutter) / alignment;
+
+		assert((width <= gridSize) && (height <= gridSize));
+
+		Rect rect;
+		std::size_t page = 0;
+
+		while ((page < pages.size()) && !pages[page].Insert(width, height, rect))
+		{
+			++page;
+		}
+
+		if (page == pages.size())
+		{
+			pages.emplace_back(gridSize);
+			pages.back().Insert(width, height, rect);
+		}
+
+		Placement& placement = layout.placements[i];
+		placement.page = uint32_t(page);
+		placement.x = rect.x * alignment + layout.gutter;
+		placement.y = rect.y * alignment + layout.gutter;
+		placement.width = info.width;
+		placement.height = info.height;
+		placement.uvScale = XMFLOAT2(float(info.width) / settings.pageSize, float(info.height) / settings.pageSize);
+		placement.uvOffset = XMFLOAT2(float(placement.x) / settings.pageSize, float(placement.y) / settings.pageSize);
+
+		packedTexels += std::size_t(width) * height * alignment * alignment;
+		textureTexels += std::size_t(info.width) * info.height;
+	}
+
+	layout.pageCount = uint32_t(pages.size());
+
+	if (report)
+	{
+		*report = Report();
+		report->textureCount = infos.size();
+		report->textureTexels = textureTexels;
+		report->gutterTexels = packedTexels - textureTexels;
+		report->pageTexels = std::size_t(layout.pageCount) * settings.pageSize * settings.pageSize;
+		report->packSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	return layout;
+}
+
+std::vector<uint8_t> TextureAtlas::Build(const std::vector<std::string>& paths,
+										 const Settings& settings,
+										 Layout& layout,
+										 Report* report)
+{
+	struct File
+	{
+		MappedFile mapping;
+		DDSTextureInfo info;
+		const uint8_t* bitData = nullptr;
+		std::size_t bitSize = 0;
+		HRESULT result = E_FAIL;
+		std::vector<D3D11_SUBRESOURCE_DATA> subresources;
+	};
+
+	std::vector<File> files(paths.size());
+
+	ParallelFor(paths.size(), [&](const std::size_t i)
+	{
+		File& file = files[i];
+
+		if (!file.mapping.Open(paths[i]))
+		{
+			return;
+		}
+
+		file.result = GetDDSTextureInfoFromMemory(file.mapping.GetData(),
+												  file.mapping.GetSize(),
+												  &file.info,
+												  &file.bitData,
+												  &file.bitSize);
+	});
+
+	std::vector<DDSTextureInfo> infos;
+	infos.reserve(files.size());
+
+	for (File& file : files)
+	{
+		ThrowIfFailed(file.result);
+
+		file.subresources.resize(file.info.mipCount);
+		ThrowIfFailed(GetDDSSubresourceData(file.info, file.bitData, file.bitSize, file.subresources.data()));
+
+		infos.push_back(file.info);
+	}
+
+	layout = Pack(infos, settings, report);
+
+	const auto start = std::chrono::steady_clock::now();
+
+	const uint32_t blockDimension = GetBlockDimension(layout.format);
+	const std::size_t elementSize = GetElementSize(layout.format);
+
+	// the mips of every page, item major like the DDS layout; the space nothing covers stays zero
+	std::vector<std::vector<uint8_t>> levels(std::size_t(layout.pageCount) * layout.mipCount);
+	std::vector<D3D11_SUBRESOURCE_DATA> pageData(levels.size());
+
+	for (std::size_t i = 0; i < levels.size(); ++i)
+	{
+		const uint32_t elements = (layout.pageSize >> (i % layout.mipCount)) / blockDimension;
+
+		levels[i].assign(std::size_t(elements) * elements * elementSize, 0);
+
+		pageData[i].pSysMem = levels[i].data();
+		pageData[i].SysMemPitch = UINT(elements * elementSize);
+		pageData[i].SysMemSlicePitch = UINT(levels[i].size());
+	}
+
+	// placements and their gutters never overlap, so the textures can be copied concurrently
+	ParallelFor(files.size(), [&](const std::size_t i)
+	{
+		const Placement& placement = layout.placements[i];
+
+		for (uint32_t mip = 0; mip < layout.mipCount; ++mip)
+		{
+			const uint32_t shift = mip + ((blockDimension == 4) ? 2 : 0);
+
+			CopyWithGutter(files[i].subresources[mip],
+						   placement.width >> shift,
+						   placement.height >> shift,
+						   pageData[std::size_t(placement.page) * layout.mipCount + mip],
+						   placement.x >> shift,
+						   placement.y >> shift,
+						   layout.gutter >> shift,
+						   elementSize);
+		}
+	});
+
+	if (report)
+	{
+		report->buildSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	DDSTextureInfo info = {};
+	info.width = layout.pageSize;
+	info.height = layout.pageSize;
+	info.depth = 1;
+	info.mipCount = layout.mipCount;
+	info.arraySize = layout.pageCount;
+	info.format = layout.format;
+	info.resourceDimension = D3D11_RESOURCE_DIMENSION_TEXTURE2D;
+	info.isCubeMap = 0;
+
+	std::size_t size = 0;
+	ThrowIfFailed(SaveDDSTextureToMemory(info, pageData.data(), nullptr, 0, &size));
+
+	std::vector<uint8_t> result(size);
+	ThrowIfFailed(SaveDDSTextureToMemory(info, pageData.data(), result.data(), result.size(), &size));
+
+	return result;
+}
+
+void TextureAtlas::Build(const std::vector<std::string>& paths,
+						 const std::string& destinationPath,
+						 const Settings& settings,
+						 Layout& layout,
+						 Report* report)
+{
+	const std::vector<uint8_t> result = Build(paths, settings, layout, report);
+
+	std::ofstream stream(destinationPath, std::ios::binary);
+	assert(stream);
+
+	stream.write(reinterpret_cast<const char*>(result.data()), result.size());
+}
\ No newline at end of file
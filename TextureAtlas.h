@@ -0,0 +1,86 @@
+#pragma once
+
+// std
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// d3d
+#include <d3d11.h>
+#include <directxmath.h>
+#include "DDSTextureLoader11.h"
+using namespace DirectX;
+
+// packs small textures of one format into the pages of a Texture2DArray, so that hundreds of UI and
+// decal textures share one resource and one SRV. rectangles are placed with MaxRects (best short side
+// fit) on a grid aligned so every kept mip starts on a block, and each texture is surrounded by a
+// gutter of replicated edge texels that is still at least settings.gutter texels wide in the last mip
+class TextureAtlas
+{
+public:
+
+	struct Settings
+	{
+		uint32_t pageSize = 2048; // power of two
+		uint32_t gutter = 2;      // texels around each texture in the smallest mip, rounded up to whole blocks
+		uint32_t maxMipCount = 3; // fewer when the textures are too small or not aligned for that many
+	};
+
+	// where a texture landed; uvs in 0-1 map into the page with uv * uvScale + uvOffset, the positions
+	// are aligned so both stay exact in the half precision PackedMaterial
+	struct Placement
+	{
+		uint32_t page = 0;
+		uint32_t x = 0; // top level texels of the texture itself, the gutter is around it
+		uint32_t y = 0;
+		uint32_t width = 0;
+		uint32_t height = 0;
+		XMFLOAT2 uvScale = XMFLOAT2(1.0f, 1.0f);
+		XMFLOAT2 uvOffset = XMFLOAT2(0.0f, 0.0f);
+	};
+
+	struct Layout
+	{
+		DXGI_FORMAT format = DXGI_FORMAT_UNKNOWN;
+		uint32_t pageSize = 0;
+		uint32_t pageCount = 0;
+		uint32_t mipCount = 0;
+		uint32_t gutter = 0; // top level texels around each placement
+		std::vector<Placement> placements; // in the order of the textures
+	};
+
+	struct Report
+	{
+		std::size_t textureCount = 0;
+		std::size_t textureTexels = 0; // top level texels of the textures alone
+		std::size_t gutterTexels = 0;  // added around them, alignment included
+		std::size_t pageTexels = 0;
+		double packSeconds = 0.0;
+		double buildSeconds = 0.0;     // copying the texels and filling the gutters
+
+		// fraction of the pages covered by texture texels
+		double GetEfficiency() const
+		{
+			return pageTexels ? double(textureTexels) / double(pageTexels) : 0.0;
+		}
+	};
+
+	// 8 bit rgba and bgra, srgb or not, and the block compressed formats BlockDecoder knows
+	static bool IsSupportedFormat(const DXGI_FORMAT format);
+
+	// place the textures from their descriptions alone, they must all be 2D and share the format
+	static Layout Pack(const std::vector<DDSTextureInfo>& infos, const Settings& settings, Report* report = nullptr);
+
+	// pack the DDS files and copy their mips into the pages, the result is a DDS Texture2DArray
+	// with one item per page
+	static std::vector<uint8_t> Build(const std::vector<std::string>& paths,
+									  const Settings& settings,
+									  Layout& layout,
+									  Report* report = nullptr);
+
+	static void Build(const std::vector<std::string>& paths,
+					  const std::string& destinationPath,
+					  const Settings& settings,
+					  Layout& layout,
+					  Report* report = nullptr);
+};
\ No newline at end of file
@@ -0,0 +1,260 @@
+#include "UnitTest.h"
+
+// std
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <string>
+#include <vector>
+
+// d3d
+#include <directxpackedvector.h>
+
+#include "TextureAtlas.h"
+#include "Utility.h"
+
+// TextureAtlas placements checked from the descriptions alone, and one atlas built from files whose
+// texels say where they came from
+
+namespace
+{
+	DDSTextureInfo CreateInfo(const uint32_t width, const uint32_t height, const DXGI_FORMAT format, const uint32_t mipCount = 8)
+	{
+		DDSTextureInfo info = {};
+		info.width = width;
+		info.height = height;
+		info.depth = 1;
+		info.mipCount = mipCount;
+		info.arraySize = 1;
+		info.format = format;
+		info.resourceDimension = D3D11_RESOURCE_DIMENSION_TEXTURE2D;
+		info.isCubeMap = 0;
+
+		return info;
+	}
+
+	// a spread of sizes, every one a multiple of 16 so that three mips stay block aligned
+	std::vector<DDSTextureInfo> CreateInfos(const DXGI_FORMAT format)
+	{
+		std::vector<DDSTextureInfo> infos;
+		uint32_t random = 12345;
+
+		for (int i = 0; i < 96; ++i)
+		{
+			random = random * 1664525u + 1013904223u;
+			const uint32_t width = 16 * (1 + ((random >> 8) % 16));
+			const uint32_t height = 16 * (1 + ((random >> 16) % 16));
+
+			infos.push_back(CreateInfo(width, height, format));
+		}
+
+		return infos;
+	}
+
+	bool IsExactInHalf(const float value)
+	{
+		return PackedVector::XMConvertHalfToFloat(PackedVector::XMConvertFloatToHalf(value)) == value;
+	}
+
+	// every check of a layout that doesn't need the texels
+	void CheckLayout(const std::vector<DDSTextureInfo>& infos, const TextureAtlas::Settings& settings)
+	{
+		const TextureAtlas::Layout layout = TextureAtlas::Pack(infos, settings);
+		const uint32_t blockDimension = (layout.format == DXGI_FORMAT_R8G8B8A8_UNORM) ? 1 : 4;
+		const uint32_t lastMip = layout.mipCount - 1;
+
+		CHECK(layout.placements.size() == infos.size());
+		CHECK((layout.mipCount >= 1) && (layout.mipCount <= settings.maxMipCount));
+
+		// at least settings.gutter texels around each texture in the last mip, whole blocks of them
+		CHECK((layout.gutter >> lastMip) >= settings.gutter);
+		CHECK((layout.gutter >> lastMip) % blockDimension == 0);
+
+		for (std::size_t i = 0; i < infos.size(); ++i)
+		{
+			const TextureAtlas::Placement& a = layout.placements[i];
+
+			CHECK((a.width == infos[i].width) && (a.height == infos[i].height));
+			CHECK(a.page < layout.pageCount);
+
+			// the gutter stays on the page
+			CHECK((a.x >= layout.gutter) && (a.x + a.width + layout.gutter <= layout.pageSize));
+			CHECK((a.y >= layout.gutter) && (a.y + a.height + layout.gutter <= layout.pageSize));
+
+			// every kept mip starts on a block
+			CHECK((a.x >> lastMip) % blockDimension == 0);
+			CHECK((a.y >> lastMip) % blockDimension == 0);
+			CHECK((a.x % (1u << lastMip) == 0) && (a.y % (1u << lastMip) == 0));
+
+			// the transform packed into the material is what the float one is
+			CHECK(a.uvScale.x * layout.pageSize == float(a.width));
+			CHECK(a.uvScale.y * layout.pageSize == float(a.height));
+			CHECK(a.uvOffset.x * layout.pageSize == float(a.x));
+			CHECK(a.uvOffset.y * layout.pageSize == float(a.y));
+			CHECK(IsExactInHalf(a.uvScale.x) && IsExactInHalf(a.uvScale.y));
+			CHECK(IsExactInHalf(a.uvOffset.x) && IsExactInHalf(a.uvOffset.y));
+
+			// no two textures and their gutters share a texel
+			for (std::size_t j = 0; j < i; ++j)
+			{
+				const TextureAtlas::Placement& b = layout.placements[j];
+
+				const bool isOverlapping = (a.page == b.page) &&
+										   (a.x < b.x + b.width + 2 * layout.gutter) && (b.x < a.x + a.width + 2 * layout.gutter) &&
+										   (a.y < b.y + b.height + 2 * layout.gutter) && (b.y < a.y + a.height + 2 * layout.gutter);
+
+				CHECK(!isOverlapping);
+			}
+		}
+	}
+
+	void WriteFile(const std::string& path, const std::vector<uint8_t>& data)
+	{
+		std::ofstream stream(path, std::ios::binary);
+		stream.write(reinterpret_cast<const char*>(data.data()), std::streamsize(data.size()));
+	}
+
+	// an RGBA8 texel of texture id at (x, y) of mip
+	uint32_t GetTexel(const uint32_t id, const uint32_t mip, const uint32_t x, const uint32_t y)
+	{
+		return x | (y << 8) | (mip << 16) | (id << 24);
+	}
+
+	// a width x height RGBA8 DDS with mipCount mips, texels from GetTexel
+	std::vector<uint8_t> CreateDDS(const uint32_t id, const uint32_t width, const uint32_t height, const uint32_t mipCount)
+	{
+		const DDSTextureInfo info = CreateInfo(width, height, DXGI_FORMAT_R8G8B8A8_UNORM, mipCount);
+
+		std::vector<std::vector<uint32_t>> mips(mipCount);
+		std::vector<D3D11_SUBRESOURCE_DATA> subresources(mipCount);
+
+		for (uint32_t mip = 0; mip < mipCount; ++mip)
+		{
+			const uint32_t mipWidth = width >> mip;
+			const uint32_t mipHeight = height >> mip;
+
+			for (uint32_t y = 0; y < mipHeight; ++y)
+			{
+				for (uint32_t x = 0; x < mipWidth; ++x)
+				{
+					mips[mip].push_back(GetTexel(id, mip, x, y));
+				}
+			}
+
+			subresources[mip].pSysMem = mips[mip].data();
+			subresources[mip].SysMemPitch = UINT(mipWidth * 4);
+			subresources[mip].SysMemSlicePitch = UINT(mipWidth * mipHeight * 4);
+		}
+
+		std::size_t size = 0;
+		ThrowIfFailed(SaveDDSTextureToMemory(info, subresources.data(), nullptr, 0, &size));
+
+		std::vector<uint8_t> dds(size);
+		ThrowIfFailed(SaveDDSTextureToMemory(info, subresources.data(), dds.data(), dds.size(), &size));
+
+		return dds;
+	}
+}
+
+UNIT_TEST(TextureAtlasPackRGBA)
+{
+	TextureAtlas::Settings settings;
+	settings.pageSize = 1024;
+
+	CheckLayout(CreateInfos(DXGI_FORMAT_R8G8B8A8_UNORM), settings);
+}
+
+UNIT_TEST(TextureAtlasPackBlockCompressed)
+{
+	TextureAtlas::Settings settings;
+	settings.pageSize = 1024;
+
+	CheckLayout(CreateInfos(DXGI_FORMAT_BC1_UNORM), settings);
+
+	// a gutter that isn't a whole block is rounded up to one
+	settings.gutter = 1;
+	CheckLayout(CreateInfos(DXGI_FORMAT_BC3_UNORM), settings);
+}
+
+// four 100 texel textures and their 2 texel gutters fill a 256 page, the fifth starts another
+UNIT_TEST(TextureAtlasPackOverflowsToNewPage)
+{
+	TextureAtlas::Settings settings;
+	settings.pageSize = 256;
+
+	const std::vector<DDSTextureInfo> infos(5, CreateInfo(100, 100, DXGI_FORMAT_R8G8B8A8_UNORM, 1));
+
+	TextureAtlas::Report report;
+	const TextureAtlas::Layout layout = TextureAtlas::Pack(infos, settings, &report);
+
+	CHECK(layout.pageCount == 2);
+	CHECK(layout.placements[4].page == 1);
+	CHECK(std::count_if(layout.placements.begin(), layout.placements.end(), [](const TextureAtlas::Placement& p) { return p.page == 0; }) == 4);
+	CHECK(report.pageTexels == 2 * 256 * 256);
+	CHECK(report.textureTexels == 5 * 100 * 100);
+
+	CheckLayout(infos, settings);
+}
+
+// every texture lands at its placement in every mip, and each gutter texel repeats the nearest edge
+// texel of its texture
+UNIT_TEST(TextureAtlasBuildRepeatsEdges)
+{
+	const std::vector<std::string> paths = { "unittest_atlas_0.dds", "unittest_atlas_1.dds", "unittest_atlas_2.dds" };
+
+	WriteFile(paths[0], CreateDDS(0, 32, 16, 2));
+	WriteFile(paths[1], CreateDDS(1, 16, 16, 2));
+	WriteFile(paths[2], CreateDDS(2, 8, 24, 2));
+
+	TextureAtlas::Settings settings;
+	settings.pageSize = 64;
+	settings.gutter = 2;
+	settings.maxMipCount = 2;
+
+	TextureAtlas::Layout layout;
+	const std::vector<uint8_t> atlas = TextureAtlas::Build(paths, settings, layout);
+
+	DDSTextureInfo info;
+	const uint8_t* bitData = nullptr;
+	std::size_t bitSize = 0;
+	ThrowIfFailed(GetDDSTextureInfoFromMemory(atlas.data(), atlas.size(), &info, &bitData, &bitSize));
+
+	CHECK((info.width == 64) && (info.mipCount == 2) && (info.arraySize == layout.pageCount));
+
+	std::vector<D3D11_SUBRESOURCE_DATA> subresources(std::size_t(info.mipCount) * info.arraySize);
+	ThrowIfFailed(GetDDSSubresourceData(info, bitData, bitSize, subresources.data()));
+
+	for (uint32_t id = 0; id < paths.size(); ++id)
+	{
+		const TextureAtlas::Placement& placement = layout.placements[id];
+
+		for (uint32_t mip = 0; mip < layout.mipCount; ++mip)
+		{
+			const D3D11_SUBRESOURCE_DATA& page = subresources[std::size_t(placement.page) * layout.mipCount + mip];
+
+			const int width = int(placement.width >> mip);
+			const int height = int(placement.height >> mip);
+			const int gutter = int(layout.gutter >> mip);
+
+			for (int y = -gutter; y < height + gutter; ++y)
+			{
+				for (int x = -gutter; x < width + gutter; ++x)
+				{
+					const uint8_t* row = static_cast<const uint8_t*>(page.pSysMem) + std::size_t(int(placement.y >> mip) + y) * page.SysMemPitch;
+
+					uint32_t texel = 0;
+					std::memcpy(&texel, row + std::size_t(int(placement.x >> mip) + x) * 4, 4);
+
+					CHECK(texel == GetTexel(id, mip, uint32_t(std::clamp(x, 0, width - 1)), uint32_t(std::clamp(y, 0, height - 1))));
+				}
+			}
+		}
+	}
+
+	for (const std::string& path : paths)
+	{
+		std::remove(path.c_str());
+	}
+}
\ No newline at end of file
@@ -1 +1,810 @@
-#include "TextureManager.h"
\ No newline at end of file
+#include "TextureManager.h"
+
+// std
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <map>
+#include <tuple>
+
+bool TextureManager::IsArrayCompatible(const DDSTextureInfo& info)
+{
+	return (info.resourceDimension == D3D11_RESOURCE_DIMENSION_TEXTURE2D) &&
+		   (info.arraySize == 1) &&
+		   (info.isCubeMap == 0);
+}
+
+std::vector<TextureManager::TextureArrayBucket> TextureManager::PlanTextureArrays(const std::vector<DDSTextureInfo>& infos,
+																				  std::vector<std::size_t>& bucketOfTexture)
+{
+	using Key = std::tuple<DXGI_FORMAT, uint32_t, uint32_t, uint32_t>;
+
+	std::vector<TextureArrayBucket> buckets;
+	std::map<Key, std::size_t> openBuckets;
+
+	bucketOfTexture.assign(infos.size(), std::size_t(-1));
+
+	for (std::size_t i = 0; i < infos.size(); ++i)
+	{
+		const DDSTextureInfo& info = infos[i];
+
+		if (!IsArrayCompatible(info))
+		{
+			continue;
+		}
+
+		// every slice of an array shares format, size and mip count
+		const Key key = { info.format, info.width, info.height, info.mipCount };
+
+		auto it = openBuckets.find(key);
+
+		if ((it == openBuckets.end()) || (buckets[it->second].members.size() == D3D11_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION))
+		{
+			TextureArrayBucket bucket;
+			bucket.info = info;
+
+			buckets.push_back(bucket);
+			openBuckets[key] = buckets.size() - 1;
+
+			it = openBuckets.find(key);
+		}
+
+		buckets[it->second].members.push_back(i);
+		bucketOfTexture[i] = it->second;
+	}
+
+	return buckets;
+}
+
+DDSTextureInfo TextureManager::ReadTextureInfo(const std::string& path)
+{
+	MappedFile file(path);
+	ThrowIfFailed(file.IsOpen() ? S_OK : E_FAIL);
+
+	// no subresource of a CompressedTexture is decompressed, only its headers are written
+	std::vector<uint8_t> storage;
+	CompressedTexture::Report report;
+	const std::span<const uint8_t> data = ReadDDS(file, storage, UINT32_MAX, report);
+
+	DDSTextureInfo info;
+	ThrowIfFailed(GetDDSTextureInfoFromMemory(data.data(), std::min(data.size(), DDS_MAX_HEADER_SIZE), &info));
+
+	return info;
+}
+
+std::size_t TextureManager::LoadTextureAsync(const std::string& name)
+{
+	assert(!mLookup.contains(name));
+
+	if (mPlaceholderSRV.Get() == nullptr)
+	{
+		CreatePlaceholder();
+	}
+
+	const Clock::time_point now = Clock::now();
+
+	if (mAsyncLoadStats.requestCount++ == 0)
+	{
+		mFirstAsyncRequestTime = now;
+	}
+
+	mTextures.push_back(mPlaceholder);
+	mSRVs.push_back(mPlaceholderSRV);
+
+	const std::size_t texture = mTextures.size() - 1;
+	mLookup[name] = texture;
+
+	auto load = std::make_unique<AsyncLoad>();
+	load->texture = texture;
+	load->requestTime = now;
+
+	// std::function wants a copyable job, hand the load over as a raw pointer
+	GetWorkerPool().Submit([this, name, load = load.release()]()
+	{
+		const Clock::time_point start = Clock::now();
+
+		if (load->file.Open(name))
+		{
+			const uint8_t* bitData = nullptr;
+
+			load->result = GetDDSTextureInfoFromMemory(load->file.GetData(),
+													   load->file.GetSize(),
+													   &load->info,
+													   &bitData,
+													   &load->bitSize);
+
+			if (SUCCEEDED(load->result))
+			{
+				// same content key as LoadTexture
+				load->hash = HashBytes128(&load->info, sizeof(load->info));
+				load->hash = HashBytes128(bitData, load->bitSize, load->hash);
+			}
+		}
+
+		load->parseMs = std::chrono::duration<double, std::milli>(Clock::now() - start).count();
+
+		std::lock_guard<std::mutex> lock(mAsyncMutex);
+		mParsedLoads.emplace_back(load);
+	});
+
+	return texture;
+}
+
+std::size_t TextureManager::FlushAsyncLoads(const std::size_t maxCount)
+{
+	std::vector<std::unique_ptr<AsyncLoad>> loads;
+
+	{
+		std::lock_guard<std::mutex> lock(mAsyncMutex);
+
+		const std::size_t count = std::min(maxCount, mParsedLoads.size());
+
+		loads.assign(std::make_move_iterator(mParsedLoads.begin()),
+					 std::make_move_iterator(mParsedLoads.begin() + count));
+		mParsedLoads.erase(mParsedLoads.begin(), mParsedLoads.begin() + count);
+	}
+
+	for (const std::unique_ptr<AsyncLoad>& load : loads)
+	{
+		ThrowIfFailed(load->result);
+
+		++mDeduplicationStats.requestCount;
+
+		const std::size_t fileSize = load->file.GetSize();
+
+		if (const TextureContent* content = FindContent(load->hash, load->info, load->bitSize))
+		{
+			// the slot keeps its index, it just shares the resources of the first load
+			mTextures[load->texture] = mTextures[content->texture];
+			mSRVs[load->texture] = mSRVs[content->texture];
+
+			mDeduplicationStats.savedBytes += load->bitSize;
+			++mDeduplicationStats.savedSRVs;
+		}
+		else
+		{
+			CreateTexture(load->file.GetData(), fileSize, load->info, mTextures[load->texture], mSRVs[load->texture]);
+			AddContent(load->hash, load->texture, load->info, load->bitSize);
+		}
+
+		const Clock::time_point now = Clock::now();
+		const double latencyMs = std::chrono::duration<double, std::milli>(now - load->requestTime).count();
+
+		++mAsyncLoadStats.completedCount;
+		mAsyncLoadStats.bytes += fileSize;
+		mAsyncLoadStats.totalParseMs += load->parseMs;
+		mAsyncLoadStats.totalLatencyMs += latencyMs;
+		mAsyncLoadStats.maxLatencyMs = std::max(mAsyncLoadStats.maxLatencyMs, latencyMs);
+		mAsyncLoadStats.elapsedMs = std::chrono::duration<double, std::milli>(now - mFirstAsyncRequestTime).count();
+	}
+
+	return loads.size();
+}
+
+const TextureManager::TextureContent* TextureManager::FindContent(const Hash128& hash,
+																  const DDSTextureInfo& info,
+																  const std::size_t bitSize) const
+{
+	const auto it = mContentLookup.find(hash);
+
+	// the description is at hand, so it's compared too
+	if ((it != mContentLookup.end()) &&
+		(it->second.bitSize == bitSize) &&
+		(std::memcmp(&it->second.info, &info, sizeof(info)) == 0))
+	{
+		return &it->second;
+	}
+
+	return nullptr;
+}
+
+void TextureManager::AddContent(const Hash128& hash, const std::size_t texture, const DDSTextureInfo& info, const std::size_t bitSize)
+{
+	mContentLookup.emplace(hash, TextureContent{ texture, info, bitSize });
+}
+
+std::size_t TextureManager::LoadTextureStreamed(const std::string& name)
+{
+	assert(!mLookup.contains(name));
+
+	MappedFile file(name);
+	assert(file.IsOpen());
+
+	// only the headers of a CompressedTexture for now, its resident mips are decompressed once the
+	// streamer picked them
+	std::vector<uint8_t> storage;
+	std::span<const uint8_t> data = ReadDDS(file, storage, UINT32_MAX);
+
+	DDSTextureInfo info;
+	const uint8_t* bitData = nullptr;
+	std::size_t bitSize = 0;
+
+	ThrowIfFailed(GetDDSTextureInfoFromMemory(data.data(),
+											  data.size(),
+											  &info,
+											  &bitData,
+											  &bitSize));
+
+	// the subresource table already knows the byte size of every mip
+	std::vector<D3D11_SUBRESOURCE_DATA> initData(std::size_t(info.mipCount) * info.arraySize);
+	ThrowIfFailed(GetDDSSubresourceData(info, bitData, bitSize, initData.data()));
+
+	std::vector<std::size_t> mipBytes(info.mipCount, 0);
+
+	for (std::size_t i = 0; i < initData.size(); ++i)
+	{
+		mipBytes[i % info.mipCount] += initData[i].SysMemSlicePitch * std::max(1u, info.depth >> (i % info.mipCount));
+	}
+
+	const std::size_t streamed = mStreamer.AddTexture(info.width, info.height, mipBytes);
+
+	ComPtr<ID3D11Resource> pTexture;
+	ComPtr<ID3D11ShaderResourceView> pSRV;
+
+	data = ReadDDS(file, storage, mStreamer.GetResidentMip(streamed));
+
+	CreateTexture(data.data(), data.size(), info, pTexture, pSRV, mStreamer.GetResidentMip(streamed));
+
+	mTextures.push_back(pTexture);
+	mSRVs.push_back(pSRV);
+
+	const std::size_t texture = mTextures.size() - 1;
+
+	mLookup[name] = texture;
+	mStreamLookup[texture] = streamed;
+	mStreamedTextures.push_back({ texture, name, info, mipBytes });
+
+	return texture;
+}
+
+void TextureManager::RequestTextureMip(const std::size_t i, const float screenSize, const float uvSpan)
+{
+	auto streamed = mStreamLookup.find(i);
+
+	if (streamed == mStreamLookup.end())
+	{
+		return;
+	}
+
+	const DDSTextureInfo& info = mStreamedTextures[streamed->second].info;
+
+	mStreamer.RequestMip(streamed->second,
+						 TextureStreamer::ComputeRequiredMip(screenSize, uvSpan, info.width, info.height, info.mipCount));
+}
+
+std::size_t TextureManager::UpdateStreaming()
+{
+	{
+		std::lock_guard<std::mutex> lock(mAsyncMutex);
+
+		mReadyReads.insert(mReadyReads.end(),
+						   std::make_move_iterator(mFinishedReads.begin()),
+						   std::make_move_iterator(mFinishedReads.end()));
+		mFinishedReads.clear();
+	}
+
+	// swap in what the workers read, in the order they finished, until the upload budget is spent
+	const std::size_t maxUploadBytes = mStreamer.GetSettings().maxUploadBytesPerUpdate;
+
+	std::size_t uploadBytes = 0;
+	std::size_t recreatedCount = 0;
+	std::size_t readCount = 0;
+
+	for (; readCount < mReadyReads.size(); ++readCount)
+	{
+		const StreamRead& read = *mReadyReads[readCount];
+		const StreamedTexture& streamed = mStreamedTextures[read.streamed];
+
+		ThrowIfFailed(read.result);
+		AddDecompressionStats(read.report);
+
+		// a newer read of the same texture is on its way
+		if (read.generation != streamed.generation)
+		{
+			continue;
+		}
+
+		std::size_t bytes = 0;
+
+		for (uint32_t mip = read.mip; mip < streamed.mipBytes.size(); ++mip)
+		{
+			bytes += streamed.mipBytes[mip];
+		}
+
+		if ((recreatedCount > 0) && (uploadBytes + bytes > maxUploadBytes))
+		{
+			break;
+		}
+
+		// d3d11 can't resize a mip chain in place, the texture is recreated starting at the new mip and
+		// the old one is released with its last reference
+		CreateTexture(read.data.data(), read.data.size(), streamed.info, mTextures[streamed.texture], mSRVs[streamed.texture], read.mip);
+
+		uploadBytes += bytes;
+		++recreatedCount;
+	}
+
+	mReadyReads.erase(mReadyReads.begin(), mReadyReads.begin() + readCount);
+	mPendingStreamCount -= readCount;
+
+	// the streamer already counts the new mips as resident, the textures catch up once the reads are in
+	for (const TextureStreamer::ResidencyChange& change : mStreamer.Update())
+	{
+		StreamedTexture& streamed = mStreamedTextures[change.texture];
+
+		auto read = std::make_unique<StreamRead>();
+		read->streamed = change.texture;
+		read->mip = change.mip;
+		read->generation = ++streamed.generation;
+
+		++mPendingStreamCount;
+
+		// std::function wants a copyable job, hand the read over as a raw pointer
+		GetWorkerPool().Submit([this, path = streamed.path, read = read.release()]()
+		{
+			if (read->file.Open(path))
+			{
+				try
+				{
+					read->data = ReadDDS(read->file, read->storage, read->mip, read->report);
+					read->result = S_OK;
+				}
+				catch (Exception&)
+				{
+					// result stays failed, UpdateStreaming throws on the main thread
+				}
+			}
+
+			std::lock_guard<std::mutex> lock(mAsyncMutex);
+			mFinishedReads.emplace_back(read);
+		});
+	}
+
+	return recreatedCount;
+}
+
+std::size_t TextureManager::LoadVirtualTexture(const std::string& path, const VirtualTexture::Settings& settings)
+{
+	auto pVirtualTexture = std::make_unique<VirtualTextureResources>();
+
+	pVirtualTexture->file.Open(path);
+	assert(pVirtualTexture->file.IsOpen());
+
+	const VirtualTexturePageFile::Header& header = pVirtualTexture->file.GetHeader();
+	const uint32_t tileSize = header.GetBorderedTileSize();
+
+	pVirtualTexture->pageTable.Init(header.levelCount, settings);
+
+	D3D11_TEXTURE2D_DESC desc = {};
+	desc.Width = settings.slotsX * tileSize;
+	desc.Height = settings.slotsY * tileSize;
+	desc.MipLevels = 1;
+	desc.ArraySize = 1;
+	desc.Format = DXGI_FORMAT(header.format);
+	desc.SampleDesc.Count = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+	ThrowIfFailed(mDevice->CreateTexture2D(&desc, nullptr, &pVirtualTexture->pPhysical));
+	NameResource(pVirtualTexture->pPhysical.Get(), path + "Physical");
+
+	ThrowIfFailed(mDevice->CreateShaderResourceView(pVirtualTexture->pPhysical.Get(), nullptr, &pVirtualTexture->pPhysicalSRV));
+	NameResource(pVirtualTexture->pPhysicalSRV.Get(), path + "PhysicalSRV");
+
+	// a texel per tile, every level starts pointing at the pinned root page
+	std::vector<D3D11_SUBRESOURCE_DATA> initData(header.levelCount);
+
+	for (uint32_t level = 0; level < header.levelCount; ++level)
+	{
+		initData[level].pSysMem = pVirtualTexture->pageTable.GetIndirection(level).data();
+		initData[level].SysMemPitch = UINT(header.GetTilesPerSide(level) * sizeof(uint32_t));
+		initData[level].SysMemSlicePitch = 0;
+	}
+
+	desc.Width = header.GetTilesPerSide(0);
+	desc.Height = header.GetTilesPerSide(0);
+	desc.MipLevels = header.levelCount;
+	desc.Format = DXGI_FORMAT_R8G8B8A8_UINT;
+
+	ThrowIfFailed(mDevice->CreateTexture2D(&desc, initData.data(), &pVirtualTexture->pIndirection));
+	NameResource(pVirtualTexture->pIndirection.Get(), path + "Indirection");
+
+	ThrowIfFailed(mDevice->CreateShaderResourceView(pVirtualTexture->pIndirection.Get(), nullptr, &pVirtualTexture->pIndirectionSRV));
+	NameResource(pVirtualTexture->pIndirectionSRV.Get(), path + "IndirectionSRV");
+
+	mVirtualTextures.push_back(std::move(pVirtualTexture));
+
+	return mVirtualTextures.size() - 1;
+}
+
+std::size_t TextureManager::UpdateVirtualTextures()
+{
+	std::size_t uploadCount = 0;
+
+	std::vector<VirtualTexture::IndirectionUpdate> indirectionUpdates;
+
+	for (const std::unique_ptr<VirtualTextureResources>& pVirtualTexture : mVirtualTextures)
+	{
+		const VirtualTexturePageFile& file = pVirtualTexture->file;
+		const VirtualTexture& pageTable = pVirtualTexture->pageTable;
+		const uint32_t tileSize = file.GetHeader().GetBorderedTileSize();
+
+		const std::vector<VirtualTexture::Upload> uploads = pVirtualTexture->pageTable.Update(&indirectionUpdates);
+
+		for (const VirtualTexture::Upload& upload : uploads)
+		{
+			D3D11_BOX box;
+			box.left = (upload.slot % pageTable.GetSettings().slotsX) * tileSize;
+			box.top = (upload.slot / pageTable.GetSettings().slotsX) * tileSize;
+			box.front = 0;
+			box.right = box.left + tileSize;
+			box.bottom = box.top + tileSize;
+			box.back = 1;
+
+			mContext->UpdateSubresource(pVirtualTexture->pPhysical.Get(),
+										0,
+										&box,
+										file.GetTile(upload.page.level, upload.page.x, upload.page.y),
+										UINT(file.GetTileRowPitch()),
+										0);
+		}
+
+		// after the tiles, so no indirection texel points at a slot that still holds the evicted page
+		for (const VirtualTexture::IndirectionUpdate& update : indirectionUpdates)
+		{
+			const uint32_t tilesPerSide = pageTable.GetTilesPerSide(update.level);
+
+			D3D11_BOX box;
+			box.left = update.left;
+			box.top = update.top;
+			box.front = 0;
+			box.right = update.right;
+			box.bottom = update.bottom;
+			box.back = 1;
+
+			mContext->UpdateSubresource(pVirtualTexture->pIndirection.Get(),
+										update.level,
+										&box,
+										&pageTable.GetIndirection(update.level)[std::size_t(update.top) * tilesPerSide + update.left],
+										UINT(tilesPerSide * sizeof(uint32_t)),
+										0);
+		}
+
+		uploadCount += uploads.size();
+	}
+
+	return uploadCount;
+}
+
+std::size_t TextureManager::LoadTexturesIntoTexture2DArray(const std::string& name,
+														   const std::vector<std::string>& paths)
+{
+	assert(!mLookup.contains(name));
+	assert(!paths.empty());
+
+	struct File
+	{
+		MappedFile mapping;
+		std::vector<uint8_t> storage; // a decompressed CompressedTexture
+		CompressedTexture::Report report;
+		DDSTextureInfo info;
+		const uint8_t* bitData = nullptr;
+		std::size_t bitSize = 0;
+		HRESULT result = E_FAIL;
+	};
+
+	std::vector<File> files(paths.size());
+
+	// mapping, decompression and header parsing don't need the device
+	ParallelFor(paths.size(), [&](const std::size_t i)
+	{
+		File& file = files[i];
+
+		if (!file.mapping.Open(paths[i]))
+		{
+			return;
+		}
+
+		std::span<const uint8_t> data;
+
+		try
+		{
+			data = ReadDDS(file.mapping, file.storage, 0, file.report);
+		}
+		catch (Exception&)
+		{
+			return;
+		}
+
+		file.result = GetDDSTextureInfoFromMemory(data.data(),
+												  data.size(),
+												  &file.info,
+												  &file.bitData,
+												  &file.bitSize);
+	});
+
+	const DDSTextureInfo info = files[0].info;
+
+	for (const File& file : files)
+	{
+		ThrowIfFailed(file.result);
+		AddDecompressionStats(file.report);
+
+		// every slice must have the same layout as the first one, checked in release too: a slice with
+		// more mips would overrun initData and a smaller one would be read past its mapping
+		const bool isMatching = IsArrayCompatible(file.info) &&
+								(file.info.format == info.format) &&
+								(file.info.width == info.width) &&
+								(file.info.height == info.height) &&
+								(file.info.mipCount == info.mipCount);
+
+		ThrowIfFailed(isMatching ? S_OK : E_INVALIDARG);
+	}
+
+	// one subresource per mip of each slice, pointing into the mapped files
+	std::vector<D3D11_SUBRESOURCE_DATA> initData(std::size_t(info.mipCount) * files.size());
+
+	for (std::size_t i = 0; i < files.size(); ++i)
+	{
+		ThrowIfFailed(GetDDSSubresourceData(files[i].info,
+											files[i].bitData,
+											files[i].bitSize,
+											&initData[i * info.mipCount]));
+	}
+
+	D3D11_TEXTURE2D_DESC desc;
+	desc.Width = info.width;
+	desc.Height = info.height;
+	desc.MipLevels = info.mipCount;
+	desc.ArraySize = UINT(files.size());
+	desc.Format = info.format;
+	desc.SampleDesc.Count = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	desc.CPUAccessFlags = 0;
+	desc.MiscFlags = 0;
+
+	ComPtr<ID3D11Texture2D> pTextureArray;
+	ThrowIfFailed(mDevice->CreateTexture2D(&desc, initData.data(), &pTextureArray));
+	NameResource(pTextureArray.Get(), name);
+
+	// the texels live in the texture now, drop the mapped pages before creating the view
+	files.clear();
+
+	// explicit array view, the default one would be a Texture2D for single slice arrays
+	ComPtr<ID3D11ShaderResourceView> pTextureArraySRV = CreateTexture2DArraySRV(pTextureArray.Get(), desc.Format, desc.ArraySize);
+	NameResource(pTextureArraySRV.Get(), name + "SRV");
+
+	mTextures.push_back(pTextureArray);
+	mSRVs.push_back(pTextureArraySRV);
+
+	mLookup[name] = mTextures.size() - 1;
+
+	return mTextures.size() - 1;
+}
+
+std::vector<TextureManager::TextureArraySlot> TextureManager::LoadTexturesIntoArrays(const std::vector<std::string>& paths)
+{
+	std::vector<DDSTextureInfo> infos;
+	infos.reserve(paths.size());
+
+	for (const std::string& path : paths)
+	{
+		infos.push_back(ReadTextureInfo(path));
+	}
+
+	std::vector<std::size_t> bucketOfTexture;
+	const std::vector<TextureArrayBucket> buckets = PlanTextureArrays(infos, bucketOfTexture);
+
+	std::vector<TextureArraySlot> slots(paths.size());
+
+	for (const TextureArrayBucket& bucket : buckets)
+	{
+		std::vector<std::string> bucketPaths;
+		bucketPaths.reserve(bucket.members.size());
+
+		for (const std::size_t member : bucket.members)
+		{
+			bucketPaths.push_back(paths[member]);
+		}
+
+		const std::string name = "TextureArray" + std::to_string(mTextures.size());
+		const std::size_t texture = LoadTexturesIntoTexture2DArray(name, bucketPaths);
+
+		for (std::size_t slice = 0; slice < bucket.members.size(); ++slice)
+		{
+			slots[bucket.members[slice]] = { texture, slice };
+		}
+	}
+
+	for (std::size_t i = 0; i < paths.size(); ++i)
+	{
+		if (bucketOfTexture[i] == std::size_t(-1))
+		{
+			// cubemaps, volumes and arrays keep a texture of their own
+			slots[i] = { LoadTexture(paths[i]), 0 };
+		}
+
+		mSlotLookup[paths[i]] = slots[i];
+	}
+
+	return slots;
+}
+
+std::size_t TextureManager::LoadTextureAtlas(const std::string& name,
+											 const std::vector<std::string>& paths,
+											 const TextureAtlas::Settings& settings,
+											 TextureAtlas::Report* report)
+{
+	assert(!mLookup.contains(name));
+
+	TextureAtlas::Layout layout;
+	const std::vector<uint8_t> atlas = TextureAtlas::Build(paths, settings, layout, report);
+
+	DDSTextureInfo info;
+	const uint8_t* bitData = nullptr;
+	std::size_t bitSize = 0;
+
+	ThrowIfFailed(GetDDSTextureInfoFromMemory(atlas.data(), atlas.size(), &info, &bitData, &bitSize));
+
+	std::vector<D3D11_SUBRESOURCE_DATA> initData(std::size_t(info.mipCount) * info.arraySize);
+	ThrowIfFailed(GetDDSSubresourceData(info, bitData, bitSize, initData.data()));
+
+	D3D11_TEXTURE2D_DESC desc;
+	desc.Width = info.width;
+	desc.Height = info.height;
+	desc.MipLevels = info.mipCount;
+	desc.ArraySize = info.arraySize;
+	desc.Format = info.format;
+	desc.SampleDesc.Count = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	desc.CPUAccessFlags = 0;
+	desc.MiscFlags = 0;
+
+	ComPtr<ID3D11Texture2D> pAtlas;
+	ThrowIfFailed(mDevice->CreateTexture2D(&desc, initData.data(), &pAtlas));
+	NameResource(pAtlas.Get(), name);
+
+	ComPtr<ID3D11ShaderResourceView> pAtlasSRV = CreateTexture2DArraySRV(pAtlas.Get(), desc.Format, desc.ArraySize);
+	NameResource(pAtlasSRV.Get(), name + "SRV");
+
+	mTextures.push_back(pAtlas);
+	mSRVs.push_back(pAtlasSRV);
+
+	mLookup[name] = mTextures.size() - 1;
+
+	for (std::size_t i = 0; i < paths.size(); ++i)
+	{
+		const TextureAtlas::Placement& placement = layout.placements[i];
+
+		mAtlasLookup[paths[i]] = { mTextures.size() - 1, placement.page, placement.uvScale, placement.uvOffset };
+	}
+
+	return mTextures.size() - 1;
+}
+
+void TextureManager::CreateTexture(const uint8_t* ddsData,
+								   const std::size_t ddsDataSize,
+								   const DDSTextureInfo& info,
+								   ComPtr<ID3D11Resource>& pTexture,
+								   ComPtr<ID3D11ShaderResourceView>& pSRV,
+								   const uint32_t mip)
+{
+	const bool isArrayCompatible = IsArrayCompatible(info);
+
+	// the loader skips the mips larger than maxsize, 0 keeps them all
+	const std::size_t maxsize = (mip == 0) ? 0 : std::max({ info.width >> mip, info.height >> mip, 1u });
+
+	pTexture.Reset();
+	pSRV.Reset();
+
+	ThrowIfFailed(CreateDDSTextureFromMemory(mDevice.Get(),
+											 ddsData,
+											 ddsDataSize,
+											 &pTexture,
+											 isArrayCompatible ? nullptr : &pSRV,
+											 maxsize,
+											 nullptr));
+
+	if (isArrayCompatible)
+	{
+		pSRV = CreateTexture2DArraySRV(pTexture.Get(), info.format, 1);
+	}
+}
+
+std::span<const uint8_t> TextureManager::ReadDDS(const MappedFile& file, std::vector<uint8_t>& storage, const uint32_t mip)
+{
+	CompressedTexture::Report report;
+	const std::span<const uint8_t> data = ReadDDS(file, storage, mip, report);
+
+	AddDecompressionStats(report);
+
+	return data;
+}
+
+std::span<const uint8_t> TextureManager::ReadDDS(const MappedFile& file,
+												 std::vector<uint8_t>& storage,
+												 const uint32_t mip,
+												 CompressedTexture::Report& report)
+{
+	if (!CompressedTexture::IsCompressedTexture(file.GetData(), file.GetSize()))
+	{
+		return std::span<const uint8_t>(file.GetData(), file.GetSize());
+	}
+
+	storage.resize(CompressedTexture::GetDDSSize(file.GetData(), file.GetSize()));
+
+	const bool isValid = CompressedTexture::Decompress(file.GetData(), file.GetSize(), storage.data(), storage.size(), mip, &report);
+
+	ThrowIfFailed(isValid ? S_OK : E_FAIL);
+
+	return std::span<const uint8_t>(storage.data(), storage.size());
+}
+
+void TextureManager::AddDecompressionStats(const CompressedTexture::Report& report)
+{
+	mDecompressionStats.chunkCount += report.chunkCount;
+	mDecompressionStats.storedChunkCount += report.storedChunkCount;
+	mDecompressionStats.originalBytes += report.originalBytes;
+	mDecompressionStats.compressedBytes += report.compressedBytes;
+	mDecompressionStats.seconds += report.seconds;
+}
+
+WorkerPool& TextureManager::GetWorkerPool()
+{
+	if (mWorkerPool == nullptr)
+	{
+		mWorkerPool = std::make_unique<WorkerPool>();
+	}
+
+	return *mWorkerPool;
+}
+
+void TextureManager::CreatePlaceholder()
+{
+	const uint32_t white = 0xffffffff;
+
+	D3D11_TEXTURE2D_DESC desc = {};
+	desc.Width = 1;
+	desc.Height = 1;
+	desc.MipLevels = 1;
+	desc.ArraySize = 1;
+	desc.Format = DXGI_FORMAT_R8G8B8A8_UNORM;
+	desc.SampleDesc.Count = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Usage = D3D11_USAGE_IMMUTABLE;
+	desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+
+	D3D11_SUBRESOURCE_DATA initData = {};
+	initData.pSysMem = &white;
+	initData.SysMemPitch = sizeof(white);
+
+	ComPtr<ID3D11Texture2D> pPlaceholder;
+	ThrowIfFailed(mDevice->CreateTexture2D(&desc, &initData, &pPlaceholder));
+	NameResource(pPlaceholder.Get(), "TexturePlaceholder");
+
+	mPlaceholder = pPlaceholder;
+	mPlaceholderSRV = CreateTexture2DArraySRV(mPlaceholder.Get(), desc.Format, 1);
+}
+
+ComPtr<ID3D11ShaderResourceView> TextureManager::CreateTexture2DArraySRV(ID3D11Resource* pTexture,
+																		 const DXGI_FORMAT format,
+																		 const UINT arraySize)
+{
+	D3D11_SHADER_RESOURCE_VIEW_DESC desc = {};
+	desc.Format = format;
+	desc.ViewDimension = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+	desc.Texture2DArray.MostDetailedMip = 0;
+	desc.Texture2DArray.MipLevels = UINT(-1);
+	desc.Texture2DArray.FirstArraySlice = 0;
+	desc.Texture2DArray.ArraySize = arraySize;
+
+	ComPtr<ID3D11ShaderResourceView> pSRV;
+	ThrowIfFailed(mDevice->CreateShaderResourceView(pTexture, &desc, &pSRV));
+
+	return pSRV;
+}
@@ -2,6 +2,11 @@
 
 // std
 #include <cassert>
+#include <chrono>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <span>
 #include <unordered_map>
 #include <vector>
 
@@ -11,7 +16,13 @@
 using namespace DirectX;
 
 //
+#include "AssetArchive.h"
+#include "CompressedTexture.h"
+#include "TextureAtlas.h"
+#include "TextureStreamer.h"
 #include "Utility.h"
+#include "VirtualTexture.h"
+#include "VirtualTexturePageFile.h"
 
 class TextureManager
 {
@@ -24,19 +35,68 @@ public:
 		mContext = pContext;
 	}
 
+	// files with the same content (the same resource description and texels, whatever the
+	// header flavour) are aliased to the texture that was loaded first
 	std::size_t LoadTexture(const std::string& name)
+	{
+		// the header, the hash and the upload all read straight from the mapped pages,
+		// which are released when file goes out of scope; CompressedTexture files are
+		// decompressed first
+		MappedFile file(name);
+		assert(file.IsOpen());
+
+		std::vector<uint8_t> storage;
+		const std::span<const uint8_t> data = ReadDDS(file, storage);
+
+		return LoadTexture(name, data.data(), data.size());
+	}
+
+	// the DDS file is an entry of the archive, stored entries are uploaded from the archive mapping
+	std::size_t LoadTexture(const AssetArchive& archive, const std::string& name)
+	{
+		std::vector<uint8_t> storage;
+		const std::span<const uint8_t> data = archive.GetEntry(name, storage);
+		assert(!data.empty());
+
+		return LoadTexture(name, data.data(), data.size());
+	}
+
+	// ddsData is a whole DDS file, only read during the call
+	std::size_t LoadTexture(const std::string& name, const uint8_t* ddsData, const std::size_t ddsDataSize)
 	{
 		assert(!mLookup.contains(name));
 
+		++mDeduplicationStats.requestCount;
+
+		DDSTextureInfo info;
+		const uint8_t* bitData = nullptr;
+		std::size_t bitSize = 0;
+
+		ThrowIfFailed(GetDDSTextureInfoFromMemory(ddsData,
+												  ddsDataSize,
+												  &info,
+												  &bitData,
+												  &bitSize));
+
+		// hash the parsed description instead of the raw header, exporters disagree on
+		// pitchOrLinearSize, reserved fields and legacy vs DX10 headers for the same data
+		Hash128 hash = HashBytes128(&info, sizeof(info));
+		hash = HashBytes128(bitData, bitSize, hash);
+
+		if (const TextureContent* content = FindContent(hash, info, bitSize))
+		{
+			mLookup[name] = content->texture;
+
+			mDeduplicationStats.savedBytes += bitSize;
+			++mDeduplicationStats.savedSRVs;
+
+			return content->texture;
+		}
+
 		ComPtr<ID3D11Resource> pTexture;
 		ComPtr<ID3D11ShaderResourceView> pSRV;
 
-		ThrowIfFailed(CreateDDSTextureFromFile(mDevice.Get(),
-											   ToWideString(name).c_str(),
-											   &pTexture,
-											   &pSRV,
-											   0,
-											   nullptr));
+		CreateTexture(ddsData, ddsDataSize, info, pTexture, pSRV);
 
 		//NameResource(pTexture.Get(), name);
 
@@ -44,97 +104,153 @@ public:
 		mSRVs.push_back(pSRV);
 
 		mLookup[name] = mTextures.size() - 1;
+		AddContent(hash, mTextures.size() - 1, info, bitSize);
 
 		return mTextures.size() - 1;
 	}
 
-	std::size_t LoadTexturesIntoTexture2DArray(const std::string& name,
-											   const std::vector<std::string>& paths)
+	// returns the index of the texture right away, the file is mapped, parsed and hashed on a worker
+	// thread and the slot binds a 1x1 white placeholder until FlushAsyncLoads creates the texture
+	std::size_t LoadTextureAsync(const std::string& name);
+
+	// create the device resources of the loads the workers are done with, meant to run once per frame
+	// so device work happens at a frame boundary; returns how many textures became ready
+	std::size_t FlushAsyncLoads(const std::size_t maxCount = std::size_t(-1));
+
+	bool IsTextureReady(const std::size_t i) const
 	{
-		assert(!mLookup.contains(name));
+		assert(i < mSRVs.size());
+		return mSRVs[i].Get() != mPlaceholderSRV.Get();
+	}
 
-		std::vector<ComPtr<ID3D11Resource>> resources;
-		resources.resize(paths.size());
+	// load only the tail mips of the texture, UpdateStreaming brings in the larger ones as
+	// RequestTextureMip asks for them and the streaming budget allows
+	std::size_t LoadTextureStreamed(const std::string& name);
 
-		D3D11_TEXTURE2D_DESC desc;
+	// report one use of a streamed texture this frame, by the screen size in pixels of the surface
+	// and the uv range across it; textures that aren't streamed are ignored
+	void RequestTextureMip(const std::size_t i, const float screenSize, const float uvSpan);
 
-		for (std::size_t i = 0; i < paths.size(); ++i)
-		{
-			ThrowIfFailed(CreateDDSTextureFromFile(mDevice.Get(),
-												   ToWideString(paths[i]).c_str(),
-												   &resources[i],
-												   nullptr,
-												   0,
-												   nullptr));
+	// recreate the streamed textures whose reads the workers finished, as many as the streamer's upload
+	// budget allows, then turn this frame's requests into reads of the new mips on the worker threads;
+	// meant to run once per frame after the requests, returns how many textures were recreated
+	std::size_t UpdateStreaming();
 
-			D3D11_RESOURCE_DIMENSION dimension;
-			resources[i]->GetType(&dimension);
+	// reads of streamed mips that haven't replaced their texture yet
+	std::size_t GetPendingStreamCount() const
+	{
+		return mPendingStreamCount;
+	}
 
-			assert(dimension == D3D11_RESOURCE_DIMENSION_TEXTURE2D);
+	TextureStreamer& GetStreamer()
+	{
+		return mStreamer;
+	}
 
-			ID3D11Texture2D* pTexture2D = static_cast<ID3D11Texture2D*>(resources[i].Get());
+	// open a page file built by VirtualTexturePageFile and create its physical cache, settings.slotsX by
+	// slotsY bordered tiles, and its indirection texture, rgba8 uint with a mip per page table level;
+	// returns the index of the virtual texture for the calls below
+	std::size_t LoadVirtualTexture(const std::string& path, const VirtualTexture::Settings& settings = VirtualTexture::Settings());
 
-			D3D11_TEXTURE2D_DESC temp;
-			pTexture2D->GetDesc((i == 0) ? &desc : &temp);
+	// pass the feedback texels the renderer read back for a virtual texture this frame
+	void AnalyzeVirtualTextureFeedback(const std::size_t i, const uint32_t* texels, const std::size_t count)
+	{
+		assert(i < mVirtualTextures.size());
+		mVirtualTextures[i]->pageTable.AnalyzeFeedback(texels, count);
+	}
 
-			if (i != 0)
-			{
-				assert(std::memcmp(&desc, &temp, sizeof(D3D11_TEXTURE2D_DESC)) == 0);
-			}
-		}
+	// copy the tiles the page tables asked for into the physical caches and update the indirection
+	// textures, meant to run once per frame after the feedback; returns how many tiles were copied
+	std::size_t UpdateVirtualTextures();
 
-		ComPtr<ID3D11Texture2D> pTextureArray;
-		ComPtr<ID3D11ShaderResourceView> pTextureArraySRV;
+	const VirtualTexture& GetVirtualTexture(const std::size_t i) const
+	{
+		assert(i < mVirtualTextures.size());
+		return mVirtualTextures[i]->pageTable;
+	}
 
-		desc.ArraySize = UINT(resources.size());
-		desc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+	std::size_t GetVirtualTextureCount() const
+	{
+		return mVirtualTextures.size();
+	}
 
-		ThrowIfFailed(mDevice->CreateTexture2D(&desc, nullptr, &pTextureArray));
-		NameResource(pTextureArray.Get(), name);
+	ID3D11ShaderResourceView* GetVirtualTexturePhysicalSRV(const std::size_t i)
+	{
+		assert(i < mVirtualTextures.size());
+		return mVirtualTextures[i]->pPhysicalSRV.Get();
+	}
 
-		for (UINT arraySlice = 0; arraySlice < desc.ArraySize; ++arraySlice)
-		{
-			const ComPtr<ID3D11Resource>& resource = resources[arraySlice];
-
-			for (UINT mipSlice = 0; mipSlice < desc.MipLevels; ++mipSlice)
-			{
-				//D3D11_MAPPED_SUBRESOURCE mapped;
-				//ThrowIfFailed(mContext->Map(resource.Get(), mipSlice, D3D11_MAP_READ, 0, &mapped));
-
-				const UINT subresource = D3D11CalcSubresource(mipSlice,
-															  arraySlice,
-															  desc.MipLevels);
-
-				//mContext->UpdateSubresource(pTextureArray.Get(),
-				//							subresource,
-				//							nullptr,
-				//							mapped.pData,
-				//							mapped.RowPitch,
-				//							mapped.DepthPitch);
-
-				//mContext->Unmap(resource.Get(), mipSlice);
-
-				mContext->CopySubresourceRegion(pTextureArray.Get(),
-												subresource,
-												0,
-												0,
-												0,
-												resource.Get(),
-												mipSlice,
-												nullptr);
-			}
+	ID3D11ShaderResourceView* GetVirtualTextureIndirectionSRV(const std::size_t i)
+	{
+		assert(i < mVirtualTextures.size());
+		return mVirtualTextures[i]->pIndirectionSRV.Get();
+	}
 
-		}
+	// build a Texture2DArray out of DDS files that share format, size and mip count; the files are read
+	// mapped, CompressedTexture files decompressed, and parsed in parallel and the array is created in
+	// one call straight from the mapped pages or the decompressed copies
+	std::size_t LoadTexturesIntoTexture2DArray(const std::string& name,
+											   const std::vector<std::string>& paths);
 
-		mDevice->CreateShaderResourceView(pTextureArray.Get(), nullptr, &pTextureArraySRV);
-		NameResource(pTextureArraySRV.Get(), name + "SRV");
+	// where a texture ended up once grouped into a Texture2DArray
+	struct TextureArraySlot
+	{
+		std::size_t texture = std::size_t(-1); // index of the array for GetTexture/GetSRV
+		std::size_t slice = 0;
+	};
 
-		mTextures.push_back(pTextureArray);
-		mSRVs.push_back(pTextureArraySRV);
+	// textures that can share one Texture2DArray
+	struct TextureArrayBucket
+	{
+		DDSTextureInfo info;
+		std::vector<std::size_t> members; // indices into the planned textures, in slice order
+	};
 
-		mLookup[name] = mTextures.size() - 1;
+	// textures that are a single, non cube, 2D texture can be a slice of an array
+	static bool IsArrayCompatible(const DDSTextureInfo& info);
 
-		return mTextures.size() - 1;
+	// group the textures by format, size and mip count, splitting the groups that exceed the maximum
+	// array size; bucketOfTexture receives the bucket of each texture, or -1 if it can't be in an array
+	static std::vector<TextureArrayBucket> PlanTextureArrays(const std::vector<DDSTextureInfo>& infos,
+															 std::vector<std::size_t>& bucketOfTexture);
+
+	// parse only the header of a DDS file, or of the DDS file in a CompressedTexture
+	static DDSTextureInfo ReadTextureInfo(const std::string& path);
+
+	// load the textures into as few Texture2DArrays as their formats and sizes allow, so that
+	// materials can switch textures by slice index without rebinding SRVs
+	std::vector<TextureArraySlot> LoadTexturesIntoArrays(const std::vector<std::string>& paths);
+
+	TextureArraySlot GetTextureArraySlot(const std::string& name) const
+	{
+		auto i = mSlotLookup.find(name);
+		assert(i != mSlotLookup.end());
+
+		return i->second;
+	}
+
+	// pack small textures of one format into the pages of a single Texture2DArray, see TextureAtlas;
+	// returns the index of the array, GetAtlasSlot tells where each path ended up
+	std::size_t LoadTextureAtlas(const std::string& name,
+								 const std::vector<std::string>& paths,
+								 const TextureAtlas::Settings& settings = TextureAtlas::Settings(),
+								 TextureAtlas::Report* report = nullptr);
+
+	// the page is the slice of the array, uvScale and uvOffset go to MaterialManager::ApplyAtlasPlacement
+	struct AtlasSlot
+	{
+		std::size_t texture = std::size_t(-1);
+		std::size_t slice = 0;
+		XMFLOAT2 uvScale = XMFLOAT2(1.0f, 1.0f);
+		XMFLOAT2 uvOffset = XMFLOAT2(0.0f, 0.0f);
+	};
+
+	AtlasSlot GetAtlasSlot(const std::string& path) const
+	{
+		auto i = mAtlasLookup.find(path);
+		assert(i != mAtlasLookup.end());
+
+		return i->second;
 	}
 
 	ID3D11Resource* GetTexture(const std::size_t i)
@@ -149,13 +265,175 @@ public:
 		return mSRVs[i].Get();
 	}
 
+	struct DeduplicationStats
+	{
+		std::size_t requestCount = 0; // LoadTexture calls
+		std::size_t savedBytes = 0;   // texel bytes not uploaded thanks to aliasing
+		std::size_t savedSRVs = 0;    // resources and SRVs not created, each one a distinct bind avoided
+	};
+
+	const DeduplicationStats& GetDeduplicationStats() const
+	{
+		return mDeduplicationStats;
+	}
+
+	std::size_t GetTextureCount() const
+	{
+		return mTextures.size();
+	}
+
+	struct AsyncLoadStats
+	{
+		std::size_t requestCount = 0;   // LoadTextureAsync calls
+		std::size_t completedCount = 0; // loads that replaced their placeholder
+		std::size_t bytes = 0;          // file bytes of the completed loads
+		double totalParseMs = 0.0;      // worker time spent mapping, parsing and hashing
+		double totalLatencyMs = 0.0;    // request to ready, summed over the completed loads
+		double maxLatencyMs = 0.0;
+		double elapsedMs = 0.0;         // first request to last completion, for throughput
+
+		std::size_t GetPendingCount() const { return requestCount - completedCount; }
+		double GetAverageLatencyMs() const { return completedCount ? totalLatencyMs / completedCount : 0.0; }
+		double GetThroughputMBs() const { return (elapsedMs > 0.0) ? (bytes / (1024.0 * 1024.0)) / (elapsedMs / 1000.0) : 0.0; }
+	};
+
+	const AsyncLoadStats& GetAsyncLoadStats() const
+	{
+		return mAsyncLoadStats;
+	}
+
+	// totals over the CompressedTexture files loaded so far
+	const CompressedTexture::Report& GetDecompressionStats() const
+	{
+		return mDecompressionStats;
+	}
+
 private:
 
+	using Clock = std::chrono::steady_clock;
+
+	// everything a worker produces for one async load, the mapping stays alive until the upload
+	struct AsyncLoad
+	{
+		std::size_t texture = 0;
+		MappedFile file;
+		DDSTextureInfo info;
+		std::size_t bitSize = 0;
+		Hash128 hash;
+		HRESULT result = E_FAIL;
+		Clock::time_point requestTime;
+		double parseMs = 0.0;
+	};
+
+	// plain 2D textures get a single slice array view, so they can be bound
+	// to the Texture2DArray slots material textures are sampled from
+	// mip is the most detailed one to create, the ones above it are skipped
+	void CreateTexture(const uint8_t* ddsData,
+					   const std::size_t ddsDataSize,
+					   const DDSTextureInfo& info,
+					   ComPtr<ID3D11Resource>& pTexture,
+					   ComPtr<ID3D11ShaderResourceView>& pSRV,
+					   const uint32_t mip = 0);
+
+	// the DDS file as is, or for a CompressedTexture the subresources from mip on decompressed into storage
+	std::span<const uint8_t> ReadDDS(const MappedFile& file, std::vector<uint8_t>& storage, const uint32_t mip = 0);
+
+	// same, safe to call from any thread: what was decompressed goes to report rather than to the stats
+	static std::span<const uint8_t> ReadDDS(const MappedFile& file,
+											std::vector<uint8_t>& storage,
+											const uint32_t mip,
+											CompressedTexture::Report& report);
+
+	void AddDecompressionStats(const CompressedTexture::Report& report);
+
+	void CreatePlaceholder();
+
+	// what a texture was created from, keyed by the 128 bit hash of its description and texels; nothing
+	// of the file is kept, the hash is wide enough to stand for the bytes
+	struct TextureContent
+	{
+		std::size_t texture = 0;
+		DDSTextureInfo info;
+		std::size_t bitSize = 0;
+	};
+
+	// the texture with the same description and texels, nullptr if there's none
+	const TextureContent* FindContent(const Hash128& hash, const DDSTextureInfo& info, const std::size_t bitSize) const;
+
+	void AddContent(const Hash128& hash, const std::size_t texture, const DDSTextureInfo& info, const std::size_t bitSize);
+
+	ComPtr<ID3D11ShaderResourceView> CreateTexture2DArraySRV(ID3D11Resource* pTexture,
+															 const DXGI_FORMAT format,
+															 const UINT arraySize);
+
 	ComPtr<ID3D11Device> mDevice;
 	ComPtr<ID3D11DeviceContext> mContext;
 
 	std::unordered_map<std::string, std::size_t> mLookup;
+	std::unordered_map<Hash128, TextureContent> mContentLookup;
+	std::unordered_map<std::string, TextureArraySlot> mSlotLookup;
+	std::unordered_map<std::string, AtlasSlot> mAtlasLookup;
 
 	std::vector<ComPtr<ID3D11Resource>> mTextures;
 	std::vector<ComPtr<ID3D11ShaderResourceView>> mSRVs;
+
+	DeduplicationStats mDeduplicationStats;
+
+	// what it takes to recreate a streamed texture from its file
+	struct StreamedTexture
+	{
+		std::size_t texture = 0;
+		std::string path;
+		DDSTextureInfo info;
+		std::vector<std::size_t> mipBytes;
+		uint64_t generation = 0; // of the newest read, the older ones are dropped when they finish
+	};
+
+	// the chain from mip on of a streamed texture, read by a worker; the mapping or the decompressed
+	// copy stays alive until the texture is recreated from it
+	struct StreamRead
+	{
+		std::size_t streamed = 0;
+		uint32_t mip = 0;
+		uint64_t generation = 0;
+		MappedFile file;
+		std::vector<uint8_t> storage;
+		std::span<const uint8_t> data;
+		CompressedTexture::Report report;
+		HRESULT result = E_FAIL;
+	};
+
+	WorkerPool& GetWorkerPool();
+
+	TextureStreamer mStreamer;
+	std::vector<StreamedTexture> mStreamedTextures; // indexed like the streamer textures
+	std::unordered_map<std::size_t, std::size_t> mStreamLookup; // texture index to streamer index
+
+	// the tiles are read from the mapped page file as they are copied
+	struct VirtualTextureResources
+	{
+		VirtualTexturePageFile file;
+		VirtualTexture pageTable;
+		ComPtr<ID3D11Texture2D> pPhysical;
+		ComPtr<ID3D11ShaderResourceView> pPhysicalSRV;
+		ComPtr<ID3D11Texture2D> pIndirection;
+		ComPtr<ID3D11ShaderResourceView> pIndirectionSRV;
+	};
+
+	std::vector<std::unique_ptr<VirtualTextureResources>> mVirtualTextures;
+
+	ComPtr<ID3D11Resource> mPlaceholder;
+	ComPtr<ID3D11ShaderResourceView> mPlaceholderSRV;
+
+	std::mutex mAsyncMutex;
+	std::vector<std::unique_ptr<AsyncLoad>> mParsedLoads; // guarded by mAsyncMutex
+	std::vector<std::unique_ptr<StreamRead>> mFinishedReads; // guarded by mAsyncMutex
+	std::vector<std::unique_ptr<StreamRead>> mReadyReads;    // finished, waiting for upload budget
+	std::size_t mPendingStreamCount = 0;
+	AsyncLoadStats mAsyncLoadStats;
+	CompressedTexture::Report mDecompressionStats;
+	Clock::time_point mFirstAsyncRequestTime;
+
+	// last, so the workers are joined before anything they touch is destroyed
+	std::unique_ptr<WorkerPool> mWorkerPool;
 };
\ No newline at end of file
@@ -0,0 +1,353 @@
+#include "UnitTest.h"
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "RenderDeviceNull.h"
+#include "TextureManager.h"
+
+// TextureManager on the null device, and the parts of it that only read DDS headers
+
+namespace
+{
+	// a width x height DDS of arraySize items with mipCount mips, 0 for a full chain; RGBA8 texels are
+	// fill, the blocks of other formats fill's bytes repeated
+	std::vector<uint8_t> CreateDDS(const uint32_t width,
+								   const uint32_t height,
+								   const uint32_t fill,
+								   const DXGI_FORMAT format = DXGI_FORMAT_R8G8B8A8_UNORM,
+								   const uint32_t mipCount = 0,
+								   const uint32_t arraySize = 1)
+	{
+		DDSTextureInfo info;
+		info.width = width;
+		info.height = height;
+		info.depth = 1;
+		info.mipCount = mipCount;
+		info.arraySize = arraySize;
+		info.format = format;
+		info.resourceDimension = D3D11_RESOURCE_DIMENSION_TEXTURE2D;
+		info.isCubeMap = 0;
+
+		if (info.mipCount == 0)
+		{
+			info.mipCount = 1;
+
+			while ((std::max(width, height) >> info.mipCount) != 0)
+			{
+				++info.mipCount;
+			}
+		}
+
+		// every subresource reads from the top mip's bytes, they're the largest
+		std::size_t topBytes = 0;
+		ThrowIfFailed(GetDDSSurfaceInfo(width, height, format, &topBytes, nullptr, nullptr));
+
+		std::vector<uint32_t> bytes((topBytes + 3) / 4, fill);
+		std::vector<D3D11_SUBRESOURCE_DATA> subresources(std::size_t(info.mipCount) * arraySize);
+
+		for (uint32_t item = 0; item < arraySize; ++item)
+		{
+			for (uint32_t mip = 0; mip < info.mipCount; ++mip)
+			{
+				std::size_t numBytes = 0;
+				std::size_t rowBytes = 0;
+				ThrowIfFailed(GetDDSSurfaceInfo(std::max(1u, width >> mip), std::max(1u, height >> mip), format, &numBytes, &rowBytes, nullptr));
+
+				D3D11_SUBRESOURCE_DATA& subresource = subresources[item * info.mipCount + mip];
+				subresource.pSysMem = bytes.data();
+				subresource.SysMemPitch = UINT(rowBytes);
+				subresource.SysMemSlicePitch = UINT(numBytes);
+			}
+		}
+
+		std::size_t size = 0;
+		ThrowIfFailed(SaveDDSTextureToMemory(info, subresources.data(), nullptr, 0, &size));
+
+		std::vector<uint8_t> dds(size);
+		ThrowIfFailed(SaveDDSTextureToMemory(info, subresources.data(), dds.data(), dds.size(), &size));
+
+		return dds;
+	}
+
+	// what ReadTextureInfo gets out of a file, parsed from its first DDS_MAX_HEADER_SIZE bytes
+	DDSTextureInfo ReadHeader(const std::vector<uint8_t>& dds)
+	{
+		DDSTextureInfo info;
+		ThrowIfFailed(GetDDSTextureInfoFromMemory(dds.data(), std::min(dds.size(), DDS_MAX_HEADER_SIZE), &info));
+
+		return info;
+	}
+
+	void WriteFile(const std::string& path, const std::vector<uint8_t>& data)
+	{
+		std::ofstream stream(path, std::ios::binary);
+		stream.write(reinterpret_cast<const char*>(data.data()), std::streamsize(data.size()));
+	}
+
+	struct NullTextureManager
+	{
+		NullTextureManager()
+		{
+			RenderDeviceNull::CreateDevice(device, context);
+			textureManager.Init(device, context);
+		}
+
+		ComPtr<ID3D11Device> device;
+		ComPtr<ID3D11DeviceContext> context;
+		TextureManager textureManager;
+	};
+}
+
+UNIT_TEST(TextureDeduplication)
+{
+	NullTextureManager null;
+	TextureManager& textureManager = null.textureManager;
+
+	const std::vector<uint8_t> a = CreateDDS(16, 16, 0xff0000ffu);
+	const std::vector<uint8_t> b = CreateDDS(16, 16, 0xff00ff00u);
+	const std::vector<uint8_t> c = CreateDDS(16, 8, 0xff0000ffu);
+
+	const std::size_t first = textureManager.LoadTexture("a", a.data(), a.size());
+
+	// same content under another name, a copy of the buffer so only the bytes are the same
+	const std::vector<uint8_t> aCopy = a;
+	CHECK(textureManager.LoadTexture("a copy", aCopy.data(), aCopy.size()) == first);
+
+	// other texels, other description
+	CHECK(textureManager.LoadTexture("b", b.data(), b.size()) != first);
+	CHECK(textureManager.LoadTexture("c", c.data(), c.size()) != first);
+
+	const TextureManager::DeduplicationStats& stats = textureManager.GetDeduplicationStats();
+	CHECK(stats.requestCount == 4);
+	CHECK(stats.savedSRVs == 1);
+}
+
+// nothing of the first file is kept, the later ones alias it by the hash of their content
+UNIT_TEST(TextureDeduplicationFromFiles)
+{
+	NullTextureManager null;
+	TextureManager& textureManager = null.textureManager;
+
+	const std::string a = "unittest_dedup_a.dds";
+	const std::string b = "unittest_dedup_b.dds";
+	const std::string c = "unittest_dedup_c.dds";
+
+	WriteFile(a, CreateDDS(32, 32, 0xff102030u));
+	WriteFile(b, CreateDDS(32, 32, 0xff102030u));
+	WriteFile(c, CreateDDS(32, 32, 0xff102031u));
+
+	const std::size_t first = textureManager.LoadTexture(a);
+	CHECK(textureManager.LoadTexture(b) == first);
+	CHECK(textureManager.LoadTexture(c) != first);
+
+	std::remove(a.c_str());
+	std::remove(b.c_str());
+	std::remove(c.c_str());
+}
+
+UNIT_TEST(TextureArrayPlanBuckets)
+{
+	const std::vector<DDSTextureInfo> infos =
+	{
+		ReadHeader(CreateDDS(64, 64, 1)),                                    // 0 rgba8 64x64 full chain
+		ReadHeader(CreateDDS(64, 64, 2, DXGI_FORMAT_BC1_UNORM)),             // 1 other format
+		ReadHeader(CreateDDS(64, 64, 3)),                                    // 2 same as 0
+		ReadHeader(CreateDDS(32, 64, 4)),                                    // 3 other width
+		ReadHeader(CreateDDS(64, 64, 5, DXGI_FORMAT_R8G8B8A8_UNORM, 1)),     // 4 other mip count
+		ReadHeader(CreateDDS(64, 64, 6, DXGI_FORMAT_R8G8B8A8_UNORM, 0, 2)),  // 5 already an array
+		ReadHeader(CreateDDS(64, 64, 7, DXGI_FORMAT_BC1_UNORM)),             // 6 same as 1
+		ReadHeader(CreateDDS(64, 32, 8)),                                    // 7 other height
+	};
+
+	CHECK(infos[0].mipCount == 7);
+	CHECK(infos[5].arraySize == 2);
+
+	std::vector<std::size_t> bucketOfTexture;
+	const std::vector<TextureManager::TextureArrayBucket> buckets = TextureManager::PlanTextureArrays(infos, bucketOfTexture);
+
+	CHECK(buckets.size() == 5);
+	CHECK(bucketOfTexture.size() == infos.size());
+
+	CHECK(bucketOfTexture[0] == bucketOfTexture[2]);
+	CHECK(bucketOfTexture[1] == bucketOfTexture[6]);
+	CHECK(bucketOfTexture[0] != bucketOfTexture[1]);
+	CHECK(bucketOfTexture[3] != bucketOfTexture[0]);
+	CHECK(bucketOfTexture[4] != bucketOfTexture[0]);
+	CHECK(bucketOfTexture[7] != bucketOfTexture[0]);
+	CHECK(bucketOfTexture[7] != bucketOfTexture[3]);
+	CHECK(bucketOfTexture[5] == std::size_t(-1));
+
+	// slices in the order the textures came in
+	const TextureManager::TextureArrayBucket& bucket = buckets[bucketOfTexture[0]];
+	CHECK((bucket.members.size() == 2) && (bucket.members[0] == 0) && (bucket.members[1] == 2));
+	CHECK((bucket.info.format == DXGI_FORMAT_R8G8B8A8_UNORM) && (bucket.info.width == 64) && (bucket.info.mipCount == 7));
+}
+
+UNIT_TEST(TextureArrayPlanSplitsFullArrays)
+{
+	const std::vector<DDSTextureInfo> infos(D3D11_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION + 1, ReadHeader(CreateDDS(4, 4, 1, DXGI_FORMAT_BC1_UNORM)));
+
+	std::vector<std::size_t> bucketOfTexture;
+	const std::vector<TextureManager::TextureArrayBucket> buckets = TextureManager::PlanTextureArrays(infos, bucketOfTexture);
+
+	CHECK(buckets.size() == 2);
+	CHECK(buckets[0].members.size() == D3D11_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION);
+	CHECK((buckets[1].members.size() == 1) && (buckets[1].members[0] == D3D11_REQ_TEXTURE2D_ARRAY_AXIS_DIMENSION));
+	CHECK(bucketOfTexture.back() == 1);
+}
+
+// slices that don't match the first one fail before anything is read from them
+UNIT_TEST(TextureArrayRejectsMismatchedSlices)
+{
+	const std::string a = "unittest_array_a.dds";
+	const std::string b = "unittest_array_b.dds";
+
+	const auto Load = [&](const std::vector<uint8_t>& first, const std::vector<uint8_t>& second) -> bool
+	{
+		NullTextureManager null;
+
+		WriteFile(a, first);
+		WriteFile(b, second);
+
+		try
+		{
+			null.textureManager.LoadTexturesIntoTexture2DArray("array", { a, b });
+			return true;
+		}
+		catch (Exception&)
+		{
+			return false;
+		}
+	};
+
+	const std::vector<uint8_t> base = CreateDDS(32, 32, 1);
+
+	CHECK(Load(base, CreateDDS(32, 32, 2)));
+	CHECK(!Load(base, CreateDDS(16, 32, 2)));
+	CHECK(!Load(base, CreateDDS(32, 16, 2)));
+	CHECK(!Load(base, CreateDDS(32, 32, 2, DXGI_FORMAT_BC1_UNORM)));
+	CHECK(!Load(base, CreateDDS(32, 32, 2, DXGI_FORMAT_R8G8B8A8_UNORM, 3)));
+
+	// more mips than the first would write past the subresource table
+	CHECK(!Load(CreateDDS(32, 32, 1, DXGI_FORMAT_R8G8B8A8_UNORM, 3), base));
+
+	// nor can the first one be an array itself
+	CHECK(!Load(CreateDDS(32, 32, 1, DXGI_FORMAT_R8G8B8A8_UNORM, 0, 2), base));
+
+	std::remove(a.c_str());
+	std::remove(b.c_str());
+}
+
+// CompressedTexture files are decompressed into the array like the DDS files next to them, and their
+// headers are read through the container when the arrays are planned
+UNIT_TEST(TextureArrayFromCompressedTextures)
+{
+	const std::string a = "unittest_array_a.ctex";
+	const std::string b = "unittest_array_b.dds";
+	const std::string c = "unittest_array_c.ctex";
+
+	const std::vector<uint8_t> dds = CreateDDS(64, 64, 0x01020304);
+	WriteFile(a, CompressedTexture::Compress(dds.data(), dds.size(), CompressedTexture::Settings()));
+	WriteFile(b, CreateDDS(64, 64, 0x05060708));
+	WriteFile(c, CompressedTexture::Compress(dds.data(), dds.size(), CompressedTexture::Settings()));
+
+	const DDSTextureInfo info = TextureManager::ReadTextureInfo(a);
+	CHECK((info.width == 64) && (info.height == 64) && (info.mipCount == 7));
+	CHECK(info.format == DXGI_FORMAT_R8G8B8A8_UNORM);
+
+	NullTextureManager null;
+	TextureManager& textureManager = null.textureManager;
+
+	const std::vector<TextureManager::TextureArraySlot> slots = textureManager.LoadTexturesIntoArrays({ a, b, c });
+	CHECK(slots.size() == 3);
+
+	for (std::size_t i = 0; i < slots.size(); ++i)
+	{
+		CHECK((slots[i].texture == slots[0].texture) && (slots[i].slice == i));
+	}
+
+	D3D11_TEXTURE2D_DESC desc;
+	static_cast<ID3D11Texture2D*>(textureManager.GetTexture(slots[0].texture))->GetDesc(&desc);
+	CHECK((desc.ArraySize == 3) && (desc.MipLevels == 7) && (desc.Width == 64));
+
+	// the texels of both containers were decompressed, the plain DDS file counts nothing
+	DDSTextureInfo ddsInfo;
+	const uint8_t* bitData = nullptr;
+	std::size_t bitSize = 0;
+	ThrowIfFailed(GetDDSTextureInfoFromMemory(dds.data(), dds.size(), &ddsInfo, &bitData, &bitSize));
+
+	const CompressedTexture::Report& stats = textureManager.GetDecompressionStats();
+	CHECK(stats.chunkCount > 0);
+	CHECK(stats.originalBytes == 2 * bitSize);
+
+	std::remove(a.c_str());
+	std::remove(b.c_str());
+	std::remove(c.c_str());
+}
+
+// mips stream in on the worker threads and replace the texture a frame or more later, no more than the
+// upload budget a frame
+UNIT_TEST(TextureStreamingAsync)
+{
+	const std::string a = "unittest_stream_a.dds";
+	const std::string b = "unittest_stream_b.ctex";
+
+	const std::vector<uint8_t> dds = CreateDDS(256, 256, 0x01020304);
+	WriteFile(a, dds);
+	WriteFile(b, CompressedTexture::Compress(dds.data(), dds.size(), CompressedTexture::Settings()));
+
+	NullTextureManager null;
+	TextureManager& textureManager = null.textureManager;
+
+	// a byte of budget, one texture a frame
+	TextureStreamer::Settings settings;
+	settings.maxUploadBytesPerUpdate = 1;
+	textureManager.GetStreamer().SetSettings(settings);
+
+	const std::size_t textures[] = { textureManager.LoadTextureStreamed(a), textureManager.LoadTextureStreamed(b) };
+
+	const auto GetWidth = [&](const std::size_t texture)
+	{
+		D3D11_TEXTURE2D_DESC desc;
+		static_cast<ID3D11Texture2D*>(textureManager.GetTexture(texture))->GetDesc(&desc);
+		return desc.Width;
+	};
+
+	CHECK((GetWidth(textures[0]) == 64) && (GetWidth(textures[1]) == 64));
+
+	for (const std::size_t texture : textures)
+	{
+		textureManager.RequestTextureMip(texture, 1024.0f, 1.0f);
+	}
+
+	// the reads are only submitted, nothing changes this frame
+	CHECK(textureManager.UpdateStreaming() == 0);
+	CHECK(textureManager.GetPendingStreamCount() == 2);
+	CHECK((GetWidth(textures[0]) == 64) && (GetWidth(textures[1]) == 64));
+
+	std::size_t recreatedCount = 0;
+
+	for (int frame = 0; (frame < 10000) && (textureManager.GetPendingStreamCount() > 0); ++frame)
+	{
+		const std::size_t count = textureManager.UpdateStreaming();
+		CHECK(count <= 1);
+
+		recreatedCount += count;
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+	}
+
+	CHECK(recreatedCount == 2);
+	CHECK((GetWidth(textures[0]) == 256) && (GetWidth(textures[1]) == 256));
+	CHECK(textureManager.GetDecompressionStats().chunkCount > 0);
+
+	std::remove(a.c_str());
+	std::remove(b.c_str());
+}
\ No newline at end of file
@@ -0,0 +1,210 @@
+#include "TextureStreamer.h"
+
+// std
+#include <algorithm>
+#include <cmath>
+
+std::size_t TextureStreamer::AddTexture(const uint32_t width, const uint32_t height, const std::vector<std::size_t>& mipBytes)
+{
+	assert(!mipBytes.empty());
+
+	Texture texture;
+	texture.chainBytes.resize(mipBytes.size());
+
+	std::size_t chainBytes = 0;
+
+	for (std::size_t mip = mipBytes.size(); mip-- > 0;)
+	{
+		chainBytes += mipBytes[mip];
+		texture.chainBytes[mip] = chainBytes;
+	}
+
+	const uint32_t lastMip = uint32_t(mipBytes.size() - 1);
+
+	while ((texture.tailMip < lastMip) && (std::max(width >> texture.tailMip, height >> texture.tailMip) > mSettings.tailSize))
+	{
+		++texture.tailMip;
+	}
+
+	texture.residentMip = texture.tailMip;
+	texture.requestedMip = texture.tailMip;
+
+	// the tail is resident for good, even when it doesn't fit in the budget
+	mStats.residentBytes += texture.chainBytes[texture.tailMip];
+
+	mTextures.push_back(std::move(texture));
+
+	return mTextures.size() - 1;
+}
+
+void TextureStreamer::RequestMip(const std::size_t texture, const uint32_t mip)
+{
+	assert(texture < mTextures.size());
+
+	Texture& t = mTextures[texture];
+
+	t.requestedMip = std::min(t.requestedMip, mip);
+	t.lastUsedFrame = mFrame;
+}
+
+uint32_t TextureStreamer::ComputeRequiredMip(const float screenSize,
+											 const float uvSpan,
+											 const uint32_t width,
+											 const uint32_t height,
+											 const uint32_t mipCount)
+{
+	assert(mipCount > 0);
+
+	const float texels = uvSpan * float(std::max(width, height));
+
+	if ((screenSize <= 0.0f) || (texels <= screenSize))
+	{
+		return (screenSize <= 0.0f) ? (mipCount - 1) : 0;
+	}
+
+	// each mip halves the texels covering the same pixels
+	const uint32_t mip = uint32_t(std::floor(std::log2(texels / screenSize)));
+
+	return std::min(mip, mipCount - 1);
+}
+
+float TextureStreamer::ComputeScreenSize(const float radius,
+										 const float distance,
+										 const float fovY,
+										 const float viewportHeight)
+{
+	if (distance <= radius)
+	{
+		return viewportHeight;
+	}
+
+	return std::min(viewportHeight, viewportHeight * radius / (distance * std::tan(0.5f * fovY)));
+}
+
+std::vector<TextureStreamer::ResidencyChange> TextureStreamer::Update()
+{
+	std::vector<ResidencyChange> changes;
+
+	// textures that want more detail than they have, the largest deficit first
+	std::vector<std::size_t> candidates;
+
+	for (std::size_t i = 0; i < mTextures.size(); ++i)
+	{
+		if (mTextures[i].requestedMip < mTextures[i].residentMip)
+		{
+			candidates.push_back(i);
+		}
+	}
+
+	std::sort(candidates.begin(), candidates.end(), [this](const std::size_t a, const std::size_t b)
+	{
+		return (mTextures[a].residentMip - mTextures[a].requestedMip) > (mTextures[b].residentMip - mTextures[b].requestedMip);
+	});
+
+	if (candidates.size() > mSettings.maxChangesPerUpdate)
+	{
+		candidates.resize(mSettings.maxChangesPerUpdate);
+	}
+
+	for (const std::size_t i : candidates)
+	{
+		Texture& texture = mTextures[i];
+
+		// settle for a coarser mip when the requested one doesn't fit
+		uint32_t mip = texture.requestedMip;
+
+		while ((mip < texture.residentMip) &&
+			   !MakeRoom(texture.chainBytes[mip] - texture.chainBytes[texture.residentMip], i, changes))
+		{
+			++mip;
+		}
+
+		if (mip == texture.residentMip)
+		{
+			++mStats.deniedCount;
+			continue;
+		}
+
+		SetResidentMip(texture, mip);
+		changes.push_back({ i, mip });
+	}
+
+	for (Texture& texture : mTextures)
+	{
+		texture.requestedMip = texture.tailMip;
+	}
+
+	++mFrame;
+
+	return changes;
+}
+
+bool TextureStreamer::MakeRoom(const std::size_t bytes, const std::size_t protectedTexture, std::vector<ResidencyChange>& changes)
+{
+	if (mStats.residentBytes + bytes <= mSettings.budgetBytes)
+	{
+		return true;
+	}
+
+	// textures holding more detail than they were asked for this frame, which is all of it for
+	// the ones that weren't asked at all
+	std::vector<std::size_t> victims;
+	std::size_t freeableBytes = 0;
+
+	for (std::size_t i = 0; i < mTextures.size(); ++i)
+	{
+		const Texture& texture = mTextures[i];
+
+		if ((i != protectedTexture) && (texture.residentMip < texture.requestedMip))
+		{
+			victims.push_back(i);
+			freeableBytes += texture.chainBytes[texture.residentMip] - texture.chainBytes[texture.requestedMip];
+		}
+	}
+
+	// don't throw away anything if it wouldn't be enough anyway
+	if (mStats.residentBytes - freeableBytes + bytes > mSettings.budgetBytes)
+	{
+		return false;
+	}
+
+	std::sort(victims.begin(), victims.end(), [this](const std::size_t a, const std::size_t b)
+	{
+		return mTextures[a].lastUsedFrame < mTextures[b].lastUsedFrame;
+	});
+
+	for (const std::size_t i : victims)
+	{
+		Texture& texture = mTextures[i];
+
+		SetResidentMip(texture, texture.requestedMip);
+		changes.push_back({ i, texture.requestedMip });
+
+		if (mStats.residentBytes + bytes <= mSettings.budgetBytes)
+		{
+			break;
+		}
+	}
+
+	return true;
+}
+
+void TextureStreamer::SetResidentMip(Texture& texture, const uint32_t mip)
+{
+	const std::size_t before = texture.chainBytes[texture.residentMip];
+	const std::size_t after = texture.chainBytes[mip];
+
+	if (after > before)
+	{
+		mStats.streamedInBytes += after - before;
+		++mStats.streamInCount;
+	}
+	else
+	{
+		mStats.evictedBytes += before - after;
+		++mStats.evictionCount;
+	}
+
+	mStats.residentBytes = mStats.residentBytes - before + after;
+	texture.residentMip = mip;
+}
\ No newline at end of file
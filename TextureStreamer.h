@@ -0,0 +1,107 @@
+#pragma once
+
+// std
+#include <cassert>
+#include <cstdint>
+#include <vector>
+
+// decides which mips of the streamed textures are resident; it only does the bookkeeping, no device
+// calls, so it can be driven by a simulated camera path. a texture always keeps its tail mips, the
+// larger mips come and go with the per-frame requests and the memory budget
+class TextureStreamer
+{
+public:
+
+	struct Settings
+	{
+		std::size_t budgetBytes = std::size_t(256) * 1024 * 1024;
+		uint32_t tailSize = 64;            // mips this size and smaller are never evicted
+		std::size_t maxChangesPerUpdate = 8; // bounds the uploads a single frame can trigger
+
+		// texel bytes TextureManager::UpdateStreaming hands to the device in one frame, a single chain
+		// larger than this still goes, alone
+		std::size_t maxUploadBytesPerUpdate = std::size_t(32) * 1024 * 1024;
+	};
+
+	// new most detailed resident mip of a texture, the caller recreates it starting at that mip
+	struct ResidencyChange
+	{
+		std::size_t texture = 0;
+		uint32_t mip = 0;
+	};
+
+	struct Stats
+	{
+		std::size_t residentBytes = 0;
+		std::size_t streamedInBytes = 0; // totals since the start
+		std::size_t evictedBytes = 0;
+		std::size_t streamInCount = 0;
+		std::size_t evictionCount = 0;
+		std::size_t deniedCount = 0;     // requests that did not fit even after evicting
+	};
+
+	void SetSettings(const Settings& settings) { mSettings = settings; }
+	const Settings& GetSettings() const { return mSettings; }
+
+	// mipBytes has the size of every mip, most detailed first; returns the id used by the other calls,
+	// the texture starts with only its tail resident
+	std::size_t AddTexture(const uint32_t width, const uint32_t height, const std::vector<std::size_t>& mipBytes);
+
+	// most detailed mip that was requested for the texture this frame, several requests keep the finest
+	void RequestMip(const std::size_t texture, const uint32_t mip);
+
+	// mip whose texels map about one to one to pixels for a surface that covers screenSize pixels
+	// across and a uvSpan range of uv along the same direction
+	static uint32_t ComputeRequiredMip(const float screenSize,
+									   const float uvSpan,
+									   const uint32_t width,
+									   const uint32_t height,
+									   const uint32_t mipCount);
+
+	// projected diameter in pixels of a bounding sphere with a perspective projection
+	static float ComputeScreenSize(const float radius,
+								   const float distance,
+								   const float fovY,
+								   const float viewportHeight);
+
+	// close the frame: evict least recently used mips if needed and return what has to change,
+	// the requests are cleared for the next frame
+	std::vector<ResidencyChange> Update();
+
+	uint32_t GetResidentMip(const std::size_t texture) const
+	{
+		assert(texture < mTextures.size());
+		return mTextures[texture].residentMip;
+	}
+
+	uint32_t GetTailMip(const std::size_t texture) const
+	{
+		assert(texture < mTextures.size());
+		return mTextures[texture].tailMip;
+	}
+
+	std::size_t GetTextureCount() const { return mTextures.size(); }
+	const Stats& GetStats() const { return mStats; }
+
+private:
+
+	struct Texture
+	{
+		std::vector<std::size_t> chainBytes; // bytes of the chain starting at each mip
+		uint32_t tailMip = 0;
+		uint32_t residentMip = 0;
+		uint32_t requestedMip = 0; // tailMip when nothing asked for it this frame
+		uint64_t lastUsedFrame = 0;
+	};
+
+	// drop least recently used detail until bytes more fit in the budget, never touching protectedTexture
+	bool MakeRoom(const std::size_t bytes, const std::size_t protectedTexture, std::vector<ResidencyChange>& changes);
+
+	void SetResidentMip(Texture& texture, const uint32_t mip);
+
+	Settings mSettings;
+	Stats mStats;
+
+	std::vector<Texture> mTextures;
+	uint64_t mFrame = 1;
+};
\ No newline at end of file
@@ -0,0 +1,169 @@
+#include "UnitTest.h"
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+#include "TextureStreamer.h"
+
+// the streamer driven by a simulated camera path: a camera flying down a row of textures asks each one
+// it's looking at for the mip its distance wants, as the draw path would, and the budget accounting is
+// checked against the mips it reported after every frame
+
+namespace
+{
+	constexpr uint32_t kSize = 1024;
+	constexpr uint32_t kMipCount = 11;
+	constexpr float kFovY = 0.25f * 3.14159265f;
+	constexpr float kViewportHeight = 720.0f;
+	constexpr float kSpacing = 10.0f; // between the textures along x
+	constexpr float kViewDistance = 40.0f;
+
+	// rgba8 mips, most detailed first
+	std::vector<std::size_t> GetMipBytes()
+	{
+		std::vector<std::size_t> mipBytes;
+
+		for (uint32_t mip = 0; mip < kMipCount; ++mip)
+		{
+			const std::size_t size = std::max(1u, kSize >> mip);
+			mipBytes.push_back(size * size * 4);
+		}
+
+		return mipBytes;
+	}
+
+	std::size_t GetChainBytes(const uint32_t mip)
+	{
+		const std::vector<std::size_t> mipBytes = GetMipBytes();
+
+		std::size_t bytes = 0;
+
+		for (uint32_t i = mip; i < kMipCount; ++i)
+		{
+			bytes += mipBytes[i];
+		}
+
+		return bytes;
+	}
+
+	struct CameraFlight
+	{
+		TextureStreamer streamer;
+		std::vector<uint32_t> mips; // the caller's view, the changes applied in order
+		std::size_t failedFrames = 0;
+
+		CameraFlight(const std::size_t textureCount, const std::size_t budgetBytes)
+		{
+			TextureStreamer::Settings settings;
+			settings.budgetBytes = budgetBytes;
+			settings.maxChangesPerUpdate = 4;
+			streamer.SetSettings(settings);
+
+			for (std::size_t i = 0; i < textureCount; ++i)
+			{
+				streamer.AddTexture(kSize, kSize, GetMipBytes());
+				mips.push_back(streamer.GetResidentMip(i));
+			}
+		}
+
+		// the camera at x looks down +x at every texture ahead of it within kViewDistance
+		void Frame(const float cameraX)
+		{
+			for (std::size_t i = 0; i < mips.size(); ++i)
+			{
+				const float distance = float(i) * kSpacing - cameraX;
+
+				if ((distance > 0.0f) && (distance < kViewDistance))
+				{
+					const float screenSize = TextureStreamer::ComputeScreenSize(1.0f, distance, kFovY, kViewportHeight);
+					streamer.RequestMip(i, TextureStreamer::ComputeRequiredMip(screenSize, 1.0f, kSize, kSize, kMipCount));
+				}
+			}
+
+			const std::size_t streamInCount = streamer.GetStats().streamInCount;
+
+			for (const TextureStreamer::ResidencyChange& change : streamer.Update())
+			{
+				mips[change.texture] = change.mip;
+			}
+
+			const TextureStreamer::Stats& stats = streamer.GetStats();
+
+			std::size_t residentBytes = 0;
+			bool isMatching = true;
+
+			for (std::size_t i = 0; i < mips.size(); ++i)
+			{
+				residentBytes += GetChainBytes(mips[i]);
+				isMatching = isMatching && (mips[i] == streamer.GetResidentMip(i)) && (mips[i] <= streamer.GetTailMip(i));
+			}
+
+			const bool isValid = isMatching &&
+								 (stats.residentBytes == residentBytes) &&
+								 (stats.residentBytes <= streamer.GetSettings().budgetBytes) &&
+								 (stats.streamInCount - streamInCount <= streamer.GetSettings().maxChangesPerUpdate);
+
+			failedFrames += isValid ? 0 : 1;
+		}
+	};
+}
+
+UNIT_TEST(TextureStreamerRequiredMip)
+{
+	// a surface as wide on screen as its texels takes the top mip, every halving of it one mip more
+	CHECK(TextureStreamer::ComputeRequiredMip(1024.0f, 1.0f, kSize, kSize, kMipCount) == 0);
+	CHECK(TextureStreamer::ComputeRequiredMip(256.0f, 1.0f, kSize, kSize, kMipCount) == 2);
+	CHECK(TextureStreamer::ComputeRequiredMip(0.5f, 1.0f, kSize, kSize, kMipCount) == kMipCount - 1);
+	CHECK(TextureStreamer::ComputeRequiredMip(0.0f, 1.0f, kSize, kSize, kMipCount) == kMipCount - 1);
+
+	CHECK(TextureStreamer::ComputeScreenSize(1.0f, 0.5f, kFovY, kViewportHeight) == kViewportHeight);
+	CHECK(TextureStreamer::ComputeScreenSize(1.0f, 20.0f, kFovY, kViewportHeight) < TextureStreamer::ComputeScreenSize(1.0f, 10.0f, kFovY, kViewportHeight));
+}
+
+// room for everything, the textures reach the mips the camera asked for and keep them
+UNIT_TEST(TextureStreamerCameraPathUnbounded)
+{
+	CameraFlight flight(16, std::size_t(1) << 30);
+
+	for (int frame = 0; frame < 300; ++frame)
+	{
+		flight.Frame(float(frame) * 0.5f);
+	}
+
+	CHECK(flight.failedFrames == 0);
+	CHECK(flight.streamer.GetStats().evictionCount == 0);
+	CHECK(flight.streamer.GetStats().deniedCount == 0);
+
+	// the camera ended at x 149.5 and passed texture 14 at x 140 up close, texture 0 it started on was
+	// never ahead of it
+	CHECK(flight.streamer.GetResidentMip(14) == 0);
+	CHECK(flight.streamer.GetResidentMip(1) < flight.streamer.GetTailMip(1));
+	CHECK(flight.streamer.GetResidentMip(0) == flight.streamer.GetTailMip(0));
+}
+
+// about two full chains fit, what the camera left behind is evicted for what's ahead of it
+UNIT_TEST(TextureStreamerCameraPathBudget)
+{
+	const std::size_t budgetBytes = 2 * GetChainBytes(0) + 16 * GetChainBytes(4);
+
+	CameraFlight flight(16, budgetBytes);
+
+	for (int frame = 0; frame < 200; ++frame)
+	{
+		flight.Frame(float(frame) * 0.5f);
+	}
+
+	const TextureStreamer::Stats& stats = flight.streamer.GetStats();
+
+	CHECK(flight.failedFrames == 0);
+	CHECK(stats.evictionCount > 0);
+	CHECK(stats.streamedInBytes - stats.evictedBytes + 16 * GetChainBytes(4) == stats.residentBytes);
+
+	// the camera sits at x 99.5, texture 10 right ahead of it gets detail and the first ones are back
+	// to their tails
+	CHECK(flight.streamer.GetResidentMip(10) < flight.streamer.GetTailMip(10));
+	CHECK(flight.streamer.GetResidentMip(0) == flight.streamer.GetTailMip(0));
+	CHECK(flight.streamer.GetResidentMip(1) == flight.streamer.GetTailMip(1));
+}
\ No newline at end of file
@@ -1,46 +1,62 @@
 #include "Timer.h"
 
-#include <windows.h>
+#include <cassert>
+#include <chrono>
+
+int64_t Timer::GetSystemTicks()
+{
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
 
 Timer::Timer()
-    : mSecondsPerCount(0.0)
-    , mDeltaTime(-1.0)
+    : Timer(&Timer::GetSystemTicks)
+{
+}
+
+Timer::Timer(Clock clock)
+    : mClock(std::move(clock))
+    , mDeltaTime(0)
     , mBaseTime(0)
     , mPauseTime(0)
     , mStopTime(0)
     , mPrevTime(0)
     , mCurrTime(0)
     , mStopped(false)
+    , mFixedStep(0)
+    , mMaxStepsPerTick(0)
+    , mAccumulator(0)
+    , mFixedStepCount(0)
+    , mDroppedTime(0)
 {
-    LARGE_INTEGER CountsPerSecond;
-    QueryPerformanceFrequency(&CountsPerSecond);
-
-    mSecondsPerCount = 1.0 / static_cast<double>(CountsPerSecond.QuadPart);
+    assert(mClock);
 }
 
 void Timer::Reset()
 {
-    LARGE_INTEGER CurrTime;
-    QueryPerformanceCounter(&CurrTime);
+    const int64_t currTime = mClock();
 
-    mBaseTime = static_cast<__int64>(CurrTime.QuadPart);
-    mPrevTime = static_cast<__int64>(CurrTime.QuadPart);
+    mBaseTime = currTime;
+    mPrevTime = currTime;
+    mCurrTime = currTime;
+    mPauseTime = 0;
     mStopTime = 0;
     mStopped = false;
+
+    mDeltaTime = 0;
+    mAccumulator = 0;
+    mFixedStepCount = 0;
+    mDroppedTime = 0;
 }
 
 void Timer::Start()
 {
-    LARGE_INTEGER StartTime;
-    QueryPerformanceCounter(&StartTime);
-
     if (mStopped)
     {
-        __int64 StartTime64 = static_cast<__int64>(StartTime.QuadPart);
+        const int64_t startTime = mClock();
 
-        mPauseTime += (StartTime64 - mStopTime);
+        mPauseTime += (startTime - mStopTime);
 
-        mPrevTime = StartTime64;
+        mPrevTime = startTime;
         mStopTime = 0;
         mStopped = false;
     }
@@ -50,50 +66,88 @@ void Timer::Stop()
 {
     if (!mStopped)
     {
-        LARGE_INTEGER CurrTime;
-        QueryPerformanceCounter(&CurrTime);
-
-        mStopTime = static_cast<__int64>(CurrTime.QuadPart);
+        mStopTime = mClock();
         mStopped = true;
     }
 }
 
 void Timer::Tick()
 {
+    mFixedStepCount = 0;
+
     if (mStopped)
     {
-        mDeltaTime = 0.0;
+        mDeltaTime = 0;
         return;
     }
 
-    LARGE_INTEGER CurrTime;
-    QueryPerformanceCounter(&CurrTime);
+    mCurrTime = mClock();
+    mDeltaTime = (mCurrTime > mPrevTime) ? mCurrTime - mPrevTime : 0;
+    mPrevTime = mCurrTime;
 
-    mCurrTime = static_cast<__int64>(CurrTime.QuadPart);
+    if (mFixedStep == 0)
+    {
+        return;
+    }
 
-    mDeltaTime = (mCurrTime - mPrevTime) * mSecondsPerCount;
+    mAccumulator += mDeltaTime;
 
-    mPrevTime = mCurrTime;
+    const int64_t stepCount = mAccumulator / mFixedStep;
 
-    if (mDeltaTime < 0.0)
+    // keep the fraction of a step so the interpolation stays smooth, drop the whole steps that don't fit
+    if (stepCount > mMaxStepsPerTick)
     {
-        mDeltaTime = 0.0;
+        mDroppedTime += (stepCount - mMaxStepsPerTick) * mFixedStep;
+        mAccumulator -= (stepCount - mMaxStepsPerTick) * mFixedStep;
     }
+
+    mFixedStepCount = int(mAccumulator / mFixedStep);
+    mAccumulator -= mFixedStepCount * mFixedStep;
 }
 
-float Timer::GetDeltaTime() const
+double Timer::GetDeltaTime() const
 {
-    return static_cast<float>(mDeltaTime);
+    return double(mDeltaTime) / kTicksPerSecond;
 }
 
-float Timer::GetTotalTime() const
+double Timer::GetTotalTime() const
+{
+    return double(GetTotalTicks()) / kTicksPerSecond;
+}
+
+int64_t Timer::GetTotalTicks() const
 {
     if (mStopped)
     {
-        return static_cast<float>(((mStopTime - mPauseTime) - mBaseTime) * mSecondsPerCount);
+        return (mStopTime - mPauseTime) - mBaseTime;
     }
     else
     {
-        return static_cast<float>(((mCurrTime - mPauseTime) - mBaseTime) * mSecondsPerCount);
+        return (mCurrTime - mPauseTime) - mBaseTime;
     }
+}
+
+void Timer::SetFixedTimestep(const double stepSeconds, const int maxStepsPerTick)
+{
+    assert((stepSeconds >= 0.0) && (maxStepsPerTick > 0));
+
+    mFixedStep = int64_t(stepSeconds * kTicksPerSecond + 0.5);
+    mMaxStepsPerTick = maxStepsPerTick;
+    mAccumulator = 0;
+    mFixedStepCount = 0;
+}
+
+double Timer::GetFixedTimestep() const
+{
+    return double(mFixedStep) / kTicksPerSecond;
+}
+
+double Timer::GetInterpolationAlpha() const
+{
+    return (mFixedStep > 0) ? double(mAccumulator) / double(mFixedStep) : 1.0;
+}
+
+double Timer::GetDroppedTime() const
+{
+    return double(mDroppedTime) / kTicksPerSecond;
 }
\ No newline at end of file
@@ -1,27 +1,71 @@
 #pragma once
 
+// std
+#include <cstdint>
+#include <functional>
+
+// frame clock with optional fixed timestep simulation: times are kept as integer nanoseconds, so the
+// total time doesn't lose precision after hours, and read back as double seconds. the clock it reads
+// can be replaced, which lets tests step time by hand
 class Timer
 {
 public:
+	static constexpr int64_t kTicksPerSecond = 1000000000;
+
+	// nanoseconds since an arbitrary point, never going backwards
+	using Clock = std::function<int64_t()>;
+
+	// steady_clock, clock_gettime(CLOCK_MONOTONIC) on linux and QueryPerformanceCounter on windows
+	static int64_t GetSystemTicks();
+
 	Timer();
+	explicit Timer(Clock clock);
 
 	void Reset();
 	void Start();
 	void Stop();
 	void Tick();
 
-	float GetDeltaTime() const;
-	float GetTotalTime() const;
+	double GetDeltaTime() const;
+	double GetTotalTime() const;
+
+	int64_t GetDeltaTicks() const { return mDeltaTime; }
+	int64_t GetTotalTicks() const;
+
+	bool IsStopped() const { return mStopped; }
+
+	// every Tick turns the time since the previous one into whole steps of stepSeconds for the simulation,
+	// the remainder carries over; past maxStepsPerTick the rest of the time is dropped, so a slow frame
+	// can't ask for more steps than it can take. 0 turns it off
+	void SetFixedTimestep(const double stepSeconds, const int maxStepsPerTick = 8);
+
+	double GetFixedTimestep() const;
+
+	// steps to simulate for the last Tick
+	int GetFixedStepCount() const { return mFixedStepCount; }
+
+	// how far the frame is between the last simulated step and the next one, to blend the two states
+	double GetInterpolationAlpha() const;
+
+	// time dropped by the clamp since Reset
+	double GetDroppedTime() const;
 
 private:
-	double mSecondsPerCount;
-	double mDeltaTime; // microseconds
+	Clock mClock;
+
+	int64_t mDeltaTime;
 
-	__int64 mBaseTime;
-	__int64 mPauseTime;
-	__int64 mStopTime;
-	__int64 mPrevTime;
-	__int64 mCurrTime;
+	int64_t mBaseTime;
+	int64_t mPauseTime;
+	int64_t mStopTime;
+	int64_t mPrevTime;
+	int64_t mCurrTime;
 
 	bool mStopped;
+
+	int64_t mFixedStep;
+	int mMaxStepsPerTick;
+	int64_t mAccumulator;
+	int mFixedStepCount;
+	int64_t mDroppedTime;
 };
\ No newline at end of file
@@ -0,0 +1,192 @@
+#include "UnitTest.h"
+
+#include "Timer.h"
+
+// a clock stepped by hand through pauses, fixed steps and the clamp on them
+
+namespace
+{
+	constexpr int64_t kMs = Timer::kTicksPerSecond / 1000;
+
+	struct FakeClock
+	{
+		int64_t ticks = 1000 * kMs; // not 0, the timer mustn't depend on where the clock starts
+
+		Timer::Clock Get()
+		{
+			return [this]() { return ticks; };
+		}
+	};
+}
+
+UNIT_TEST(TimerDeltaAndTotal)
+{
+	FakeClock clock;
+	Timer timer(clock.Get());
+	timer.Reset();
+
+	clock.ticks += 16 * kMs;
+	timer.Tick();
+
+	CHECK(timer.GetDeltaTicks() == 16 * kMs);
+	CHECK(timer.GetTotalTicks() == 16 * kMs);
+	CHECK_NEAR(timer.GetDeltaTime(), 0.016, 1e-12);
+
+	clock.ticks += 17 * kMs;
+	timer.Tick();
+
+	CHECK(timer.GetDeltaTicks() == 17 * kMs);
+	CHECK(timer.GetTotalTicks() == 33 * kMs);
+	CHECK_NEAR(timer.GetTotalTime(), 0.033, 1e-12);
+
+	// no precision lost after a day: whole nanoseconds on top of 86400 s
+	clock.ticks += 86400 * Timer::kTicksPerSecond;
+	timer.Tick();
+	clock.ticks += 1;
+	timer.Tick();
+
+	CHECK(timer.GetDeltaTicks() == 1);
+	CHECK(timer.GetTotalTicks() == 86400 * Timer::kTicksPerSecond + 33 * kMs + 1);
+}
+
+// the time between Stop and Start counts neither in the total nor in the next delta
+UNIT_TEST(TimerPause)
+{
+	FakeClock clock;
+	Timer timer(clock.Get());
+	timer.Reset();
+
+	clock.ticks += 10 * kMs;
+	timer.Tick();
+
+	clock.ticks += 5 * kMs;
+	timer.Stop();
+
+	CHECK(timer.IsStopped());
+	CHECK(timer.GetTotalTicks() == 15 * kMs);
+
+	// ticks while stopped have no time, and the total holds where Stop left it
+	clock.ticks += 1000 * kMs;
+	timer.Tick();
+
+	CHECK(timer.GetDeltaTicks() == 0);
+	CHECK(timer.GetTotalTicks() == 15 * kMs);
+
+	// a second Stop doesn't move the stop time
+	timer.Stop();
+	clock.ticks += 1000 * kMs;
+	timer.Start();
+
+	CHECK(!timer.IsStopped());
+
+	clock.ticks += 7 * kMs;
+	timer.Tick();
+
+	CHECK(timer.GetDeltaTicks() == 7 * kMs);
+	CHECK(timer.GetTotalTicks() == 22 * kMs);
+
+	// a second pause adds up with the first
+	timer.Stop();
+	clock.ticks += 500 * kMs;
+	timer.Start();
+	timer.Start();
+
+	clock.ticks += 3 * kMs;
+	timer.Tick();
+
+	CHECK(timer.GetDeltaTicks() == 3 * kMs);
+	CHECK(timer.GetTotalTicks() == 25 * kMs);
+}
+
+UNIT_TEST(TimerFixedSteps)
+{
+	FakeClock clock;
+	Timer timer(clock.Get());
+	timer.Reset();
+	timer.SetFixedTimestep(0.010);
+
+	CHECK_NEAR(timer.GetFixedTimestep(), 0.010, 1e-12);
+
+	// 25 ms is two steps and half of the next
+	clock.ticks += 25 * kMs;
+	timer.Tick();
+
+	CHECK(timer.GetFixedStepCount() == 2);
+	CHECK_NEAR(timer.GetInterpolationAlpha(), 0.5, 1e-12);
+
+	// the remainder carries over: 5 + 4 ms is less than a step
+	clock.ticks += 4 * kMs;
+	timer.Tick();
+
+	CHECK(timer.GetFixedStepCount() == 0);
+	CHECK_NEAR(timer.GetInterpolationAlpha(), 0.9, 1e-12);
+
+	// 9 + 1 ms is exactly one
+	clock.ticks += 1 * kMs;
+	timer.Tick();
+
+	CHECK(timer.GetFixedStepCount() == 1);
+	CHECK_NEAR(timer.GetInterpolationAlpha(), 0.0, 1e-12);
+
+	// no steps while stopped, and the pause isn't simulated after it
+	timer.Stop();
+	clock.ticks += 1000 * kMs;
+	timer.Tick();
+
+	CHECK(timer.GetFixedStepCount() == 0);
+
+	timer.Start();
+	clock.ticks += 10 * kMs;
+	timer.Tick();
+
+	CHECK(timer.GetFixedStepCount() == 1);
+	CHECK(timer.GetDroppedTime() == 0.0);
+
+	// without a fixed timestep there are no steps and the frame is the state
+	timer.SetFixedTimestep(0.0);
+	clock.ticks += 25 * kMs;
+	timer.Tick();
+
+	CHECK(timer.GetFixedStepCount() == 0);
+	CHECK(timer.GetInterpolationAlpha() == 1.0);
+}
+
+// a slow frame takes at most maxStepsPerTick steps, the whole steps past them are dropped and the
+// fraction of a step kept
+UNIT_TEST(TimerFixedStepClamp)
+{
+	FakeClock clock;
+	Timer timer(clock.Get());
+	timer.Reset();
+	timer.SetFixedTimestep(0.010, 4);
+
+	clock.ticks += 1005 * kMs;
+	timer.Tick();
+
+	CHECK(timer.GetFixedStepCount() == 4);
+	CHECK_NEAR(timer.GetDroppedTime(), 0.960, 1e-12);
+	CHECK_NEAR(timer.GetInterpolationAlpha(), 0.5, 1e-12);
+
+	// back to speed nothing more is dropped
+	clock.ticks += 15 * kMs;
+	timer.Tick();
+
+	CHECK(timer.GetFixedStepCount() == 2);
+	CHECK_NEAR(timer.GetDroppedTime(), 0.960, 1e-12);
+	CHECK_NEAR(timer.GetInterpolationAlpha(), 0.0, 1e-12);
+
+	// exactly at the clamp nothing is dropped either
+	clock.ticks += 40 * kMs;
+	timer.Tick();
+
+	CHECK(timer.GetFixedStepCount() == 4);
+	CHECK_NEAR(timer.GetDroppedTime(), 0.960, 1e-12);
+
+	// the total time still has all of it, only the simulation skipped
+	CHECK(timer.GetTotalTicks() == 1060 * kMs);
+
+	// Reset clears the dropped time
+	timer.Reset();
+
+	CHECK(timer.GetDroppedTime() == 0.0);
+}
\ No newline at end of file
@@ -0,0 +1,273 @@
+#include "TraceExporter.h"
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <cstdio>
+
+namespace
+{
+	// the names are literals and scope names, only quotes, backslashes and control characters need care
+	void AppendEscaped(std::string& out, const char* text)
+	{
+		for (; *text; ++text)
+		{
+			if ((*text == '"') || (*text == '\\'))
+			{
+				out += '\\';
+				out += *text;
+			}
+			else if (uint8_t(*text) < 0x20)
+			{
+				out += ' ';
+			}
+			else
+			{
+				out += *text;
+			}
+		}
+	}
+}
+
+TraceExporter::TraceExporter() :
+	TraceExporter(Settings())
+{
+}
+
+TraceExporter::TraceExporter(const Settings& settings) :
+	mSettings(settings),
+	mWriter(1)
+{
+	assert((settings.maxPendingFrames > 0) && (settings.historyFrames > 0));
+}
+
+TraceExporter::~TraceExporter()
+{
+	if (mCapture)
+	{
+		FinishCapture();
+	}
+}
+
+bool TraceExporter::CaptureFrames(const std::string& path, const std::size_t frameCount)
+{
+	if (IsCapturing() || (frameCount == 0))
+	{
+		return false;
+	}
+
+	StartCapture(path);
+	mRemainingFrames = frameCount;
+
+	return true;
+}
+
+void TraceExporter::SetSpikeCapture(const std::string& pathPrefix, const double thresholdMs)
+{
+	mSpikePathPrefix = pathPrefix;
+	mSpikeThresholdMs = thresholdMs;
+
+	if (thresholdMs <= 0.0)
+	{
+		mHistory.clear();
+	}
+}
+
+void TraceExporter::AddFrame(const GPUProfiler& gpuProfiler, const double frameMs)
+{
+	++mFrame;
+	mStats.writtenFrames = mWrittenFrames.load();
+
+	const bool isSpikeCaptureOn = (mSpikeThresholdMs > 0.0);
+
+	// nothing is converted while there's nothing to write
+	if (!IsCapturing() && !isSpikeCaptureOn)
+	{
+		return;
+	}
+
+	const std::shared_ptr<const Frame> frame = std::make_shared<const Frame>(CollectFrame(gpuProfiler));
+
+	if (IsCapturing())
+	{
+		SubmitFrame(frame);
+
+		if (--mRemainingFrames == 0)
+		{
+			FinishCapture();
+		}
+	}
+	else if (isSpikeCaptureOn && (frameMs > mSpikeThresholdMs))
+	{
+		StartCapture(mSpikePathPrefix + std::to_string(mFrame) + ".json");
+
+		for (const std::shared_ptr<const Frame>& previous : mHistory)
+		{
+			SubmitFrame(previous);
+		}
+
+		SubmitFrame(frame);
+		FinishCapture();
+
+		// the next spike gets frames of its own
+		mHistory.clear();
+		return;
+	}
+
+	if (isSpikeCaptureOn)
+	{
+		mHistory.push_back(frame);
+
+		while (mHistory.size() >= mSettings.historyFrames)
+		{
+			mHistory.pop_front();
+		}
+	}
+}
+
+TraceExporter::Frame TraceExporter::CollectFrame(const GPUProfiler& gpuProfiler)
+{
+	Frame frame;
+	frame.frame = mFrame;
+
+	const double usPerTick = 1000.0 * CPUProfiler::TicksToMs(1);
+	const std::vector<CPUProfiler::Event>& cpuEvents = CPUProfiler::GetFrameEvents();
+
+	frame.events.reserve(cpuEvents.size() + gpuProfiler.GetResults().size() + 1);
+
+	for (const CPUProfiler::Event& event : cpuEvents)
+	{
+		frame.events.push_back({ event.name, double(event.begin) * usPerTick, double(event.end - event.begin) * usPerTick, event.thread });
+	}
+
+	const GPUProfiler::FrameTiming& timing = gpuProfiler.GetResolvedFrameTiming();
+
+	// the gpu scopes show up once, with the frame they were resolved in
+	if ((gpuProfiler.GetResolvedFrame() == mLastGPUFrame) || (timing.gpuFrequency == 0))
+	{
+		return frame;
+	}
+
+	mLastGPUFrame = gpuProfiler.GetResolvedFrame();
+
+	const double cpuBeginUs = double(timing.cpuBeginTicks) * usPerTick;
+	const double gpuBeginUs = 1e6 * double(timing.gpuBeginTicks) / double(timing.gpuFrequency);
+
+	// d3d11 has no clock calibration; the gpu can't start a frame before it's submitted, so the smallest
+	// difference seen between the two is the best guess at the offset between the clocks
+	if ((timing.gpuFrequency != mGPUFrequency) || (gpuBeginUs - cpuBeginUs < mGPUOffsetUs))
+	{
+		mGPUFrequency = timing.gpuFrequency;
+		mGPUOffsetUs = gpuBeginUs - cpuBeginUs;
+	}
+
+	const double frameBeginUs = gpuBeginUs - mGPUOffsetUs;
+
+	frame.events.push_back({ "gpu frame", frameBeginUs, 1000.0 * gpuProfiler.GetFrameMs(), kGPUThread });
+
+	for (const GPUProfiler::ScopeResult& result : gpuProfiler.GetResults())
+	{
+		frame.events.push_back({ gpuProfiler.GetScopeName(result.scope).c_str(),
+								 frameBeginUs + 1000.0 * result.beginMs,
+								 1000.0 * result.durationMs,
+								 kGPUThread });
+	}
+
+	return frame;
+}
+
+void TraceExporter::StartCapture(const std::string& path)
+{
+	assert(!mCapture);
+
+	mCapture = std::make_shared<Capture>();
+	++mStats.captureCount;
+
+	mWriter.Submit([capture = mCapture, path]()
+	{
+		capture->stream.open(path, std::ios::binary);
+		capture->stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+	});
+}
+
+void TraceExporter::SubmitFrame(const std::shared_ptr<const Frame>& frame)
+{
+	if (mPendingFrames.load() >= mSettings.maxPendingFrames)
+	{
+		++mStats.droppedFrames;
+		return;
+	}
+
+	++mPendingFrames;
+
+	mWriter.Submit([this, capture = mCapture, frame]()
+	{
+		WriteFrame(*capture, *frame);
+
+		--mPendingFrames;
+		++mWrittenFrames;
+	});
+}
+
+void TraceExporter::FinishCapture()
+{
+	mWriter.Submit([capture = mCapture]()
+	{
+		capture->stream << "\n]}\n";
+		capture->stream.close();
+	});
+
+	mCapture.reset();
+	mRemainingFrames = 0;
+}
+
+void TraceExporter::WriteFrame(Capture& capture, const Frame& frame)
+{
+	std::string out;
+	out.reserve(frame.events.size() * 96);
+
+	char buffer[128];
+
+	const auto BeginEvent = [&]()
+	{
+		out += capture.isFirstEvent ? "" : ",\n";
+		capture.isFirstEvent = false;
+	};
+
+	for (const Event& event : frame.events)
+	{
+		// the cpu threads are one process and the gpu another, each named the first time it shows up
+		const int pid = (event.thread == kGPUThread) ? 1 : 0;
+		const uint32_t tid = (event.thread == kGPUThread) ? 0 : event.thread;
+
+		if (std::find(capture.namedThreads.begin(), capture.namedThreads.end(), event.thread) == capture.namedThreads.end())
+		{
+			capture.namedThreads.push_back(event.thread);
+
+			BeginEvent();
+
+			if (event.thread == kGPUThread)
+			{
+				std::snprintf(buffer, sizeof(buffer), "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":1,\"tid\":0,\"args\":{\"name\":\"GPU\"}}");
+			}
+			else
+			{
+				std::snprintf(buffer, sizeof(buffer), "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,\"args\":{\"name\":\"thread %u\"}}", tid, tid);
+			}
+
+			out += buffer;
+		}
+
+		BeginEvent();
+
+		out += "{\"name\":\"";
+		AppendEscaped(out, event.name);
+
+		std::snprintf(buffer, sizeof(buffer), "\",\"ph\":\"X\",\"pid\":%d,\"tid\":%u,\"ts\":%.3f,\"dur\":%.3f,\"args\":{\"frame\":%llu}}",
+					  pid, tid, event.beginUs, event.durationUs, static_cast<unsigned long long>(frame.frame));
+
+		out += buffer;
+	}
+
+	capture.stream.write(out.data(), out.size());
+}
\ No newline at end of file
@@ -0,0 +1,122 @@
+#pragma once
+
+// std
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+//
+#include "CPUProfiler.h"
+#include "GPUProfiler.h"
+#include "Utility.h"
+
+// writes the cpu scopes and the gpu scopes of a span of frames as a chrome trace, which chrome://tracing
+// and the perfetto ui both open. a capture covers the next N frames, or the frames leading up to one that
+// took too long; the frames are converted on the calling thread and written by a thread of their own,
+// and frames past the pending limit are dropped rather than stalling the frame loop
+class TraceExporter
+{
+public:
+
+	struct Settings
+	{
+		std::size_t maxPendingFrames = 32; // converted but not written yet, bounds the memory
+		std::size_t historyFrames = 16;    // kept for spike captures, the spike included
+	};
+
+	struct Stats
+	{
+		std::size_t captureCount = 0;
+		std::size_t writtenFrames = 0;
+		std::size_t droppedFrames = 0; // the writer couldn't keep up
+	};
+
+	TraceExporter();
+	explicit TraceExporter(const Settings& settings);
+
+	// the pending frames are written and the open capture is closed
+	~TraceExporter();
+
+	TraceExporter(const TraceExporter&) = delete;
+	TraceExporter& operator=(const TraceExporter&) = delete;
+
+	// write the next frameCount frames to path, unless a capture is already running
+	bool CaptureFrames(const std::string& path, const std::size_t frameCount);
+
+	// a frame over thresholdMs is written with the frames before it to pathPrefix followed by its number,
+	// 0 turns it off; frames are only kept for it while it's on
+	void SetSpikeCapture(const std::string& pathPrefix, const double thresholdMs);
+
+	bool IsCapturing() const
+	{
+		return mRemainingFrames > 0;
+	}
+
+	// once a frame, after CPUProfiler::EndFrame and GPUProfiler::EndFrame; the gpu scopes are those of
+	// the frame the gpu profiler resolved last, which trails the cpu by a few frames
+	void AddFrame(const GPUProfiler& gpuProfiler, const double frameMs);
+
+	const Stats& GetStats() const
+	{
+		return mStats;
+	}
+
+private:
+
+	// everything in microseconds on the cpu time base
+	struct Event
+	{
+		const char* name = nullptr; // a literal or a GPUProfiler name, both outlive the capture
+		double beginUs = 0.0;
+		double durationUs = 0.0;
+		uint32_t thread = 0; // kGPUThread for the gpu
+	};
+
+	struct Frame
+	{
+		uint64_t frame = 0;
+		std::vector<Event> events;
+	};
+
+	// the file of a capture, only touched by the writer thread
+	struct Capture
+	{
+		std::ofstream stream;
+		bool isFirstEvent = true;
+		std::vector<uint32_t> namedThreads;
+	};
+
+	static constexpr uint32_t kGPUThread = ~0u;
+
+	Frame CollectFrame(const GPUProfiler& gpuProfiler);
+
+	void StartCapture(const std::string& path);
+	void SubmitFrame(const std::shared_ptr<const Frame>& frame);
+	void FinishCapture();
+
+	static void WriteFrame(Capture& capture, const Frame& frame);
+
+	Settings mSettings;
+	Stats mStats;
+
+	uint64_t mFrame = 0;
+	std::shared_ptr<Capture> mCapture;
+	std::size_t mRemainingFrames = 0;
+
+	std::string mSpikePathPrefix;
+	double mSpikeThresholdMs = 0.0;
+	std::deque<std::shared_ptr<const Frame>> mHistory;
+
+	// gpu minus cpu time, the smallest seen is the closest to the gpu starting a frame the moment it's submitted
+	double mGPUOffsetUs = 0.0;
+	uint64_t mGPUFrequency = 0;
+	uint64_t mLastGPUFrame = 0;
+
+	std::atomic<std::size_t> mPendingFrames = 0;
+	std::atomic<std::size_t> mWrittenFrames = 0;
+	WorkerPool mWriter;
+};
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "UnitTest.h"
+
+// std
+#include <cstdio>
+#include <exception>
+#include <iostream>
+#include <vector>
+
+//
+#include "Utility.h"
+
+namespace
+{
+	struct Test
+	{
+		std::string name;
+		UnitTest::Function function;
+	};
+
+	// registered from static initializers, so created on first use
+	std::vector<Test>& GetTests()
+	{
+		static std::vector<Test> tests;
+		return tests;
+	}
+
+	// failed checks of the running test
+	int sFailureCount = 0;
+}
+
+bool UnitTest::Register(const std::string& name, Function function)
+{
+	GetTests().push_back({ name, std::move(function) });
+
+	return true;
+}
+
+int UnitTest::Run(const std::string& filter)
+{
+	int failedCount = 0;
+	int runCount = 0;
+
+	for (const Test& test : GetTests())
+	{
+		if (!filter.empty() && (test.name.find(filter) == std::string::npos))
+		{
+			continue;
+		}
+
+		sFailureCount = 0;
+
+		try
+		{
+			test.function();
+		}
+		catch (Exception& exception)
+		{
+			std::wcerr << L"HR Failed\n" << exception.ToString() << L'\n';
+			++sFailureCount;
+		}
+		catch (std::exception& exception)
+		{
+			std::fprintf(stderr, "exception: %s\n", exception.what());
+			++sFailureCount;
+		}
+
+		std::printf("%-6s %s\n", (sFailureCount == 0) ? "ok" : "FAILED", test.name.c_str());
+
+		++runCount;
+		failedCount += (sFailureCount != 0) ? 1 : 0;
+	}
+
+	std::printf("%d of %d tests failed\n", failedCount, runCount);
+
+	return failedCount;
+}
+
+void UnitTest::Fail(const char* file, const int line, const std::string& expression)
+{
+	std::fprintf(stderr, "%s:%d: check failed: %s\n", file, line, expression.c_str());
+	++sFailureCount;
+}
\ No newline at end of file
@@ -0,0 +1,41 @@
+#pragma once
+
+// std
+#include <cmath>
+#include <functional>
+#include <string>
+
+// device-free checks of the cpu side, in the style of MicroBenchmark: a test is registered once and runs
+// its checks, a failed check is reported and the test goes on,
+//
+//     UNIT_TEST(SortKeepsEqualKeys)
+//     {
+//         CHECK(...);
+//         CHECK_NEAR(a, b, 1e-6);
+//     }
+//
+// thrown Exceptions and std::exceptions fail the test they escape from
+class UnitTest
+{
+public:
+
+	using Function = std::function<void()>;
+
+	// for UNIT_TEST, returns true so it can initialize a static
+	static bool Register(const std::string& name, Function function);
+
+	// runs the tests whose name contains filter, all when empty, and returns how many failed
+	static int Run(const std::string& filter);
+
+	static void Fail(const char* file, const int line, const std::string& expression);
+};
+
+#define UNIT_TEST(name) \
+	static void name(); \
+	static const bool name##Registered = UnitTest::Register(#name, name); \
+	static void name()
+
+#define CHECK(expression) \
+	((expression) ? (void)0 : UnitTest::Fail(__FILE__, __LINE__, #expression))
+
+#define CHECK_NEAR(a, b, epsilon) ((std::fabs(double(a) - double(b)) <= double(epsilon)) ? (void)0 : UnitTest::Fail(__FILE__, __LINE__, "|" #a " - " #b "| <= " #epsilon " (" + std::to_string(double(a)) + " vs " + std::to_string(double(b)) + ")"))
\ No newline at end of file
@@ -0,0 +1,31 @@
+#include "UnitTest.h"
+
+// std
+#include <cstdio>
+#include <cstring>
+#include <string>
+
+// the unit tests, built from UnitTests.cpp, UnitTest.cpp and the *Tests.cpp files together with the
+// sources they test; none of them needs a window or a gpu:
+// unittests [--filter text]
+int main(int argc, char* argv[])
+{
+	std::string filter;
+
+	for (int i = 1; i < argc; ++i)
+	{
+		const bool hasValue = (i + 1) < argc;
+
+		if ((std::strcmp(argv[i], "--filter") == 0) && hasValue)
+		{
+			filter = argv[++i];
+		}
+		else
+		{
+			std::fprintf(stderr, "usage: %s [--filter text]\n", argv[0]);
+			return 1;
+		}
+	}
+
+	return (UnitTest::Run(filter) == 0) ? 0 : 1;
+}
\ No newline at end of file
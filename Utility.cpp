@@ -1,7 +1,27 @@
 #include "Utility.h"
 
+#ifdef _WIN32
 // d3d
 #include <d3dcompiler.h>
+#endif // _WIN32
+
+// std
+#include <atomic>
+#include <cstring>
+#include <utility>
+
+#ifndef _WIN32
+// posix
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif // _WIN32
+
+namespace
+{
+	std::atomic<NameResourceHook> gNameResourceHook = nullptr;
+}
 
 void NameResource(ID3D11DeviceChild* pDeviceChild, const std::string& name)
 {
@@ -9,14 +29,25 @@ void NameResource(ID3D11DeviceChild* pDeviceChild, const std::string& name)
 	ThrowIfFailed(pDeviceChild->SetPrivateData(WKPDID_D3DDebugObjectName,
 											   UINT(name.length()),
 											   name.data()));
+#else
+	if (const NameResourceHook hook = gNameResourceHook.load(std::memory_order_acquire))
+	{
+		hook(pDeviceChild, name);
+	}
 #endif // _DEBUG
 }
 
+void SetNameResourceHook(const NameResourceHook hook)
+{
+	gNameResourceHook.store(hook, std::memory_order_release);
+}
+
 ComPtr<ID3DBlob> CompileShader(const std::wstring& fileName,
 							   const D3D_SHADER_MACRO* defines,
 							   const std::string& entryPoint,
 							   const ShaderTarget target)
 {
+#ifdef _WIN32
 	UINT flags = 0;
 #ifdef _DEBUG
 	flags = D3DCOMPILE_DEBUG | D3DCOMPILE_SKIP_OPTIMIZATION;
@@ -59,10 +90,282 @@ ComPtr<ID3DBlob> CompileShader(const std::wstring& fileName,
 	ThrowIfFailed(result);
 
 	return code;
+#else
+	// d3dcompiler only exists on windows, RenderDeviceNull doesn't compile anything
+	ThrowIfFailed(E_NOTIMPL);
+
+	return nullptr;
+#endif // _WIN32
 }
 
 std::wstring ToWideString(const std::string& narrow)
 {
 	// very bad way to convert a narrow string to a wide string
 	return std::wstring(narrow.begin(), narrow.end());
+}
+
+uint64_t HashBytes(const void* data, const std::size_t size, const uint64_t seed)
+{
+	constexpr uint64_t k0 = 0xff51afd7ed558ccdull;
+	constexpr uint64_t k1 = 0xc4ceb9fe1a85ec53ull;
+
+	auto Mix = [](uint64_t x) -> uint64_t
+	{
+		x ^= x >> 33;
+		x *= k0;
+		x ^= x >> 33;
+		x *= k1;
+		x ^= x >> 33;
+		return x;
+	};
+
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	uint64_t hash = seed ^ (uint64_t(size) * k1);
+
+	// consume 8 bytes at a time, texture payloads are large
+	std::size_t i = 0;
+	for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t))
+	{
+		uint64_t word;
+		std::memcpy(&word, bytes + i, sizeof(uint64_t));
+
+		hash ^= Mix(word);
+		hash = (hash << 27) | (hash >> 37);
+		hash = hash * 5 + 0x52dce729;
+	}
+
+	uint64_t tail = 0;
+	std::memcpy(&tail, bytes + i, size - i);
+	hash ^= Mix(tail);
+
+	return Mix(hash);
+}
+
+Hash128 HashBytes128(const void* data, const std::size_t size, const Hash128& seed)
+{
+	constexpr uint64_t c1 = 0x87c37b91114253d5ull;
+	constexpr uint64_t c2 = 0x4cf5ad432745937full;
+
+	auto Rotate = [](const uint64_t x, const int r) -> uint64_t
+	{
+		return (x << r) | (x >> (64 - r));
+	};
+
+	auto Mix = [](uint64_t x) -> uint64_t
+	{
+		x ^= x >> 33;
+		x *= 0xff51afd7ed558ccdull;
+		x ^= x >> 33;
+		x *= 0xc4ceb9fe1a85ec53ull;
+		x ^= x >> 33;
+		return x;
+	};
+
+	const uint8_t* bytes = static_cast<const uint8_t*>(data);
+	uint64_t h1 = seed.low;
+	uint64_t h2 = seed.high;
+
+	// two lanes of 8 bytes, each folded into the other after every block
+	std::size_t i = 0;
+	for (; i + 2 * sizeof(uint64_t) <= size; i += 2 * sizeof(uint64_t))
+	{
+		uint64_t k1;
+		uint64_t k2;
+		std::memcpy(&k1, bytes + i, sizeof(uint64_t));
+		std::memcpy(&k2, bytes + i + sizeof(uint64_t), sizeof(uint64_t));
+
+		h1 ^= Rotate(k1 * c1, 31) * c2;
+		h1 = (Rotate(h1, 27) + h2) * 5 + 0x52dce729;
+
+		h2 ^= Rotate(k2 * c2, 33) * c1;
+		h2 = (Rotate(h2, 31) + h1) * 5 + 0x38495ab5;
+	}
+
+	// a zero tail leaves the lanes as they are
+	uint64_t tail[2] = {};
+	std::memcpy(tail, bytes + i, size - i);
+
+	h1 ^= Rotate(tail[0] * c1, 31) * c2;
+	h2 ^= Rotate(tail[1] * c2, 33) * c1;
+
+	h1 ^= uint64_t(size);
+	h2 ^= uint64_t(size);
+	h1 += h2;
+	h2 += h1;
+	h1 = Mix(h1);
+	h2 = Mix(h2);
+	h1 += h2;
+	h2 += h1;
+
+	return { h1, h2 };
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+	: mData(std::exchange(other.mData, nullptr))
+	, mSize(std::exchange(other.mSize, 0))
+{}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+	if (this != &other)
+	{
+		Close();
+
+		mData = std::exchange(other.mData, nullptr);
+		mSize = std::exchange(other.mSize, 0);
+	}
+
+	return *this;
+}
+
+bool MappedFile::Open(const std::string& path)
+{
+	Close();
+
+#ifdef _WIN32
+	const HANDLE file = CreateFileW(ToWideString(path).c_str(),
+									GENERIC_READ,
+									FILE_SHARE_READ,
+									nullptr,
+									OPEN_EXISTING,
+									FILE_FLAG_SEQUENTIAL_SCAN,
+									nullptr);
+
+	if (file == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size = {};
+	GetFileSizeEx(file, &size);
+
+	// a view keeps the mapping and the file alive, both handles can go right away
+	const HANDLE mapping = (size.QuadPart > 0) ? CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+	CloseHandle(file);
+
+	if (mapping == nullptr)
+	{
+		return false;
+	}
+
+	const void* view = MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+	CloseHandle(mapping);
+
+	if (view == nullptr)
+	{
+		return false;
+	}
+
+	mData = static_cast<const uint8_t*>(view);
+	mSize = std::size_t(size.QuadPart);
+#else
+	const int file = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+
+	if (file < 0)
+	{
+		return false;
+	}
+
+	struct stat status = {};
+
+	if ((fstat(file, &status) != 0) || (status.st_size <= 0))
+	{
+		close(file);
+		return false;
+	}
+
+	void* view = mmap(nullptr, std::size_t(status.st_size), PROT_READ, MAP_PRIVATE, file, 0);
+	close(file);
+
+	if (view == MAP_FAILED)
+	{
+		return false;
+	}
+
+	madvise(view, std::size_t(status.st_size), MADV_SEQUENTIAL);
+
+	mData = static_cast<const uint8_t*>(view);
+	mSize = std::size_t(status.st_size);
+#endif // _WIN32
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+	if (mData == nullptr)
+	{
+		return;
+	}
+
+#ifdef _WIN32
+	UnmapViewOfFile(mData);
+#else
+	munmap(const_cast<uint8_t*>(mData), mSize);
+#endif // _WIN32
+
+	mData = nullptr;
+	mSize = 0;
+}
+
+WorkerPool::WorkerPool(const std::size_t threadCount)
+{
+	for (std::size_t i = 0; i < threadCount; ++i)
+	{
+		mThreads.emplace_back(&WorkerPool::Work, this);
+	}
+}
+
+WorkerPool::~WorkerPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mIsStopping = true;
+	}
+
+	mCondition.notify_all();
+
+	for (std::thread& thread : mThreads)
+	{
+		thread.join();
+	}
+}
+
+WorkerPool& WorkerPool::GetShared()
+{
+	static WorkerPool pool;
+	return pool;
+}
+
+void WorkerPool::Submit(std::function<void()> job)
+{
+	{
+		std::lock_guard<std::mutex> lock(mMutex);
+		mJobs.push_back(std::move(job));
+	}
+
+	mCondition.notify_one();
+}
+
+void WorkerPool::Work()
+{
+	for (;;)
+	{
+		std::function<void()> job;
+
+		{
+			std::unique_lock<std::mutex> lock(mMutex);
+			mCondition.wait(lock, [this]() { return mIsStopping || !mJobs.empty(); });
+
+			if (mJobs.empty())
+			{
+				return;
+			}
+
+			job = std::move(mJobs.front());
+			mJobs.pop_front();
+		}
+
+		job();
+	}
 }
\ No newline at end of file
@@ -2,15 +2,27 @@
 
 // windows
 #include <wrl.h>
+#ifdef _WIN32
 #include <comdef.h>
+#endif // _WIN32
 using Microsoft::WRL::ComPtr;
 
 // d3d
 #include <d3d11.h>
 
 // std
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
 #include <sstream>
 #include <string>
+#include <thread>
+#include <vector>
 
 #ifndef ThrowIfFailed
 #if _DEBUG || 1
@@ -33,8 +45,12 @@ struct Exception
 
     std::wstring ToString() const
     {
+#ifdef _WIN32
         const _com_error err(result);
         const std::wstring msg = err.ErrorMessage();
+#else
+        const std::wstring msg = L"no message outside windows";
+#endif // _WIN32
 
         std::wostringstream woss;
         woss << L"code: 0x" << std::hex << result << '\n';
@@ -49,24 +65,34 @@ struct Exception
 
 inline std::wstring AnsiToWString(const std::string& str)
 {
+#ifdef _WIN32
     WCHAR buffer[512];
     MultiByteToWideChar(CP_ACP, 0, str.c_str(), -1, buffer, 512);
     return std::wstring(buffer);
+#else
+    return std::wstring(str.begin(), str.end());
+#endif // _WIN32
 }
 
 #define ThrowIfFailed(x)                                                      \
 {                                                                             \
     HRESULT hr__ = (x);                                                       \
     std::wstring wfn = AnsiToWString(__FILE__);                               \
-    if (FAILED(hr__)) { throw Exception(hr__, L#x, wfn, __LINE__); } \
+    if (FAILED(hr__)) { throw Exception(hr__, L"" #x, wfn, __LINE__); } \
 }
 #else // _DEBUG
 #define ThrowIfFailed(x) 
 #endif // _DEBUG
 #endif // ThrowIfFailed
 
+// debug object name; hardware objects are only named in debug builds, the null device groups its
+// reports by it and takes it in every build through the hook below
 void NameResource(ID3D11DeviceChild* pDeviceChild, const std::string& name);
 
+// what NameResource calls instead in builds that don't name hardware objects, nullptr for nothing
+using NameResourceHook = void (*)(ID3D11DeviceChild* pDeviceChild, const std::string& name);
+void SetNameResourceHook(const NameResourceHook hook);
+
 enum class ShaderTarget
 {
     VS,
@@ -78,4 +104,146 @@ ComPtr<ID3DBlob> CompileShader(const std::wstring& fileName,
                                const std::string& entryPoint,
                                const ShaderTarget target);
 
-std::wstring ToWideString(const std::string& narrow);
\ No newline at end of file
+std::wstring ToWideString(const std::string& narrow);
+
+// 64 bit non-cryptographic hash used to detect duplicated content, pass the previous
+// result as seed to hash several buffers as if they were one
+uint64_t HashBytes(const void* data, const std::size_t size, const uint64_t seed = 0x9e3779b97f4a7c15ull);
+
+// 128 bit variant (murmur3 x64), wide enough that content with the same hash can be taken as the
+// same without keeping a copy to compare it to; chained through the seed the same way
+struct Hash128
+{
+    uint64_t low = 0;
+    uint64_t high = 0;
+
+    bool operator==(const Hash128&) const = default;
+};
+
+template<>
+struct std::hash<Hash128>
+{
+    std::size_t operator()(const Hash128& hash) const { return std::size_t(hash.low); }
+};
+
+Hash128 HashBytes128(const void* data, const std::size_t size, const Hash128& seed = Hash128());
+
+// read only view of a whole file, backed by mmap or a windows file mapping so parsers can point
+// straight into the page cache instead of a heap copy; pages go away with Close or the destructor
+class MappedFile
+{
+public:
+
+    MappedFile() = default;
+    explicit MappedFile(const std::string& path) { Open(path); }
+    ~MappedFile() { Close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    MappedFile(MappedFile&& other) noexcept;
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    // the whole file is read once front to back by the loaders, the mapping is hinted as such
+    bool Open(const std::string& path);
+    void Close();
+
+    bool IsOpen() const { return mData != nullptr; }
+    const uint8_t* GetData() const { return mData; }
+    std::size_t GetSize() const { return mSize; }
+
+private:
+
+    const uint8_t* mData = nullptr;
+    std::size_t mSize = 0;
+};
+
+// fixed set of threads running submitted jobs in fifo order, jobs still queued when the pool
+// is destroyed are run before the threads are joined; jobs must not throw
+class WorkerPool
+{
+public:
+
+    // one less than the hardware threads and at least one, hardware_concurrency is 0 when unknown
+    explicit WorkerPool(const std::size_t threadCount = std::max(2u, std::thread::hardware_concurrency()) - 1);
+    ~WorkerPool();
+
+    WorkerPool(const WorkerPool&) = delete;
+    WorkerPool& operator=(const WorkerPool&) = delete;
+
+    void Submit(std::function<void()> job);
+
+    std::size_t GetThreadCount() const { return mThreads.size(); }
+
+    // the pool ParallelFor runs on, created on first use and kept for the lifetime of the process
+    static WorkerPool& GetShared();
+
+private:
+
+    void Work();
+
+    std::vector<std::thread> mThreads;
+    std::deque<std::function<void()>> mJobs;
+    std::mutex mMutex;
+    std::condition_variable mCondition;
+    bool mIsStopping = false;
+};
+
+// call f(i) for every i in [0, count) on the shared WorkerPool, the calling thread takes part in the
+// work and returns once every call is done, so it makes progress even while the pool is busy or when
+// called from one of its jobs; f must not throw, report failures through its captures
+template<typename F>
+void ParallelFor(const std::size_t count, F&& f)
+{
+    WorkerPool& pool = WorkerPool::GetShared();
+    const std::size_t helperCount = (count > 1) ? std::min(count - 1, pool.GetThreadCount()) : 0;
+
+    if (helperCount == 0)
+    {
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            f(i);
+        }
+
+        return;
+    }
+
+    // a helper can start after the caller returned, it then finds no index left and only touches this
+    struct State
+    {
+        std::atomic<std::size_t> next = 0;
+        std::size_t doneCount = 0; // guarded by mutex
+        std::mutex mutex;
+        std::condition_variable condition;
+    };
+
+    const auto state = std::make_shared<State>();
+
+    auto Work = [state, count, &f]()
+    {
+        std::size_t doneCount = 0;
+
+        for (std::size_t i = state->next++; i < count; i = state->next++)
+        {
+            f(i);
+            ++doneCount;
+        }
+
+        if (doneCount > 0)
+        {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->doneCount += doneCount;
+            state->condition.notify_all();
+        }
+    };
+
+    for (std::size_t i = 0; i < helperCount; ++i)
+    {
+        pool.Submit(Work);
+    }
+
+    Work();
+
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->condition.wait(lock, [&]() { return state->doneCount == count; });
+}
\ No newline at end of file
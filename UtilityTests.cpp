@@ -0,0 +1,126 @@
+#include "UnitTest.h"
+
+// std
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "RenderDeviceNull.h"
+#include "Utility.h"
+
+// ParallelFor on the shared pool, the content hashes, and resource names
+
+UNIT_TEST(ParallelForCoversEveryIndexOnce)
+{
+	std::vector<std::atomic<int>> calls(1000);
+
+	ParallelFor(calls.size(), [&](const std::size_t i) { ++calls[i]; });
+
+	bool isEveryIndexOnce = true;
+
+	for (const std::atomic<int>& count : calls)
+	{
+		isEveryIndexOnce = isEveryIndexOnce && (count == 1);
+	}
+
+	CHECK(isEveryIndexOnce);
+
+	// nothing to do, and a single index runs on the caller
+	ParallelFor(0, [&](const std::size_t) { CHECK(false); });
+
+	std::thread::id caller;
+	ParallelFor(1, [&](const std::size_t) { caller = std::this_thread::get_id(); });
+
+	CHECK(caller == std::this_thread::get_id());
+}
+
+// the same threads every call, the caller and the shared pool's
+UNIT_TEST(ParallelForReusesThreads)
+{
+	std::mutex mutex;
+	std::set<std::thread::id> threads;
+
+	for (int call = 0; call < 50; ++call)
+	{
+		ParallelFor(64, [&](const std::size_t)
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			threads.insert(std::this_thread::get_id());
+		});
+	}
+
+	CHECK(threads.size() <= WorkerPool::GetShared().GetThreadCount() + 1);
+}
+
+// called from a job of the pool it runs on, the caller does the work its helpers can't get to
+UNIT_TEST(ParallelForFromPoolJob)
+{
+	WorkerPool& pool = WorkerPool::GetShared();
+
+	std::atomic<std::size_t> doneCount = 0;
+	std::atomic<std::size_t> sum = 0;
+
+	for (std::size_t job = 0; job < pool.GetThreadCount(); ++job)
+	{
+		pool.Submit([&]()
+		{
+			ParallelFor(100, [&](const std::size_t i) { sum += i; });
+			++doneCount;
+		});
+	}
+
+	while (doneCount != pool.GetThreadCount())
+	{
+		std::this_thread::yield();
+	}
+
+	CHECK(sum == pool.GetThreadCount() * 4950);
+}
+
+UNIT_TEST(Hash128Content)
+{
+	const std::vector<uint8_t> a(1000, 7);
+	std::vector<uint8_t> b = a;
+
+	CHECK(HashBytes128(a.data(), a.size()) == HashBytes128(b.data(), b.size()));
+
+	// a bit anywhere, the tail too, and the length change it
+	b[500] ^= 1;
+	CHECK(!(HashBytes128(a.data(), a.size()) == HashBytes128(b.data(), b.size())));
+
+	b = a;
+	b.back() ^= 0x80;
+	CHECK(!(HashBytes128(a.data(), a.size()) == HashBytes128(b.data(), b.size())));
+	CHECK(!(HashBytes128(a.data(), a.size()) == HashBytes128(a.data(), a.size() - 1)));
+
+	// chained through the seed, hashing in parts is stable and depends on the order of the parts
+	const Hash128 ab = HashBytes128(a.data() + 16, 100, HashBytes128(a.data(), 16));
+	CHECK(ab == HashBytes128(a.data() + 16, 100, HashBytes128(a.data(), 16)));
+	CHECK(!(ab == HashBytes128(a.data(), 16, HashBytes128(a.data() + 16, 100))));
+}
+
+// the null device gets its names whether or not the build names hardware objects
+UNIT_TEST(NameResourceOnNullDevice)
+{
+	ComPtr<ID3D11Device> device;
+	ComPtr<ID3D11DeviceContext> context;
+	RenderDeviceNull::CreateDevice(device, context);
+
+	D3D11_BUFFER_DESC desc = {};
+	desc.ByteWidth = 16;
+	desc.Usage = D3D11_USAGE_DEFAULT;
+	desc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+
+	ComPtr<ID3D11Buffer> buffer;
+	ThrowIfFailed(device->CreateBuffer(&desc, nullptr, &buffer));
+
+	NameResource(buffer.Get(), "NamedCB");
+
+	char name[16] = {};
+	UINT size = sizeof(name);
+	CHECK(buffer->GetPrivateData(WKPDID_D3DDebugObjectName, &size, name) == S_OK);
+	CHECK(std::string(name, size) == "NamedCB");
+}
\ No newline at end of file
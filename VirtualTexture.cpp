@@ -0,0 +1,318 @@
+#include "VirtualTexture.h"
+
+// std
+#include <algorithm>
+
+uint32_t VirtualTexture::EncodeFeedback(const Page& page)
+{
+	assert((page.x < 4096) && (page.y < 4096) && (page.level < 16));
+	return 0x80000000 | (page.level << 24) | (page.y << 12) | page.x;
+}
+
+bool VirtualTexture::DecodeFeedback(const uint32_t texel, Page& page)
+{
+	page.level = (texel >> 24) & 15;
+	page.y = (texel >> 12) & 4095;
+	page.x = texel & 4095;
+
+	return (texel & 0x80000000) != 0;
+}
+
+uint32_t VirtualTexture::EncodeIndirection(const uint32_t slotX, const uint32_t slotY, const uint32_t level)
+{
+	return slotX | (slotY << 8) | (level << 16) | 0xff000000;
+}
+
+void VirtualTexture::Init(const uint32_t levelCount, const Settings& settings)
+{
+	assert((levelCount > 0) && (levelCount <= 13));
+	assert((settings.slotsX > 0) && (settings.slotsX <= 256) && (settings.slotsY > 0) && (settings.slotsY <= 256));
+
+	mSettings = settings;
+	mStats = Stats();
+
+	mSlotOfPage.assign(levelCount, {});
+	mIndirection.assign(levelCount, {});
+	mDirtyRegions.assign(levelCount, {});
+
+	for (uint32_t level = 0; level < levelCount; ++level)
+	{
+		const std::size_t tileCount = std::size_t(GetTilesPerSide(level)) * GetTilesPerSide(level);
+
+		mSlotOfPage[level].assign(tileCount, kNotResident);
+		mIndirection[level].assign(tileCount, 0);
+		mDirtyRegions[level].level = level;
+	}
+
+	mSlots.assign(std::size_t(settings.slotsX) * settings.slotsY, {});
+	mFreeSlots.clear();
+
+	for (uint32_t slot = uint32_t(mSlots.size()); slot-- > 1;)
+	{
+		mFreeSlots.push_back(slot);
+	}
+
+	mRequests.clear();
+	mFeedbackTexels = 0;
+	mFrame = 1;
+
+	// the single tile level is always there for the others to fall back to
+	const Page root = { levelCount - 1, 0, 0 };
+
+	mSlots[0].isPinned = true;
+	MapPage(root, 0);
+
+	mPendingUploads.assign(1, { root, 0 });
+}
+
+void VirtualTexture::AnalyzeFeedback(const uint32_t* texels, const std::size_t count)
+{
+	mFeedbackTexels += count;
+
+	// neighbouring texels mostly ask for the same page, skip the runs before touching the map
+	uint32_t previous = 0;
+
+	for (std::size_t i = 0; i < count; ++i)
+	{
+		const uint32_t texel = texels[i];
+
+		if (texel == previous)
+		{
+			continue;
+		}
+
+		previous = texel;
+
+		Page page;
+
+		if (!DecodeFeedback(texel, page) ||
+			(page.level >= GetLevelCount()) ||
+			(page.x >= GetTilesPerSide(page.level)) ||
+			(page.y >= GetTilesPerSide(page.level)))
+		{
+			continue;
+		}
+
+		++mRequests[texel];
+
+		// the coarser pages covering it are needed as fallbacks and must outlive it in the cache
+		while (++page.level < GetLevelCount())
+		{
+			page.x >>= 1;
+			page.y >>= 1;
+
+			++mRequests[EncodeFeedback(page)];
+		}
+	}
+}
+
+std::vector<VirtualTexture::Upload> VirtualTexture::Update(std::vector<IndirectionUpdate>* indirectionUpdates)
+{
+	std::vector<Upload> uploads = std::move(mPendingUploads);
+	mPendingUploads.clear();
+
+	// the resident pages that were asked for are used this frame, the others are to be loaded
+	std::vector<std::pair<Page, uint32_t>> missing;
+
+	for (const auto& [texel, count] : mRequests)
+	{
+		Page page;
+		DecodeFeedback(texel, page);
+
+		const uint32_t slot = mSlotOfPage[page.level][GetTileIndex(page)];
+
+		if (slot != kNotResident)
+		{
+			mSlots[slot].lastUsedFrame = mFrame;
+		}
+		else
+		{
+			missing.push_back({ page, count });
+		}
+	}
+
+	mStats.feedbackTexels = mFeedbackTexels;
+	mStats.requestedPages = mRequests.size();
+	mStats.missingPages = missing.size();
+
+	// coarse levels first, a finer page is useless without them, then the most requested
+	std::sort(missing.begin(), missing.end(), [](const auto& a, const auto& b)
+	{
+		if (a.first.level != b.first.level)
+		{
+			return a.first.level > b.first.level;
+		}
+
+		return a.second > b.second;
+	});
+
+	std::size_t loadedCount = 0;
+
+	for (const auto& [page, count] : missing)
+	{
+		if (loadedCount == mSettings.maxUploadsPerUpdate)
+		{
+			break;
+		}
+
+		const uint32_t slot = AcquireSlot();
+
+		if (slot == kNotResident)
+		{
+			break;
+		}
+
+		MapPage(page, slot);
+		mSlots[slot].lastUsedFrame = mFrame;
+
+		uploads.push_back({ page, slot });
+		++loadedCount;
+	}
+
+	mStats.deniedCount += missing.size() - loadedCount;
+	mStats.uploadCount += loadedCount;
+
+	if (indirectionUpdates)
+	{
+		indirectionUpdates->clear();
+
+		for (const IndirectionUpdate& region : mDirtyRegions)
+		{
+			if (region.right > region.left)
+			{
+				indirectionUpdates->push_back(region);
+			}
+		}
+	}
+
+	for (IndirectionUpdate& region : mDirtyRegions)
+	{
+		region.left = region.right = region.top = region.bottom = 0;
+	}
+
+	mRequests.clear();
+	mFeedbackTexels = 0;
+	++mFrame;
+
+	return uploads;
+}
+
+VirtualTexture::Page VirtualTexture::GetResidentPage(const Page& page) const
+{
+	const uint32_t texel = mIndirection[page.level][GetTileIndex(page)];
+	const uint32_t level = (texel >> 16) & 0xff;
+
+	return { level, page.x >> (level - page.level), page.y >> (level - page.level) };
+}
+
+uint32_t VirtualTexture::AcquireSlot()
+{
+	if (!mFreeSlots.empty())
+	{
+		const uint32_t slot = mFreeSlots.back();
+		mFreeSlots.pop_back();
+
+		return slot;
+	}
+
+	uint32_t victim = kNotResident;
+
+	for (uint32_t slot = 0; slot < mSlots.size(); ++slot)
+	{
+		const Slot& candidate = mSlots[slot];
+
+		if (!candidate.isPinned &&
+			(candidate.lastUsedFrame < mFrame) &&
+			((victim == kNotResident) || (candidate.lastUsedFrame < mSlots[victim].lastUsedFrame)))
+		{
+			victim = slot;
+		}
+	}
+
+	if (victim != kNotResident)
+	{
+		UnmapPage(mSlots[victim].page);
+		++mStats.evictionCount;
+	}
+
+	return victim;
+}
+
+void VirtualTexture::MapPage(const Page& page, const uint32_t slot)
+{
+	mSlotOfPage[page.level][GetTileIndex(page)] = slot;
+
+	mSlots[slot].page = page;
+
+	++mStats.residentPages;
+
+	// the tiles that fell back to coarser pages now have this one
+	SetIndirection(page, slot, page.level, page.level, GetLevelCount() - 1);
+}
+
+void VirtualTexture::UnmapPage(const Page& page)
+{
+	mSlotOfPage[page.level][GetTileIndex(page)] = kNotResident;
+
+	--mStats.residentPages;
+
+	// the tiles that had this page fall back to the closest resident parent, the pinned root at worst
+	Page parent = page;
+	uint32_t parentSlot = kNotResident;
+
+	while (parentSlot == kNotResident)
+	{
+		++parent.level;
+		parent.x >>= 1;
+		parent.y >>= 1;
+
+		parentSlot = mSlotOfPage[parent.level][GetTileIndex(parent)];
+	}
+
+	SetIndirection(page, parentSlot, parent.level, page.level, page.level);
+}
+
+void VirtualTexture::SetIndirection(const Page& page, const uint32_t slot, const uint32_t level, const uint32_t minLevel, const uint32_t maxLevel)
+{
+	const uint32_t texel = EncodeIndirection(slot % mSettings.slotsX, slot / mSettings.slotsX, level);
+
+	for (uint32_t tileLevel = 0; tileLevel <= page.level; ++tileLevel)
+	{
+		// the tiles of this level under page
+		const uint32_t scale = 1u << (page.level - tileLevel);
+		const uint32_t left = page.x * scale;
+		const uint32_t top = page.y * scale;
+		const uint32_t tilesPerSide = GetTilesPerSide(tileLevel);
+
+		std::vector<uint32_t>& indirection = mIndirection[tileLevel];
+
+		for (uint32_t y = top; y < top + scale; ++y)
+		{
+			for (uint32_t x = left; x < left + scale; ++x)
+			{
+				uint32_t& current = indirection[std::size_t(y) * tilesPerSide + x];
+				const uint32_t currentLevel = (current >> 16) & 0xff;
+
+				// tiles that were never set only exist before the root is mapped
+				if ((current == 0) || ((currentLevel >= minLevel) && (currentLevel <= maxLevel)))
+				{
+					current = texel;
+				}
+			}
+		}
+
+		IndirectionUpdate& region = mDirtyRegions[tileLevel];
+
+		if (region.right == region.left)
+		{
+			region = { tileLevel, left, top, left + scale, top + scale };
+		}
+		else
+		{
+			region.left = std::min(region.left, left);
+			region.top = std::min(region.top, top);
+			region.right = std::max(region.right, left + scale);
+			region.bottom = std::max(region.bottom, top + scale);
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,145 @@
+#pragma once
+
+// std
+#include <cassert>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// page management of a virtual texture: a quadtree of mip tiles (pages) mapped into a fixed cache of
+// physical slots. the renderer's feedback says which pages were sampled, Update turns the missing ones
+// into uploads, coarse pages first, recycling the least recently used slots, and keeps an indirection
+// table that points every tile at the finest resident page covering it. there are no device calls,
+// so it can be driven by synthetic feedback
+class VirtualTexture
+{
+public:
+
+	struct Settings
+	{
+		uint32_t slotsX = 32; // physical cache in tiles, the single tile level is pinned in one slot
+		uint32_t slotsY = 32;
+		std::size_t maxUploadsPerUpdate = 16; // bounds the tile copies a single frame can trigger
+	};
+
+	struct Page
+	{
+		uint32_t level = 0;
+		uint32_t x = 0;
+		uint32_t y = 0;
+	};
+
+	// copy the tile of page into slot of the physical texture
+	struct Upload
+	{
+		Page page;
+		uint32_t slot = 0;
+	};
+
+	// texels of an indirection level that changed, right and bottom excluded
+	struct IndirectionUpdate
+	{
+		uint32_t level = 0;
+		uint32_t left = 0;
+		uint32_t top = 0;
+		uint32_t right = 0;
+		uint32_t bottom = 0;
+	};
+
+	struct Stats
+	{
+		std::size_t feedbackTexels = 0;  // analyzed during the last frame
+		std::size_t requestedPages = 0;  // distinct pages of the last frame, their coarser levels included
+		std::size_t missingPages = 0;    // requested but not resident
+		std::size_t residentPages = 0;
+		std::size_t uploadCount = 0;     // totals since the start
+		std::size_t evictionCount = 0;
+		std::size_t deniedCount = 0;     // missing pages left for a later frame
+	};
+
+	// a feedback texel has x in bits 0-11, y in 12-23, the level in 24-27 and bit 31 set, 0 means no request
+	static uint32_t EncodeFeedback(const Page& page);
+	static bool DecodeFeedback(const uint32_t texel, Page& page);
+
+	// an indirection texel is rgba8 uint: slot x, slot y, level of the page in the slot, 255
+	static uint32_t EncodeIndirection(const uint32_t slotX, const uint32_t slotY, const uint32_t level);
+
+	// levelCount levels down to a single tile, the level below it has 2x2 tiles and so on
+	void Init(const uint32_t levelCount, const Settings& settings);
+
+	// collect the pages a feedback buffer asks for, several calls per frame add up
+	void AnalyzeFeedback(const uint32_t* texels, const std::size_t count);
+
+	// close the frame: pick the slots for the missing pages and return the tiles to copy, the first
+	// call also returns the pinned page; indirectionUpdates receives the regions to upload after them
+	std::vector<Upload> Update(std::vector<IndirectionUpdate>* indirectionUpdates = nullptr);
+
+	bool IsResident(const Page& page) const
+	{
+		return mSlotOfPage[page.level][GetTileIndex(page)] != kNotResident;
+	}
+
+	// the finest resident page covering a tile, as the indirection table has it
+	Page GetResidentPage(const Page& page) const;
+
+	// one texel per tile of the level, row major
+	const std::vector<uint32_t>& GetIndirection(const uint32_t level) const
+	{
+		assert(level < mIndirection.size());
+		return mIndirection[level];
+	}
+
+	uint32_t GetLevelCount() const
+	{
+		return uint32_t(mSlotOfPage.size());
+	}
+
+	uint32_t GetTilesPerSide(const uint32_t level) const
+	{
+		return (1u << (GetLevelCount() - 1)) >> level;
+	}
+
+	const Settings& GetSettings() const { return mSettings; }
+	const Stats& GetStats() const { return mStats; }
+
+private:
+
+	static constexpr uint32_t kNotResident = UINT32_MAX;
+
+	struct Slot
+	{
+		Page page;
+		uint64_t lastUsedFrame = 0;
+		bool isPinned = false;
+	};
+
+	std::size_t GetTileIndex(const Page& page) const
+	{
+		assert((page.level < GetLevelCount()) && (page.x < GetTilesPerSide(page.level)) && (page.y < GetTilesPerSide(page.level)));
+		return std::size_t(page.y) * GetTilesPerSide(page.level) + page.x;
+	}
+
+	// a free slot, or the least recently used one that wasn't asked for this frame; kNotResident if none
+	uint32_t AcquireSlot();
+
+	void MapPage(const Page& page, const uint32_t slot);
+	void UnmapPage(const Page& page);
+
+	// point the tiles under page whose indirection level is in [minLevel, maxLevel] at slot
+	void SetIndirection(const Page& page, const uint32_t slot, const uint32_t level, const uint32_t minLevel, const uint32_t maxLevel);
+
+	Settings mSettings;
+	Stats mStats;
+
+	std::vector<std::vector<uint32_t>> mSlotOfPage; // the quadtree, a slot or kNotResident per tile of each level
+	std::vector<std::vector<uint32_t>> mIndirection;
+	std::vector<Slot> mSlots;
+	std::vector<uint32_t> mFreeSlots;
+
+	std::unordered_map<uint32_t, uint32_t> mRequests; // feedback texel to request count
+	std::size_t mFeedbackTexels = 0;
+	std::vector<Upload> mPendingUploads;
+	std::vector<IndirectionUpdate> mDirtyRegions;      // one per level, empty when right == left
+
+	uint64_t mFrame = 1;
+};
\ No newline at end of file
@@ -0,0 +1,202 @@
+#include "VirtualTexturePageFile.h"
+
+// std
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+
+// d3d
+#include "BlockDecoder.h"
+#include "DDSTextureLoader11.h"
+using namespace DirectX;
+
+namespace
+{
+	constexpr uint32_t kMagic = 0x46505456; // "VTPF"
+	constexpr uint32_t kVersion = 1;
+	constexpr std::size_t kAlignment = 4096;
+
+	std::size_t AlignUp(const std::size_t value, const std::size_t alignment)
+	{
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	// texels along the side of a block, or 1 for uncompressed formats
+	uint32_t GetBlockDimension(const DXGI_FORMAT format)
+	{
+		return BlockDecoder::IsSupportedFormat(format) ? 4 : 1;
+	}
+
+	// bytes of a block, or of a texel for uncompressed formats
+	std::size_t GetElementSize(const DXGI_FORMAT format)
+	{
+		return BlockDecoder::IsSupportedFormat(format) ? BlockDecoder::GetBlockSize(format) : 4;
+	}
+
+	bool IsPowerOfTwo(const uint32_t value)
+	{
+		return (value > 0) && ((value & (value - 1)) == 0);
+	}
+}
+
+bool VirtualTexturePageFile::IsSupportedFormat(const DXGI_FORMAT format)
+{
+	switch (format)
+	{
+		case DXGI_FORMAT_R8G8B8A8_UNORM:
+		case DXGI_FORMAT_R8G8B8A8_UNORM_SRGB:
+		case DXGI_FORMAT_B8G8R8A8_UNORM:
+		case DXGI_FORMAT_B8G8R8A8_UNORM_SRGB:
+			return true;
+		default:
+			return BlockDecoder::IsSupportedFormat(format);
+	}
+}
+
+std::vector<uint8_t> VirtualTexturePageFile::Build(const uint8_t* ddsData, const std::size_t ddsDataSize, const Settings& settings)
+{
+	DDSTextureInfo info;
+	const uint8_t* bitData = nullptr;
+	std::size_t bitSize = 0;
+
+	ThrowIfFailed(GetDDSTextureInfoFromMemory(ddsData, ddsDataSize, &info, &bitData, &bitSize));
+
+	const uint32_t blockDimension = GetBlockDimension(info.format);
+	const std::size_t elementSize = GetElementSize(info.format);
+
+	assert(IsSupportedFormat(info.format));
+	assert(info.resourceDimension == D3D11_RESOURCE_DIMENSION_TEXTURE2D);
+	assert((info.arraySize == 1) && (info.isCubeMap == 0));
+	assert((info.width == info.height) && IsPowerOfTwo(info.width));
+	assert(IsPowerOfTwo(settings.tileSize) && (settings.tileSize <= info.width));
+	assert((settings.tileSize % blockDimension == 0) && (settings.border % blockDimension == 0));
+
+	Header header;
+	header.magic = kMagic;
+	header.version = kVersion;
+	header.format = info.format;
+	header.size = info.width;
+	header.tileSize = settings.tileSize;
+	header.border = settings.border;
+
+	while ((info.width >> header.levelCount) >= settings.tileSize)
+	{
+		++header.levelCount;
+	}
+
+	assert(header.levelCount <= info.mipCount);
+
+	// everything below is counted in blocks, or texels for uncompressed formats
+	const uint32_t tileElements = settings.tileSize / blockDimension;
+	const uint32_t borderElements = settings.border / blockDimension;
+	const uint32_t borderedElements = tileElements + 2 * borderElements;
+
+	header.tileBytes = uint32_t(std::size_t(borderedElements) * borderedElements * elementSize);
+	header.tileStride = uint32_t(AlignUp(header.tileBytes, kAlignment));
+
+	std::vector<D3D11_SUBRESOURCE_DATA> mips(info.mipCount);
+	ThrowIfFailed(GetDDSSubresourceData(info, bitData, bitSize, mips.data()));
+
+	const uint32_t lastLevel = header.levelCount - 1;
+	std::vector<uint8_t> result(GetTileOffset(header, lastLevel, 0, 0) + header.tileStride, 0);
+	std::memcpy(result.data(), &header, sizeof(header));
+
+	for (uint32_t level = 0; level < header.levelCount; ++level)
+	{
+		const uint32_t tilesPerSide = header.GetTilesPerSide(level);
+		const uint32_t levelElements = tilesPerSide * tileElements;
+		const D3D11_SUBRESOURCE_DATA& mip = mips[level];
+
+		ParallelFor(std::size_t(tilesPerSide) * tilesPerSide, [&](const std::size_t tile)
+		{
+			const uint32_t tileX = uint32_t(tile % tilesPerSide);
+			const uint32_t tileY = uint32_t(tile / tilesPerSide);
+
+			uint8_t* dst = result.data() + GetTileOffset(header, level, tileX, tileY);
+
+			// first element of the bordered tile in the level, the border can reach past the edges
+			const int32_t left = int32_t(tileX * tileElements) - int32_t(borderElements);
+			const int32_t top = int32_t(tileY * tileElements) - int32_t(borderElements);
+
+			for (uint32_t row = 0; row < borderedElements; ++row)
+			{
+				const int32_t sourceRow = std::clamp(top + int32_t(row), 0, int32_t(levelElements) - 1);
+				const uint8_t* src = static_cast<const uint8_t*>(mip.pSysMem) + std::size_t(sourceRow) * mip.SysMemPitch;
+
+				for (uint32_t column = 0; column < borderedElements; ++column)
+				{
+					const int32_t sourceColumn = std::clamp(left + int32_t(column), 0, int32_t(levelElements) - 1);
+					std::memcpy(dst + (std::size_t(row) * borderedElements + column) * elementSize, src + sourceColumn * elementSize, elementSize);
+				}
+			}
+		});
+	}
+
+	return result;
+}
+
+void VirtualTexturePageFile::Build(const std::string& sourcePath, const std::string& destinationPath, const Settings& settings)
+{
+	std::vector<uint8_t> result;
+
+	{
+		MappedFile source(sourcePath);
+		assert(source.IsOpen());
+
+		result = Build(source.GetData(), source.GetSize(), settings);
+	}
+
+	std::ofstream stream(destinationPath, std::ios::binary);
+	assert(stream);
+
+	stream.write(reinterpret_cast<const char*>(result.data()), result.size());
+}
+
+bool VirtualTexturePageFile::Open(const std::string& path)
+{
+	Close();
+
+	if (!mFile.Open(path))
+	{
+		return false;
+	}
+
+	if (mFile.GetSize() >= sizeof(Header))
+	{
+		std::memcpy(&mHeader, mFile.GetData(), sizeof(Header));
+	}
+
+	const bool isValid = (mHeader.magic == kMagic) &&
+						 (mHeader.version == kVersion) &&
+						 (mHeader.levelCount > 0) &&
+						 (mFile.GetSize() >= GetTileOffset(mHeader, mHeader.levelCount - 1, 0, 0) + mHeader.tileBytes);
+
+	if (!isValid)
+	{
+		Close();
+	}
+
+	return isValid;
+}
+
+std::size_t VirtualTexturePageFile::GetTileRowPitch() const
+{
+	const DXGI_FORMAT format = DXGI_FORMAT(mHeader.format);
+
+	return std::size_t(mHeader.GetBorderedTileSize() / GetBlockDimension(format)) * GetElementSize(format);
+}
+
+std::size_t VirtualTexturePageFile::GetTileOffset(const Header& header, const uint32_t level, const uint32_t x, const uint32_t y)
+{
+	// levels follow each other from the top, tiles row major within a level
+	std::size_t tile = 0;
+
+	for (uint32_t i = 0; i < level; ++i)
+	{
+		tile += std::size_t(header.GetTilesPerSide(i)) * header.GetTilesPerSide(i);
+	}
+
+	tile += std::size_t(y) * header.GetTilesPerSide(level) + x;
+
+	return AlignUp(sizeof(Header), kAlignment) + tile * header.tileStride;
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+
+// std
+#include <cassert>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// d3d
+#include <d3d11.h>
+
+//
+#include "Utility.h"
+
+// tiled page file of a virtual texture: the mips of a square DDS are cut into tiles carrying a border
+// of their neighbours' texels, so pages can be filtered in the physical cache without seams. tiles have
+// a fixed size padded to 4 KiB, so one is found by arithmetic and read straight from the mapping
+class VirtualTexturePageFile
+{
+public:
+
+	struct Settings
+	{
+		uint32_t tileSize = 128; // texels inside the border, a power of two
+		uint32_t border = 4;     // texels on each side, whole blocks for block compressed formats
+	};
+
+	// what precedes the tiles in the file, which start at the first 4 KiB boundary after it
+	struct Header
+	{
+		uint32_t magic = 0;
+		uint32_t version = 0;
+		uint32_t format = DXGI_FORMAT_UNKNOWN;
+		uint32_t size = 0;       // texels across the top level
+		uint32_t tileSize = 0;
+		uint32_t border = 0;
+		uint32_t levelCount = 0; // down to the level made of a single tile
+		uint32_t tileBytes = 0;  // texels of a bordered tile
+		uint32_t tileStride = 0; // tileBytes padded to 4 KiB
+
+		uint32_t GetTilesPerSide(const uint32_t level) const
+		{
+			return (size / tileSize) >> level;
+		}
+
+		uint32_t GetBorderedTileSize() const
+		{
+			return tileSize + 2 * border;
+		}
+	};
+
+	// 8 bit rgba and bgra, srgb or not, and the block compressed formats BlockDecoder knows
+	static bool IsSupportedFormat(const DXGI_FORMAT format);
+
+	// the top level must be square, a power of two and at least one tile, and its chain must reach
+	// the single tile level; texels past the edges of the texture are clamped
+	static std::vector<uint8_t> Build(const uint8_t* ddsData, const std::size_t ddsDataSize, const Settings& settings);
+
+	static void Build(const std::string& sourcePath, const std::string& destinationPath, const Settings& settings);
+
+	bool Open(const std::string& path);
+
+	void Close()
+	{
+		mFile.Close();
+		mHeader = Header();
+	}
+
+	bool IsOpen() const
+	{
+		return mFile.IsOpen();
+	}
+
+	const Header& GetHeader() const
+	{
+		return mHeader;
+	}
+
+	// rows of whole blocks for block compressed formats
+	std::size_t GetTileRowPitch() const;
+
+	// the bordered texels of a tile, in the mapping; touching them is what reads the tile from disk
+	const uint8_t* GetTile(const uint32_t level, const uint32_t x, const uint32_t y) const
+	{
+		assert(IsOpen());
+		assert((level < mHeader.levelCount) && (x < mHeader.GetTilesPerSide(level)) && (y < mHeader.GetTilesPerSide(level)));
+
+		return mFile.GetData() + GetTileOffset(mHeader, level, x, y);
+	}
+
+private:
+
+	static std::size_t GetTileOffset(const Header& header, const uint32_t level, const uint32_t x, const uint32_t y);
+
+	MappedFile mFile;
+	Header mHeader;
+};
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include "UnitTest.h"
+
+// std
+#include <cstdint>
+#include <map>
+#include <vector>
+
+#include "VirtualTexture.h"
+
+// VirtualTexture fed synthetic feedback buffers, the page table and the residency it ends up with are
+// checked against the uploads it asked for
+
+namespace
+{
+	using Page = VirtualTexture::Page;
+
+	constexpr uint32_t kLevelCount = 5; // 16x16 tiles at level 0
+
+	// a width x width screen's worth of feedback, pages[i] covering the i-th band of rows
+	std::vector<uint32_t> CreateFeedback(const std::vector<Page>& pages, const std::size_t width = 64)
+	{
+		std::vector<uint32_t> texels(width * width, 0);
+
+		for (std::size_t i = 0; i < texels.size(); ++i)
+		{
+			const std::size_t band = (i / width) * pages.size() / width;
+			texels[i] = VirtualTexture::EncodeFeedback(pages[band]);
+		}
+
+		return texels;
+	}
+
+	// what the caller of Update keeps, the page copied into each slot
+	struct Cache
+	{
+		VirtualTexture virtualTexture;
+		std::map<uint32_t, Page> slots;
+		std::size_t uploadCount = 0;
+
+		explicit Cache(const VirtualTexture::Settings& settings)
+		{
+			virtualTexture.Init(kLevelCount, settings);
+		}
+
+		void Frame(const std::vector<uint32_t>& feedback)
+		{
+			virtualTexture.AnalyzeFeedback(feedback.data(), feedback.size());
+
+			const std::vector<VirtualTexture::Upload> uploads = virtualTexture.Update();
+
+			for (const VirtualTexture::Upload& upload : uploads)
+			{
+				slots[upload.slot] = upload.page;
+			}
+
+			uploadCount = uploads.size();
+		}
+
+		// the finest resident page over the tile, walking up the quadtree
+		Page FindResidentPage(Page page) const
+		{
+			while (!virtualTexture.IsResident(page))
+			{
+				++page.level;
+				page.x >>= 1;
+				page.y >>= 1;
+			}
+
+			return page;
+		}
+
+		// every tile of every level points at the finest resident page over it, through the slot that page
+		// was copied to
+		bool IsPageTableValid() const
+		{
+			const uint32_t slotsX = virtualTexture.GetSettings().slotsX;
+
+			for (uint32_t level = 0; level < kLevelCount; ++level)
+			{
+				const std::vector<uint32_t>& indirection = virtualTexture.GetIndirection(level);
+
+				for (uint32_t y = 0; y < virtualTexture.GetTilesPerSide(level); ++y)
+				{
+					for (uint32_t x = 0; x < virtualTexture.GetTilesPerSide(level); ++x)
+					{
+						const Page expected = FindResidentPage({ level, x, y });
+						const Page resident = virtualTexture.GetResidentPage({ level, x, y });
+
+						const uint32_t texel = indirection[std::size_t(y) * virtualTexture.GetTilesPerSide(level) + x];
+						const uint32_t slot = (texel & 0xff) + ((texel >> 8) & 0xff) * slotsX;
+						const auto it = slots.find(slot);
+
+						if ((resident.level != expected.level) || (resident.x != expected.x) || (resident.y != expected.y) ||
+							(it == slots.end()) ||
+							(it->second.level != expected.level) || (it->second.x != expected.x) || (it->second.y != expected.y))
+						{
+							return false;
+						}
+					}
+				}
+			}
+
+			return true;
+		}
+	};
+}
+
+UNIT_TEST(VirtualTextureFeedbackEncoding)
+{
+	Page page;
+
+	CHECK(VirtualTexture::DecodeFeedback(VirtualTexture::EncodeFeedback({ 3, 4095, 17 }), page));
+	CHECK((page.level == 3) && (page.x == 4095) && (page.y == 17));
+	CHECK(!VirtualTexture::DecodeFeedback(0, page));
+}
+
+UNIT_TEST(VirtualTextureFeedbackResidency)
+{
+	Cache cache({});
+
+	// a level 0 and a level 1 page, and texels the analysis has to drop: nothing sampled, a level past the
+	// last and a tile past the edge of its level
+	std::vector<uint32_t> feedback = CreateFeedback({ { 0, 3, 5 }, { 1, 6, 6 } });
+	feedback[0] = 0;
+	feedback[1] = VirtualTexture::EncodeFeedback({ kLevelCount, 0, 0 });
+	feedback[2] = VirtualTexture::EncodeFeedback({ 2, 4, 0 });
+
+	cache.Frame(feedback);
+
+	const VirtualTexture::Stats& stats = cache.virtualTexture.GetStats();
+
+	// the two pages and their parents up to the root, which is pinned and resident from the start
+	CHECK(stats.feedbackTexels == feedback.size());
+	CHECK(stats.requestedPages == 8);
+	CHECK(stats.missingPages == 7);
+	CHECK(cache.uploadCount == 8);
+	CHECK(stats.residentPages == 8);
+	CHECK(stats.deniedCount == 0);
+
+	CHECK(cache.virtualTexture.IsResident({ 0, 3, 5 }));
+	CHECK(cache.virtualTexture.IsResident({ 2, 3, 3 }));
+	CHECK(!cache.virtualTexture.IsResident({ 0, 15, 15 }));
+	CHECK(!cache.virtualTexture.IsResident({ 2, 1, 1 }));
+
+	// tiles nobody asked for fall back to the parents the requests brought in
+	const Page fallback = cache.virtualTexture.GetResidentPage({ 0, 15, 15 });
+	CHECK((fallback.level == 2) && (fallback.x == 3) && (fallback.y == 3));
+
+	CHECK(cache.IsPageTableValid());
+
+	// nothing new the next frame
+	cache.Frame(feedback);
+
+	CHECK(cache.uploadCount == 0);
+	CHECK(cache.IsPageTableValid());
+}
+
+// coarse levels go first when the uploads of a frame are capped, the rest follow the next frames
+UNIT_TEST(VirtualTextureUploadLimit)
+{
+	VirtualTexture::Settings settings;
+	settings.maxUploadsPerUpdate = 2;
+
+	Cache cache(settings);
+
+	const std::vector<uint32_t> feedback = CreateFeedback({ { 0, 3, 5 }, { 1, 6, 6 } });
+
+	cache.Frame(feedback);
+
+	CHECK(cache.uploadCount == 3); // the pinned root and two
+	CHECK(cache.virtualTexture.GetStats().deniedCount == 5);
+	CHECK(cache.virtualTexture.IsResident({ 3, 0, 0 }) && cache.virtualTexture.IsResident({ 3, 1, 1 }));
+	CHECK(!cache.virtualTexture.IsResident({ 0, 3, 5 }));
+	CHECK(cache.IsPageTableValid());
+
+	for (int frame = 0; frame < 3; ++frame)
+	{
+		cache.Frame(feedback);
+		CHECK(cache.IsPageTableValid());
+	}
+
+	CHECK(cache.virtualTexture.IsResident({ 0, 3, 5 }) && cache.virtualTexture.IsResident({ 1, 6, 6 }));
+}
+
+// four slots, one of them the root's: a new region of the texture recycles the pages of the last one
+UNIT_TEST(VirtualTextureEviction)
+{
+	VirtualTexture::Settings settings;
+	settings.slotsX = 2;
+	settings.slotsY = 2;
+
+	Cache cache(settings);
+
+	cache.Frame(CreateFeedback({ { 2, 0, 0 } }));
+
+	CHECK(cache.virtualTexture.IsResident({ 2, 0, 0 }) && cache.virtualTexture.IsResident({ 3, 0, 0 }));
+	CHECK(cache.IsPageTableValid());
+
+	cache.Frame(CreateFeedback({ { 2, 3, 3 } }));
+
+	const VirtualTexture::Stats& stats = cache.virtualTexture.GetStats();
+
+	CHECK(cache.virtualTexture.IsResident({ 2, 3, 3 }) && cache.virtualTexture.IsResident({ 3, 1, 1 }));
+	CHECK(stats.evictionCount == 1);
+	CHECK(stats.residentPages == 4);
+	CHECK(stats.deniedCount == 0);
+	CHECK(cache.IsPageTableValid());
+
+	// the pages asked for this frame are never the ones evicted for it
+	cache.Frame(CreateFeedback({ { 2, 3, 3 }, { 1, 0, 0 } }));
+
+	CHECK(cache.virtualTexture.IsResident({ 2, 3, 3 }) && cache.virtualTexture.IsResident({ 3, 1, 1 }));
+	CHECK(cache.IsPageTableValid());
+}
\ No newline at end of file
@@ -18,13 +18,65 @@ struct MaterialData
 	float4x4 uvTransform;
 };
 
+// GPU side layout of a material, it must match PackedMaterial in MaterialManager.h
+struct PackedMaterialData
+{
+	uint2 diffuse;          // half4
+	uint2 fresnelRoughness; // half4, xyz = fresnel, w = roughness
+	uint2 uvScaleRotation;  // half4, uvTransform _11 _12 _21 _22
+	uint  uvTranslation;    // half2, uvTransform _41 _42
+	uint  textureIndices;   // 16 bit diffuse | 16 bit normal, 0xffff = no texture
+};
+
 // material buffer, it contains all materials
-StructuredBuffer<MaterialData> gMaterialBuffer : register(t0);
+StructuredBuffer<PackedMaterialData> gMaterialBuffer : register(t0);
+
+float2 UnpackHalf2(const uint packed)
+{
+	return f16tof32(uint2(packed, packed >> 16));
+}
+
+float4 UnpackHalf4(const uint2 packed)
+{
+	return float4(UnpackHalf2(packed.x), UnpackHalf2(packed.y));
+}
+
+int UnpackTextureIndex(const uint packed)
+{
+	return (packed == 0xffff) ? -1 : int(packed);
+}
+
+MaterialData LoadMaterial(const uint index)
+{
+	const PackedMaterialData packed = gMaterialBuffer[index];
+
+	MaterialData material;
+
+	material.diffuse = UnpackHalf4(packed.diffuse);
+
+	const float4 fresnelRoughness = UnpackHalf4(packed.fresnelRoughness);
+	material.fresnel = fresnelRoughness.xyz;
+	material.roughness = fresnelRoughness.w;
+
+	material.diffuseTextureIndex = UnpackTextureIndex(packed.textureIndices & 0xffff);
+	material.normalTextureIndex = UnpackTextureIndex(packed.textureIndices >> 16);
+	material.padding = 0.0f;
+
+	// rebuild uvTransform as it was seen by the shader when the full matrix was uploaded (column major)
+	const float4 scaleRotation = UnpackHalf4(packed.uvScaleRotation);
+	const float2 translation = UnpackHalf2(packed.uvTranslation);
+
+	material.uvTransform = float4x4(scaleRotation.x, scaleRotation.z, 0.0f, translation.x,
+									scaleRotation.y, scaleRotation.w, 0.0f, translation.y,
+									0.0f,            0.0f,            1.0f, 0.0f,
+									0.0f,            0.0f,            0.0f, 1.0f);
+
+	return material;
+}
 
-// Texture2DArray gDiffuseTextures : register(t1);
-// Texture2DArray gNormalTextures : register(t2);
-Texture2D gDiffuseTextures : register(t1);
-Texture2D gNormalTextures : register(t2);
+// textures grouped by TextureManager::LoadTexturesIntoArrays, indexed by the material texture indices
+Texture2DArray gDiffuseTextures : register(t1);
+Texture2DArray gNormalTextures : register(t2);
 
 Texture2D<float> gShadowResolve : register(t3);
 #if REFLECTIVE_SURFACE
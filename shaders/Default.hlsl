@@ -52,7 +52,7 @@ DefaultVSOut DefaultVS(DefaultVSIn vin)
 {
 	DefaultVSOut vout;
 
-	const MaterialData material = gMaterialBuffer[gMaterialIndex];
+	const MaterialData material = LoadMaterial(gMaterialIndex);
 	
 // #ifdef SKINNED
 //     float weights[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
@@ -110,8 +110,7 @@ void GetDiffuseAndNormal(const DefaultVSOut pin,
 	diffuse = material.diffuse;
 	if (material.diffuseTextureIndex != -1)
 	{
-		// diffuse *= gDiffuseTextures.Sample(gSamplerLinearWrap, float3(pin.uv, material.diffuseTextureIndex));
-		diffuse *= gDiffuseTextures.Sample(gSamplerLinearWrap, pin.uv);
+		diffuse *= gDiffuseTextures.Sample(gSamplerLinearWrap, float3(pin.uv, material.diffuseTextureIndex));
 	}
 
 #if ALPHA_TEST
@@ -131,8 +130,7 @@ void GetDiffuseAndNormal(const DefaultVSOut pin,
 #else // WATER_NORMAL_MAPPING
 	if (material.normalTextureIndex != -1)
 	{
-		// const float4 normalTexel = gNormalTextures.Sample(gSamplerLinearWrap, float3(pin.uv, material.normalTextureIndex));
-		const float4 normalTexel = gNormalTextures.Sample(gSamplerLinearWrap, pin.uv);
+		const float4 normalTexel = gNormalTextures.Sample(gSamplerLinearWrap, float3(pin.uv, material.normalTextureIndex));
 		normal = NormalSampleToWorldSpace(normalTexel, normalize(pin.normal), pin.tangent);
 	}
 	else
@@ -144,7 +142,7 @@ void GetDiffuseAndNormal(const DefaultVSOut pin,
 
 float4 DefaultImpl(const DefaultVSOut pin, const int materialIndex)
 {
-	const MaterialData material = gMaterialBuffer[materialIndex];
+	const MaterialData material = LoadMaterial(materialIndex);
 
 	float4 diffuse;
 	float3 normal;
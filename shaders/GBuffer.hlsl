@@ -9,7 +9,7 @@
 
 float4 GBufferPS(const DefaultVSOut pin) : SV_Target0
 {
-	const MaterialData material = gMaterialBuffer[gMaterialIndex];
+	const MaterialData material = LoadMaterial(gMaterialIndex);
 
 	float4 diffuse;
 	float3 normal;
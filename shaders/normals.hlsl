@@ -24,7 +24,7 @@ VertexOut VS(VertexIn vin)
 {
 	VertexOut vout;
 
-	const MaterialData material = gMaterialBuffer[gMaterialIndex];
+	const MaterialData material = LoadMaterial(gMaterialIndex);
 
 #ifdef SKINNED
     float weights[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
@@ -65,7 +65,7 @@ VertexOut VS(VertexIn vin)
 
 float4 PS(const VertexOut pin) : SV_Target
 {
-	const MaterialData material = gMaterialBuffer[gMaterialIndex];
+	const MaterialData material = LoadMaterial(gMaterialIndex);
 
 	const float4 DiffuseAlbedo = gDiffuseTexture[material.DiffuseTextureIndex].Sample(gSamplerLinearWrap, pin.TexCoord) * material.DiffuseAlbedo;
 
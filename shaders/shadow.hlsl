@@ -20,7 +20,7 @@ VertexOut VS(VertexIn vin)
 {
 	VertexOut vout = (VertexOut)0.0f;
 
-	MaterialData material = gMaterialBuffer[gMaterialIndex];
+	MaterialData material = LoadMaterial(gMaterialIndex);
 	
 #ifdef SKINNED
     float weights[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
@@ -57,7 +57,7 @@ VertexOut VS(VertexIn vin)
 // geometry that does not need to sample a texture can use a NULL pixel shader for depth pass
 void PS(VertexOut pin) 
 {
-	const MaterialData material = gMaterialBuffer[gMaterialIndex];
+	const MaterialData material = LoadMaterial(gMaterialIndex);
 
 	const float4 DiffuseAlbedo = gDiffuseTexture[material.DiffuseTextureIndex].Sample(gSamplerLinearWrap, pin.TexCoord) * material.DiffuseAlbedo;
 